@@ -0,0 +1,168 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "engine/bvh.h"
+#include "engine/jobsystem.h"
+
+const neko::Entity entitiesNmb = 100'000;
+
+static std::vector<neko::Aabb3d> CreateAabbs(unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> positionDistribution(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.5f, 2.0f);
+    std::vector<neko::Aabb3d> aabbs(entitiesNmb);
+    for (auto& aabb : aabbs)
+    {
+        aabb.FromCenterExtends(
+                neko::Vec3f(positionDistribution(generator), positionDistribution(generator),
+                            positionDistribution(generator)),
+                neko::Vec3f(sizeDistribution(generator), sizeDistribution(generator), sizeDistribution(generator)));
+    }
+    return aabbs;
+}
+
+static neko::Frustum CreateFrustum()
+{
+    neko::Camera3D camera;
+    camera.position = neko::Vec3f(0.0f, 0.0f, 100.0f);
+    camera.WorldLookAt(neko::Vec3f::zero);
+    camera.farPlane = 300.0f;
+    return neko::Frustum::FromCamera(camera);
+}
+
+static void FillBvh(neko::DynamicBvh& bvh, const std::vector<neko::Aabb3d>& aabbs)
+{
+    for (neko::Entity entity = 0; entity < entitiesNmb; entity++)
+    {
+        bvh.Insert(entity, aabbs[entity]);
+    }
+}
+
+//Reference: every box tested against the frustum
+static void BM_FrustumBruteForce(benchmark::State& state)
+{
+    const auto aabbs = CreateAabbs(0);
+    const auto frustum = CreateFrustum();
+    std::vector<neko::Entity> result;
+    for (auto _ : state)
+    {
+        result.clear();
+        for (neko::Entity entity = 0; entity < entitiesNmb; entity++)
+        {
+            if (frustum.IntersectAabb(aabbs[entity]))
+                result.push_back(entity);
+        }
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+
+BENCHMARK(BM_FrustumBruteForce);
+
+static void BM_BvhQueryFrustum(benchmark::State& state)
+{
+    const auto aabbs = CreateAabbs(0);
+    const auto frustum = CreateFrustum();
+    neko::DynamicBvh bvh;
+    FillBvh(bvh, aabbs);
+    std::vector<neko::Entity> result;
+    for (auto _ : state)
+    {
+        result.clear();
+        bvh.QueryFrustum(frustum, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+
+BENCHMARK(BM_BvhQueryFrustum);
+
+static void BM_BvhRaycast(benchmark::State& state)
+{
+    const auto aabbs = CreateAabbs(0);
+    neko::DynamicBvh bvh;
+    FillBvh(bvh, aabbs);
+    neko::BvhRaycastHit hit;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bvh.Raycast(neko::Vec3f(-600.0f, 1.0f, 2.0f), neko::Vec3f(1.0f, 0.01f, 0.02f),
+                                             2'000.0f, hit));
+    }
+}
+
+BENCHMARK(BM_BvhRaycast);
+
+//The argument is the percentage of entities moved each frame
+static void BM_BvhUpdate(benchmark::State& state)
+{
+    const auto aabbs = CreateAabbs(0);
+    const auto movedAabbs = CreateAabbs(1);
+    const auto movedNmb = entitiesNmb * neko::Entity(state.range(0)) / 100;
+    neko::DynamicBvh bvh;
+    FillBvh(bvh, aabbs);
+    bool moved = false;
+    for (auto _ : state)
+    {
+        const auto& targetAabbs = moved ? aabbs : movedAabbs;
+        for (neko::Entity entity = 0; entity < movedNmb; entity++)
+        {
+            bvh.Update(entity, targetAabbs[entity]);
+        }
+        moved = !moved;
+    }
+    state.SetItemsProcessed(state.iterations() * movedNmb);
+}
+
+BENCHMARK(BM_BvhUpdate)->Arg(1)->Arg(10)->Arg(100);
+
+static void BM_BvhRebuild(benchmark::State& state)
+{
+    const auto aabbs = CreateAabbs(0);
+    neko::DynamicBvh bvh;
+    FillBvh(bvh, aabbs);
+    for (auto _ : state)
+    {
+        bvh.Rebuild();
+    }
+}
+
+BENCHMARK(BM_BvhRebuild)->Unit(benchmark::kMillisecond);
+
+static void BM_BvhRebuildJobSystem(benchmark::State& state)
+{
+    const auto aabbs = CreateAabbs(0);
+    neko::DynamicBvh bvh;
+    FillBvh(bvh, aabbs);
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        bvh.Rebuild(&jobSystem);
+    }
+    jobSystem.Destroy();
+}
+
+BENCHMARK(BM_BvhRebuildJobSystem)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,100 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+#include "engine/component.h"
+#include "mathematics/vector.h"
+
+const neko::Entity entitiesNmb = 100'000;
+const neko::EntityMask componentType = 1u << 0u;
+const float dt = 0.016f;
+
+struct Particle
+{
+    neko::Vec3f position = neko::Vec3f::zero;
+    neko::Vec3f velocity = neko::Vec3f::one;
+};
+
+//The argument is the percentage of entities owning the component, spread over all the entity ids
+template<neko::ComponentStorage storage>
+static void BM_ComponentIteration(benchmark::State& state)
+{
+    const auto density = state.range(0);
+    neko::EntityManager entityManager;
+    neko::ComponentManager<Particle, componentType, storage> particleManager(entityManager);
+    size_t componentsNmb = 0;
+    for (neko::Entity i = 0; i < entitiesNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (entity * density / 100 != (entity + 1) * density / 100)
+        {
+            particleManager.AddComponent(entity);
+            particleManager.SetComponent(entity, Particle{});
+            componentsNmb++;
+        }
+    }
+    for (auto _ : state)
+    {
+        particleManager.ForEach([](neko::Entity, Particle& particle)
+        {
+            particle.position += particle.velocity * dt;
+        });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * componentsNmb);
+}
+
+BENCHMARK_TEMPLATE(BM_ComponentIteration, neko::ComponentStorage::DENSE)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK_TEMPLATE(BM_ComponentIteration, neko::ComponentStorage::SPARSE_SET)->Arg(1)->Arg(10)->Arg(100);
+
+//Random access by entity, like systems reading another manager components
+template<neko::ComponentStorage storage>
+static void BM_ComponentAccess(benchmark::State& state)
+{
+    const auto density = state.range(0);
+    neko::EntityManager entityManager;
+    neko::ComponentManager<Particle, componentType, storage> particleManager(entityManager);
+    std::vector<neko::Entity> entities;
+    for (neko::Entity i = 0; i < entitiesNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (entity * density / 100 != (entity + 1) * density / 100)
+        {
+            particleManager.AddComponent(entity);
+            entities.push_back(entity);
+        }
+    }
+    for (auto _ : state)
+    {
+        neko::Vec3f sum = neko::Vec3f::zero;
+        for (const auto entity : entities)
+        {
+            sum += particleManager.GetComponent(entity).velocity;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * entities.size());
+}
+
+BENCHMARK_TEMPLATE(BM_ComponentAccess, neko::ComponentStorage::DENSE)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK_TEMPLATE(BM_ComponentAccess, neko::ComponentStorage::SPARSE_SET)->Arg(1)->Arg(10)->Arg(100);
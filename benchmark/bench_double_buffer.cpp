@@ -0,0 +1,108 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <random>
+#include <benchmark/benchmark.h>
+#include "engine/component.h"
+#include "mathematics/matrix.h"
+
+const neko::Entity entitiesNmb = 100'000;
+const neko::EntityMask componentType = 1u << 1u;
+
+class TransformBufferManager : public neko::DoubleBufferComponentManager<neko::Mat4f, componentType>
+{
+public:
+    using DoubleBufferComponentManager::DoubleBufferComponentManager;
+
+    //The sync before the dirty tracking, copying every component and swapping the buffers
+    void SyncBuffersFullCopy()
+    {
+        const auto newSize = components_.size();
+        ResizeIfNecessary(currentComponents_, newSize - 1, {});
+        for (size_t i = 0; i < newSize; i++)
+        {
+            if (entityManager_.get().HasComponent(i, componentType))
+            {
+                currentComponents_[i] = components_[i];
+            }
+        }
+        std::swap(components_, currentComponents_);
+    }
+};
+
+static std::vector<neko::Entity> FillTransforms(neko::EntityManager& entityManager,
+                                                TransformBufferManager& transformManager, long churn)
+{
+    for (neko::Entity i = 0; i < entitiesNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        transformManager.AddComponent(entity);
+        transformManager.SetComponent(entity, neko::Mat4f::Identity);
+    }
+    transformManager.SyncBuffers();
+    //The argument is the percentage of entities changed each frame
+    std::vector<neko::Entity> changedEntities(entitiesNmb);
+    for (neko::Entity i = 0; i < entitiesNmb; i++)
+    {
+        changedEntities[i] = i;
+    }
+    std::shuffle(changedEntities.begin(), changedEntities.end(), std::mt19937(0));
+    changedEntities.resize(entitiesNmb * churn / 100);
+    return changedEntities;
+}
+
+static void BM_SyncBuffersFullCopy(benchmark::State& state)
+{
+    neko::EntityManager entityManager;
+    TransformBufferManager transformManager(entityManager);
+    const auto changedEntities = FillTransforms(entityManager, transformManager, state.range(0));
+    for (auto _ : state)
+    {
+        for (const auto entity : changedEntities)
+        {
+            transformManager.SetComponent(entity, neko::Mat4f::Zero);
+        }
+        transformManager.SyncBuffersFullCopy();
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(BM_SyncBuffersFullCopy)->Arg(1)->Arg(10)->Arg(100);
+
+static void BM_SyncBuffersDirty(benchmark::State& state)
+{
+    neko::EntityManager entityManager;
+    TransformBufferManager transformManager(entityManager);
+    const auto changedEntities = FillTransforms(entityManager, transformManager, state.range(0));
+    for (auto _ : state)
+    {
+        for (const auto entity : changedEntities)
+        {
+            transformManager.SetComponent(entity, neko::Mat4f::Zero);
+        }
+        transformManager.SyncBuffers();
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(BM_SyncBuffersDirty)->Arg(1)->Arg(10)->Arg(100);
@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+#include "engine/entity.h"
+
+const neko::Entity entitiesNmb = 100'000;
+const neko::EntityMask componentType = 1u << 1u;
+
+//The argument is the percentage of entities owning the component
+static void FillEntities(neko::EntityManager& entityManager, long density)
+{
+    for (neko::Entity i = 0; i < entitiesNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (entity * density / 100 != (entity + 1) * density / 100)
+        {
+            entityManager.AddComponentType(entity, componentType);
+        }
+    }
+}
+
+//The loop used by the systems before the views
+static void BM_EntityScan(benchmark::State& state)
+{
+    neko::EntityManager entityManager;
+    FillEntities(entityManager, state.range(0));
+    for (auto _ : state)
+    {
+        neko::Entity sum = 0;
+        for (neko::Entity entity = 0; entity < entityManager.GetEntitiesSize(); entity++)
+        {
+            if (entityManager.HasComponent(entity, componentType))
+            {
+                sum += entity;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(BM_EntityScan)->Arg(1)->Arg(10)->Arg(100);
+
+static void BM_EntityView(benchmark::State& state)
+{
+    neko::EntityManager entityManager;
+    FillEntities(entityManager, state.range(0));
+    for (auto _ : state)
+    {
+        neko::Entity sum = 0;
+        for (neko::Entity entity : entityManager.View(componentType))
+        {
+            sum += entity;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(BM_EntityView)->Arg(1)->Arg(10)->Arg(100);
@@ -0,0 +1,179 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "engine/jobsystem.h"
+#include "graphics/frustum.h"
+#include "mathematics/quaternion.h"
+#include "mathematics/transform.h"
+
+const std::size_t objectsNmb = 1'000'000;
+const float objectRadius = 1.0f;
+
+static neko::Camera3D CreateCamera()
+{
+    neko::Camera3D camera;
+    camera.position = neko::Vec3f(0.0f, 0.0f, 100.0f);
+    camera.WorldLookAt(neko::Vec3f::zero);
+    camera.farPlane = 1'000.0f;
+    return camera;
+}
+
+static std::vector<neko::Vec3f> CreatePositions()
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(-200.0f, 200.0f);
+    std::vector<neko::Vec3f> positions(objectsNmb);
+    for (auto& position : positions)
+    {
+        position = neko::Vec3f(distribution(generator), distribution(generator), distribution(generator));
+    }
+    return positions;
+}
+
+//Same tests as HelloFrustumProgram::Culling, one object at a time with the planes built from the camera angles
+static std::size_t SampleCulling(const neko::Camera3D& camera, const std::vector<neko::Vec3f>& positions,
+                                 std::vector<std::uint32_t>& visibleIndices)
+{
+    using namespace neko;
+    const auto cameraDir = -camera.reverseDir;
+    const auto cameraRight = camera.rightDir;
+    const auto cameraUp = camera.upDir;
+    const auto fovX = camera.GetFovX();
+
+    const auto rightQuaternion = Quaternion::AngleAxis(fovX / 2.0f, cameraUp);
+    const auto rightNormal = Vec3f(Transform3d::RotationMatrixFrom(rightQuaternion) * Vec4f(cameraRight));
+    const auto leftQuaternion = Quaternion::AngleAxis(-fovX / 2.0f, cameraUp);
+    const auto leftNormal = Vec3f(Transform3d::RotationMatrixFrom(leftQuaternion) * Vec4f(-cameraRight));
+    const auto topQuaternion = Quaternion::AngleAxis(camera.fovY / 2.0f, cameraRight);
+    const auto topNormal = Vec3f(Transform3d::RotationMatrixFrom(topQuaternion) * Vec4f(-cameraUp));
+    const auto bottomQuaternion = Quaternion::AngleAxis(-camera.fovY / 2.0f, cameraRight);
+    const auto bottomNormal = Vec3f(Transform3d::RotationMatrixFrom(bottomQuaternion) * Vec4f(cameraUp));
+
+    visibleIndices.clear();
+    for (std::size_t i = 0; i < positions.size(); i++)
+    {
+        const auto position = positions[i];
+        if (Vec3f::Dot(cameraDir, position - (camera.position + cameraDir * camera.nearPlane)) < -objectRadius)
+            continue;
+        if (Vec3f::Dot(camera.reverseDir, position - (camera.position + cameraDir * camera.farPlane)) < -objectRadius)
+            continue;
+        const auto relativePosition = position - camera.position;
+        if (Vec3f::Dot(rightNormal, relativePosition) < -objectRadius)
+            continue;
+        if (Vec3f::Dot(leftNormal, relativePosition) < -objectRadius)
+            continue;
+        if (Vec3f::Dot(topNormal, relativePosition) < -objectRadius)
+            continue;
+        if (Vec3f::Dot(bottomNormal, relativePosition) < -objectRadius)
+            continue;
+        visibleIndices.push_back(std::uint32_t(i));
+    }
+    return visibleIndices.size();
+}
+
+static void BM_FrustumCullingSample(benchmark::State& state)
+{
+    const auto camera = CreateCamera();
+    const auto positions = CreatePositions();
+    std::vector<std::uint32_t> visibleIndices;
+    visibleIndices.reserve(objectsNmb);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(SampleCulling(camera, positions, visibleIndices));
+    }
+    state.SetItemsProcessed(state.iterations() * objectsNmb);
+}
+
+BENCHMARK(BM_FrustumCullingSample)->Unit(benchmark::kMillisecond);
+
+static neko::BoundingSpheres CreateSpheres()
+{
+    const auto positions = CreatePositions();
+    neko::BoundingSpheres spheres;
+    spheres.Resize(objectsNmb);
+    for (std::size_t i = 0; i < objectsNmb; i++)
+    {
+        spheres.Set(i, {positions[i], objectRadius});
+    }
+    return spheres;
+}
+
+static void BM_FrustumCullingSpheres(benchmark::State& state)
+{
+    const auto frustum = neko::Frustum::FromCamera(CreateCamera());
+    const auto spheres = CreateSpheres();
+    neko::FrustumCuller culler;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(culler.Cull(frustum, spheres).size());
+    }
+    state.SetItemsProcessed(state.iterations() * objectsNmb);
+}
+
+BENCHMARK(BM_FrustumCullingSpheres)->Unit(benchmark::kMillisecond);
+
+static void BM_FrustumCullingSpheresJobSystem(benchmark::State& state)
+{
+    const auto frustum = neko::Frustum::FromCamera(CreateCamera());
+    const auto spheres = CreateSpheres();
+    neko::FrustumCuller culler;
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(culler.Cull(frustum, spheres, jobSystem).size());
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * objectsNmb);
+}
+
+BENCHMARK(BM_FrustumCullingSpheresJobSystem)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_FrustumCullingBoxesJobSystem(benchmark::State& state)
+{
+    const auto frustum = neko::Frustum::FromCamera(CreateCamera());
+    const auto positions = CreatePositions();
+    neko::BoundingBoxes boxes;
+    boxes.Resize(objectsNmb);
+    for (std::size_t i = 0; i < objectsNmb; i++)
+    {
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(positions[i], neko::Vec3f::one * objectRadius);
+        boxes.Set(i, aabb);
+    }
+    neko::FrustumCuller culler;
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(culler.Cull(frustum, boxes, jobSystem).size());
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * objectsNmb);
+}
+
+BENCHMARK(BM_FrustumCullingBoxesJobSystem)->Unit(benchmark::kMillisecond)->UseRealTime();
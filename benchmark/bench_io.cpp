@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utilities/file_utility.h"
+#include "utilities/io_service.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static std::vector<std::string> GetDataFiles()
+{
+    std::vector<std::string> paths;
+    neko::IterateDirectory(SOURCE_PATH "/data/", [&paths](const std::string_view path)
+    {
+        paths.emplace_back(path);
+    }, true);
+    return paths;
+}
+
+//Drop the files from the page cache so the next reads hit the disk, Linux only
+static void EvictFiles(const std::vector<std::string>& paths)
+{
+#if defined(__linux__)
+    for (const auto& path : paths)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+#else
+    (void) paths;
+#endif
+}
+
+//The argument is 1 for cold loads, 0 for loads from the page cache
+static void BM_SerialLoad(benchmark::State& state)
+{
+    const auto paths = GetDataFiles();
+    std::size_t bytes = 0;
+    for (auto _ : state)
+    {
+        if (state.range(0))
+        {
+            state.PauseTiming();
+            EvictFiles(paths);
+            state.ResumeTiming();
+        }
+        //What the single resource thread does, reading into heap buffers like the I/O service as a mapping
+        //only touches the pages when they are used
+        for (const auto& path : paths)
+        {
+            neko::BufferFile bufferFile;
+            bufferFile.Load(path, neko::BufferFile::LoadMode::READ);
+            bytes += bufferFile.dataLength;
+            benchmark::DoNotOptimize(bufferFile.dataBuffer);
+            bufferFile.Destroy();
+        }
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.counters["files"] = static_cast<double>(paths.size());
+}
+BENCHMARK(BM_SerialLoad)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void IoServiceLoad(benchmark::State& state, neko::IoBackend backend)
+{
+    const auto paths = GetDataFiles();
+    std::unique_ptr<neko::ResourceJob[]> jobs(new neko::ResourceJob[paths.size()]);
+    neko::IoService ioService;
+    ioService.Init(backend);
+    if (ioService.GetBackend() != backend)
+    {
+        state.SkipWithError("Backend not available");
+    }
+    std::size_t bytes = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (std::size_t i = 0; i < paths.size(); i++)
+        {
+            jobs[i].Reset();
+            jobs[i].SetFilePath(paths[i]);
+        }
+        if (state.range(0))
+        {
+            EvictFiles(paths);
+        }
+        state.ResumeTiming();
+        for (std::size_t i = 0; i < paths.size(); i++)
+        {
+            ioService.Read(&jobs[i]);
+        }
+        for (std::size_t i = 0; i < paths.size(); i++)
+        {
+            jobs[i].Join();
+            bytes += jobs[i].GetBufferFile().dataLength;
+        }
+    }
+    ioService.Destroy();
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.counters["files"] = static_cast<double>(paths.size());
+}
+
+static void BM_IoUringLoad(benchmark::State& state)
+{
+    IoServiceLoad(state, neko::IoBackend::IO_URING);
+}
+BENCHMARK(BM_IoUringLoad)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_ThreadPoolLoad(benchmark::State& state)
+{
+    IoServiceLoad(state, neko::IoBackend::THREAD_POOL);
+}
+BENCHMARK(BM_ThreadPoolLoad)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,139 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "engine/jobsystem.h"
+
+const long fromRange = 8;
+const long toRange = 1 << 10;
+
+static void Task(std::atomic<unsigned int>& doneTasks)
+{
+    float value = 1.0f;
+    for (int i = 0; i < 256; i++)
+    {
+        value = value * 1.0001f + 0.5f;
+    }
+    benchmark::DoNotOptimize(value);
+    ++doneTasks;
+}
+
+static std::vector<std::unique_ptr<neko::Job>> CreateJobs(size_t jobsNmb, std::atomic<unsigned int>& doneTasks)
+{
+    std::vector<std::unique_ptr<neko::Job>> jobs;
+    jobs.reserve(jobsNmb);
+    for (size_t i = 0; i < jobsNmb; i++)
+    {
+        jobs.push_back(std::make_unique<neko::Job>([&doneTasks] { Task(doneTasks); }));
+    }
+    return jobs;
+}
+
+//Same scenario as Engine.TestJobSystem: independent jobs scheduled from the main thread
+static void BM_JobSystemIndependentJobs(benchmark::State& state)
+{
+    const size_t jobsNmb = state.range(0);
+    std::atomic<unsigned int> doneTasks = 0;
+    auto jobs = CreateJobs(jobsNmb, doneTasks);
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        for (auto& job : jobs)
+        {
+            job->Reset();
+            jobSystem.ScheduleJob(job.get(), neko::JobThreadType::OTHER_THREAD);
+        }
+        for (auto& job : jobs)
+        {
+            job->Join();
+        }
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * jobsNmb);
+}
+
+BENCHMARK(BM_JobSystemIndependentJobs)->Range(fromRange, toRange)->UseRealTime();
+
+//Each job depends on the previous one, scheduled in reverse order
+static void BM_JobSystemDependencyChain(benchmark::State& state)
+{
+    const size_t jobsNmb = state.range(0);
+    std::atomic<unsigned int> doneTasks = 0;
+    auto jobs = CreateJobs(jobsNmb, doneTasks);
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        for (auto& job : jobs)
+        {
+            job->Reset();
+        }
+        for (size_t i = 1; i < jobsNmb; i++)
+        {
+            jobs[i]->AddDependency(jobs[i - 1].get());
+        }
+        for (size_t i = jobsNmb; i > 0; i--)
+        {
+            jobSystem.ScheduleJob(jobs[i - 1].get(), neko::JobThreadType::OTHER_THREAD);
+        }
+        jobs.back()->Join();
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * jobsNmb);
+}
+
+BENCHMARK(BM_JobSystemDependencyChain)->Range(fromRange, toRange)->UseRealTime();
+
+//One job waiting for all the others, like the swap buffer job of the engine frame
+static void BM_JobSystemFanIn(benchmark::State& state)
+{
+    const size_t jobsNmb = state.range(0);
+    std::atomic<unsigned int> doneTasks = 0;
+    auto jobs = CreateJobs(jobsNmb, doneTasks);
+    neko::Job lastJob([&doneTasks] { Task(doneTasks); });
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        lastJob.Reset();
+        for (auto& job : jobs)
+        {
+            job->Reset();
+            lastJob.AddDependency(job.get());
+        }
+        jobSystem.ScheduleJob(&lastJob, neko::JobThreadType::OTHER_THREAD);
+        for (auto& job : jobs)
+        {
+            jobSystem.ScheduleJob(job.get(), neko::JobThreadType::OTHER_THREAD);
+        }
+        lastJob.Join();
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * (jobsNmb + 1));
+}
+
+BENCHMARK(BM_JobSystemFanIn)->Range(fromRange, toRange)->UseRealTime();
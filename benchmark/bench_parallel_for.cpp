@@ -0,0 +1,97 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "engine/jobsystem.h"
+#include "mathematics/vector.h"
+
+const size_t grainSize = 1'024;
+const float gravityConst = 1000.0f;
+const float centerMass = 1000.0f;
+const float asteroidMass = 1.0f;
+const float dt = 0.016f;
+
+//Same update as HelloInstancingProgram::Update
+static void UpdateAsteroids(std::vector<neko::Vec3f>& positions, std::vector<neko::Vec3f>& velocities,
+                            size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        const auto deltaToCenter = neko::Vec3f::zero - positions[i];
+        const auto r = deltaToCenter.Magnitude();
+        const auto force = gravityConst * centerMass * asteroidMass / (r * r);
+        auto velDir = neko::Vec3f(-deltaToCenter.z, 0.0f, deltaToCenter.x).Normalized();
+        const auto speed = std::sqrt(force / asteroidMass * r);
+        velocities[i] = velDir * speed;
+        positions[i] += velocities[i] * dt;
+    }
+}
+
+//First argument is the number of asteroids, second the number of threads including the caller
+static void BM_ParallelForAsteroids(benchmark::State& state)
+{
+    const size_t asteroidNmb = state.range(0);
+    const auto threadsNmb = static_cast<std::uint8_t>(state.range(1));
+    std::vector<neko::Vec3f> positions(asteroidNmb);
+    std::vector<neko::Vec3f> velocities(asteroidNmb);
+    for (size_t i = 0; i < asteroidNmb; i++)
+    {
+        positions[i] = neko::Vec3f(100.0f + float(i % 200), 0.0f, 100.0f + float(i % 300));
+    }
+    //With one thread the job system is not initialized and ParallelFor runs on the caller only
+    neko::JobSystem jobSystem(threadsNmb - 1);
+    if (threadsNmb > 1)
+    {
+        jobSystem.Init();
+    }
+    for (auto _ : state)
+    {
+        jobSystem.ParallelFor(0, asteroidNmb, grainSize, [&positions, &velocities](size_t begin, size_t end)
+        {
+            UpdateAsteroids(positions, velocities, begin, end);
+        });
+        benchmark::ClobberMemory();
+    }
+    if (threadsNmb > 1)
+    {
+        jobSystem.Destroy();
+    }
+    state.SetItemsProcessed(state.iterations() * asteroidNmb);
+}
+
+static void ParallelForArguments(benchmark::internal::Benchmark* b)
+{
+    const long maxThreadsNmb = std::max(2u, std::thread::hardware_concurrency());
+    for (long asteroidNmb = 1 << 12; asteroidNmb <= 1 << 18; asteroidNmb <<= 3)
+    {
+        for (long threadsNmb = 1; threadsNmb <= maxThreadsNmb; threadsNmb++)
+        {
+            b->Args({asteroidNmb, threadsNmb});
+        }
+    }
+}
+
+BENCHMARK(BM_ParallelForAsteroids)->Apply(ParallelForArguments)->UseRealTime();
@@ -78,4 +78,95 @@ static void BM_Angle(benchmark::State& state)
 }
 BENCHMARK(BM_Angle)->Range(fromRange, toRange);
 
+static void BM_Slerp(benchmark::State& state)
+{
+    std::vector<neko::Quaternion> as;
+    std::vector<neko::Quaternion> bs;
+    for (int i = 0; i < state.range(0); i++)
+    {
+        neko::Vec4f v;
+        RandomFill(v);
+        as.push_back(neko::Quaternion::Normalized(neko::Quaternion(v.x, v.y, v.z, v.w)));
+        RandomFill(v);
+        bs.push_back(neko::Quaternion::Normalized(neko::Quaternion(v.x, v.y, v.z, v.w)));
+    }
+
+    for (auto s : state)
+    {
+        for (size_t i = 0; i < as.size(); i++)
+        {
+            benchmark::DoNotOptimize(neko::Quaternion::Slerp(as[i], bs[i], 0.3f));
+        }
+    }
+}
+BENCHMARK(BM_Slerp)->Range(fromRange, toRange);
+
+static void BM_SlerpBatch(benchmark::State& state)
+{
+    const size_t batchNmb = (state.range(0) + 7) / 8;
+    std::vector<neko::EightVec4f> as(batchNmb);
+    std::vector<neko::EightVec4f> bs(batchNmb);
+    for (size_t i = 0; i < batchNmb; i++)
+    {
+        for (size_t j = 0; j < 8; j++)
+        {
+            neko::Vec4f v;
+            RandomFill(v);
+            const auto a = neko::Quaternion::Normalized(neko::Quaternion(v.x, v.y, v.z, v.w));
+            RandomFill(v);
+            const auto b = neko::Quaternion::Normalized(neko::Quaternion(v.x, v.y, v.z, v.w));
+            as[i].xs[j] = a.x;
+            as[i].ys[j] = a.y;
+            as[i].zs[j] = a.z;
+            as[i].ws[j] = a.w;
+            bs[i].xs[j] = b.x;
+            bs[i].ys[j] = b.y;
+            bs[i].zs[j] = b.z;
+            bs[i].ws[j] = b.w;
+        }
+    }
+
+    for (auto s : state)
+    {
+        for (size_t i = 0; i < batchNmb; i++)
+        {
+            benchmark::DoNotOptimize(neko::Quaternion::Slerp(as[i], bs[i], 0.3f));
+        }
+    }
+}
+BENCHMARK(BM_SlerpBatch)->Range(fromRange, toRange);
+
+static void BM_NlerpBatch(benchmark::State& state)
+{
+    const size_t batchNmb = (state.range(0) + 7) / 8;
+    std::vector<neko::EightVec4f> as(batchNmb);
+    std::vector<neko::EightVec4f> bs(batchNmb);
+    for (size_t i = 0; i < batchNmb; i++)
+    {
+        for (size_t j = 0; j < 8; j++)
+        {
+            neko::Vec4f v;
+            RandomFill(v);
+            as[i].xs[j] = v.x;
+            as[i].ys[j] = v.y;
+            as[i].zs[j] = v.z;
+            as[i].ws[j] = v.w;
+            RandomFill(v);
+            bs[i].xs[j] = v.x;
+            bs[i].ys[j] = v.y;
+            bs[i].zs[j] = v.z;
+            bs[i].ws[j] = v.w;
+        }
+    }
+
+    for (auto s : state)
+    {
+        for (size_t i = 0; i < batchNmb; i++)
+        {
+            benchmark::DoNotOptimize(neko::Quaternion::Nlerp(as[i], bs[i], 0.3f));
+        }
+    }
+}
+BENCHMARK(BM_NlerpBatch)->Range(fromRange, toRange);
+
 BENCHMARK_MAIN();
\ No newline at end of file
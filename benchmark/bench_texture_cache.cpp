@@ -0,0 +1,91 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+
+#include "graphics/texture.h"
+#include "graphics/texture_cache.h"
+
+static const char* const texturePaths[] =
+{
+    SOURCE_PATH "/data/sprites/wall.jpg",
+    SOURCE_PATH "/data/sprites/grass.png"
+};
+
+//What the loaders do at each launch without the cache
+static void BM_StbDecode(benchmark::State& state)
+{
+    neko::BufferFile file;
+    file.Load(texturePaths[state.range(0)], neko::BufferFile::LoadMode::READ);
+    for (auto _ : state)
+    {
+        auto image = neko::StbImageConvert(file);
+        benchmark::DoNotOptimize(image.data);
+        image.Destroy();
+    }
+    file.Destroy();
+}
+BENCHMARK(BM_StbDecode)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+//First launch, the mip chain is built on the CPU
+static void BM_WriteTextureCache(benchmark::State& state)
+{
+    neko::BufferFile file;
+    file.Load(texturePaths[state.range(0)], neko::BufferFile::LoadMode::READ);
+    auto image = neko::StbImageConvert(file);
+    for (auto _ : state)
+    {
+        auto cacheFile = neko::WriteTextureCache(image, neko::Texture::DEFAULT, "");
+        benchmark::DoNotOptimize(cacheFile.dataBuffer);
+        cacheFile.Destroy();
+    }
+    image.Destroy();
+    file.Destroy();
+}
+BENCHMARK(BM_WriteTextureCache)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+//Next launches, including the copy of the file read from the disk
+static void BM_ReadTextureCache(benchmark::State& state)
+{
+    neko::BufferFile file;
+    file.Load(texturePaths[state.range(0)], neko::BufferFile::LoadMode::READ);
+    auto image = neko::StbImageConvert(file);
+    auto cacheFile = neko::WriteTextureCache(image, neko::Texture::DEFAULT, "");
+    for (auto _ : state)
+    {
+        neko::BufferFile readFile;
+        readFile.dataLength = cacheFile.dataLength;
+        readFile.dataBuffer = new unsigned char[readFile.dataLength + 1];
+        std::memcpy(readFile.dataBuffer, cacheFile.dataBuffer, readFile.dataLength + 1);
+        neko::CachedTexture cachedTexture;
+        neko::ReadTextureCache(std::move(readFile), "", cachedTexture);
+        benchmark::DoNotOptimize(cachedTexture.levels.data());
+        cachedTexture.Destroy();
+    }
+    cacheFile.Destroy();
+    image.Destroy();
+    file.Destroy();
+}
+BENCHMARK(BM_ReadTextureCache)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2020 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "engine/transform.h"
+#include "mathematics/transform.h"
+
+const long fromRange = 1 << 10;
+const long toRange = 1 << 16;
+
+struct TransformInputs
+{
+    std::vector<neko::Vec3f> positions;
+    std::vector<neko::Vec3f> scales;
+    std::vector<neko::Quaternion> rotations;
+};
+
+static TransformInputs GenerateInputs(size_t transformsNmb)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    TransformInputs inputs;
+    for (size_t i = 0; i < transformsNmb; i++)
+    {
+        inputs.positions.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+        inputs.scales.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+        inputs.rotations.push_back(neko::Quaternion::FromEuler(neko::EulerAngles(
+                neko::degree_t(distribution(generator)),
+                neko::degree_t(distribution(generator)),
+                neko::degree_t(distribution(generator)))));
+    }
+    return inputs;
+}
+
+//The three matrix multiplications done by UpdateTransform
+static void BM_ComposeTransformsMultiply(benchmark::State& state)
+{
+    const size_t transformsNmb = state.range(0);
+    const auto inputs = GenerateInputs(transformsNmb);
+    std::vector<neko::Mat4f> transforms(transformsNmb);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < transformsNmb; i++)
+        {
+            auto transform = neko::Transform3d::Rotate(neko::Mat4f::Identity, inputs.rotations[i]);
+            transform = neko::Transform3d::Scale(transform, inputs.scales[i]);
+            transforms[i] = neko::Transform3d::Translate(transform, inputs.positions[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * transformsNmb);
+}
+
+BENCHMARK(BM_ComposeTransformsMultiply)->Range(fromRange, toRange);
+
+template<typename Vec3Batch, typename Vec4Batch>
+static void BM_ComposeTransformsBatch(benchmark::State& state)
+{
+    const size_t batchSize = sizeof(Vec4Batch::xs) / sizeof(float);
+    const size_t transformsNmb = state.range(0);
+    const auto inputs = GenerateInputs(transformsNmb);
+    std::vector<Vec3Batch> positions(transformsNmb / batchSize);
+    std::vector<Vec3Batch> scales(transformsNmb / batchSize);
+    std::vector<Vec4Batch> rotations(transformsNmb / batchSize);
+    for (size_t i = 0; i < transformsNmb; i++)
+    {
+        const size_t batch = i / batchSize;
+        const size_t lane = i % batchSize;
+        positions[batch].xs[lane] = inputs.positions[i].x;
+        positions[batch].ys[lane] = inputs.positions[i].y;
+        positions[batch].zs[lane] = inputs.positions[i].z;
+        scales[batch].xs[lane] = inputs.scales[i].x;
+        scales[batch].ys[lane] = inputs.scales[i].y;
+        scales[batch].zs[lane] = inputs.scales[i].z;
+        rotations[batch].xs[lane] = inputs.rotations[i].x;
+        rotations[batch].ys[lane] = inputs.rotations[i].y;
+        rotations[batch].zs[lane] = inputs.rotations[i].z;
+        rotations[batch].ws[lane] = inputs.rotations[i].w;
+    }
+    std::vector<neko::Mat4f> transforms(transformsNmb);
+    for (auto _ : state)
+    {
+        for (size_t batch = 0; batch < positions.size(); batch++)
+        {
+            neko::Transform3d::ComposeTransforms(positions[batch], scales[batch], rotations[batch],
+                                                 &transforms[batch * batchSize]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * transformsNmb);
+}
+
+BENCHMARK_TEMPLATE(BM_ComposeTransformsBatch, neko::FourVec3f, neko::FourVec4f)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_ComposeTransformsBatch, neko::EightVec3f, neko::EightVec4f)->Range(fromRange, toRange);
+
+//Whole update of dirty transforms, the argument is the number of hierarchy levels
+static void BM_Transform3dManagerUpdate(benchmark::State& state)
+{
+    const neko::Entity entitiesNmb = 1 << 14;
+    const neko::Entity levelsNmb = state.range(0);
+    neko::EntityManager entityManager;
+    neko::Transform3dManager transformManager(entityManager);
+    for (neko::Entity i = 0; i < entitiesNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        transformManager.AddComponent(entity);
+        if (entity >= entitiesNmb / levelsNmb)
+        {
+            entityManager.SetEntityParent(entity, entity - entitiesNmb / levelsNmb);
+        }
+    }
+    for (auto _ : state)
+    {
+        for (neko::Entity entity = 0; entity < entitiesNmb / levelsNmb; entity++)
+        {
+            transformManager.SetPosition(entity, neko::Vec3f::one);
+        }
+        transformManager.Update();
+    }
+    state.SetItemsProcessed(state.iterations() * entitiesNmb);
+}
+
+BENCHMARK(BM_Transform3dManagerUpdate)->Arg(1)->Arg(4)->Arg(16);
@@ -28,6 +28,7 @@
 #include "assimp/material.h"
 #include "mathematics/vector.h"
 #include "gl/shader.h"
+#include "gl/instancing.h"
 #include "gl/texture.h"
 #include "mathematics/circle.h"
 
@@ -74,6 +75,15 @@ namespace neko::assimp
 
 		[[nodiscard]] unsigned int GetVao() const {return VAO;}
 		[[nodiscard]] size_t GetElementsCount() const {return indices_.size();}
+		/**
+		 * \brief Geometry to give to the gl::InstancedBatchRenderer, only valid once the mesh is loaded.
+		 * The batch binds the textures of the mesh before drawing it, so the mesh should outlive the batch.
+		 */
+		[[nodiscard]] gl::InstancedMesh GetInstancedMesh() const
+		{
+			return {VAO, GLsizei(indices_.size()), GL_TRIANGLES,
+				[this](const gl::Shader& shader) { BindTextures(shader); }};
+		}
 
 		[[nodiscard]] Sphere GenerateBoundingSphere() const;
 	protected:
@@ -46,6 +46,10 @@ public:
     {
 	    return meshes_[index];
     };
+    /**
+     * \brief Meshes to give to the gl::InstancedBatchRenderer, only valid once the model is loaded
+     */
+    [[nodiscard]] std::vector<gl::InstancedMesh> GetInstancedMeshes() const;
 private:
     // model data
     std::vector<Mesh> meshes_;
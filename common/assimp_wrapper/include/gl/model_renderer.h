@@ -0,0 +1,82 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <vector>
+
+#include "engine/component.h"
+#include "gl/instancing.h"
+#include "gl/model.h"
+
+namespace neko::assimp
+{
+/**
+ * \brief Model drawn at the transform of the entity, the material id separates the entities drawing
+ * the same model and shader with different material values
+ */
+struct ModelRenderer
+{
+    const Model* model = nullptr;
+    const gl::Shader* shader = nullptr;
+    std::uint32_t materialId = 0;
+};
+
+/**
+ * \brief Puts the entities with a ModelRenderer in the batches of the gl::InstancedBatchRenderer,
+ * all the entities sharing the same model, shader and material are drawn with one instanced draw call per mesh.
+ * The shader should take the model matrix at gl::InstancedBatchRenderer::INSTANCE_MODEL_LOCATION,
+ * like shaders/engine/instanced.vert. The entities wait out of the batches until their model is loaded.
+ * Models and shaders should outlive the batch renderer.
+ */
+class ModelRendererManager : public ComponentManager<ModelRenderer, EntityMask(ComponentType::MODEL3D)>
+{
+public:
+    ModelRendererManager(EntityManager& entityManager, gl::InstancedBatchRenderer& batchRenderer);
+    void SetModel(Entity entity, const Model& model, const gl::Shader& shader, std::uint32_t materialId = 0);
+    void SetComponent(Entity entity, const ModelRenderer& component) override;
+    void DestroyComponent(Entity entity) override;
+    /**
+     * \brief Add the entities whose model finished loading to their batch,
+     * should be called on the main thread before the batch renderer is synced
+     */
+    void Update();
+    void Destroy();
+
+    [[nodiscard]] std::size_t GetPendingNmb() const { return pendingEntities_.size(); }
+private:
+    struct ModelBatch
+    {
+        ModelRenderer modelRenderer;
+        InstancedBatchId batchId = INVALID_INSTANCED_BATCH_ID;
+    };
+    /**
+     * \brief Return the batch of this model, shader and material, the model should be loaded
+     */
+    InstancedBatchId GetModelBatch(const ModelRenderer& modelRenderer);
+
+    gl::InstancedBatchRenderer& batchRenderer_;
+    std::vector<ModelBatch> modelBatches_;
+    std::vector<Entity> pendingEntities_;
+};
+}
@@ -31,6 +31,7 @@
 #include "gl/gles3_include.h"
 #include "graphics/graphics.h"
 #include "graphics/texture.h"
+#include "gl/state_cache.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -75,16 +76,16 @@ void Mesh::Draw(const gl::Shader& shader) const
 {
     BindTextures(shader);
     // draw mesh
-    glBindVertexArray(VAO);
+    gl::BindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, indices_.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    gl::BindVertexArray(0);
 }
 
 void Mesh::Destroy()
 {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    gl::DeleteVertexArrays(1, &VAO);
+    gl::DeleteBuffers(1, &VBO);
+    gl::DeleteBuffers(1, &EBO);
 
 	for(auto& texture : textures_)
 	{
@@ -216,12 +217,12 @@ void Mesh::SetupMesh()
     EASY_END_BLOCK;
     EASY_BLOCK("Copy Buffers");
 #endif
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    gl::BindVertexArray(VAO);
+    gl::BindBuffer(GL_ARRAY_BUFFER, VBO);
     glCheckError();
     glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), &vertices_[0], GL_STATIC_DRAW);
     glCheckError();
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * sizeof(unsigned int),
         &indices_[0], GL_STATIC_DRAW);
         glCheckError();
@@ -246,7 +247,7 @@ void Mesh::SetupMesh()
     glEnableVertexAttribArray(3);
     glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
     glCheckError();
-    glBindVertexArray(0);
+    gl::BindVertexArray(0);
     glCheckError();
 }
 
@@ -290,7 +291,7 @@ void Mesh::BindTextures(const gl::Shader& shader) const
     for (size_t i = 0; i < textures_.size(); i++)
     {
         // activate proper texture unit before binding
-        glActiveTexture(GL_TEXTURE0 + i);
+        gl::ActiveTexture(GL_TEXTURE0 + i);
         // retrieve texture number (the N in diffuse_textureN)
         std::string number;
         std::string name;
@@ -311,11 +312,11 @@ void Mesh::BindTextures(const gl::Shader& shader) const
             default: ;
         }
         shader.SetInt("material." + name + number, i);
-        glBindTexture(GL_TEXTURE_2D, textures_[i].textureName);
+        gl::BindTexture(GL_TEXTURE_2D, textures_[i].textureName);
     }
     shader.SetFloat("material.shininess", specularExponent_);
     shader.SetBool("enableNormalMap", normalNr > 1);
-    glActiveTexture(GL_TEXTURE0);
+    gl::ActiveTexture(GL_TEXTURE0);
     glCheckError();
 }
 }
@@ -48,6 +48,15 @@ void Model::Draw(const gl::Shader& shader)
 		mesh.Draw(shader);
 }
 
+std::vector<gl::InstancedMesh> Model::GetInstancedMeshes() const
+{
+	std::vector<gl::InstancedMesh> instancedMeshes;
+	instancedMeshes.reserve(meshes_.size());
+	for (const auto& mesh : meshes_)
+		instancedMeshes.push_back(mesh.GetInstancedMesh());
+	return instancedMeshes;
+}
+
 void Model::Destroy()
 {
 	for (auto& mesh : meshes_)
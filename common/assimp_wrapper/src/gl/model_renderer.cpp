@@ -0,0 +1,127 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "gl/model_renderer.h"
+
+#include <algorithm>
+
+#include "engine/entity.h"
+
+namespace neko::assimp
+{
+ModelRendererManager::ModelRendererManager(EntityManager& entityManager,
+                                           gl::InstancedBatchRenderer& batchRenderer) :
+    ComponentManager(entityManager),
+    batchRenderer_(batchRenderer)
+{
+}
+
+void ModelRendererManager::SetModel(Entity entity, const Model& model, const gl::Shader& shader,
+                                    std::uint32_t materialId)
+{
+    SetComponent(entity, {&model, &shader, materialId});
+}
+
+void ModelRendererManager::SetComponent(Entity entity, const ModelRenderer& component)
+{
+    ComponentManager::SetComponent(entity, component);
+    if (component.model == nullptr || component.shader == nullptr)
+    {
+        batchRenderer_.RemoveInstance(entity);
+        return;
+    }
+    if (component.model->IsLoaded())
+    {
+        batchRenderer_.AddInstance(entity, GetModelBatch(component));
+        return;
+    }
+    //Keeps drawing its previous model until the new one is loaded
+    pendingEntities_.push_back(entity);
+}
+
+void ModelRendererManager::DestroyComponent(Entity entity)
+{
+    ComponentManager::DestroyComponent(entity);
+    batchRenderer_.RemoveInstance(entity);
+}
+
+void ModelRendererManager::Update()
+{
+    if (pendingEntities_.empty())
+        return;
+    //The pending entities mostly share a few models, each model is only checked once
+    std::vector<std::pair<const Model*, bool>> loadedModels;
+    const auto isLoaded = [&loadedModels](const Model* model)
+    {
+        const auto it = std::find_if(loadedModels.begin(), loadedModels.end(),
+            [model](const auto& loadedModel) { return loadedModel.first == model; });
+        if (it != loadedModels.end())
+        {
+            return it->second;
+        }
+        loadedModels.emplace_back(model, model->IsLoaded());
+        return loadedModels.back().second;
+    };
+    const auto& entityManager = entityManager_.get();
+    const auto it = std::remove_if(pendingEntities_.begin(), pendingEntities_.end(),
+        [this, &entityManager, &isLoaded](Entity entity)
+    {
+        //Destroyed entities or components are dropped, the current component is used if it was set again
+        if (!entityManager.HasComponent(entity, EntityMask(ComponentType::MODEL3D)))
+            return true;
+        const auto& component = components_[entity];
+        if (component.model == nullptr || component.shader == nullptr)
+            return true;
+        if (!isLoaded(component.model))
+            return false;
+        batchRenderer_.AddInstance(entity, GetModelBatch(component));
+        return true;
+    });
+    pendingEntities_.erase(it, pendingEntities_.end());
+}
+
+void ModelRendererManager::Destroy()
+{
+    modelBatches_.clear();
+    pendingEntities_.clear();
+}
+
+InstancedBatchId ModelRendererManager::GetModelBatch(const ModelRenderer& modelRenderer)
+{
+    const auto it = std::find_if(modelBatches_.begin(), modelBatches_.end(),
+        [&modelRenderer](const ModelBatch& modelBatch)
+    {
+        return modelBatch.modelRenderer.model == modelRenderer.model &&
+            modelBatch.modelRenderer.shader == modelRenderer.shader &&
+            modelBatch.modelRenderer.materialId == modelRenderer.materialId;
+    });
+    if (it != modelBatches_.end())
+    {
+        return it->batchId;
+    }
+    const InstancedBatchId batchId = batchRenderer_.AddBatch(modelRenderer.model->GetInstancedMeshes(),
+        *modelRenderer.shader, modelRenderer.materialId);
+    modelBatches_.push_back({modelRenderer, batchId});
+    return batchId;
+}
+}
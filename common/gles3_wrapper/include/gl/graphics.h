@@ -25,6 +25,7 @@
 #include <thread>
 
 #include "texture.h"
+#include "gl/state_cache.h"
 #include "graphics/graphics.h"
 namespace neko::gl
 {
@@ -38,7 +39,15 @@ public:
     void BeforeRenderLoop() override;
 
     void AfterRenderLoop() override;
-
+    /**
+     * \brief Show the GL state cache counters of the last frame
+     */
+    void DrawImGui() override;
+protected:
+    void BindShader(std::uint32_t shader) override;
+    void BindTexture(std::uint32_t texture) override;
+
+    StateCacheStats lastFrameStateCacheStats_;
 };
 
 }
\ No newline at end of file
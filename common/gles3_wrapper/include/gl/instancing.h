@@ -0,0 +1,109 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "graphics/instancing.h"
+#include "gl/gles3_include.h"
+#include "gl/shader.h"
+
+namespace neko::gl
+{
+using BindMaterialFunc = std::function<void(const Shader&)>;
+
+/**
+ * \brief Indexed geometry drawn by an instanced batch, e.g. an assimp::Mesh VAO or a RenderQuad VAO
+ */
+struct InstancedMesh
+{
+    GLuint vao = 0;
+    GLsizei elementsCount = 0;
+    GLenum mode = GL_TRIANGLES;
+    /**
+     * \brief Called on the render thread before drawing this mesh, e.g. to bind its textures
+     */
+    BindMaterialFunc bindMaterial;
+};
+
+/**
+ * \brief Draws every mesh of a batch with one glDrawElementsInstanced, the model matrices are streamed each frame
+ * into a ring of instance buffers orphaned on upload.
+ * The shader gets the model matrix as a mat4 attribute at INSTANCE_MODEL_LOCATION (using 4 locations)
+ * and the camera matrices in the Camera uniform block, uploaded from the CameraLocator in Render.
+ */
+class InstancedBatchRenderer : public neko::InstancedBatchRenderer
+{
+public:
+    static constexpr GLuint INSTANCE_MODEL_LOCATION = 5;
+    static constexpr std::size_t INSTANCE_BUFFERS_NMB = 3;
+
+    using neko::InstancedBatchRenderer::InstancedBatchRenderer;
+    /**
+     * \brief Return the batch drawing this mesh with this shader and material, creating it if needed.
+     * The mesh should already be uploaded and the shader should outlive the renderer.
+     * \param materialId user defined identifier, entities with a different material are drawn in another batch
+     * \param bindMaterial called on the render thread after the shader is bound, e.g. to set the lights
+     */
+    InstancedBatchId AddBatch(const InstancedMesh& mesh, const Shader& shader,
+                              std::uint32_t materialId = 0, BindMaterialFunc bindMaterial = {});
+    /**
+     * \brief Same as above for a model made of several meshes, e.g. an assimp::Model,
+     * each mesh is drawn with its own instanced draw call sharing the instances of the batch.
+     * The batch is identified by the first mesh.
+     */
+    InstancedBatchId AddBatch(const std::vector<InstancedMesh>& meshes, const Shader& shader,
+                              std::uint32_t materialId = 0, BindMaterialFunc bindMaterial = {});
+
+    void Init() override;
+    void Render() override;
+    void Destroy() override;
+    /**
+     * \brief Also copies the draw infos added in AddBatch for the render thread
+     */
+    void SyncBuffers() override;
+    /**
+     * \brief Number of glDrawElementsInstanced issued for the current batches, should be called on the main thread
+     */
+    [[nodiscard]] std::size_t GetDrawCallsNmb() const;
+private:
+    struct BatchDrawInfo
+    {
+        std::vector<InstancedMesh> meshes;
+        const Shader* shader = nullptr;
+        BindMaterialFunc bindMaterial;
+        //Set on the render thread once the Camera block of the shader is bound
+        bool isCameraBlockBound = false;
+    };
+    std::vector<BatchDrawInfo> drawInfos_;
+    std::vector<BatchDrawInfo> renderDrawInfos_;
+    bool drawInfosDirty_ = false;
+    std::array<GLuint, INSTANCE_BUFFERS_NMB> instanceVbos_{};
+    std::array<GLsizeiptr, INSTANCE_BUFFERS_NMB> instanceVboSizes_{};
+    std::size_t currentInstanceVbo_ = 0;
+    std::vector<GLintptr> batchOffsets_;
+};
+}
@@ -22,13 +22,20 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <graphics/shader.h>
 #include "graphics/texture.h"
 #include "gl/gles3_include.h"
 #include "mathematics/vector.h"
 #include "mathematics/matrix.h"
 
+namespace neko
+{
+struct Camera;
+}
+
 namespace neko::gl
 {
 const GLuint INVALID_SHADER = 0;
@@ -52,6 +59,78 @@ GLuint CreateShaderProgram(
 
 void DeleteShader(GLuint shader);
 
+using UniformHash = std::uint32_t;
+
+/**
+ * \brief FNV-1a hash of the uniform name, usable at compile time
+ */
+constexpr UniformHash HashUniformName(std::string_view name)
+{
+    UniformHash hash = 2166136261u;
+    for (const char c : name)
+    {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * \brief Hashed uniform name, declare it constexpr to set uniforms without any string work:
+ * static constexpr UniformHandle modelUniform("model");
+ */
+struct UniformHandle
+{
+    constexpr UniformHandle(std::string_view name) : hash(HashUniformName(name)) {}
+    constexpr UniformHandle(const char* name) : hash(HashUniformName(name)) {}
+    UniformHandle(const std::string& name) : hash(HashUniformName(name)) {}
+
+    UniformHash hash;
+};
+
+const GLint INVALID_UNIFORM_LOCATION = -1;
+
+/**
+ * \brief Uniform buffer bound to a binding point, shared by all the programs binding one of their blocks there
+ */
+class UniformBuffer
+{
+public:
+    void Create(GLsizeiptr size, GLuint bindingPoint);
+    void SetData(const void* data, GLsizeiptr size, GLintptr offset = 0) const;
+    template<typename T>
+    void SetData(const T& data) const
+    {
+        SetData(&data, sizeof(T));
+    }
+    void Destroy();
+    [[nodiscard]] bool IsCreated() const { return ubo_ != 0; }
+    [[nodiscard]] GLuint GetBindingPoint() const { return bindingPoint_; }
+private:
+    GLuint ubo_ = 0;
+    GLuint bindingPoint_ = 0;
+};
+
+/**
+ * \brief Per frame camera data, to be declared in the shaders as a std140 uniform block:
+ * layout (std140) uniform Camera { mat4 view; mat4 projection; vec4 viewPos; };
+ */
+struct CameraUniformData
+{
+    Mat4f view;
+    Mat4f projection;
+    Vec4f viewPos;
+};
+static_assert(sizeof(CameraUniformData) == 2 * 16 * sizeof(float) + 4 * sizeof(float), "Camera block is not std140");
+const std::string_view CAMERA_UNIFORM_BLOCK_NAME = "Camera";
+const GLuint CAMERA_UNIFORM_BLOCK_BINDING = 0;
+
+/**
+ * \brief Upload the camera to the uniform buffer at CAMERA_UNIFORM_BLOCK_BINDING, read by all the programs binding
+ * their Camera block there. Called on the render thread before drawing, skipped when the camera did not change.
+ */
+void SetCameraUniforms(const Camera& camera);
+
 class Shader : public neko::Shader
 {
 public:
@@ -66,32 +145,48 @@ public:
 
     GLuint GetProgram() const;
 
-    void SetBool(const std::string_view attributeName, bool value) const;
+    void SetBool(UniformHandle uniform, bool value) const;
 
-    void SetInt(const std::string_view attributeName, int value) const;
+    void SetInt(UniformHandle uniform, int value) const;
 
-    void SetFloat(const std::string_view attributeName, float value) const;
+    void SetFloat(UniformHandle uniform, float value) const;
 
-    void SetVec2(const std::string_view name, float x, float y) const;
+    void SetVec2(UniformHandle uniform, float x, float y) const;
 
-    void SetVec2(const std::string_view name, const Vec2f& value) const;
+    void SetVec2(UniformHandle uniform, const Vec2f& value) const;
 
-    void SetVec3(const std::string_view name, float x, float y, float z) const;
+    void SetVec3(UniformHandle uniform, float x, float y, float z) const;
 
-    void SetVec3(const std::string_view name, const Vec3f& value) const;
+    void SetVec3(UniformHandle uniform, const Vec3f& value) const;
 
-    void SetVec3(const std::string_view name, const float* value) const;
+    void SetVec3(UniformHandle uniform, const float* value) const;
 
-    void SetVec4(const std::string_view name, float x, float y, float z, float w);
+    void SetVec4(UniformHandle uniform, float x, float y, float z, float w);
 
     
-    void SetVec4(const std::string_view name, const Vec4f& value) const;
-
-    void SetMat4(const std::string_view name, const Mat4f& mat) const;
+    void SetVec4(UniformHandle uniform, const Vec4f& value) const;
+
+    void SetMat4(UniformHandle uniform, const Mat4f& mat) const;
+
+	void SetTexture(UniformHandle uniform, TextureName texture, unsigned int slot = 0) const;
+	void SetCubemap(UniformHandle uniform, TextureName texture, unsigned int slot = 0) const;
+
+    /**
+     * \brief Location from the uniforms reflected at link time, no driver call
+     */
+    [[nodiscard]] GLint GetUniformLocation(UniformHandle uniform) const;
+    /**
+     * \brief Bind the uniform block of this program to the binding point of a UniformBuffer
+     */
+    void BindUniformBlock(std::string_view blockName, GLuint bindingPoint) const;
+protected:
+    /**
+     * \brief Fill the uniform locations table with the active uniforms of the linked program
+     */
+    void ReflectUniforms();
 
-	void SetTexture(const std::string_view name, TextureName texture, unsigned int slot = 0) const;
-	void SetCubemap(const std::string_view name, TextureName texture, unsigned int slot = 0) const;
-private:
     GLuint shaderProgram_ = 0;
+private:
+    std::unordered_map<UniformHash, GLint> uniformLocations_;
 };
 }
\ No newline at end of file
@@ -23,9 +23,11 @@
  SOFTWARE.
  */
 
+#include <vector>
+
 #include "graphics/sprite.h"
+#include "gl/gles3_include.h"
 #include "gl/shader.h"
-#include "gl/shape.h"
 
 
 namespace neko::gl
@@ -41,7 +43,18 @@ public:
     void Render() override;
 	
 private:
+    /**
+     * \brief Copy the newly packed textures into their atlas on the GPU
+     */
+    void CopyToAtlases();
+    void ReserveSprites(std::size_t spritesNmb);
+
     gl::Shader spriteShader_;
-    gl::RenderQuad spriteQuad_{Vec3f::zero, Vec2f::one};
+    GLuint vao_ = 0;
+    GLuint vbo_ = 0;
+    GLuint ebo_ = 0;
+    std::size_t spritesCapacity_ = 0;
+    GLuint copyFramebuffer_ = 0;
+    std::vector<TextureName> atlasTextures_;
 };
 }
@@ -0,0 +1,83 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include <cstddef>
+#include "gl/gles3_include.h"
+
+namespace neko::gl
+{
+/**
+ * \brief Number of GL calls that went to the driver and that were skipped by the state cache
+ */
+struct StateCacheStats
+{
+    std::size_t issuedCalls = 0;
+    std::size_t filteredCalls = 0;
+};
+
+/*
+ * Wrappers of the state changing GL calls, they skip the call when the state is already set.
+ * The shadow state is thread local, as the GL context is only current on the render thread.
+ * Every bind of the cached states should go through these functions, code changing them behind
+ * the cache (external libraries) needs to call InvalidateStateCache afterwards.
+ */
+void UseProgram(GLuint program);
+void BindVertexArray(GLuint vertexArray);
+/**
+ * \brief Only GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached, the other targets are always issued
+ */
+void BindBuffer(GLenum target, GLuint buffer);
+void ActiveTexture(GLenum textureUnit);
+/**
+ * \brief Only GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP are cached, on the current active texture unit
+ */
+void BindTexture(GLenum target, GLuint texture);
+void BindFramebuffer(GLenum target, GLuint framebuffer);
+/**
+ * \brief GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_STENCIL_TEST and GL_SCISSOR_TEST are cached
+ */
+void Enable(GLenum capability);
+void Disable(GLenum capability);
+void BlendFunc(GLenum sourceFactor, GLenum destinationFactor);
+void DepthFunc(GLenum func);
+void DepthMask(GLboolean flag);
+void CullFace(GLenum mode);
+
+/*
+ * Deleting a bound object unbinds it, the cache forgets it so that a new object with the same name
+ * is bound again.
+ */
+void DeleteProgram(GLuint program);
+void DeleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
+void DeleteBuffers(GLsizei n, const GLuint* buffers);
+void DeleteTextures(GLsizei n, const GLuint* textures);
+void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+
+/**
+ * \brief Forget the whole shadow state, the next calls are all issued
+ */
+void InvalidateStateCache();
+[[nodiscard]] StateCacheStats GetStateCacheStats();
+void ResetStateCacheStats();
+}
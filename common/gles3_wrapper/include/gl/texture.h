@@ -37,6 +37,10 @@ public:
 	void Destroy() override;
 protected:
 	void CreateTexture() override;
+	/**
+	 * \brief Upload the mip chain read from the texture cache instead of generating it on the GPU
+	 */
+	void CreateCachedTexture();
 
 };
 
@@ -25,6 +25,8 @@
 #include "gl/font.h"
 #include "mathematics/transform.h"
 #include "engine/engine.h"
+#include "gl/state_cache.h"
+
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
 #endif
@@ -41,13 +43,13 @@ void FontManager::Init()
     // -----------------------------------
     glGenVertexArrays(1, &textureQuad_.VAO);
     glGenBuffers(1, &textureQuad_.VBO[0]);
-    glBindVertexArray(textureQuad_.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
+    gl::BindVertexArray(textureQuad_.VAO);
+    gl::BindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    gl::BindBuffer(GL_ARRAY_BUFFER, 0);
+    gl::BindVertexArray(0);
 }
 
 FontId FontManager::LoadFont(std::string_view fontName, int pixelHeight)
@@ -117,7 +119,7 @@ FontId FontManager::LoadFont(std::string_view fontName, int pixelHeight)
         // generate texture
         unsigned int texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        gl::BindTexture(GL_TEXTURE_2D, texture);
         glTexImage2D(
                 GL_TEXTURE_2D,
                 0,
@@ -144,7 +146,7 @@ FontId FontManager::LoadFont(std::string_view fontName, int pixelHeight)
         };
         characters[c] = character;
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl::BindTexture(GL_TEXTURE_2D, 0);
     // destroy FreeType once we're finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
@@ -166,11 +168,11 @@ void FontManager::Destroy()
     {
         for(auto& character : font.second.characters)
         {
-            glDeleteTextures(1, &character.textureID);
+            gl::DeleteTextures(1, &character.textureID);
         }
     }
     fonts_.clear();
-    glDeleteVertexArrays(1, &textureQuad_.VAO);
+    gl::DeleteVertexArrays(1, &textureQuad_.VAO);
 }
 
 void FontManager::Render()
@@ -189,8 +191,8 @@ void FontManager::Render()
         // activate corresponding render state
 
         textShader_.SetVec4("textColor", command.color);
-        glActiveTexture(GL_TEXTURE0);
-        glBindVertexArray(textureQuad_.VAO);
+        gl::ActiveTexture(GL_TEXTURE0);
+        gl::BindVertexArray(textureQuad_.VAO);
 
         Vec2f textPosition = CalculateTextPosition(command.position, command.anchor);
         float x = textPosition.x;
@@ -216,19 +218,19 @@ void FontManager::Render()
                     { xpos + w, ypos + h,   1.0f, 0.0f }
             };
             // render glyph texture over quad
-            glBindTexture(GL_TEXTURE_2D, ch.textureID);
+            gl::BindTexture(GL_TEXTURE_2D, ch.textureID);
             // update content of VBO memory
-            glBindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
+            gl::BindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
             glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // be sure to use glBufferSubData and not glBufferData
 
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            gl::BindBuffer(GL_ARRAY_BUFFER, 0);
             // render quad
             glDrawArrays(GL_TRIANGLES, 0, 6);
             // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
             x += (ch.advance >> 6) * command.scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
         }
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl::BindVertexArray(0);
+        gl::BindTexture(GL_TEXTURE_2D, 0);
     }
     commands_.clear();
 }
@@ -240,7 +242,7 @@ void FontManager::DestroyFont(FontId font)
         return;
     for(auto& character : it->second.characters)
     {
-        glDeleteTextures(1, &character.textureID);
+        gl::DeleteTextures(1, &character.textureID);
     }
     fonts_.erase(font);
 }
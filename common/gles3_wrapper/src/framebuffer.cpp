@@ -23,6 +23,7 @@
  */
 
 #include "gl/framebuffer.h"
+#include "gl/state_cache.h"
 
 namespace neko::gl
 {
@@ -44,7 +45,7 @@ void Framebuffer::Create()
     if(frameBufferType_ & DEPTH_ATTACHMENT)
     {
         glGenTextures(1, &depthBuffer_);
-        glBindTexture(GL_TEXTURE_2D, depthBuffer_);
+        gl::BindTexture(GL_TEXTURE_2D, depthBuffer_);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16,
             size_.x, size_.y, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -56,7 +57,7 @@ void Framebuffer::Create()
         GLenum drawBuffers = GL_NONE;
         glDrawBuffers(1, &drawBuffers);
         glReadBuffer(GL_NONE);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl::BindTexture(GL_TEXTURE_2D, 0);
         glCheckError();
     }
     else if(frameBufferType_ & DEPTH_RBO)
@@ -78,12 +79,12 @@ void Framebuffer::Create()
     else if(frameBufferType_ & COLOR_ATTACHMENT_0)
     {
         glGenTextures(1, &colorBuffer_);
-        glBindTexture(GL_TEXTURE_2D, colorBuffer_);
+        gl::BindTexture(GL_TEXTURE_2D, colorBuffer_);
         glTexImage2D(GL_TEXTURE_2D, 0, frameBufferType_ & HDR ? GL_RGB16F : GL_RGB8, size_.x, size_.y, 0, GL_RGB,
             frameBufferType_ & HDR ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl::BindTexture(GL_TEXTURE_2D, 0);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorBuffer_, 0);
         glCheckError();
     }
@@ -104,11 +105,11 @@ void Framebuffer::Reload()
 void Framebuffer::Destroy()
 {
     if (fbo_)
-        glDeleteFramebuffers(1, &fbo_);
+        gl::DeleteFramebuffers(1, &fbo_);
     if (colorBuffer_)
-        glDeleteTextures(1, &colorBuffer_);
+        gl::DeleteTextures(1, &colorBuffer_);
     if (depthBuffer_)
-        glDeleteTextures(1, &depthBuffer_);
+        gl::DeleteTextures(1, &depthBuffer_);
     if (depthRbo_)
         glDeleteRenderbuffers(1, &depthRbo_);
     fbo_ = 0;
@@ -119,7 +120,7 @@ void Framebuffer::Destroy()
 
 void Framebuffer::Bind() const
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
     currentFramebufferBind_ = fbo_;
 }
 
@@ -131,7 +132,7 @@ void Framebuffer::Clear(const Color3& color)
 
 void Framebuffer::Unbind()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     currentFramebufferBind_ = 0;
 }
 
@@ -29,6 +29,8 @@
 #include "engine/log.h"
 
 #include <fmt/format.h>
+#include "gl/state_cache.h"
+#include "imgui.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -104,19 +106,44 @@ void Gles3Renderer::ClearScreen()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Clear Screen");
 #endif
+    //Start of the render frame, the counters of the previous one are kept for the ImGui window
+    lastFrameStateCacheStats_ = GetStateCacheStats();
+    ResetStateCacheStats();
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
+void Gles3Renderer::DrawImGui()
+{
+    const auto& stats = lastFrameStateCacheStats_;
+    const auto totalCalls = stats.issuedCalls + stats.filteredCalls;
+    ImGui::Text("GL state calls issued: %zu filtered: %zu (%.1f%%)",
+                stats.issuedCalls, stats.filteredCalls,
+                totalCalls == 0 ? 0.0 : 100.0 * double(stats.filteredCalls) / double(totalCalls));
+}
+
 
 void Gles3Renderer::BeforeRenderLoop()
 {
     Renderer::BeforeRenderLoop();
-    glEnable(GL_DEPTH_TEST);
+    //The context was just made current on the render thread
+    InvalidateStateCache();
+    gl::Enable(GL_DEPTH_TEST);
 }
 
 void Gles3Renderer::AfterRenderLoop()
 {
     Renderer::AfterRenderLoop();
 }
+
+void Gles3Renderer::BindShader(std::uint32_t shader)
+{
+    gl::UseProgram(shader);
+}
+
+void Gles3Renderer::BindTexture(std::uint32_t texture)
+{
+    gl::ActiveTexture(GL_TEXTURE0);
+    gl::BindTexture(GL_TEXTURE_2D, texture);
+}
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "gl/instancing.h"
+
+#include <algorithm>
+
+#include "engine/assert.h"
+#include "gl/state_cache.h"
+#include "graphics/camera.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko::gl
+{
+static_assert(sizeof(Mat4f) == 4 * sizeof(Vec4f), "Model matrices are uploaded as 4 packed vec4 attributes");
+
+InstancedBatchId InstancedBatchRenderer::AddBatch(const InstancedMesh& mesh, const Shader& shader,
+                                                  std::uint32_t materialId, BindMaterialFunc bindMaterial)
+{
+    return AddBatch(std::vector<InstancedMesh>{mesh}, shader, materialId, std::move(bindMaterial));
+}
+
+InstancedBatchId InstancedBatchRenderer::AddBatch(const std::vector<InstancedMesh>& meshes, const Shader& shader,
+                                                  std::uint32_t materialId, BindMaterialFunc bindMaterial)
+{
+    neko_assert(!meshes.empty(), "Instanced batch without mesh");
+    const InstancedBatchId batchId = GetBatch({meshes.front().vao, shader.GetProgram(), materialId});
+    if (batchId >= drawInfos_.size())
+    {
+        drawInfos_.resize(batchId + 1);
+    }
+    //Adding an existing batch again replaces its draw info, e.g. a new material binding
+    drawInfos_[batchId] = {meshes, &shader, std::move(bindMaterial)};
+    drawInfosDirty_ = true;
+    return batchId;
+}
+
+std::size_t InstancedBatchRenderer::GetDrawCallsNmb() const
+{
+    std::size_t drawCallsNmb = 0;
+    for (std::size_t i = 0; i < drawInfos_.size(); i++)
+    {
+        if (GetInstancesNmb(InstancedBatchId(i)) > 0)
+        {
+            drawCallsNmb += drawInfos_[i].meshes.size();
+        }
+    }
+    return drawCallsNmb;
+}
+
+void InstancedBatchRenderer::Init()
+{
+    neko::InstancedBatchRenderer::Init();
+    glGenBuffers(GLsizei(instanceVbos_.size()), instanceVbos_.data());
+    instanceVboSizes_.fill(0);
+}
+
+void InstancedBatchRenderer::SyncBuffers()
+{
+    neko::InstancedBatchRenderer::SyncBuffers();
+    if (drawInfosDirty_)
+    {
+        renderDrawInfos_ = drawInfos_;
+        drawInfosDirty_ = false;
+    }
+}
+
+void InstancedBatchRenderer::Render()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Render Instanced Batches");
+#endif
+    //The batches are laid out one after the other in the same instance buffer
+    batchOffsets_.resize(renderDrawInfos_.size());
+    GLsizeiptr totalSize = 0;
+    for (std::size_t i = 0; i < renderDrawInfos_.size(); i++)
+    {
+        batchOffsets_[i] = totalSize;
+        totalSize += GLsizeiptr(renderBatches_[i].size() * sizeof(Mat4f));
+    }
+    if (totalSize == 0)
+        return;
+
+    currentInstanceVbo_ = (currentInstanceVbo_ + 1) % instanceVbos_.size();
+    const GLuint instanceVbo = instanceVbos_[currentInstanceVbo_];
+    auto& instanceVboSize = instanceVboSizes_[currentInstanceVbo_];
+    instanceVboSize = std::max(totalSize, instanceVboSize);
+    gl::BindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    //Orphan the storage still used by the draws of the previous frames instead of waiting for them
+    glBufferData(GL_ARRAY_BUFFER, instanceVboSize, nullptr, GL_STREAM_DRAW);
+    auto* instances = static_cast<Mat4f*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    if (instances == nullptr)
+    {
+        logDebug("[Error] Could not map the instance buffer");
+        return;
+    }
+    for (std::size_t i = 0; i < renderDrawInfos_.size(); i++)
+    {
+        CopyInstanceTransforms(InstancedBatchId(i), instances + batchOffsets_[i] / sizeof(Mat4f));
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glCheckError();
+
+    SetCameraUniforms(CameraLocator::get());
+    for (std::size_t i = 0; i < renderDrawInfos_.size(); i++)
+    {
+        const auto instancesNmb = GLsizei(renderBatches_[i].size());
+        auto& drawInfo = renderDrawInfos_[i];
+        if (instancesNmb == 0 || drawInfo.shader == nullptr)
+            continue;
+        const auto& shader = *drawInfo.shader;
+        if (!drawInfo.isCameraBlockBound)
+        {
+            shader.BindUniformBlock(CAMERA_UNIFORM_BLOCK_NAME, CAMERA_UNIFORM_BLOCK_BINDING);
+            drawInfo.isCameraBlockBound = true;
+        }
+        shader.Bind();
+        if (drawInfo.bindMaterial)
+        {
+            drawInfo.bindMaterial(shader);
+        }
+        for (const auto& mesh : drawInfo.meshes)
+        {
+            if (mesh.bindMaterial)
+            {
+                mesh.bindMaterial(shader);
+            }
+            gl::BindVertexArray(mesh.vao);
+            gl::BindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+            for (GLuint column = 0; column < 4; column++)
+            {
+                const GLuint location = INSTANCE_MODEL_LOCATION + column;
+                glEnableVertexAttribArray(location);
+                glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4f),
+                                      reinterpret_cast<void*>(batchOffsets_[i] + column * sizeof(Vec4f)));
+                glVertexAttribDivisor(location, 1);
+            }
+            glDrawElementsInstanced(mesh.mode, mesh.elementsCount, GL_UNSIGNED_INT, nullptr, instancesNmb);
+            //The mesh VAO can still be drawn without instancing
+            for (GLuint column = 0; column < 4; column++)
+            {
+                glDisableVertexAttribArray(INSTANCE_MODEL_LOCATION + column);
+            }
+            glCheckError();
+        }
+    }
+    gl::BindVertexArray(0);
+}
+
+void InstancedBatchRenderer::Destroy()
+{
+    gl::DeleteBuffers(GLsizei(instanceVbos_.size()), instanceVbos_.data());
+    instanceVbos_.fill(0);
+    drawInfos_.clear();
+    renderDrawInfos_.clear();
+    drawInfosDirty_ = false;
+    neko::InstancedBatchRenderer::Destroy();
+}
+}
@@ -42,8 +42,9 @@ Material::Material(TextureManager& textureManager) :
 
 void Material::LoadFromFile(std::string_view path)
 {
-    BasicEngine::GetInstance()->ScheduleJob(&loadMaterialJsonJob_, JobThreadType::RESOURCE_THREAD);
+    //Linked before the read is submitted, the I/O service can complete it right away
     loadingMaterialContentJob_.AddDependency(&loadMaterialJsonJob_);
+    BasicEngine::GetInstance()->ScheduleResourceJob(&loadMaterialJsonJob_);
     BasicEngine::GetInstance()->ScheduleJob(&loadingMaterialContentJob_, JobThreadType::OTHER_THREAD);
 }
 
@@ -173,7 +174,7 @@ UniformId Material::GetUniformId(std::string_view uniformName)
         return it->second;
     }
 
-    UniformId uniformId = glGetUniformLocation(shader_.GetProgram(), uniformName.data());
+    UniformId uniformId = shader_.GetUniformLocation(uniformName);
     if (uniformId != INVALID_UNIFORM_ID)
     {
         uniformsMap_[uniformName.data()] = uniformId;
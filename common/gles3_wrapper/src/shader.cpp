@@ -23,11 +23,20 @@
  */
 #include "gl/shader.h"
 #include <utilities/file_utility.h>
+#include <cstring>
 #include <sstream>
 #include <engine/log.h>
 #include <fmt/format.h>
+#include "gl/state_cache.h"
+#include "graphics/camera.h"
 namespace neko::gl
 {
+namespace
+{
+//Render thread only, freed with the GL context
+UniformBuffer cameraUniformBuffer;
+CameraUniformData lastCameraData;
+}
 
 void Shader::LoadFromFile(const std::string_view vertexShaderPath, const std::string_view fragmentShaderPath)
 {
@@ -59,13 +68,17 @@ void Shader::LoadFromFile(const std::string_view vertexShaderPath, const std::st
         logDebug(fmt::format("[Error] Loading shader program with vertex: {} and fragment {}",
                              vertexShaderPath, fragmentShaderPath));
     }
+    else
+    {
+        ReflectUniforms();
+    }
     DeleteShader(vertexShader);
     DeleteShader(fragmentShader);
 }
 
 void Shader::Bind() const
 {
-    glUseProgram(shaderProgram_);
+    gl::UseProgram(shaderProgram_);
 }
 
 GLuint Shader::GetProgram() const
@@ -74,66 +87,66 @@ GLuint Shader::GetProgram() const
 }
 
 
-void Shader::SetBool(const std::string_view attributeName, bool value) const
+void Shader::SetBool(UniformHandle uniform, bool value) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, attributeName.data()), (int) value);
+    glUniform1i(GetUniformLocation(uniform), (int) value);
     glCheckError();
 }
 
-void Shader::SetInt(const std::string_view attributeName, int value) const
+void Shader::SetInt(UniformHandle uniform, int value) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, attributeName.data()), value);
+    glUniform1i(GetUniformLocation(uniform), value);
     glCheckError();
 }
 
-void Shader::SetFloat(const std::string_view attributeName, float value) const
+void Shader::SetFloat(UniformHandle uniform, float value) const
 {
-    glUniform1f(glGetUniformLocation(shaderProgram_, attributeName.data()), value);
+    glUniform1f(GetUniformLocation(uniform), value);
     glCheckError();
 }
 
 // ------------------------------------------------------------------------
-void Shader::SetVec2(const std::string_view name, const Vec2f& value) const
+void Shader::SetVec2(UniformHandle uniform, const Vec2f& value) const
 {
-    glUniform2fv(glGetUniformLocation(shaderProgram_, name.data()), 1, &value[0]);
+    glUniform2fv(GetUniformLocation(uniform), 1, &value[0]);
     glCheckError();
 }
 
-void Shader::SetVec2(const std::string_view name, float x, float y) const
+void Shader::SetVec2(UniformHandle uniform, float x, float y) const
 {
-    glUniform2f(glGetUniformLocation(shaderProgram_, name.data()), x, y);
+    glUniform2f(GetUniformLocation(uniform), x, y);
     glCheckError();
 }
 
 // ------------------------------------------------------------------------
-void Shader::SetVec3(const std::string_view name, const Vec3f& value) const
+void Shader::SetVec3(UniformHandle uniform, const Vec3f& value) const
 {
-    glUniform3fv(glGetUniformLocation(shaderProgram_, name.data()), 1, &value[0]);
+    glUniform3fv(GetUniformLocation(uniform), 1, &value[0]);
     glCheckError();
 }
 
-void Shader::SetVec3(const std::string_view name, const float* value) const
+void Shader::SetVec3(UniformHandle uniform, const float* value) const
 {
-    glUniform3fv(glGetUniformLocation(shaderProgram_, name.data()), 1, value);
+    glUniform3fv(GetUniformLocation(uniform), 1, value);
     glCheckError();
 }
 
-void Shader::SetVec3(const std::string_view name, float x, float y, float z) const
+void Shader::SetVec3(UniformHandle uniform, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(shaderProgram_, name.data()), x, y, z);
+    glUniform3f(GetUniformLocation(uniform), x, y, z);
     glCheckError();
 }
 
 // ------------------------------------------------------------------------
-void Shader::SetVec4(const std::string_view name, const Vec4f& value) const
+void Shader::SetVec4(UniformHandle uniform, const Vec4f& value) const
 {
-    glUniform4fv(glGetUniformLocation(shaderProgram_, name.data()), 1, &value[0]);
+    glUniform4fv(GetUniformLocation(uniform), 1, &value[0]);
     glCheckError();
 }
 
-void Shader::SetVec4(const std::string_view name, float x, float y, float z, float w)
+void Shader::SetVec4(UniformHandle uniform, float x, float y, float z, float w)
 {
-    glUniform4f(glGetUniformLocation(shaderProgram_, name.data()), x, y, z, w);
+    glUniform4f(GetUniformLocation(uniform), x, y, z, w);
     glCheckError();
 }
 
@@ -141,9 +154,10 @@ void Shader::Destroy()
 {
     if(shaderProgram_ != 0)
     {
-        glDeleteProgram(shaderProgram_);
+        gl::DeleteProgram(shaderProgram_);
         shaderProgram_ = 0;
     }
+    uniformLocations_.clear();
 }
 
 /*
@@ -160,26 +174,136 @@ void Shader::SetMat3(const std::string& name, const glm::mat3& mat) const
 }
 */
 // ------------------------------------------------------------------------
-void Shader::SetMat4(const std::string_view name, const Mat4f& mat) const
+void Shader::SetMat4(UniformHandle uniform, const Mat4f& mat) const
+{
+    glUniformMatrix4fv(GetUniformLocation(uniform), 1, GL_FALSE, &mat[0][0]);
+    glCheckError();
+}
+
+
+void Shader::SetTexture(UniformHandle uniform, TextureName texture, unsigned slot) const
+{
+    glUniform1i(GetUniformLocation(uniform), slot);
+    gl::ActiveTexture(GL_TEXTURE0 + slot);
+    gl::BindTexture(GL_TEXTURE_2D, texture);
+}
+
+
+void Shader::SetCubemap(UniformHandle uniform, TextureName texture, unsigned slot) const
+{
+    glUniform1i(GetUniformLocation(uniform), slot);
+    gl::ActiveTexture(GL_TEXTURE0 + slot);
+    gl::BindTexture(GL_TEXTURE_CUBE_MAP, texture);
+}
+
+GLint Shader::GetUniformLocation(UniformHandle uniform) const
+{
+    const auto it = uniformLocations_.find(uniform.hash);
+    return it == uniformLocations_.end() ? INVALID_UNIFORM_LOCATION : it->second;
+}
+
+void Shader::BindUniformBlock(std::string_view blockName, GLuint bindingPoint) const
+{
+    const GLuint blockIndex = glGetUniformBlockIndex(shaderProgram_, blockName.data());
+    if (blockIndex == GL_INVALID_INDEX)
+    {
+        logDebug(fmt::format("[Warning] Uniform block {} not found in shader program", blockName));
+        return;
+    }
+    glUniformBlockBinding(shaderProgram_, blockIndex, bindingPoint);
+    glCheckError();
+}
+
+void Shader::ReflectUniforms()
 {
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram_, name.data()), 1, GL_FALSE, &mat[0][0]);
+    uniformLocations_.clear();
+    GLint uniformsNmb = 0;
+    glGetProgramiv(shaderProgram_, GL_ACTIVE_UNIFORMS, &uniformsNmb);
+    GLint maxNameLength = 0;
+    glGetProgramiv(shaderProgram_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::string name(maxNameLength, '\0');
+    const auto addUniform = [this](const std::string& uniformName, GLint location)
+    {
+        const auto hash = HashUniformName(uniformName);
+        const auto it = uniformLocations_.find(hash);
+        if (it != uniformLocations_.end() && it->second != location)
+        {
+            logDebug(fmt::format("[Error] Uniform name {} hash collision in shader program", uniformName));
+        }
+        uniformLocations_[hash] = location;
+    };
+    for (GLint i = 0; i < uniformsNmb; i++)
+    {
+        GLsizei nameLength = 0;
+        GLint arraySize = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shaderProgram_, i, maxNameLength, &nameLength, &arraySize, &type, name.data());
+        const std::string uniformName(name.data(), nameLength);
+        const GLint location = glGetUniformLocation(shaderProgram_, uniformName.c_str());
+        //Uniforms in blocks have no location
+        if (location == INVALID_UNIFORM_LOCATION)
+        {
+            continue;
+        }
+        addUniform(uniformName, location);
+        //Arrays are reported as "name[0]", they can be set with and without the index
+        const auto arrayPos = uniformName.rfind("[0]");
+        if (arrayPos != std::string::npos && arrayPos + 3 == uniformName.size())
+        {
+            const std::string baseName = uniformName.substr(0, arrayPos);
+            addUniform(baseName, location);
+            for (GLint element = 1; element < arraySize; element++)
+            {
+                const std::string elementName = fmt::format("{}[{}]", baseName, element);
+                addUniform(elementName, glGetUniformLocation(shaderProgram_, elementName.c_str()));
+            }
+        }
+    }
     glCheckError();
 }
 
+void UniformBuffer::Create(GLsizeiptr size, GLuint bindingPoint)
+{
+    bindingPoint_ = bindingPoint;
+    glGenBuffers(1, &ubo_);
+    gl::BindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint_, ubo_);
+    glCheckError();
+}
 
-void Shader::SetTexture(const std::string_view name, TextureName texture, unsigned slot) const
+void UniformBuffer::SetData(const void* data, GLsizeiptr size, GLintptr offset) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, name.data()), slot);
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl::BindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    glCheckError();
 }
 
+void UniformBuffer::Destroy()
+{
+    if (ubo_ != 0)
+    {
+        gl::DeleteBuffers(1, &ubo_);
+        ubo_ = 0;
+    }
+}
 
-void Shader::SetCubemap(const std::string_view name, TextureName texture, unsigned slot) const
+void SetCameraUniforms(const Camera& camera)
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, name.data()), slot);
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    CameraUniformData cameraData;
+    cameraData.view = camera.GenerateViewMatrix();
+    cameraData.projection = camera.GenerateProjectionMatrix();
+    cameraData.viewPos = Vec4f(camera.position, 1.0f);
+    if (!cameraUniformBuffer.IsCreated())
+    {
+        cameraUniformBuffer.Create(sizeof(CameraUniformData), CAMERA_UNIFORM_BLOCK_BINDING);
+    }
+    else if (std::memcmp(&cameraData, &lastCameraData, sizeof(CameraUniformData)) == 0)
+    {
+        return;
+    }
+    cameraUniformBuffer.SetData(cameraData);
+    lastCameraData = cameraData;
 }
 
 Shader::~Shader()
@@ -25,6 +25,7 @@
 #include <gl/shape.h>
 #include <mathematics/trigo.h>
 #include "gl/gles3_include.h"
+#include "gl/state_cache.h"
 
 namespace neko::gl
 {
@@ -79,45 +80,45 @@ void RenderQuad::Init()
 	glGenBuffers(1, &EBO);
 	glGenVertexArrays(1, &VAO);
 	// 1. bind Vertex Array Object
-	glBindVertexArray(VAO);
+	gl::BindVertexArray(VAO);
 	// 2. copy our vertices array in a buffer for OpenGL to use
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[0]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2f), (void*)0);
 	glEnableVertexAttribArray(0);
 	//bind texture coords data
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[1]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[1]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords, GL_STATIC_DRAW);
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
 	glEnableVertexAttribArray(1);
 	// bind normals data
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[2]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[2]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(normals), normals, GL_STATIC_DRAW);
 	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3f), (void*)0);
 	glEnableVertexAttribArray(2);
 	// bind tangent data
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[3]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[3]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(tangent), &tangent[0], GL_STATIC_DRAW);
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3f), (void*)0);
 	glEnableVertexAttribArray(3);
 	//bind EBO
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	glBindVertexArray(0);
+	gl::BindVertexArray(0);
 	glCheckError();
 }
 
 void RenderQuad::Draw() const
 {
-	glBindVertexArray(VAO);
+	gl::BindVertexArray(VAO);
 	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
 
 void RenderQuad::Destroy()
 {
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(4, &VBO[0]);
-	glDeleteBuffers(1, &EBO);
+	gl::DeleteVertexArrays(1, &VAO);
+	gl::DeleteBuffers(4, &VBO[0]);
+	gl::DeleteBuffers(1, &EBO);
 
 }
 
@@ -276,43 +277,43 @@ void RenderCuboid::Init()
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(4, &VBO[0]);
 
-	glBindVertexArray(VAO);
+	gl::BindVertexArray(VAO);
 	// position attribute
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[0]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(position), position, GL_STATIC_DRAW);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
 	glEnableVertexAttribArray(0);
 	// texture coord attribute
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[1]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[1]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords, GL_STATIC_DRAW);
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
 	glEnableVertexAttribArray(1);
 	// normal attribute
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[2]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[2]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(normals), normals, GL_STATIC_DRAW);
 	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
 	glEnableVertexAttribArray(2);
 	//tangent attribute
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[3]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[3]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(tangent), tangent, GL_STATIC_DRAW);
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
 	glEnableVertexAttribArray(3);
 
-	glBindVertexArray(0);
+	gl::BindVertexArray(0);
 	glCheckError();
 }
 
 void RenderCuboid::Draw() const
 {
-	glBindVertexArray(VAO);
+	gl::BindVertexArray(VAO);
 	glDrawArrays(GL_TRIANGLES, 0, 36);
 }
 
 void RenderCuboid::Destroy()
 {
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(4, &VBO[0]);
-	//glDeleteBuffers(2, &EBO);
+	gl::DeleteVertexArrays(1, &VAO);
+	gl::DeleteBuffers(4, &VBO[0]);
+	//gl::DeleteBuffers(2, &EBO);
 }
 
 RenderSphere::RenderSphere(Vec3f offset, float radius, size_t segment) : neko::RenderSphere(offset, radius), segment_(segment)
@@ -414,10 +415,10 @@ void RenderSphere::Init()
 			data.push_back(tangent[i].z);
 		}
 	}
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
+	gl::BindVertexArray(VAO);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[0]);
 	glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
 	const auto stride = (3 + 2 + 3 + 3) * sizeof(float);
 	glEnableVertexAttribArray(0);
@@ -428,21 +429,21 @@ void RenderSphere::Init()
 	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(5 * sizeof(float)));
 	glEnableVertexAttribArray(3);
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(8 * sizeof(float)));
-	glBindVertexArray(0);
+	gl::BindVertexArray(0);
 	glCheckError();
 }
 
 void RenderSphere::Draw() const
 {
-	glBindVertexArray(VAO);
+	gl::BindVertexArray(VAO);
 	glDrawElements(GL_TRIANGLE_STRIP, indexCount_, GL_UNSIGNED_INT, 0);
 }
 
 void RenderSphere::Destroy()
 {
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO[0]);
-	glDeleteBuffers(1, &EBO);
+	gl::DeleteVertexArrays(1, &VAO);
+	gl::DeleteBuffers(1, &VBO[0]);
+	gl::DeleteBuffers(1, &EBO);
 }
 
 void RenderCircle::Init()
@@ -470,29 +471,29 @@ void RenderCircle::Init()
 	glGenBuffers(1, &EBO);
 	glGenVertexArrays(1, &VAO);
 	// 1. bind Vertex Array Object
-	glBindVertexArray(VAO);
+	gl::BindVertexArray(VAO);
 	// 2. copy our vertices array in a buffer for OpenGL to use
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[0]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2f), (void*) nullptr);
 	glEnableVertexAttribArray(0);
 	//bind texture coords data
-	glBindBuffer(GL_ARRAY_BUFFER, VBO[1]);
+	gl::BindBuffer(GL_ARRAY_BUFFER, VBO[1]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords, GL_STATIC_DRAW);
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2f), (void*) nullptr);
-	glBindVertexArray(0);
+	gl::BindVertexArray(0);
 	glCheckError();
 }
 
 void RenderCircle::Draw() const
 {
-	glBindVertexArray(VAO);
+	gl::BindVertexArray(VAO);
 	glDrawArrays(GL_TRIANGLE_FAN, 0, resolution + 2);
 }
 
 void RenderCircle::Destroy()
 {
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(2, &VBO[0]);
+	gl::DeleteVertexArrays(1, &VAO);
+	gl::DeleteBuffers(2, &VBO[0]);
 }
 }
\ No newline at end of file
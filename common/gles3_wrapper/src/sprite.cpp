@@ -28,6 +28,7 @@
 #include "engine/transform.h"
 #include "graphics/camera.h"
 #include "engine/engine.h"
+#include "gl/state_cache.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -40,9 +41,29 @@ namespace neko::gl
 void SpriteManager::Init()
 {
     const auto& config = BasicEngine::GetInstance()->config;
-    spriteShader_.LoadFromFile(config.dataRootPath + "shaders/engine/sprite.vert",
-        config.dataRootPath + "shaders/engine/sprite.frag");
-    spriteQuad_.Init();
+    spriteShader_.LoadFromFile(config.dataRootPath + "shaders/engine/sprite_batch.vert",
+        config.dataRootPath + "shaders/engine/sprite_batch.frag");
+    spriteShader_.BindUniformBlock(CAMERA_UNIFORM_BLOCK_NAME, CAMERA_UNIFORM_BLOCK_BINDING);
+    static constexpr UniformHandle spriteTextureUniform("spriteTexture");
+    spriteShader_.Bind();
+    spriteShader_.SetInt(spriteTextureUniform, 0);
+
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &ebo_);
+    gl::BindVertexArray(vao_);
+    gl::BindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, texCoords));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, color));
+    glEnableVertexAttribArray(2);
+    gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    gl::BindVertexArray(0);
+    glGenFramebuffers(1, &copyFramebuffer_);
+    glCheckError();
+    RendererLocator::get().RegisterSyncBuffersFunction(this);
 }
 
 void SpriteManager::Destroy()
@@ -52,7 +73,23 @@ void SpriteManager::Destroy()
         sprite.textureId = INVALID_TEXTURE_ID;
         sprite.texture.name = INVALID_TEXTURE_NAME;
     }
-    spriteQuad_.Destroy();
+    gl::DeleteVertexArrays(1, &vao_);
+    gl::DeleteBuffers(1, &vbo_);
+    gl::DeleteBuffers(1, &ebo_);
+    gl::DeleteFramebuffers(1, &copyFramebuffer_);
+    gl::DeleteTextures(GLsizei(atlasTextures_.size()), atlasTextures_.data());
+    atlasTextures_.clear();
+    //The packed regions point into the deleted atlases
+    atlasRegions_.clear();
+    atlasPackers_.clear();
+    newAtlasRegions_.clear();
+    atlasRegionsToCopy_.clear();
+    failedAtlasCopies_.clear();
+    currentFrame_.vertices.clear();
+    currentFrame_.batches.clear();
+    renderFrame_.vertices.clear();
+    renderFrame_.batches.clear();
+    spritesCapacity_ = 0;
     spriteShader_.Destroy();
 }
 
@@ -61,31 +98,110 @@ void SpriteManager::Render()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Render Sprite Manager");
 #endif
-    //TODO batch sprite with the same texture together
+    CopyToAtlases();
+    const auto& vertices = renderFrame_.vertices;
+    if (vertices.empty())
+        return;
+    ReserveSprites(vertices.size() / 4);
+    gl::BindVertexArray(vao_);
+    gl::BindBuffer(GL_ARRAY_BUFFER, vbo_);
+    //Orphan the vertex stream of the previous frame
+    glBufferData(GL_ARRAY_BUFFER, spritesCapacity_ * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(SpriteVertex), vertices.data());
+
     spriteShader_.Bind();
-    const auto& camera = CameraLocator::get();
-    spriteShader_.SetMat4("view", camera.GenerateViewMatrix());
-    spriteShader_.SetMat4("projection", camera.GenerateProjectionMatrix());
-    for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
+    SetCameraUniforms(CameraLocator::get());
+    gl::ActiveTexture(GL_TEXTURE0);
+    for (const auto& batch : renderFrame_.batches)
     {
-        if (entityManager_.get().HasComponent(entity,EntityMask(ComponentType::SPRITE2D)))
+        gl::BindTexture(GL_TEXTURE_2D, batch.atlasIndex != INVALID_SPRITE_ATLAS ?
+            atlasTextures_[batch.atlasIndex] : batch.texture);
+        glDrawElements(GL_TRIANGLES, GLsizei(batch.spritesNmb * 6), GL_UNSIGNED_INT,
+            reinterpret_cast<void*>(std::size_t(batch.firstSprite) * 6 * sizeof(std::uint32_t)));
+    }
+    gl::BindVertexArray(0);
+    glCheckError();
+}
+
+void SpriteManager::CopyToAtlases()
+{
+    if (atlasRegionsToCopy_.empty())
+        return;
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Copy Sprites To Atlases");
+#endif
+    gl::BindFramebuffer(GL_READ_FRAMEBUFFER, copyFramebuffer_);
+    for (const auto& region : atlasRegionsToCopy_)
+    {
+        while (region.atlasIndex >= atlasTextures_.size())
         {
-            if (!entityManager_.get().HasComponent(entity, EntityMask(ComponentType::TRANSFORM2D)))
-            {
-                spriteShader_.SetMat4("model", Mat4f::Identity);
-            }
-            else
+            TextureName atlas = INVALID_TEXTURE_NAME;
+            glGenTextures(1, &atlas);
+            gl::BindTexture(GL_TEXTURE_2D, atlas);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            atlasTextures_.push_back(atlas);
+        }
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, region.texture, 0);
+        if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            logDebug(fmt::format("[Error] Sprite texture {} cannot be copied into its atlas", region.texture));
+            //Drawn from its own texture after the next sync instead of the empty atlas region
+            failedAtlasCopies_.push_back(region.textureId);
+            continue;
+        }
+        gl::BindTexture(GL_TEXTURE_2D, atlasTextures_[region.atlasIndex]);
+        const Vec2i position = region.position;
+        const Vec2i size = region.size;
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, 0, 0, size.x, size.y);
+        //Extrude the edge texels into the padding, the corners repeat the corner texels
+        for (int offset = 1; offset <= ATLAS_PADDING; offset++)
+        {
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x - offset, position.y, 0, 0, 1, size.y);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x + size.x - 1 + offset, position.y,
+                size.x - 1, 0, 1, size.y);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y - offset, 0, 0, size.x, 1);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y + size.y - 1 + offset,
+                0, size.y - 1, size.x, 1);
+            for (int otherOffset = 1; otherOffset <= ATLAS_PADDING; otherOffset++)
             {
-                const auto& transform = transformManager_.GetComponent(entity);
-                spriteShader_.SetMat4("model", transform);
+                glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x - offset, position.y - otherOffset,
+                    0, 0, 1, 1);
+                glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x + size.x - 1 + offset, position.y - otherOffset,
+                    size.x - 1, 0, 1, 1);
+                glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x - offset, position.y + size.y - 1 + otherOffset,
+                    0, size.y - 1, 1, 1);
+                glCopyTexSubImage2D(GL_TEXTURE_2D, 0, position.x + size.x - 1 + offset,
+                    position.y + size.y - 1 + otherOffset, size.x - 1, size.y - 1, 1, 1);
             }
-            const auto& sprite = GetComponent(entity);
-            spriteShader_.SetTexture("spriteTexture", sprite.texture.name);
-            spriteShader_.SetVec4("spriteColor", sprite.color);
-            spriteQuad_.Draw();
         }
     }
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    gl::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    atlasRegionsToCopy_.clear();
+    glCheckError();
 }
-}
-
 
+void SpriteManager::ReserveSprites(std::size_t spritesNmb)
+{
+    if (spritesNmb <= spritesCapacity_)
+        return;
+    spritesCapacity_ = std::max(spritesNmb, spritesCapacity_ * 2);
+    //The quads always use the same indices, they only need to grow with the sprites count
+    std::vector<std::uint32_t> indices(spritesCapacity_ * 6);
+    for (std::uint32_t i = 0; i < spritesCapacity_; i++)
+    {
+        const std::uint32_t quad[6] = {0, 1, 3, 1, 2, 3};
+        for (std::uint32_t j = 0; j < 6; j++)
+        {
+            indices[i * 6 + j] = i * 4 + quad[j];
+        }
+    }
+    gl::BindVertexArray(vao_);
+    gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint32_t), indices.data(), GL_STATIC_DRAW);
+}
+}
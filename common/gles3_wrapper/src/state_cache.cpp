@@ -0,0 +1,381 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "gl/state_cache.h"
+
+#include <array>
+#include <limits>
+
+namespace neko::gl
+{
+namespace
+{
+const GLuint UNKNOWN_NAME = std::numeric_limits<GLuint>::max();
+const GLenum UNKNOWN_ENUM = std::numeric_limits<GLenum>::max();
+const std::size_t CACHED_TEXTURE_UNITS_NMB = 16;
+
+enum CachedCapability : std::size_t
+{
+    BLEND_CAPABILITY = 0,
+    CULL_FACE_CAPABILITY,
+    DEPTH_TEST_CAPABILITY,
+    STENCIL_TEST_CAPABILITY,
+    SCISSOR_TEST_CAPABILITY,
+    CAPABILITIES_NMB
+};
+
+enum class CapabilityState : std::uint8_t
+{
+    UNKNOWN,
+    ENABLED,
+    DISABLED
+};
+
+struct TextureUnitState
+{
+    GLuint texture2d = UNKNOWN_NAME;
+    GLuint textureCubeMap = UNKNOWN_NAME;
+};
+
+struct StateCache
+{
+    GLuint program = UNKNOWN_NAME;
+    GLuint vertexArray = UNKNOWN_NAME;
+    GLuint arrayBuffer = UNKNOWN_NAME;
+    //Part of the vertex array state
+    GLuint elementArrayBuffer = UNKNOWN_NAME;
+    GLuint drawFramebuffer = UNKNOWN_NAME;
+    GLuint readFramebuffer = UNKNOWN_NAME;
+    GLenum activeTexture = UNKNOWN_ENUM;
+    std::array<TextureUnitState, CACHED_TEXTURE_UNITS_NMB> textureUnits{};
+    std::array<CapabilityState, CAPABILITIES_NMB> capabilities{};
+    GLenum blendSourceFactor = UNKNOWN_ENUM;
+    GLenum blendDestinationFactor = UNKNOWN_ENUM;
+    GLenum depthFunc = UNKNOWN_ENUM;
+    GLenum cullFaceMode = UNKNOWN_ENUM;
+    //GLboolean is unsigned, anything but GL_TRUE and GL_FALSE is unknown
+    GLboolean depthMask = 2;
+    StateCacheStats stats;
+};
+
+thread_local StateCache stateCache;
+
+/**
+ * \brief Return true if the call needs to be issued, and store the new value
+ */
+template<typename T>
+bool UpdateState(T& cachedValue, T value)
+{
+    if (cachedValue == value)
+    {
+        stateCache.stats.filteredCalls++;
+        return false;
+    }
+    cachedValue = value;
+    stateCache.stats.issuedCalls++;
+    return true;
+}
+
+void IssueUncached()
+{
+    stateCache.stats.issuedCalls++;
+}
+
+GLuint* GetCachedTexture(GLenum target)
+{
+    const GLenum activeTexture = stateCache.activeTexture;
+    if (activeTexture == UNKNOWN_ENUM || activeTexture - GL_TEXTURE0 >= CACHED_TEXTURE_UNITS_NMB)
+    {
+        return nullptr;
+    }
+    auto& textureUnit = stateCache.textureUnits[activeTexture - GL_TEXTURE0];
+    switch (target)
+    {
+        case GL_TEXTURE_2D:
+            return &textureUnit.texture2d;
+        case GL_TEXTURE_CUBE_MAP:
+            return &textureUnit.textureCubeMap;
+        default:
+            return nullptr;
+    }
+}
+
+CapabilityState* GetCachedCapability(GLenum capability)
+{
+    switch (capability)
+    {
+        case GL_BLEND:
+            return &stateCache.capabilities[BLEND_CAPABILITY];
+        case GL_CULL_FACE:
+            return &stateCache.capabilities[CULL_FACE_CAPABILITY];
+        case GL_DEPTH_TEST:
+            return &stateCache.capabilities[DEPTH_TEST_CAPABILITY];
+        case GL_STENCIL_TEST:
+            return &stateCache.capabilities[STENCIL_TEST_CAPABILITY];
+        case GL_SCISSOR_TEST:
+            return &stateCache.capabilities[SCISSOR_TEST_CAPABILITY];
+        default:
+            return nullptr;
+    }
+}
+
+//The deleted object can still be bound (a program in use) or unbound by GL, the binding becomes unknown
+void ForgetName(GLuint& cachedName, GLuint deletedName)
+{
+    if (cachedName == deletedName)
+    {
+        cachedName = UNKNOWN_NAME;
+    }
+}
+}
+
+void UseProgram(GLuint program)
+{
+    if (UpdateState(stateCache.program, program))
+    {
+        glUseProgram(program);
+    }
+}
+
+void BindVertexArray(GLuint vertexArray)
+{
+    if (UpdateState(stateCache.vertexArray, vertexArray))
+    {
+        glBindVertexArray(vertexArray);
+        stateCache.elementArrayBuffer = UNKNOWN_NAME;
+    }
+}
+
+void BindBuffer(GLenum target, GLuint buffer)
+{
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER:
+            if (UpdateState(stateCache.arrayBuffer, buffer))
+            {
+                glBindBuffer(target, buffer);
+            }
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            if (UpdateState(stateCache.elementArrayBuffer, buffer))
+            {
+                glBindBuffer(target, buffer);
+            }
+            break;
+        default:
+            IssueUncached();
+            glBindBuffer(target, buffer);
+            break;
+    }
+}
+
+void ActiveTexture(GLenum textureUnit)
+{
+    if (UpdateState(stateCache.activeTexture, textureUnit))
+    {
+        glActiveTexture(textureUnit);
+    }
+}
+
+void BindTexture(GLenum target, GLuint texture)
+{
+    auto* cachedTexture = GetCachedTexture(target);
+    if (cachedTexture == nullptr)
+    {
+        IssueUncached();
+        glBindTexture(target, texture);
+    }
+    else if (UpdateState(*cachedTexture, texture))
+    {
+        glBindTexture(target, texture);
+    }
+}
+
+void BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    switch (target)
+    {
+        case GL_FRAMEBUFFER:
+            if (stateCache.drawFramebuffer == framebuffer && stateCache.readFramebuffer == framebuffer)
+            {
+                stateCache.stats.filteredCalls++;
+                return;
+            }
+            stateCache.drawFramebuffer = framebuffer;
+            stateCache.readFramebuffer = framebuffer;
+            IssueUncached();
+            glBindFramebuffer(target, framebuffer);
+            break;
+        case GL_DRAW_FRAMEBUFFER:
+            if (UpdateState(stateCache.drawFramebuffer, framebuffer))
+            {
+                glBindFramebuffer(target, framebuffer);
+            }
+            break;
+        case GL_READ_FRAMEBUFFER:
+            if (UpdateState(stateCache.readFramebuffer, framebuffer))
+            {
+                glBindFramebuffer(target, framebuffer);
+            }
+            break;
+        default:
+            IssueUncached();
+            glBindFramebuffer(target, framebuffer);
+            break;
+    }
+}
+
+void Enable(GLenum capability)
+{
+    auto* cachedCapability = GetCachedCapability(capability);
+    if (cachedCapability == nullptr)
+    {
+        IssueUncached();
+        glEnable(capability);
+    }
+    else if (UpdateState(*cachedCapability, CapabilityState::ENABLED))
+    {
+        glEnable(capability);
+    }
+}
+
+void Disable(GLenum capability)
+{
+    auto* cachedCapability = GetCachedCapability(capability);
+    if (cachedCapability == nullptr)
+    {
+        IssueUncached();
+        glDisable(capability);
+    }
+    else if (UpdateState(*cachedCapability, CapabilityState::DISABLED))
+    {
+        glDisable(capability);
+    }
+}
+
+void BlendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+    if (stateCache.blendSourceFactor == sourceFactor && stateCache.blendDestinationFactor == destinationFactor)
+    {
+        stateCache.stats.filteredCalls++;
+        return;
+    }
+    stateCache.blendSourceFactor = sourceFactor;
+    stateCache.blendDestinationFactor = destinationFactor;
+    IssueUncached();
+    glBlendFunc(sourceFactor, destinationFactor);
+}
+
+void DepthFunc(GLenum func)
+{
+    if (UpdateState(stateCache.depthFunc, func))
+    {
+        glDepthFunc(func);
+    }
+}
+
+void DepthMask(GLboolean flag)
+{
+    if (UpdateState(stateCache.depthMask, flag))
+    {
+        glDepthMask(flag);
+    }
+}
+
+void CullFace(GLenum mode)
+{
+    if (UpdateState(stateCache.cullFaceMode, mode))
+    {
+        glCullFace(mode);
+    }
+}
+
+void DeleteProgram(GLuint program)
+{
+    ForgetName(stateCache.program, program);
+    glDeleteProgram(program);
+}
+
+void DeleteVertexArrays(GLsizei n, const GLuint* vertexArrays)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        if (stateCache.vertexArray == vertexArrays[i])
+        {
+            stateCache.vertexArray = UNKNOWN_NAME;
+            stateCache.elementArrayBuffer = UNKNOWN_NAME;
+        }
+    }
+    glDeleteVertexArrays(n, vertexArrays);
+}
+
+void DeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        ForgetName(stateCache.arrayBuffer, buffers[i]);
+        ForgetName(stateCache.elementArrayBuffer, buffers[i]);
+    }
+    glDeleteBuffers(n, buffers);
+}
+
+void DeleteTextures(GLsizei n, const GLuint* textures)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        for (auto& textureUnit : stateCache.textureUnits)
+        {
+            ForgetName(textureUnit.texture2d, textures[i]);
+            ForgetName(textureUnit.textureCubeMap, textures[i]);
+        }
+    }
+    glDeleteTextures(n, textures);
+}
+
+void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        ForgetName(stateCache.drawFramebuffer, framebuffers[i]);
+        ForgetName(stateCache.readFramebuffer, framebuffers[i]);
+    }
+    glDeleteFramebuffers(n, framebuffers);
+}
+
+void InvalidateStateCache()
+{
+    const auto stats = stateCache.stats;
+    stateCache = StateCache();
+    stateCache.stats = stats;
+}
+
+StateCacheStats GetStateCacheStats()
+{
+    return stateCache.stats;
+}
+
+void ResetStateCacheStats()
+{
+    stateCache.stats = StateCacheStats();
+}
+}
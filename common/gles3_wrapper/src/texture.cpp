@@ -35,7 +35,7 @@
 #include "ktx.h"
 
 #include <fmt/format.h>
-
+#include "gl/state_cache.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -47,8 +47,15 @@ void TextureManager::CreateTexture()
     const auto textureId = currentUploadedTexture_.textureId;
     const auto flags = currentUploadedTexture_.flags;
     auto& image = currentUploadedTexture_.image;
+    const auto& cachedTexture = currentUploadedTexture_.cachedTexture;
+    if (!cachedTexture.levels.empty())
+    {
+        CreateCachedTexture();
+        return;
+    }
     if (image.data == nullptr)
     {
+        std::lock_guard<std::mutex> lock(textureMapMutex_);
         textureMap_[textureId] = {};
         return;
     }
@@ -62,7 +69,7 @@ void TextureManager::CreateTexture()
 #ifdef EASY_PROFILE_USE
     EASY_END_BLOCK;
 #endif
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl::BindTexture(GL_TEXTURE_2D, texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, flags& Texture::CLAMP_WRAP ? GL_CLAMP_TO_EDGE : GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, flags& Texture::CLAMP_WRAP ? GL_CLAMP_TO_EDGE : GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, flags& Texture::SMOOTH_TEXTURE ? GL_LINEAR : GL_NEAREST);
@@ -169,11 +176,66 @@ void TextureManager::CreateTexture()
         glGenerateMipmap(GL_TEXTURE_2D);
         glCheckError();
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    textureMap_[textureId] = {texture, {currentUploadedTexture_.image.width, currentUploadedTexture_.image.height}};
+    gl::BindTexture(GL_TEXTURE_2D, 0);
+    std::lock_guard<std::mutex> lock(textureMapMutex_);
+    textureMap_[textureId] = {texture, {currentUploadedTexture_.image.width, currentUploadedTexture_.image.height},
+                              internalFormat == GL_RGBA8};
 
 }
 
+void TextureManager::CreateCachedTexture()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Create Cached Texture");
+#endif
+    const auto textureId = currentUploadedTexture_.textureId;
+    const auto flags = currentUploadedTexture_.flags;
+    const auto& cachedTexture = currentUploadedTexture_.cachedTexture;
+    const auto& levels = cachedTexture.levels;
+    TextureName texture;
+    glGenTextures(1, &texture);
+    gl::BindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, flags & Texture::CLAMP_WRAP ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, flags & Texture::CLAMP_WRAP ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, flags & Texture::SMOOTH_TEXTURE ? GL_LINEAR : GL_NEAREST);
+    //The mip chain comes from the cache, an offline file can have fewer levels
+    if ((flags & Texture::MIPMAPS_TEXTURE) && levels.size() > 1)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                        flags & Texture::SMOOTH_TEXTURE ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
+    }
+    else
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, flags & Texture::SMOOTH_TEXTURE ? GL_LINEAR : GL_NEAREST);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1));
+    glCheckError();
+    //The KTX rows are aligned to 4 bytes
+    GLint unpackAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (std::size_t i = 0; i < levels.size(); i++)
+    {
+        const auto& level = levels[i];
+        if (cachedTexture.IsCompressed())
+        {
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), cachedTexture.glInternalFormat,
+                                   level.width, level.height, 0, static_cast<GLsizei>(level.size), level.data);
+        }
+        else
+        {
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), static_cast<GLint>(cachedTexture.glInternalFormat),
+                         level.width, level.height, 0, cachedTexture.glFormat, cachedTexture.glType, level.data);
+        }
+        glCheckError();
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+    gl::BindTexture(GL_TEXTURE_2D, 0);
+    std::lock_guard<std::mutex> lock(textureMapMutex_);
+    textureMap_[textureId] = {texture, {levels.front().width, levels.front().height},
+                              !cachedTexture.IsCompressed() && cachedTexture.glInternalFormat == GL_RGBA8};
+}
+
 	void TextureManager::Destroy()
 	{
 		for(auto& textureName : textureMap_)
@@ -228,7 +290,7 @@ TextureName stbCreateTexture(const std::string_view filename, Texture::TextureFl
     TextureName texture;
     glGenTextures(1, &texture);
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl::BindTexture(GL_TEXTURE_2D, texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, flags & Texture::CLAMP_WRAP ? GL_CLAMP_TO_EDGE : GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, flags & Texture::CLAMP_WRAP ? GL_CLAMP_TO_EDGE : GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, flags & Texture::SMOOTH_TEXTURE ? GL_LINEAR : GL_NEAREST);
@@ -368,6 +430,8 @@ TextureName CreateTextureFromKTX(const std::string_view filename)
 #endif
       glGenTextures(1, &texture); // Optional. GLUpload can generate a texture.
       result = ktxTexture_GLUpload(kTexture, &texture, &target, &glerror);
+      //The texture was bound by KTX without the state cache
+      gl::InvalidateStateCache();
       glCheckError();
       if(result != KTX_SUCCESS)
       {
@@ -382,7 +446,7 @@ TextureName LoadCubemap(std::vector<std::string> facesFilename)
 {
     TextureName textureID;
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    gl::BindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
 
     for (unsigned int i = 0; i < facesFilename.size(); i++)
@@ -421,7 +485,7 @@ TextureName LoadCubemap(std::vector<std::string> facesFilename)
 
 void DestroyTexture(TextureName textureName)
 {
-    glDeleteTextures(1, &textureName);
+    gl::DeleteTextures(1, &textureName);
     textureName = INVALID_TEXTURE_NAME;
 
 }
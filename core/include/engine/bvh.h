@@ -0,0 +1,180 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/entity.h"
+#include "graphics/frustum.h"
+#include "mathematics/aabb.h"
+
+namespace neko
+{
+class JobSystem;
+class Transform3dManager;
+
+using BvhNodeIndex = std::int32_t;
+const BvhNodeIndex INVALID_BVH_NODE = -1;
+
+struct BvhRaycastHit
+{
+    Entity entity = INVALID_ENTITY;
+    float distance = 0.0f;
+};
+
+/**
+ * \brief Dynamic AABB tree over entities. The leaves keep a fat box so that small moves do not touch the tree,
+ * insertions go to the sibling with the least surface area increase and the tree is kept balanced with rotations.
+ * Rebuild builds a balanced tree from scratch, with the subtrees built in parallel on the job system.
+ */
+class DynamicBvh
+{
+public:
+    /**
+     * \param fatMargin added around the leaf boxes, leaves are only reinserted when they leave their fat box
+     */
+    explicit DynamicBvh(float fatMargin = 0.1f);
+
+    void Insert(Entity entity, const Aabb3d& aabb);
+    void Remove(Entity entity);
+    /**
+     * \brief Move the entity bounds, only reinserts the leaf if it left its fat box
+     * \return true if the tree changed
+     */
+    bool Update(Entity entity, const Aabb3d& aabb);
+    void Clear();
+    /**
+     * \brief Rebuild a balanced tree from all the leaves, splitting at the median of the longest axis
+     * \param jobSystem builds the subtrees in parallel if not null
+     */
+    void Rebuild(JobSystem* jobSystem = nullptr);
+
+    [[nodiscard]] bool Contains(Entity entity) const;
+    [[nodiscard]] const Aabb3d& GetAabb(Entity entity) const;
+    [[nodiscard]] std::size_t GetLeavesNmb() const { return leavesNmb_; }
+    [[nodiscard]] int GetHeight() const;
+
+    /**
+     * \brief Append to result the entities whose bounds intersect the frustum
+     */
+    void QueryFrustum(const Frustum& frustum, std::vector<Entity>& result) const;
+    void QueryAabb(const Aabb3d& aabb, std::vector<Entity>& result) const;
+    /**
+     * \brief Closest entity whose bounds are hit by the ray
+     * \return false if nothing is hit before maxDistance
+     */
+    bool Raycast(const Vec3f& origin, const Vec3f& direction, float maxDistance, BvhRaycastHit& hit) const;
+private:
+    struct Node
+    {
+        Aabb3d aabb;
+        BvhNodeIndex parent = INVALID_BVH_NODE;
+        BvhNodeIndex left = INVALID_BVH_NODE;
+        BvhNodeIndex right = INVALID_BVH_NODE;
+        Entity entity = INVALID_ENTITY;
+        int height = 0;
+
+        [[nodiscard]] bool IsLeaf() const { return left == INVALID_BVH_NODE; }
+    };
+
+    BvhNodeIndex AllocateNode();
+    void FreeNode(BvhNodeIndex node);
+    void InsertLeaf(BvhNodeIndex leaf);
+    void RemoveLeaf(BvhNodeIndex leaf);
+    /**
+     * \brief Refit the bounds and heights from node up to the root, rotating the unbalanced nodes
+     */
+    void RefitAncestors(BvhNodeIndex node);
+    BvhNodeIndex Balance(BvhNodeIndex node);
+    void RefitNode(BvhNodeIndex node);
+    /**
+     * \brief Build the subtree of the leaves [begin, end) in the 2 * (end - begin) - 1 nodes starting at firstNode
+     */
+    void BuildSubtree(std::size_t begin, std::size_t end, BvhNodeIndex firstNode, BvhNodeIndex parent);
+    /**
+     * \brief Build the nodes over rebuildThreshold leaves and collect the smaller subtrees to build in parallel
+     */
+    void BuildUpperTree(std::size_t begin, std::size_t end, BvhNodeIndex firstNode, BvhNodeIndex parent);
+    /**
+     * \brief Partition the leaves around the median of the longest axis of their centers
+     */
+    std::size_t SplitLeaves(std::size_t begin, std::size_t end);
+    void AddSubtreeLeaves(BvhNodeIndex node, std::vector<Entity>& result) const;
+
+    float fatMargin_;
+    std::vector<Node> nodes_;
+    BvhNodeIndex root_ = INVALID_BVH_NODE;
+    BvhNodeIndex freeList_ = INVALID_BVH_NODE;
+    std::size_t leavesNmb_ = 0;
+    std::vector<BvhNodeIndex> entityLeaves_;
+    //Exact bounds of the entities, the leaves only keep the fat ones
+    std::vector<Aabb3d> entityAabbs_;
+    struct BuildLeaf
+    {
+        Entity entity = INVALID_ENTITY;
+        Aabb3d aabb;
+        Vec3f center;
+    };
+    struct BuildTask
+    {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        BvhNodeIndex firstNode = INVALID_BVH_NODE;
+        BvhNodeIndex parent = INVALID_BVH_NODE;
+    };
+    static constexpr std::size_t rebuildThreshold = 1'024;
+    //Rebuild scratch buffers
+    std::vector<BuildLeaf> buildLeaves_;
+    std::vector<BuildTask> buildTasks_;
+    std::vector<BvhNodeIndex> upperNodes_;
+};
+
+/**
+ * \brief Keeps a DynamicBvh over the entities with the world bounds given by their local bounds
+ * and the current transforms of the Transform3dManager
+ */
+class TransformBvh
+{
+public:
+    explicit TransformBvh(Transform3dManager& transformManager, float fatMargin = 0.1f);
+
+    void AddEntity(Entity entity, const Aabb3d& localAabb);
+    void RemoveEntity(Entity entity);
+    /**
+     * \brief Recompute the world bounds from the transforms (in parallel with the engine job system)
+     * and move the leaves that left their fat box
+     */
+    void Update();
+    [[nodiscard]] DynamicBvh& GetBvh() { return bvh_; }
+    [[nodiscard]] const DynamicBvh& GetBvh() const { return bvh_; }
+    static Aabb3d TransformAabb(const Mat4f& transform, const Aabb3d& aabb);
+private:
+    Transform3dManager& transformManager_;
+    DynamicBvh bvh_;
+    std::vector<Entity> entities_;
+    std::vector<Aabb3d> localAabbs_;
+    std::vector<Aabb3d> worldAabbs_;
+};
+}
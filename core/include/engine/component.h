@@ -23,6 +23,11 @@
  SOFTWARE.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include <engine/assert.h>
 #include <engine/entity.h>
 #include <engine/globals.h>
 #include <utilities/vector_utility.h>
@@ -50,7 +55,8 @@ enum class ComponentType : EntityMask
     POLYGON_COLLIDER2D = 1u << 11u,
     CONVEX_SHAPE2D = 1u << 12u,
     PREFAB = 1u << 13u,
-    OTHER_TYPE = 1u << 14u
+    MODEL3D = 1u << 14u,
+    OTHER_TYPE = 1u << 15u
 };
 
 struct Component
@@ -60,10 +66,10 @@ struct Component
 };
 
 /**
- * \brief The Component Manager connects data to entity
+ * \brief The Component Manager connects data to entity.
+ * The default dense storage is indexed by entity, see ComponentStorage for the other policies.
  */
-
-template<typename T, EntityMask componentType>
+template<typename T, EntityMask componentType, ComponentStorage storage>
 class ComponentManager
 {
 public:
@@ -101,31 +107,169 @@ public:
     [[nodiscard]] const std::vector<T>& GetComponentsVector() const
     { return components_; }
 
+    /**
+     * \brief Call func(entity, component) on every entity with the component type, ordered by entity.
+     * Modifying the component there bypasses SetComponent.
+     */
+    template<typename Func>
+    void ForEach(Func func)
+    {
+        const auto& entityManager = entityManager_.get();
+        const Entity endEntity = std::min(static_cast<Entity>(components_.size()),
+                                          static_cast<Entity>(entityManager.GetEntitiesSize()));
+        for (Entity entity = 0; entity < endEntity; entity++)
+        {
+            if (entityManager.HasComponent(entity, componentType))
+            {
+                func(entity, components_[entity]);
+            }
+        }
+    }
+
     virtual void UpdateDirtyComponent([[maybe_unused]]Entity entity){};
 protected:
     std::vector<T> components_;
     std::reference_wrapper<EntityManager> entityManager_;
 };
 
-template<typename T, EntityMask componentType>
-void ComponentManager<T, componentType>::AddComponent(Entity entity)
+template<typename T, EntityMask componentType, ComponentStorage storage>
+void ComponentManager<T, componentType, storage>::AddComponent(Entity entity)
 {
     ResizeIfNecessary(components_, entity, T{});
     entityManager_.get().AddComponentType(entity, componentType);
 }
 
-template<typename T, EntityMask componentType>
-void ComponentManager<T, componentType>::DestroyComponent(Entity entity)
+template<typename T, EntityMask componentType, ComponentStorage storage>
+void ComponentManager<T, componentType, storage>::DestroyComponent(Entity entity)
 {
     entityManager_.get().RemoveComponentType(entity, static_cast<EntityMask>(componentType));
 }
 
-template <typename T, EntityMask componentType>
-void ComponentManager<T, componentType>::SetComponent(Entity entity, const T& component)
+template <typename T, EntityMask componentType, ComponentStorage storage>
+void ComponentManager<T, componentType, storage>::SetComponent(Entity entity, const T& component)
 {
 	components_[entity] = component;
 }
 
+/**
+ * \brief Sparse set Component Manager, the components are packed in a dense array and
+ * an entity indexed sparse array gives their position. Memory of the components and iteration
+ * only scale with the number of entities owning the component.
+ * The dense order changes when a component is destroyed, the last component takes its place.
+ */
+template<typename T, EntityMask componentType>
+class ComponentManager<T, componentType, ComponentStorage::SPARSE_SET>
+{
+public:
+    explicit ComponentManager(EntityManager& entityManager) :
+        entityManager_(entityManager)
+    {
+        entityManager_.get().RegisterComponentManager(*this);
+        ResizeIfNecessary(sparse_, INIT_ENTITY_NMB - 1, INVALID_INDEX);
+    }
+
+    virtual ~ComponentManager()
+    {};
+
+    /**
+     * \brief Add the component type to the entity manager (Warning! it does not set a default value for the component)
+     */
+    virtual void AddComponent(Entity entity)
+    {
+        InsertComponent(entity);
+        entityManager_.get().AddComponentType(entity, componentType);
+    }
+    /**
+     * \brief Remove the component type to the entity manager
+     */
+    virtual void DestroyComponent(Entity entity)
+    {
+        if (HasComponentData(entity))
+        {
+            const Index index = sparse_[entity];
+            const Entity lastEntity = entities_.back();
+            components_[index] = std::move(components_.back());
+            entities_[index] = lastEntity;
+            sparse_[lastEntity] = index;
+            sparse_[entity] = INVALID_INDEX;
+            components_.pop_back();
+            entities_.pop_back();
+        }
+        entityManager_.get().RemoveComponentType(entity, static_cast<EntityMask>(componentType));
+    }
+    /**
+     * Copy the value component to the component manager (Warning! it does not register the component type to the entity manager)
+     */
+    virtual void SetComponent(Entity entity, const T& component)
+    {
+        components_[InsertComponent(entity)] = component;
+    }
+
+    [[nodiscard]] const T& GetComponent(Entity entity) const
+    {
+        neko_assert(HasComponentData(entity), "Entity has no component data in the sparse set");
+        return components_[sparse_[entity]];
+    }
+
+    [[nodiscard]] const T* GetComponentPtr(Entity entity) const
+    {
+        return HasComponentData(entity) ? &components_[sparse_[entity]] : nullptr;
+    }
+
+    [[nodiscard]] bool HasComponentData(Entity entity) const
+    {
+        return entity < sparse_.size() && sparse_[entity] != INVALID_INDEX;
+    }
+
+    /**
+     * \brief Packed components, in the same order as GetDenseEntities
+     */
+    [[nodiscard]] const std::vector<T>& GetDenseComponents() const
+    { return components_; }
+
+    [[nodiscard]] const std::vector<Entity>& GetDenseEntities() const
+    { return entities_; }
+
+    [[nodiscard]] size_t GetComponentsNmb() const
+    { return components_.size(); }
+
+    /**
+     * \brief Call func(entity, component) on every stored component, in dense order.
+     * Modifying the component there bypasses SetComponent.
+     */
+    template<typename Func>
+    void ForEach(Func func)
+    {
+        const size_t componentsNmb = components_.size();
+        for (size_t i = 0; i < componentsNmb; i++)
+        {
+            func(entities_[i], components_[i]);
+        }
+    }
+
+    virtual void UpdateDirtyComponent([[maybe_unused]]Entity entity){};
+protected:
+    /**
+     * \brief Return the dense index of the entity component, adding a default one if needed
+     */
+    Index InsertComponent(Entity entity)
+    {
+        ResizeIfNecessary(sparse_, entity, INVALID_INDEX);
+        if (sparse_[entity] == INVALID_INDEX)
+        {
+            sparse_[entity] = static_cast<Index>(components_.size());
+            components_.push_back(T{});
+            entities_.push_back(entity);
+        }
+        return sparse_[entity];
+    }
+
+    std::vector<Index> sparse_;
+    std::vector<T> components_;
+    std::vector<Entity> entities_;
+    std::reference_wrapper<EntityManager> entityManager_;
+};
+
 
 /**
  * \brief Sync Buffers is typically called on the render thread before the Main thread update and rendering
@@ -140,6 +284,7 @@ public:
  * \brief Double Buffer Component Manager allows for component to be share between two threads by
  * using two buffers instead of one. It can be used for example for component that are modified by the
  * main thread and rendered by the render thread.
+ * Only the components changed by SetComponent since the last sync are copied to the current buffer.
  */
 template<typename  T, EntityMask  componentType>
 class DoubleBufferComponentManager :
@@ -150,8 +295,37 @@ public:
 	explicit DoubleBufferComponentManager(EntityManager& entityManager):
 		ComponentManager<T, componentType>(entityManager)
 	{
+        dirtyFlags_.resize(this->components_.size(), 0);
 	}
 
+    void AddComponent(Entity entity) override
+    {
+        ComponentManager<T, componentType>::AddComponent(entity);
+        ResizeIfNecessary(dirtyFlags_, this->components_.size() - 1, std::uint8_t(0));
+    }
+
+    /**
+     * \brief Can be called concurrently on different entities, the entity should have been added before
+     */
+    void SetComponent(Entity entity, const T& component) override
+    {
+        ComponentManager<T, componentType>::SetComponent(entity, component);
+        dirtyFlags_[entity] = 1;
+    }
+
+    /**
+     * \brief Same as ComponentManager::ForEach, every visited component is copied at the next sync
+     */
+    template<typename Func>
+    void ForEach(Func func)
+    {
+        ComponentManager<T, componentType>::ForEach([this, &func](Entity entity, T& component)
+        {
+            dirtyFlags_[entity] = 1;
+            func(entity, component);
+        });
+    }
+
 	[[nodiscard]] const T& GetCurrentComponent(Entity entity) const
     {
         return currentComponents_[entity];
@@ -171,19 +345,47 @@ public:
 
 	void SyncBuffers() override
 	{
-        const auto newSize = this->components_.size();
-        ResizeIfNecessary(currentComponents_, newSize - 1, {});
-		for(size_t i = 0; i < newSize; i++)
-		{
-			if(this->entityManager_.get().HasComponent(i, EntityMask(componentType)))
-			{
-                currentComponents_[i] = this->components_[i];
-			}
-		}
-        std::swap(this->components_, currentComponents_);
+        const auto& components = this->components_;
+        const auto newSize = components.size();
+        //New slots are copied whole, they can have a default value other than T{}
+        const auto oldSize = currentComponents_.size();
+        if (oldSize < newSize)
+        {
+            currentComponents_.insert(currentComponents_.end(), components.begin() + oldSize, components.end());
+        }
+        ResizeIfNecessary(dirtyFlags_, newSize - 1, std::uint8_t(0));
+        //Copy each run of consecutive dirty components at once
+        const auto flagsBegin = dirtyFlags_.begin();
+        const auto flagsEnd = flagsBegin + newSize;
+        auto runEnd = flagsBegin;
+        while (true)
+        {
+            const auto runBegin = std::find(runEnd, flagsEnd, std::uint8_t(1));
+            if (runBegin == flagsEnd)
+            {
+                break;
+            }
+            runEnd = std::find(runBegin, flagsEnd, std::uint8_t(0));
+            const auto begin = std::distance(flagsBegin, runBegin);
+            const auto count = std::distance(runBegin, runEnd);
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(&currentComponents_[begin], &components[begin], count * sizeof(T));
+            }
+            else
+            {
+                std::copy_n(components.begin() + begin, count, currentComponents_.begin() + begin);
+            }
+            std::fill(runBegin, runEnd, std::uint8_t(0));
+        }
 	}
 	
 protected:
     std::vector<T> currentComponents_;
+    /**
+     * \brief One byte per entity instead of a bitset, so that SetComponent can be called
+     * concurrently on different entities
+     */
+    std::vector<std::uint8_t> dirtyFlags_;
 };
 }
@@ -28,6 +28,8 @@
 #include <utilities/action_utility.h>
 #include <graphics/color.h>
 #include <utilities/time_utility.h>
+#include <utilities/asset_archive.h>
+#include <utilities/io_service.h>
 #include <mathematics/vector.h>
 
 #include "jobsystem.h"
@@ -38,6 +40,11 @@ namespace neko
 class Renderer;
 class Window;
 
+/**
+ * \brief Number of jobs created by the engine each frame
+ */
+const std::size_t FRAME_JOB_POOL_SIZE = 16;
+
 /**
  * \brief store various Engine constant or global values
  */
@@ -49,12 +56,36 @@ struct Configuration
     bool fullscreen = false;
     bool vSync = true;
     unsigned int framerateLimit = 0u;
+    /**
+     * \brief Number of frames in flight. With 1 the main thread waits for the buffer swap at the end of each frame.
+     * With 2 the update of the next frame overlaps the buffer swap of the previous one, adding no input latency
+     * as the frame is still rendered after its update. Deeper pipelines are clamped to 2 as the renderer
+     * only has a current and a next command buffer.
+     */
+    std::uint8_t framePipelineDepth = 1;
 #if defined(EMSCRIPTEN)
     std::string dataRootPath = "./";
 #elif defined(__ANDROID__)
     std::string dataRootPath = "data/";
 #else
     std::string dataRootPath = "../../data/";
+#endif
+    /**
+     * \brief Packed asset archive mounted at init, the assets it contains are not loaded from the data folder.
+     * Empty to only use the loose files.
+     */
+    std::string dataArchivePath;
+    /**
+     * \brief Folder of the texture cache in the data root, empty to decode the source images at each launch
+     */
+    std::string textureCacheFolder = "texture_cache/";
+    /**
+     * \brief Backend of the I/O service reading the resource jobs, the Android assets are read by the job threads
+     */
+#if defined(__ANDROID__) || defined(EMSCRIPTEN)
+    IoBackend ioBackend = IoBackend::NONE;
+#else
+    IoBackend ioBackend = IoBackend::IO_URING;
 #endif
 };
 
@@ -90,6 +121,16 @@ public:
     static BasicEngine* GetInstance(){return instance_;}
 
     void ScheduleJob(Job* job, JobThreadType threadType);
+    /**
+     * \brief Read the file of the job with the I/O service, the job is scheduled on threadType when the service
+     * does not take it
+     */
+    void ScheduleResourceJob(ResourceJob* job, JobThreadType threadType = JobThreadType::RESOURCE_THREAD);
+    JobSystem& GetJobSystem() { return jobSystem_; }
+    /**
+     * \brief Split [begin, end) in chunks executed by the other workers and the calling thread
+     */
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const JobSystem::ParallelForTask& func);
     //template <typename T = BasicEngine>
     //static T* GetInstance(){ return dynamic_cast<T*>(instance_);};
 protected:
@@ -97,6 +138,13 @@ protected:
     Renderer* renderer_ = nullptr;
     Window* window_ = nullptr;
     JobSystem jobSystem_;
+    AssetArchive assetArchive_;
+    IoService ioService_;
+    JobPool frameJobPool_{FRAME_JOB_POOL_SIZE};
+    /**
+     * \brief In pipelined mode, the previous frame render and swap buffer jobs can still be running
+     */
+    bool isPreviousFramePending_ = false;
 	bool isRunning_;
     float dt_ = 0.0f;
     Action<> initAction_;
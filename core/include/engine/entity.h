@@ -23,6 +23,7 @@
  SOFTWARE.
  */
 
+#include <functional>
 #include <unordered_map>
 #include <vector>
 #include <engine/globals.h>
@@ -33,6 +34,7 @@
 namespace neko
 {
 class OnChangeParentInterface;
+class OnDestroyEntityInterface;
 /**
  * \brief Entity start at 0 and goes to N
  */
@@ -45,12 +47,41 @@ using EntityHash = xxh::hash_t<64>;
  * \brief EntityMask is a bitmask representation of the activated components
  */
 using EntityMask = std::uint32_t;
+/**
+ * \brief Incremented each time an entity is destroyed, so a recycled entity can be told apart from the old one
+ */
+using EntityGeneration = std::uint32_t;
 const Entity INVALID_ENTITY = std::numeric_limits<Index>::max();
 const EntityMask INVALID_ENTITY_MASK = 0u;
 const EntityHash INVALID_ENTITY_HASH = EntityHash(0);
 enum class ComponentType : std::uint32_t;
 
-template<typename T, EntityMask componentType>
+/**
+ * \brief Entity with the generation it was created with, used to detect handles to destroyed entities
+ */
+struct EntityHandle
+{
+    Entity entity = INVALID_ENTITY;
+    EntityGeneration generation = 0;
+};
+
+/**
+ * \brief Storage policy of a ComponentManager
+ */
+enum class ComponentStorage : std::uint8_t
+{
+    /**
+     * \brief Components indexed by entity, memory and iteration grow with the highest entity id
+     */
+    DENSE,
+    /**
+     * \brief Components packed in a dense array with a sparse entity to index array,
+     * iteration only walks the entities owning the component
+     */
+    SPARSE_SET
+};
+
+template<typename T, EntityMask componentType, ComponentStorage storage = ComponentStorage::DENSE>
 class ComponentManager;
 
 /**
@@ -63,7 +94,8 @@ public:
 
     EntityMask GetMask(Entity entity);
     /**
-     * \brief create an empty entity (non-null EntityMask)
+     * \brief create an empty entity (non-null EntityMask). Destroyed entities are recycled first in O(1).
+     * An explicit entity is used if it does not exist yet, otherwise a new entity is created.
      */
     Entity CreateEntity(Entity entity = INVALID_ENTITY);
 
@@ -79,11 +111,26 @@ public:
 
     [[nodiscard]] bool EntityExists(Entity entity);
 
+    [[nodiscard]] EntityGeneration GetEntityGeneration(Entity entity) const;
+
+    [[nodiscard]] EntityHandle GetEntityHandle(Entity entity) const;
+    /**
+     * \brief Return false if the entity was destroyed since the handle was taken, even if it was recycled
+     */
+    [[nodiscard]] bool IsEntityHandleValid(EntityHandle handle) const;
+
     [[nodiscard]] size_t GetEntitiesNmb(EntityMask filterComponents = INVALID_ENTITY_MASK);
 
     [[nodiscard]] size_t GetEntitiesSize() const;
 
     [[nodiscard]] std::vector<Entity> FilterEntities(EntityMask filterComponents = INVALID_ENTITY_MASK) const;
+    /**
+     * \brief Return the sorted entities having all the components of the mask.
+     * The view is built on the first call and then updated when the entities masks change.
+     * The reference is invalidated when an entity enters or leaves the view, use FilterEntities to get a copy
+     * when entities are modified while iterating.
+     */
+    [[nodiscard]] const std::vector<Entity>& View(EntityMask filterComponents) const;
 
     void AddComponentType(Entity entity, EntityMask componentType);
 
@@ -99,8 +146,8 @@ public:
 
     [[nodiscard]] Entity FindEntityByName(const std::string& entityName);
 
-    template<typename T, EntityMask componentType>
-    void RegisterComponentManager(ComponentManager<T, componentType>& componentManager)
+    template<typename T, EntityMask componentType, ComponentStorage storage>
+    void RegisterComponentManager(ComponentManager<T, componentType, storage>& componentManager)
     {
         onDestroyEntity.RegisterCallback(
                 [&componentManager](Entity entity) { componentManager.DestroyComponent(entity); });
@@ -108,6 +155,8 @@ public:
 
     void RegisterOnChangeParent(OnChangeParentInterface* onChangeInterface);
 
+    void RegisterOnDestroyEntity(OnDestroyEntityInterface* onDestroyInterface);
+
     Entity GetEntityParent(Entity entity);
 
 	/**
@@ -121,38 +170,47 @@ private:
     Action<Entity> onDestroyEntity;
     Action<Entity, Entity, Entity> onChangeParent;
     std::vector<Entity> parentEntities_;
+    /**
+     * \brief Resize all the per entity arrays to contain the entity
+     */
+    void ResizeEntities(Entity entity);
+    /**
+     * \brief Add or remove the entity from the cached views after its mask changed
+     */
+    void UpdateViews(Entity entity, EntityMask previousMask);
+
     std::vector<EntityMask> entityMaskArray_;
     std::vector<EntityHash> entityHashArray_;
+    std::vector<EntityGeneration> entityGenerations_;
+    /**
+     * \brief Cached views by components mask, node based so the returned references survive new views
+     */
+    mutable std::unordered_map<EntityMask, std::vector<Entity>> views_;
+    /**
+     * \brief Destroyed entities, can contain entities recreated explicitly that are skipped when popped
+     */
+    std::vector<Entity> freeEntities_;
+    /**
+     * \brief First entity that was never created
+     */
+    Entity nextEntity_ = 0;
 };
 
-class DirtyManager
+class OnChangeParentInterface
 {
 public:
-    explicit DirtyManager(EntityManager& entityManager);
-    DirtyManager( const DirtyManager & ) = default;
-    void SetDirty(Entity entity);
-
-    void UpdateDirtyEntities();
-	
-    template<typename T, EntityMask componentType>
-    void RegisterComponentManager(ComponentManager<T, componentType>* componentManager)
-    {
-        updateDirtyEntity.RegisterCallback(
-            [componentManager](Entity entity) { componentManager->UpdateDirtyComponent(entity); });
-    }
-	
-private:
-	
-    std::reference_wrapper<EntityManager> entityManager_;
-    Action<Entity> updateDirtyEntity;
-    std::vector<Entity> dirtyEntities_;
+	virtual ~OnChangeParentInterface() = default;
+	virtual void OnChangeParent(Entity entity, Entity newParent, Entity oldParent) = 0;
 };
 
-class OnChangeParentInterface
+/**
+ * \brief Called when an entity is destroyed, before it can be recycled
+ */
+class OnDestroyEntityInterface
 {
 public:
-	virtual ~OnChangeParentInterface() = default;
-	virtual void OnChangeParent(Entity entity, Entity newParent, Entity oldParent) = 0;
+	virtual ~OnDestroyEntityInterface() = default;
+	virtual void OnDestroyEntity(Entity entity) = 0;
 };
 
 class EntityHierarchy : public OnChangeParentInterface
@@ -161,12 +219,56 @@ public:
     explicit EntityHierarchy(EntityManager& entityManager);
     void OnChangeParent(Entity entity, Entity newParent, Entity oldParent) override;
     const std::vector<Entity>& GetChildren(Entity entity);
-    [[nodiscard]] bool HasChildren(Entity entity);
+    [[nodiscard]] bool HasChildren(Entity entity) const;
 private:
     EntityManager& entityManager_;
     std::unordered_map<Entity, std::vector<Entity>> entityHierarchyMap_;
 };
 
+/**
+ * \brief Collect the dirty entities and update them with their children, parents always before children
+ */
+class DirtyManager
+{
+public:
+    explicit DirtyManager(EntityManager& entityManager);
+    DirtyManager(const DirtyManager&) = delete;
+    /**
+     * \brief Mark the entity and all its children as dirty in O(1)
+     */
+    void SetDirty(Entity entity);
+    /**
+     * \brief Update the dirty entities subtrees in breadth-first order, in O(dirty subtrees)
+     */
+    void UpdateDirtyEntities();
+    using UpdateLevelFunction = std::function<void(const std::vector<Entity>& entities, std::size_t begin, std::size_t end)>;
+    /**
+     * \brief Give the dirty entities subtrees one hierarchy level at a time instead of calling the registered
+     * component managers. A level only depends on the previous ones, so its entities can be updated in parallel.
+     */
+    void UpdateDirtyLevels(const UpdateLevelFunction& updateLevel);
+	
+    template<typename T, EntityMask componentType, ComponentStorage storage>
+    void RegisterComponentManager(ComponentManager<T, componentType, storage>* componentManager)
+    {
+        updateDirtyEntity.RegisterCallback(
+            [componentManager](Entity entity) { componentManager->UpdateDirtyComponent(entity); });
+    }
+	
+private:
+    [[nodiscard]] bool HasDirtyParent(Entity entity) const;
+
+    std::reference_wrapper<EntityManager> entityManager_;
+    EntityHierarchy entityHierarchy_;
+    Action<Entity> updateDirtyEntity;
+    std::vector<Entity> dirtyEntities_;
+    std::vector<bool> dirtyFlags_;
+    /**
+     * \brief Breadth-first queue of the entities to update, grouped by level and kept to avoid allocations
+     */
+    std::vector<Entity> updateQueue_;
+};
+
 /**
  * ImGui class that allows to show the active entities and select them
  */
@@ -23,14 +23,19 @@
  SOFTWARE.
  */
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 #ifndef NEKO_SAMETHREAD
 #include <thread>
-#include <future>
+#include <mutex>
 #include <condition_variable>
 #endif
-#include <queue>
 #include "engine/system.h"
+#include "utilities/inplace_function.h"
 
 namespace neko
 {
@@ -43,6 +48,19 @@ enum class JobThreadType : int8_t
     OTHER_THREAD = 2
 };
 
+class JobSystem;
+
+/**
+ * \brief Inline buffer size of the job task, big enough for a lambda capturing a few pointers
+ */
+const std::size_t JOB_TASK_SIZE = 48;
+using JobTask = InplaceFunction<void(), JOB_TASK_SIZE>;
+
+/**
+ * \brief Node of the job graph. A job keeps the count of its unfinished dependencies and the list of
+ * the jobs depending on it. When the last dependency is done, the job is pushed to its thread queue.
+ * The task is stored inline and the status is a single atomic word, creating a job does not allocate.
+ */
 class Job
 {
 public:
@@ -52,13 +70,29 @@ public:
         DEPENDABLE,
         NICE_TO_HAVE
     };
-    enum JobStatus : std::uint8_t
+    enum JobStatus : std::uint32_t
     {
         STARTED = 1u << 0u,
-        DONE = 1u << 1u
+        DONE = 1u << 1u,
+        /**
+         * \brief The task is done, but the successors are still being released
+         */
+        TASK_DONE = 1u << 2u,
+        /**
+         * \brief Spin lock bit protecting the successors list
+         */
+        SUCCESSORS_LOCK = 1u << 3u,
+        /**
+         * \brief A thread is sleeping in Join and needs to be woken up
+         */
+        JOIN_WAITING = 1u << 4u,
+        /**
+         * \brief Given to the JobSystem, cleared by Reset
+         */
+        SCHEDULED = 1u << 5u
     };
     Job():Job([]{}){};
-    explicit Job(std::function<void()> task);
+    explicit Job(JobTask task);
     virtual ~Job() = default;
     Job(const Job&) = delete;
     Job& operator=(const Job&) = delete;
@@ -68,49 +102,261 @@ public:
 
     /**
      * \brief Wait for the Job to be done,
-     * used when dependencies are not done
      * useful when dependencies are on other threads
      */
     void Join() const;
 
     /**
-     * \brief Execute is called by the JobSystem
+     * \brief Execute is called by the JobSystem when all the dependencies are done.
+     * It releases the successors whose dependencies are all done.
      */
     void Execute();
 	/**
 	 *  \brief Check if all dependencies started
-	 *  used when we want to start the job to know if we should join or wait for other dependencies
 	 */
     [[nodiscard]] bool CheckDependenciesStarted() const;
+	/**
+	 *  \brief Check if all dependencies are done
+	 */
+    [[nodiscard]] bool CheckDependenciesDone() const;
     [[nodiscard]] bool IsDone() const;
     [[nodiscard]] bool HasStarted() const;
+    /**
+     * \brief Must be called before scheduling the job. A dependency that is already done is ignored.
+     */
     void AddDependency(const Job* dep);
 
-    std::function<void()> GetTask() const { return task_; }
-    void SetTask(std::function<void()> task) { task_ = std::move(task); }
+    [[nodiscard]] const JobTask& GetTask() const { return task_; }
+    void SetTask(JobTask task) { task_ = std::move(task); }
     virtual void Reset();
 
 protected:
+    friend class JobSystem;
+    /**
+     * \brief Run the task and release the successors, the job is not done yet
+     */
+    void ExecuteTask();
+    /**
+     * \brief Set the job as done and wake the joining threads, the job can be destroyed right after
+     */
+    void Finish();
+    /**
+     * \brief Called by a dependency when it is done
+     */
+    void ReleaseDependency();
+    /**
+     * \brief Return false if the job task is already done
+     */
+    bool AddSuccessor(Job* successor) const;
+
     std::vector<const Job*> dependencies_;
-    std::function<void()> task_;
-#ifndef NEKO_SAMETHREAD
-    mutable std::promise<void> promise_;
-    mutable std::shared_future<void> taskDoneFuture_;
-    mutable std::mutex statusLock_;
-#endif
-    std::uint8_t status_;
+    mutable std::vector<Job*> successors_;
+    JobTask task_;
+    JobSystem* jobSystem_ = nullptr;
+    /**
+     * \brief Steady clock time in nanoseconds when the job was scheduled, used for the latency counters
+     */
+    std::int64_t scheduleTime_ = 0;
+    /**
+     * \brief Unfinished dependencies plus one until the job is scheduled
+     */
+    std::atomic<std::int32_t> unfinishedDependencies_{1};
+    JobThreadType threadType_ = JobThreadType::OTHER_THREAD;
+    mutable std::atomic<std::uint32_t> status_{0};
+
+};
 
+/**
+ * \brief Fixed pool of jobs reused every frame, no allocation once the jobs vectors are warmed up.
+ * Clear must only be called when all the jobs of the previous frame are done.
+ */
+class JobPool
+{
+public:
+    explicit JobPool(std::size_t size);
+    Job* CreateJob(JobTask task);
+    void Clear();
+    [[nodiscard]] std::size_t GetSize() const { return size_; }
+private:
+    std::unique_ptr<Job[]> jobs_;
+    std::size_t size_ = 0;
+    std::size_t index_ = 0;
 };
 
-struct JobQueue
+const std::size_t JOB_QUEUE_SIZE = 4'096;
+const std::size_t WORKER_QUEUE_SIZE = 1'024;
+/**
+ * \brief Size used to keep the queue counters on separate cache lines
+ */
+const std::size_t CACHE_LINE_SIZE = 64;
+/**
+ * \brief Maximum number of helper jobs a ParallelFor schedules, the jobs live on the caller stack
+ */
+const std::size_t MAX_PARALLEL_FOR_JOBS = 32;
+/**
+ * \brief Number of jobs recorded per worker during a trace capture, the capture stops recording when full
+ */
+const std::size_t MAX_TRACE_EVENTS = 16'384;
+
+/**
+ * \brief Snapshot of the counters of one worker thread
+ */
+struct WorkerStats
+{
+    std::uint64_t executedJobs = 0;
+    std::uint64_t stolenJobs = 0;
+    std::chrono::nanoseconds busyTime{0};
+    std::chrono::nanoseconds idleTime{0};
+    /**
+     * \brief From ScheduleJob to the start of the job, including the time waiting for dependencies
+     */
+    std::chrono::nanoseconds totalScheduleLatency{0};
+    std::chrono::nanoseconds maxScheduleLatency{0};
+};
+
+/**
+ * \brief Snapshot of the job system counters, workers are ordered as the threads: render, resource, then other workers
+ */
+struct JobSystemStats
+{
+    std::vector<WorkerStats> workers;
+    std::int32_t otherQueueHighWater = 0;
+    std::int32_t renderQueueHighWater = 0;
+    std::int32_t resourceQueueHighWater = 0;
+    /**
+     * \brief Jobs that were scheduled before their dependencies were done and pushed later by the last dependency
+     */
+    std::uint64_t deferredJobs = 0;
+};
+
+struct JobTraceEvent
+{
+    std::int64_t start = 0;
+    std::int64_t end = 0;
+};
+
+/**
+ * \brief Counters of one worker, only the owning thread writes them so they stay cheap enough to be always on
+ */
+struct alignas(CACHE_LINE_SIZE) WorkerProfile
+{
+    std::atomic<std::uint64_t> executedJobs{0};
+    std::atomic<std::uint64_t> stolenJobs{0};
+    std::atomic<std::int64_t> busyTime{0};
+    std::atomic<std::int64_t> idleTime{0};
+    std::atomic<std::int64_t> totalScheduleLatency{0};
+    std::atomic<std::int64_t> maxScheduleLatency{0};
+    std::int64_t lastJobEnd = 0;
+    /**
+     * \brief Greater than one when a job executes other jobs while waiting, like in ParallelFor
+     */
+    int executionDepth = 0;
+    std::unique_ptr<JobTraceEvent[]> traceEvents;
+    /**
+     * \brief Published after the event is written, readers only read the events before it
+     */
+    std::atomic<std::size_t> traceEventsCount{0};
+    std::atomic<std::uint32_t> traceSession{0};
+};
+
+/**
+ * \brief Bounded multi-producer multi-consumer lock-free FIFO queue (Dmitry Vyukov's bounded queue).
+ * Used by the dedicated render and resource threads and as the injection queue of the other workers.
+ * Size must be a power of two.
+ */
+class JobQueue
 {
+public:
+    explicit JobQueue(std::size_t size = JOB_QUEUE_SIZE);
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+    /**
+     * \brief Return false if the queue is full
+     */
+    bool Push(Job* job);
+    /**
+     * \brief Return nullptr if the queue is empty
+     */
+    Job* Pop();
+    [[nodiscard]] bool IsEmpty() const;
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        Job* job;
+    };
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeuePos_{0};
+};
+
+/**
+ * \brief Chase-Lev lock-free deque owned by one worker.
+ * The owner pushes and pops at the bottom (LIFO), the other workers steal at the top (FIFO).
+ * Size must be a power of two.
+ */
+class WorkStealingQueue
+{
+public:
+    explicit WorkStealingQueue(std::size_t size = WORKER_QUEUE_SIZE);
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+    /**
+     * \brief Only called by the owner, return false if the deque is full
+     */
+    bool Push(Job* job);
+    /**
+     * \brief Only called by the owner
+     */
+    Job* Pop();
+    /**
+     * \brief Called by any other worker
+     */
+    Job* Steal();
+    [[nodiscard]] bool IsEmpty() const;
+private:
+    std::unique_ptr<std::atomic<Job*>[]> jobs_;
+    std::int64_t mask_;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> top_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> bottom_{0};
+};
+
 #ifndef NEKO_SAMETHREAD
+/**
+ * \brief Count the pending jobs of a group of workers and put them to sleep when there is nothing to do.
+ * The mutex is only taken when a worker goes to sleep or when a sleeping worker needs to be woken up,
+ * never when nobody is sleeping.
+ */
+class WorkerSignal
+{
+public:
+    void AddJob();
+    void RemoveJob();
+    /**
+     * \brief Sleep until a job is pending or the job system stops
+     */
+    void Wait(const std::atomic<std::uint8_t>& status);
+    void WakeAll();
+    [[nodiscard]] std::int32_t GetPendingJobs() const;
+    /**
+     * \brief Highest number of pending jobs since the last reset
+     */
+    [[nodiscard]] std::int32_t GetHighWater() const;
+    void ResetHighWater();
+private:
     std::mutex mutex_;
     std::condition_variable cv_;
-#endif
-    std::queue<Job*> jobs_;
+    std::atomic<std::int32_t> pendingJobs_{0};
+    std::atomic<std::int32_t> highWater_{0};
+    std::atomic<std::int32_t> sleepingWorkers_{0};
 };
+#endif
 
+/**
+ * \brief Schedule jobs on dedicated render and resource threads and on a pool of other workers.
+ * Each other worker owns a WorkStealingQueue and steals from the others when it runs out of jobs.
+ */
 class JobSystem : SystemInterface
 {
     enum Status : uint8_t
@@ -120,11 +366,40 @@ class JobSystem : SystemInterface
     };
 
 public:
+    using ParallelForTask = std::function<void(std::size_t begin, std::size_t end)>;
     JobSystem();
+    /**
+     * \brief Set the number of other workers instead of using the hardware concurrency
+     */
+    explicit JobSystem(std::uint8_t otherWorkersNmb);
     ~JobSystem() override;
+    /**
+     * \brief The job is pushed to its thread queue as soon as all its dependencies are done.
+     * Main thread jobs are executed directly after waiting for their dependencies.
+     */
     void ScheduleJob(Job* func, JobThreadType threadType);
+    /**
+     * \brief Split [begin, end) in chunks of grainSize and execute them on the other workers.
+     * The caller executes chunks too and helps the workers until all the chunks are done,
+     * so it can be called from the main thread or from a job.
+     */
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const ParallelForTask& func);
     void Init() override;
 
+    [[nodiscard]] JobSystemStats GetStats() const;
+    void ResetStats();
+    /**
+     * \brief Record the start and end time of the jobs executed by each worker until StopTrace is called
+     */
+    void StartTrace();
+    void StopTrace();
+    [[nodiscard]] bool IsTracing() const;
+    /**
+     * \brief Generate a Chrome trace (chrome://tracing) JSON of the last capture, call it when not tracing
+     */
+    [[nodiscard]] std::string GenerateChromeTrace() const;
+    void DumpChromeTrace(const std::string& path) const;
+
     void Update([[maybe_unused]]seconds dt) override{}
 
     void Destroy() override;
@@ -133,20 +408,56 @@ public:
     void KickJobs();
 #endif
 private:
-	void Work(JobQueue& jobQueue);
+    friend class Job;
+    /**
+     * \brief Push a job whose dependencies are all done to its thread queue
+     */
+    void EnqueueJob(Job* job, JobThreadType threadType);
+    /**
+     * \brief Execute the job and update the counters of the worker, profile is null for non worker threads
+     */
+    void ExecuteJob(Job* job, WorkerProfile* profile, bool stolen = false);
+    [[nodiscard]] static std::int64_t GetProfileTime();
+#ifdef NEKO_SAMETHREAD
+    void Work(JobQueue& jobQueue, WorkerProfile& profile);
+#else
+    /**
+     * \brief Loop of the dedicated render and resource threads, no stealing to keep the thread affinity
+     */
+    void Work(JobQueue& jobQueue, WorkerSignal& signal, WorkerProfile& profile);
+    /**
+     * \brief Loop of the other workers
+     */
+    void WorkAndSteal(std::size_t workerIndex);
+    Job* PopOtherJob(std::size_t workerIndex, bool& stolen);
+    /**
+     * \brief Execute one pending other job from any thread, return false if there was none
+     */
+    bool ExecuteOtherJob();
+    void PushJob(JobQueue& jobQueue, WorkerSignal& signal, Job* job);
+#endif
 
-    [[nodiscard]] bool IsRunning();
+    [[nodiscard]] bool IsRunning() const;
 
-    Status status_ = NONE;
-    JobQueue jobs_; // Managed via mutex. // TODO: replace with custom queue when those are implemented.
-    JobQueue renderJobs_; // Managed via mutex. // TODO: replace with custom queue when those are implemented.
-    JobQueue resourceJobs_; // Managed via mutex. // TODO: replace with custom queue when those are implemented.
+    std::atomic<std::uint8_t> status_{NONE};
+    JobQueue jobs_; // Injection queue of the other workers
+    JobQueue renderJobs_;
+    JobQueue resourceJobs_;
+    std::vector<std::unique_ptr<WorkerProfile>> profiles_;
+    std::atomic<std::uint64_t> deferredJobs_{0};
+    std::atomic<bool> tracing_{false};
+    std::atomic<std::uint32_t> traceSession_{0};
+    std::int64_t traceStart_ = 0;
 #ifndef NEKO_SAMETHREAD
-    std::uint8_t workersStarted_ = 0;
-    [[nodiscard]] std::uint8_t CountStartedWorkers();
-    std::uint8_t numberOfWorkers;
+    WorkerSignal jobsSignal_;
+    WorkerSignal renderSignal_;
+    WorkerSignal resourceSignal_;
+    std::vector<std::unique_ptr<WorkStealingQueue>> workerQueues_;
+    std::atomic<std::uint8_t> workersStarted_{0};
+    [[nodiscard]] std::uint8_t CountStartedWorkers() const;
+    std::uint8_t numberOfWorkers = 0;
+    std::uint8_t otherWorkersNmb_ = 0; // Zero to use the hardware concurrency
     std::vector<std::thread> workers_; // TODO: replace with fixed vector when those are implemented.
-    mutable std::mutex statusMutex_;
 #endif
 };
 
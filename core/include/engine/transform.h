@@ -60,7 +60,10 @@ class Position3dManager : public ComponentManager<Vec3f, EntityMask(ComponentTyp
 };
 
 
-class Rotation3dManager : public ComponentManager<EulerAngles, EntityMask(ComponentType::ROTATION3D)>
+/**
+ * \brief Stores the rotations as quaternions, the euler angles are only converted at the interface
+ */
+class Rotation3dManager : public ComponentManager<Quaternion, EntityMask(ComponentType::ROTATION3D)>
 {
     using ComponentManager::ComponentManager;
 };
@@ -78,6 +81,9 @@ class TransformManagerInterface :
 {
 public:
     virtual void UpdateDirtyComponent(Entity entity) = 0;
+    /**
+     * \brief Update the dirty transforms one hierarchy level at a time, each level in parallel with the engine job system
+     */
     virtual void Update() = 0;
 protected:
     virtual void UpdateTransform(Entity entity) = 0;
@@ -101,6 +107,10 @@ public:
     void AddComponent(Entity entity) override;
 protected:
     void UpdateTransform(Entity entity) override;
+    /**
+     * \brief Compose the transforms of the entities in SIMD batches, their parents should already be up to date
+     */
+    void UpdateTransforms(const Entity* entities, std::size_t count);
 
     Position2dManager positionManager_;
     Scale2dManager scaleManager_;
@@ -119,9 +129,11 @@ public:
     void SetPosition(Entity entity, Vec3f position);
     void SetScale(Entity entity, Vec3f scale);
     void SetRotation(Entity entity, EulerAngles angles);
+    void SetRotation(Entity entity, const Quaternion& rotation);
     [[nodiscard]]Vec3f GetPosition(Entity entity) const;
     [[nodiscard]] Vec3f GetScale(Entity entity) const;
     [[nodiscard]] EulerAngles GetAngles(Entity entity) const;
+    [[nodiscard]] Quaternion GetRotation(Entity entity) const;
     void OnChangeParent(Entity entity, Entity newParent, Entity oldParent) override;
 	/**
 	 * \brief This function is called by the Dirty Manager
@@ -132,6 +144,10 @@ public:
 protected:
 
     void UpdateTransform(Entity entity) override;
+    /**
+     * \brief Compose the transforms of the entities in SIMD batches, their parents should already be up to date
+     */
+    void UpdateTransforms(const Entity* entities, std::size_t count);
     Position3dManager position3DManager_;
     Scale3dManager scale3DManager_;
     Rotation3dManager rotation3DManager_;
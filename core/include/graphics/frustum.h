@@ -0,0 +1,146 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "graphics/camera.h"
+#include "mathematics/aabb.h"
+#include "mathematics/circle.h"
+#include "mathematics/vector_nvec.h"
+
+namespace neko
+{
+class JobSystem;
+
+/**
+ * \brief Plane defined by normal.Dot(point) + distance = 0, the normal points inside the frustum
+ */
+struct Plane
+{
+    Vec3f normal = Vec3f::up;
+    float distance = 0.0f;
+
+    [[nodiscard]] float SignedDistance(const Vec3f& point) const
+    {
+        return Vec3f::Dot(normal, point) + distance;
+    }
+};
+
+struct Frustum
+{
+    enum PlaneIndex : std::uint8_t
+    {
+        LEFT_PLANE = 0,
+        RIGHT_PLANE,
+        BOTTOM_PLANE,
+        TOP_PLANE,
+        NEAR_PLANE,
+        FAR_PLANE,
+        LENGTH
+    };
+    std::array<Plane, LENGTH> planes;
+    /**
+     * \brief Extract the normalized planes from a projection * view matrix (Gribb-Hartmann)
+     */
+    static Frustum FromMatrix(const Mat4f& viewProjection);
+    static Frustum FromCamera(const Camera3D& camera);
+
+    [[nodiscard]] bool ContainsSphere(const Sphere& sphere) const;
+    /**
+     * \brief Conservative test, some boxes near the frustum corners are kept
+     */
+    [[nodiscard]] bool IntersectAabb(const Aabb3d& aabb) const;
+};
+
+constexpr std::size_t CULLING_PACK_SIZE = 8;
+/**
+ * \brief Bounding spheres stored in SoA packs of 8 for the AVX culling
+ */
+struct BoundingSpheres
+{
+    std::vector<EightVec3f> centers;
+    std::vector<std::array<float, CULLING_PACK_SIZE>> radii;
+    std::size_t size = 0;
+
+    void Resize(std::size_t newSize);
+    void Set(std::size_t index, const Sphere& sphere);
+};
+
+/**
+ * \brief Axis aligned bounding boxes stored as center and extends in SoA packs of 8 for the AVX culling
+ */
+struct BoundingBoxes
+{
+    std::vector<EightVec3f> centers;
+    std::vector<EightVec3f> extends;
+    std::size_t size = 0;
+
+    void Resize(std::size_t newSize);
+    void Set(std::size_t index, const Aabb3d& aabb);
+};
+
+/**
+ * \brief Write the indices of the visible bounds of [beginPack, endPack) in visibleIndices, in increasing order
+ * \return the number of written indices
+ */
+std::size_t CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres,
+                        std::size_t beginPack, std::size_t endPack, std::uint32_t* visibleIndices);
+std::size_t CullBoxes(const Frustum& frustum, const BoundingBoxes& boxes,
+                      std::size_t beginPack, std::size_t endPack, std::uint32_t* visibleIndices);
+
+/**
+ * \brief Culls the bounds in chunks on the job system and outputs the compact list of visible indices,
+ * ready to fill the render queue or the instanced batches
+ */
+class FrustumCuller
+{
+public:
+    /**
+     * \param grainSize number of bounds culled by one job, rounded to a multiple of CULLING_PACK_SIZE
+     */
+    explicit FrustumCuller(std::size_t grainSize = 16'384);
+    /**
+     * \brief Use the job system of the engine, or cull on the caller thread without engine
+     */
+    const std::vector<std::uint32_t>& Cull(const Frustum& frustum, const BoundingSpheres& spheres);
+    const std::vector<std::uint32_t>& Cull(const Frustum& frustum, const BoundingBoxes& boxes);
+    const std::vector<std::uint32_t>& Cull(const Frustum& frustum, const BoundingSpheres& spheres,
+                                           JobSystem& jobSystem);
+    const std::vector<std::uint32_t>& Cull(const Frustum& frustum, const BoundingBoxes& boxes,
+                                           JobSystem& jobSystem);
+
+    [[nodiscard]] const std::vector<std::uint32_t>& GetVisibleIndices() const { return visibleIndices_; }
+private:
+    template<typename Bounds, typename CullFunc>
+    const std::vector<std::uint32_t>& CullChunks(const Frustum& frustum, const Bounds& bounds,
+                                           JobSystem* jobSystem, CullFunc cullFunc);
+
+    std::size_t grainPacks_;
+    std::vector<std::uint32_t> visibleIndices_;
+    std::vector<std::size_t> chunkVisibleNmb_;
+};
+}
@@ -32,6 +32,7 @@
 #include "engine/system.h"
 #include "engine/log.h"
 #include "engine/jobsystem.h"
+#include "graphics/render_queue.h"
 #include "utilities/action_utility.h"
 
 namespace neko
@@ -39,6 +40,9 @@ namespace neko
 class SyncBuffersInterface;
 class Job;
 	class Window;
+/**
+ * \brief Initial capacity of the render queues, they grow when a frame submits more commands
+ */
 const size_t MAX_COMMAND_NMB = 8'192;
 
 
@@ -67,6 +71,7 @@ class RendererInterface
 {
 public:
     virtual void Render(RenderCommandInterface* command) = 0;
+    virtual void Render(RenderCommandInterface* command, RenderSortKey key) = 0;
     virtual void AddPreRenderJob(Job* job) = 0;
     virtual void RegisterSyncBuffersFunction(SyncBuffersInterface* syncBuffersInterface) = 0;
 };
@@ -75,13 +80,15 @@ class NullRenderer final : public RendererInterface
 {
 public:
     void Render([[maybe_unused]]RenderCommandInterface* command) override
+    {};
+    void Render([[maybe_unused]]RenderCommandInterface* command, [[maybe_unused]]RenderSortKey key) override
     {};
 	void AddPreRenderJob([[maybe_unused]] Job* job) override {}
     void RegisterSyncBuffersFunction([[maybe_unused]] SyncBuffersInterface* syncBuffersInterface) override {}
 
 };
 
-class Renderer : public RendererInterface
+class Renderer : public RendererInterface, public DrawImGuiInterface
 {
 public:
     enum RendererFlag : std::uint8_t
@@ -97,9 +104,15 @@ public:
     virtual ~Renderer() = default;
 
     /**
-     * \brief Send the RenderCommand to the queue for next frame
+     * \brief Send the RenderCommand to the queue for next frame, with a zero sort key so that
+     * these commands are rendered first, in submission order
      */
     void Render(RenderCommandInterface* command) override;
+    /**
+     * \brief Send the RenderCommand to the queue for next frame, sorted by key with the other commands.
+     * Lock-free, can be called from several job threads.
+     */
+    void Render(RenderCommandInterface* command, RenderSortKey key) override;
 
 
 
@@ -110,6 +123,10 @@ public:
     void SetWindow(Window* window);
 
 	void AddPreRenderJob(Job* job) override;
+    /**
+     * \brief Set the time spent each frame on the pre render jobs, like the texture and mesh uploads
+     */
+    void SetPreRenderBudget(microseconds preRenderBudget) { preRenderBudget_ = preRenderBudget; }
 
     virtual void ClearScreen() = 0;
 
@@ -118,17 +135,38 @@ public:
     Job* GetSyncJob() { return &syncJob_; }
     Job* GetRenderAllJob() { return &renderAllJob_; }
     void ScheduleJobs();
+    /**
+     * \brief Sync the buffers on the calling main thread and schedule the render job, used when the next frame
+     * update overlaps the previous frame buffer swap. The previous render job needs to be done.
+     */
+    void SchedulePipelinedJobs();
     void RegisterSyncBuffersFunction([[maybe_unused]] SyncBuffersInterface* syncBuffersInterface) override;
+    /**
+     * \brief Called in the engine ImGui window on the render thread, to show the renderer statistics
+     */
+    void DrawImGui() override {}
 protected:
     /**
 	 * \brief Called from Engine Loop to sync with the Render Loop
 	 */
     void SyncBuffers();
 	/**
-	 * \brief Run the first job in the queue
+	 * \brief Run the queued pre render jobs in order, until the pre render budget is spent
 	 */
     void PreRender();
+    /**
+     * \brief Sort the commands of the frame and render them, binding the shader and texture of their key
+     * only when they change
+     */
     virtual void RenderAll();
+    /**
+     * \brief Called by RenderAll when the next command has a different shader program in its key
+     */
+    virtual void BindShader([[maybe_unused]] std::uint32_t shader) {}
+    /**
+     * \brief Called by RenderAll when the next command has a different texture in its key
+     */
+    virtual void BindTexture([[maybe_unused]] std::uint32_t texture) {}
     virtual void BeforeRenderLoop();
 
     virtual void AfterRenderLoop();
@@ -140,6 +178,7 @@ protected:
 
     std::mutex preRenderJobsMutex_;
     std::vector<Job*> preRenderJobs_;
+    microseconds preRenderBudget_{8'000};
 
 
     Window* window_ = nullptr;
@@ -147,8 +186,9 @@ protected:
     mutable std::mutex statusMutex_;
     std::uint8_t flags_{IS_RENDERING_UI};
 	
-    std::vector<RenderCommandInterface*> currentCommandBuffer_ = {};
-    std::vector<RenderCommandInterface*> nextCommandBuffer_ = {};
+    std::array<RenderQueue, 2> commandQueues_{RenderQueue(MAX_COMMAND_NMB), RenderQueue(MAX_COMMAND_NMB)};
+    RenderQueue* currentCommandQueue_ = &commandQueues_[0];
+    RenderQueue* nextCommandQueue_ = &commandQueues_[1];
 };
 
 using RendererLocator = Locator<RendererInterface, NullRenderer>;
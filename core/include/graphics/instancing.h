@@ -0,0 +1,112 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "engine/component.h"
+#include "engine/entity.h"
+#include "graphics/graphics.h"
+#include "mathematics/matrix.h"
+
+namespace neko
+{
+class EntityManager;
+class Transform3dManager;
+
+using InstancedBatchId = std::uint32_t;
+const InstancedBatchId INVALID_INSTANCED_BATCH_ID = std::numeric_limits<InstancedBatchId>::max();
+
+/**
+ * \brief Identifies what an instanced batch draws, entities sharing the same key end up in the same draw call
+ */
+struct InstancedBatchKey
+{
+    std::uint32_t mesh = 0;
+    std::uint32_t shader = 0;
+    std::uint32_t material = 0;
+
+    bool operator==(const InstancedBatchKey& other) const
+    {
+        return mesh == other.mesh && shader == other.shader && material == other.material;
+    }
+};
+
+/**
+ * \brief Double buffered render system that groups the entities sharing the same mesh and material,
+ * the implementation draws each group with one instanced draw call using the transforms of the current buffer
+ * of the Transform3dManager.
+ * Batches and instances are modified on the main thread, the render thread only sees them after SyncBuffers.
+ * Destroyed entities are removed from their batch.
+ */
+class InstancedBatchRenderer : public RenderProgram, public SyncBuffersInterface, public OnDestroyEntityInterface
+{
+public:
+    InstancedBatchRenderer(EntityManager& entityManager, Transform3dManager& transformManager);
+
+    void Init() override;
+    void Update(seconds dt) override;
+    void Destroy() override;
+    /**
+     * \brief Return the batch with this key, creating it if it does not exist yet
+     */
+    InstancedBatchId GetBatch(const InstancedBatchKey& key);
+    /**
+     * \brief Add the entity to the batch, moving it out of its previous batch if needed
+     */
+    void AddInstance(Entity entity, InstancedBatchId batchId);
+    void RemoveInstance(Entity entity);
+    void OnDestroyEntity(Entity entity) override;
+
+    [[nodiscard]] std::size_t GetBatchesNmb() const { return batches_.size(); }
+    [[nodiscard]] std::size_t GetInstancesNmb(InstancedBatchId batchId) const;
+    [[nodiscard]] InstancedBatchId GetInstanceBatch(Entity entity) const;
+    /**
+     * \brief Called by the Renderer between two frames, only copies the batches that changed
+     */
+    void SyncBuffers() override;
+    /**
+     * \brief Copy the model matrices of the synced batch into dst (which needs room for all its instances),
+     * should be called on the render thread
+     * \return the number of copied model matrices
+     */
+    std::size_t CopyInstanceTransforms(InstancedBatchId batchId, Mat4f* dst) const;
+protected:
+    struct Batch
+    {
+        InstancedBatchKey key;
+        std::vector<Entity> entities;
+        bool dirty = false;
+    };
+    Transform3dManager& transformManager_;
+    //Modified on the main thread
+    std::vector<Batch> batches_;
+    std::vector<InstancedBatchId> entityBatches_;
+    std::vector<std::uint32_t> entityIndices_;
+    //Read on the render thread
+    std::vector<std::vector<Entity>> renderBatches_;
+};
+}
@@ -72,7 +72,8 @@ public:
 	void Update([[maybe_unused]] seconds dt) override 
 	{
 		auto& renderer = RendererLocator::get();
-		renderer.Render(this);
+		//Debug lines are drawn over the scene
+		renderer.Render(this, render_key::MakeKey(render_key::OVERLAY_PASS, 0, 0, 0));
 	}
 	void Destroy() override
 	{
@@ -0,0 +1,134 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace neko
+{
+class RenderCommandInterface;
+
+/**
+ * \brief 64 bits sort key of a render command, from the most to the least significant bits:
+ * pass (4), shader program (12), material (12), texture (16), depth (20).
+ * Commands are executed in increasing key order, commands with the same key in submission order.
+ */
+using RenderSortKey = std::uint64_t;
+
+namespace render_key
+{
+const std::uint32_t PASS_BITS = 4;
+const std::uint32_t SHADER_BITS = 12;
+const std::uint32_t MATERIAL_BITS = 12;
+const std::uint32_t TEXTURE_BITS = 16;
+const std::uint32_t DEPTH_BITS = 20;
+
+const std::uint32_t DEPTH_SHIFT = 0;
+const std::uint32_t TEXTURE_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+const std::uint32_t MATERIAL_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+const std::uint32_t SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+const std::uint32_t PASS_SHIFT = SHADER_SHIFT + SHADER_BITS;
+
+/**
+ * \brief Render passes in execution order. The commands submitted without a key are in the
+ * default pass and are rendered first, in submission order.
+ */
+enum RenderPass : std::uint32_t
+{
+    DEFAULT_PASS = 0,
+    OPAQUE_PASS,
+    TRANSPARENT_PASS,
+    OVERLAY_PASS
+};
+
+/**
+ * \brief Shader program and texture are the graphics API names, 0 means the command binds them itself.
+ * Depth is a normalized value between 0 and 1, use 1 - depth to sort back to front.
+ */
+RenderSortKey MakeKey(std::uint32_t pass, std::uint32_t shader, std::uint32_t material, std::uint32_t texture,
+                      float depth = 0.0f);
+
+inline std::uint32_t GetPass(RenderSortKey key)
+{ return std::uint32_t(key >> PASS_SHIFT) & ((1u << PASS_BITS) - 1u); }
+
+inline std::uint32_t GetShader(RenderSortKey key)
+{ return std::uint32_t(key >> SHADER_SHIFT) & ((1u << SHADER_BITS) - 1u); }
+
+inline std::uint32_t GetMaterial(RenderSortKey key)
+{ return std::uint32_t(key >> MATERIAL_SHIFT) & ((1u << MATERIAL_BITS) - 1u); }
+
+inline std::uint32_t GetTexture(RenderSortKey key)
+{ return std::uint32_t(key >> TEXTURE_SHIFT) & ((1u << TEXTURE_BITS) - 1u); }
+
+inline std::uint32_t GetDepth(RenderSortKey key)
+{ return std::uint32_t(key >> DEPTH_SHIFT) & ((1u << DEPTH_BITS) - 1u); }
+}
+
+struct RenderCommand
+{
+    RenderSortKey key = 0;
+    RenderCommandInterface* command = nullptr;
+};
+
+/**
+ * \brief Queue of render commands, filled concurrently without lock and sorted by key before execution.
+ * Pushing and sorting should not overlap, the engine frame jobs give that ordering.
+ * The capacity only grows in Clear, the commands pushed over it during a frame are dropped.
+ */
+class RenderQueue
+{
+public:
+    explicit RenderQueue(std::size_t capacity);
+
+    /**
+     * \brief Lock-free, can be called from several threads at the same time.
+     * The command is dropped when the queue is full, the next Clear grows the queue to fit it.
+     */
+    void Push(RenderCommandInterface* command, RenderSortKey key);
+    /**
+     * \brief Grow the queue to hold at least capacity commands, must not overlap with Push
+     */
+    void Reserve(std::size_t capacity);
+    /**
+     * \brief Stable radix sort of the commands by key, skipping the key bytes shared by all the commands
+     */
+    void Sort();
+    void Clear();
+
+    [[nodiscard]] std::size_t Size() const;
+    [[nodiscard]] std::size_t Capacity() const { return commands_.size(); }
+    [[nodiscard]] std::size_t GetDroppedCommandsNmb() const
+    { return droppedCommandsNmb_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] const RenderCommand* begin() const { return commands_.data(); }
+    [[nodiscard]] const RenderCommand* end() const { return commands_.data() + Size(); }
+private:
+    std::vector<RenderCommand> commands_;
+    std::vector<RenderCommand> sortBuffer_;
+    std::atomic<std::size_t> commandsNmb_{0};
+    std::atomic<std::size_t> droppedCommandsNmb_{0};
+};
+}
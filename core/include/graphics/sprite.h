@@ -22,10 +22,14 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
+#include <unordered_map>
+#include <vector>
+
 #include <engine/component.h>
 #include "engine/system.h"
 #include "graphics/graphics.h"
 #include "graphics/texture.h"
+#include "graphics/texture_atlas.h"
 #include "graphics/color.h"
 
 namespace neko
@@ -39,12 +43,59 @@ struct Sprite
     Color4 color = Color4(Color::white, 1.0f);
     TextureId textureId = INVALID_TEXTURE_ID;
     Texture texture{};
+    /**
+     * \brief Sprites are drawn by increasing layer
+     */
+    int layer = 0;
+};
+
+using SpriteAtlasIndex = std::uint32_t;
+const SpriteAtlasIndex INVALID_SPRITE_ATLAS = std::numeric_limits<SpriteAtlasIndex>::max();
+
+/**
+ * \brief Where a sprite texture is packed, textures that do not fit in an atlas keep
+ * an INVALID_SPRITE_ATLAS index and are drawn from their own texture
+ */
+struct SpriteAtlasRegion
+{
+    TextureId textureId = INVALID_TEXTURE_ID;
+    TextureName texture = INVALID_TEXTURE_NAME;
+    SpriteAtlasIndex atlasIndex = INVALID_SPRITE_ATLAS;
+    Vec2i position{};
+    Vec2i size{};
+    Vec2f uvMin{};
+    Vec2f uvMax = Vec2f::one;
+};
+
+struct SpriteVertex
+{
+    Vec3f position;
+    Vec2f texCoords;
+    Color4 color;
 };
 
+/**
+ * \brief Consecutive sprites of the vertex stream sharing the same layer and atlas, drawn with one draw call
+ */
+struct SpriteBatch
+{
+    int layer = 0;
+    SpriteAtlasIndex atlasIndex = INVALID_SPRITE_ATLAS;
+    TextureName texture = INVALID_TEXTURE_NAME;
+    std::uint32_t firstSprite = 0;
+    std::uint32_t spritesNmb = 0;
+};
+
+/**
+ * \brief Packs the sprite textures into atlases and builds on the main thread the vertex stream
+ * of all the sprites sorted by layer and atlas. The render thread gets it after SyncBuffers
+ * and draws each SpriteBatch with one draw call.
+ */
 class SpriteManager :
 	public ComponentManager<Sprite, EntityMask(ComponentType::SPRITE2D)>,
 	public SystemInterface,
-	public RenderCommandInterface
+	public RenderCommandInterface,
+	public SyncBuffersInterface
 {
 public:
     explicit SpriteManager(
@@ -56,10 +107,50 @@ public:
 	transformManager_(transformManager)
 	{}
 
+    static constexpr int ATLAS_SIZE = 2048;
+    /**
+     * \brief Border around each packed texture, filled with its edge texels so linear filtering
+     * does not bleed the neighbouring sprites
+     */
+    static constexpr int ATLAS_PADDING = 2;
+
 	void Update(seconds dt) override;
 	void SetTexture(Entity entity, TextureId textureId);
+    void SyncBuffers() override;
+
+    [[nodiscard]] std::size_t GetSpritesNmb() const { return currentFrame_.vertices.size() / 4; }
+    [[nodiscard]] std::size_t GetBatchesNmb() const { return currentFrame_.batches.size(); }
 protected:
+    struct SpriteFrame
+    {
+        std::vector<SpriteVertex> vertices;
+        std::vector<SpriteBatch> batches;
+    };
+    /**
+     * \brief Pack the texture in the first atlas with enough room, the copy is done on the render thread.
+     * Only plain RGBA8 textures are packed, the atlases would lose the sRGB and compressed formats.
+     */
+    const SpriteAtlasRegion& GetAtlasRegion(TextureId textureId, const Texture& texture);
+    void BuildSpriteBatches();
+
     TextureManager& textureManager_;
     Transform2dManager& transformManager_;
+
+    //Main thread
+    /**
+     * \brief Keyed by TextureId, the driver gives the names of destroyed textures to new ones
+     */
+    std::unordered_map<TextureId, SpriteAtlasRegion> atlasRegions_;
+    std::vector<AtlasPacker> atlasPackers_;
+    std::vector<SpriteAtlasRegion> newAtlasRegions_;
+    std::vector<std::pair<std::uint64_t, Entity>> sortedSprites_;
+    SpriteFrame currentFrame_;
+    //Render thread
+    SpriteFrame renderFrame_;
+    std::vector<SpriteAtlasRegion> atlasRegionsToCopy_;
+    /**
+     * \brief Textures the render thread could not copy, drawn from their own texture after the next sync
+     */
+    std::vector<TextureId> failedAtlasCopies_;
 };
 }
\ No newline at end of file
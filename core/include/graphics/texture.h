@@ -24,12 +24,17 @@
  */
 #include <queue>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "engine/assert.h"
 #include <engine/log.h>
 #include <engine/resource.h>
 #include <xxhash.hpp>
 #include <sole.hpp>
 #include <utilities/service_locator.h>
+#include <utilities/time_utility.h>
 
 namespace neko
 {
@@ -64,6 +69,35 @@ struct Image
 
 Image StbImageConvert(const BufferFile& imageFile, bool flipY=false, bool hdr = false);
 
+/**
+ * \brief Mip level of a cached texture, pointing into the cache file
+ */
+struct TextureLevel
+{
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+    int width = 0, height = 0;
+};
+
+/**
+ * \brief Pre-decoded texture with its mip chain read from the texture cache, the formats are the OpenGL values
+ */
+struct CachedTexture
+{
+    BufferFile file;
+    std::uint32_t glInternalFormat = 0;
+    /**
+     * \brief Zero for the compressed formats, as in KTX
+     */
+    std::uint32_t glFormat = 0;
+    std::uint32_t glType = 0;
+    std::vector<TextureLevel> levels;
+
+    [[nodiscard]] bool IsCompressed() const { return glFormat == 0; }
+    [[nodiscard]] std::size_t GetDataSize() const;
+    void Destroy();
+};
+
 /**
  * \brief Result from Texture Manager functions: LoadTexture and GetTexture
  */
@@ -84,6 +118,10 @@ struct Texture
     };
     TextureName name = INVALID_TEXTURE_NAME;
     Vec2i size;
+    /**
+     * \brief Stored as plain 8 bits RGBA, not sRGB, HDR or compressed, so it can be copied into a sprite atlas
+     */
+    bool isRgba8 = false;
 };
 
 class TextureManagerInterface
@@ -114,7 +152,65 @@ public:
 };
 
 class TextureManager;
+
+/**
+ * \brief Number of textures read from disk and decoded in parallel
+ */
+const std::size_t TEXTURE_LOADERS_NMB = 8;
+/**
+ * \brief Default amount of image data uploaded to the GPU per frame, at least one texture is uploaded
+ */
+const std::size_t DEFAULT_TEXTURE_UPLOAD_BUDGET = 16u * 1024u * 1024u;
+
+struct TextureInfo
+{
+	TextureInfo() = default;
+	~TextureInfo() = default;
+    TextureInfo(TextureInfo&& image) noexcept = default;
+    TextureInfo& operator=(TextureInfo&& image) noexcept = default;
+    TextureInfo(const TextureInfo&) = delete;
+    TextureInfo& operator= (const TextureInfo&) = delete;
 	
+    TextureId textureId = INVALID_TEXTURE_ID;
+    Image image;
+    /**
+     * \brief Uploaded instead of the image when it has levels
+     */
+    CachedTexture cachedTexture;
+    Texture::TextureFlags flags = Texture::DEFAULT;
+    bool isCacheHit = false;
+    /**
+     * \brief Time from the start of the disk load to the start of the image conversion
+     */
+    microseconds readDuration{0};
+    microseconds decodeDuration{0};
+};
+
+/**
+ * \brief Texture loading timings, the durations of the textures loaded in parallel add up
+ */
+struct TextureLoadMetrics
+{
+    std::size_t requestedNmb = 0;
+    std::size_t uploadedNmb = 0;
+    std::size_t uploadedBytes = 0;
+    /**
+     * \brief Textures read from the texture cache instead of being decoded
+     */
+    std::size_t cacheHitsNmb = 0;
+    microseconds readDuration{0};
+    microseconds decodeDuration{0};
+    microseconds uploadDuration{0};
+    /**
+     * \brief Wall time from the first request until all the requested textures were uploaded, for the last batch
+     */
+    microseconds lastBatchDuration{0};
+    /**
+     * \brief Sum of the wall time of all the batches
+     */
+    microseconds batchesDuration{0};
+};
+
 class TextureLoader
 {
 public:
@@ -136,6 +232,10 @@ public:
     {
         return textureId_ != INVALID_TEXTURE_ID && diskLoadJob_.HasStarted();
     }
+    /**
+     * \brief A loader is free when it never loaded a texture or when its texture was pushed to the upload queue
+     */
+    [[nodiscard]] bool IsFree() const { return textureId_ == INVALID_TEXTURE_ID || IsLoaded(); }
     void Reset();
 private:
     TextureManager& textureManager_;
@@ -144,20 +244,12 @@ private:
     ResourceJob diskLoadJob_;
     Image image_;
     TextureId textureId_ = INVALID_TEXTURE_ID;
-};
-
-struct TextureInfo
-{
-	TextureInfo() = default;
-	~TextureInfo() = default;
-    TextureInfo(TextureInfo&& image) noexcept = default;
-    TextureInfo& operator=(TextureInfo&& image) noexcept = default;
-    TextureInfo(const TextureInfo&) = delete;
-    TextureInfo& operator= (const TextureInfo&) = delete;
-	
-    TextureId textureId = INVALID_TEXTURE_ID;
-    Image image;
-    Texture::TextureFlags flags = Texture::DEFAULT;
+    std::string sourcePath_;
+    /**
+     * \brief The disk load job reads the cached texture instead of the source image
+     */
+    bool isCacheRead_ = false;
+    std::chrono::steady_clock::time_point loadStart_;
 };
 
 class TextureManager : public TextureManagerInterface, public SystemInterface
@@ -171,9 +263,15 @@ public:
     TextureId LoadTexture(std::string_view path, Texture::TextureFlags flags = Texture::DEFAULT) override;
     std::string GetPath(TextureId textureId) const;
     void Init() override;
+    /**
+     * \brief Start the queued textures on the free loaders and schedule the upload job on the renderer pre render
+     */
 	void Update(seconds dt) override;
 	
     void Destroy() override;
+    /**
+     * \brief Called by the loaders from the job threads when a texture is converted
+     */
     virtual void UploadToGpu(TextureInfo&& texture);
     /**
      * \brief When the loading texture with the TextureId is uploaded to the GPU, the returned Texture
@@ -181,18 +279,60 @@ public:
      */
 	Texture GetTexture(TextureId index) const override;
 	bool IsTextureLoaded(TextureId textureId) const override;
+    /**
+     * \brief Set the amount of image data in bytes uploaded to the GPU per frame
+     */
+    void SetUploadBudget(std::size_t uploadBudget) { uploadBudget_ = uploadBudget; }
+    [[nodiscard]] TextureLoadMetrics GetLoadMetrics() const;
+    /**
+     * \brief Folder of the cached textures named by TextureId, empty to always decode the source images.
+     * Set by Init from the engine configuration when it was not set before.
+     */
+    void SetCacheFolder(std::string_view cacheFolder) { cacheFolder_ = cacheFolder; }
+    [[nodiscard]] const std::string& GetCacheFolder() const { return cacheFolder_; }
+    /**
+     * \brief Empty when the cache is disabled
+     */
+    [[nodiscard]] std::string GetCachePath(TextureId textureId) const;
+    /**
+     * \brief Write the decoded textures missing from the cache, not possible in the read-only Android assets
+     */
+    [[nodiscard]] bool IsCacheWritable() const { return isCacheWritable_; }
 protected:
 	/**
-	 * \brief Called on the renderer pre render
+	 * \brief Called on the renderer pre render for each uploaded texture, with currentUploadedTexture_ set
 	 */
     virtual void CreateTexture() = 0;
+    /**
+     * \brief Upload the converted textures that fit in the upload budget of the frame, at least one per frame
+     */
+    void UploadTextures();
     std::map<TextureId, std::string> texturePathMap_;
+    /**
+     * \brief Written on the render thread by CreateTexture, read by GetTexture on the other threads
+     */
     std::map<TextureId, Texture> textureMap_;
+    mutable std::mutex textureMapMutex_;
     std::queue<TextureInfo> texturesToLoad_;
     std::queue<TextureInfo> texturesToUpload_;
-    TextureLoader textureLoader_;
+    std::mutex uploadMutex_;
+    std::vector<std::unique_ptr<TextureLoader>> textureLoaders_;
     TextureInfo currentUploadedTexture_;
     Job uploadToGpuJob_;
+    bool isUploadScheduled_ = false;
+    std::size_t uploadBudget_ = DEFAULT_TEXTURE_UPLOAD_BUDGET;
+
+    mutable std::mutex metricsMutex_;
+    TextureLoadMetrics metrics_;
+    std::size_t pendingTexturesNmb_ = 0;
+    std::chrono::steady_clock::time_point batchStart_;
+
+    std::string cacheFolder_;
+#if defined(__ANDROID__) || defined(EMSCRIPTEN)
+    bool isCacheWritable_ = false;
+#else
+    bool isCacheWritable_ = true;
+#endif
 };
 using TextureManagerLocator = Locator<TextureManagerInterface, NullTextureManager>;
 
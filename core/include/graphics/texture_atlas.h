@@ -0,0 +1,57 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <vector>
+
+#include "mathematics/vector.h"
+
+namespace neko
+{
+/**
+ * \brief Shelf packer placing rectangles in a fixed size atlas, used to pack the sprite textures
+ */
+class AtlasPacker
+{
+public:
+    explicit AtlasPacker(Vec2i size, int padding = 1);
+    /**
+     * \brief Find room for a rectangle of size rectSize
+     * \return false if the rectangle does not fit in the atlas anymore
+     */
+    bool Insert(Vec2i rectSize, Vec2i& position);
+    void Clear();
+    [[nodiscard]] Vec2i GetSize() const { return size_; }
+private:
+    struct Shelf
+    {
+        int y = 0;
+        int height = 0;
+        int width = 0;
+    };
+    Vec2i size_;
+    int padding_ = 1;
+    std::vector<Shelf> shelves_;
+};
+}
@@ -0,0 +1,57 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <string>
+#include <string_view>
+
+#include "graphics/texture.h"
+
+namespace neko
+{
+const std::string_view TEXTURE_CACHE_EXTENSION = ".ktx";
+/**
+ * \brief Key of the KTX key/value data holding the stamp of the source image
+ */
+const std::string_view TEXTURE_CACHE_STAMP_KEY = "NekoSourceStamp";
+
+/**
+ * \brief Identify the source image and the flags changing the cached data, a cached texture with another stamp
+ * is decoded again
+ */
+std::string GetTextureCacheStamp(std::string_view sourcePath, Texture::TextureFlags flags);
+
+/**
+ * \brief Build a KTX 1.1 file with the image and, with MIPMAPS_TEXTURE, its mip chain box filtered on the CPU.
+ * sRGB images are filtered in linear space, HDR images are float images.
+ */
+BufferFile WriteTextureCache(const Image& image, Texture::TextureFlags flags, std::string_view stamp);
+
+/**
+ * \brief Read a KTX 1.1 file written by WriteTextureCache or by an offline tool, the levels point into the file.
+ * Files with another stamp, array, cube and 3d textures, and the compressed formats other than ETC1/ETC2/EAC
+ * (core in OpenGL ES 3.0) are rejected. Files without stamp are used as they are.
+ */
+bool ReadTextureCache(BufferFile&& file, std::string_view stamp, CachedTexture& cachedTexture);
+}
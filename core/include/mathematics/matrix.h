@@ -122,16 +122,10 @@ public:
 		columns_ = Identity.columns_;
 	}
 
-	Mat4& operator=(Mat4 m)
-	{
-		columns_ = m.columns_;
-		return *this;
-	}
+	//Defaulted to keep Mat4 trivially copyable, so arrays of matrices can be memcpy'd
+	Mat4& operator=(const Mat4& m) = default;
 
-	Mat4(const Mat4 & m) noexcept
-	{
-		columns_ = m.columns_;
-	}
+	Mat4(const Mat4 & m) noexcept = default;
 
 	explicit Mat4(const std::array<Vec4 < T>, 4> & v)
 	{
@@ -23,7 +23,9 @@
  SOFTWARE.
  */
 #include <engine/component.h>
+#include <algorithm>
 #include <mathematics/vector.h>
+#include "mathematics/vector_nvec.h"
 #include "mathematics/trigo.h"
 
 
@@ -154,6 +156,68 @@ struct Quaternion
 		);
 	}
 
+	/*
+	Returns the euler angles that give this rotation with FromEuler,
+	the y angle is kept between -90 and 90 degrees
+	*/
+	static EulerAngles ToEuler(const Quaternion& quaternion)
+	{
+		//FromEuler stores the scalar part in x and the z, x, y rotations in y, z, w
+		const float qw = quaternion.x;
+		const float qx = quaternion.y;
+		const float qy = quaternion.z;
+		const float qz = quaternion.w;
+		const radian_t angleZ = Atan2(2.0f * (qw * qx + qy * qz), 1.0f - 2.0f * (qx * qx + qy * qy));
+		const radian_t angleY = Asin(std::clamp(2.0f * (qw * qy - qz * qx), -1.0f, 1.0f));
+		const radian_t angleX = Atan2(2.0f * (qw * qz + qx * qy), 1.0f - 2.0f * (qy * qy + qz * qz));
+		return EulerAngles(angleX, angleY, angleZ);
+	}
+
+	//Normalized linear interpolation between two rotations, taking the shortest path.
+	static Quaternion Nlerp(Quaternion a, Quaternion b, float t)
+	{
+		if (Dot(a, b) < 0.0f)
+		{
+			b = b * -1.0f;
+		}
+		return Normalized(a * (1.0f - t) + b * t);
+	}
+
+	//Spherical linear interpolation between two rotations, taking the shortest path.
+	static Quaternion Slerp(Quaternion a, Quaternion b, float t)
+	{
+		float cosTheta = Dot(a, b);
+		if (cosTheta < 0.0f)
+		{
+			b = b * -1.0f;
+			cosTheta = -cosTheta;
+		}
+		//Almost the same rotations, sin(theta) is too small to divide by
+		if (cosTheta > slerpThreshold)
+		{
+			return Nlerp(a, b, t);
+		}
+		const float theta = std::acos(cosTheta);
+		const float sinTheta = std::sin(theta);
+		return a * (std::sin((1.0f - t) * theta) / sinTheta) + b * (std::sin(t * theta) / sinTheta);
+	}
+
+	/**
+	 * \brief Nlerp four rotations at once, the quaternions are stored as x, y, z, w in the NVec4
+	 */
+	static FourVec4f Nlerp(const FourVec4f& a, const FourVec4f& b, float t);
+	static EightVec4f Nlerp(const EightVec4f& a, const EightVec4f& b, float t);
+	/**
+	 * \brief Slerp four rotations at once, the quaternions are stored as x, y, z, w in the NVec4
+	 */
+	static FourVec4f Slerp(const FourVec4f& a, const FourVec4f& b, float t);
+	static EightVec4f Slerp(const EightVec4f& a, const EightVec4f& b, float t);
+
+	/**
+	 * \brief Above this dot product, slerp falls back to nlerp
+	 */
+	static constexpr float slerpThreshold = 0.9995f;
+
 	static Quaternion Identity()
 	{
 		return Quaternion(0, 0, 0, 1);
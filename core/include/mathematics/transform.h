@@ -23,6 +23,7 @@
  SOFTWARE.
  */
 #include "mathematics/matrix.h"
+#include "mathematics/vector_nvec.h"
 
 
 namespace neko::Transform3d
@@ -54,6 +55,22 @@ Mat4f Rotate(const Mat4f& transform, const Quaternion& quaternion);
 
 Mat4f Rotate(const Mat4f& transform, const EulerAngles eulerAngles);
 
+/**
+ * \brief Compose four matrices at once, equal to Translate(Scale(Rotate(Identity, rotation), scale), position)
+ * without the 4x4 matrix multiplications. The rotations are unit quaternions.
+ */
+void ComposeTransforms(const FourVec3f& positions,
+                       const FourVec3f& scales,
+                       const FourVec4f& rotations,
+                       Mat4f* transforms);
+/**
+ * \brief Compose eight matrices at once, see the FourVec3f version
+ */
+void ComposeTransforms(const EightVec3f& positions,
+                       const EightVec3f& scales,
+                       const EightVec4f& rotations,
+                       Mat4f* transforms);
+
 
 Mat4f Perspective(radian_t fovy, float aspect, float near, float far);
 Mat4f Orthographic(float left, float right, float bottom, float top, float nearPlane = 0.0f, float farPlane = 100.0f);
@@ -0,0 +1,182 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <sole.hpp>
+
+#include "utilities/file_utility.h"
+#include "utilities/service_locator.h"
+
+namespace neko
+{
+/**
+ * \brief "NKPK" read as a little endian integer
+ */
+const std::uint32_t ASSET_ARCHIVE_MAGIC = 0x4B504B4Eu;
+const std::uint32_t ASSET_ARCHIVE_VERSION = 2;
+
+enum class AssetCompression : std::uint32_t
+{
+    NONE = 0,
+    ZSTD = 1
+};
+
+/**
+ * \brief Archive written by scripts/data_folder_generator.py --archive, all the values are little endian.
+ * The header is followed by the entries sorted by uuid, the string table with the paths and
+ * the pre-baked meta files, then the aligned blobs. Each blob is followed by at least one zero byte.
+ */
+struct AssetArchiveHeader
+{
+    std::uint32_t magic = ASSET_ARCHIVE_MAGIC;
+    std::uint32_t version = ASSET_ARCHIVE_VERSION;
+    std::uint32_t entriesNmb = 0;
+    std::uint32_t flags = 0;
+    std::uint64_t entriesOffset = 0;
+    std::uint64_t stringsOffset = 0;
+};
+static_assert(sizeof(AssetArchiveHeader) == 32);
+
+struct AssetArchiveEntry
+{
+    /**
+     * \brief Two halves of the asset uuid, as in sole::uuid
+     */
+    std::uint64_t uuidAb = 0;
+    std::uint64_t uuidCd = 0;
+    std::uint64_t offset = 0;
+    /**
+     * \brief Size of the blob stored in the archive
+     */
+    std::uint64_t size = 0;
+    /**
+     * \brief Size of the asset once decompressed
+     */
+    std::uint64_t originalSize = 0;
+    /**
+     * \brief Path relative to the data root, with forward slashes, in the string table
+     */
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+    /**
+     * \brief Content of the .meta json file of the asset, in the string table
+     */
+    std::uint32_t metaOffset = 0;
+    std::uint32_t metaLength = 0;
+    AssetCompression compression = AssetCompression::NONE;
+    /**
+     * \brief CRC-32 (zlib) of the asset once decompressed, identifies the content for the derived caches
+     */
+    std::uint32_t contentCrc = 0;
+};
+static_assert(sizeof(AssetArchiveEntry) == 64);
+
+class AssetArchiveInterface
+{
+public:
+    virtual ~AssetArchiveInterface() = default;
+    [[nodiscard]] virtual const AssetArchiveEntry* FindEntry(const sole::uuid& assetId) const = 0;
+    /**
+     * \brief Find an asset by its path, starting with the data root path given when opening the archive
+     */
+    [[nodiscard]] virtual const AssetArchiveEntry* FindEntry(std::string_view path) const = 0;
+    [[nodiscard]] virtual std::string_view GetPath(const AssetArchiveEntry& entry) const = 0;
+    [[nodiscard]] virtual std::string_view GetMeta(const AssetArchiveEntry& entry) const = 0;
+    /**
+     * \brief Uncompressed entries are views into the archive, compressed ones are decompressed to the heap
+     */
+    virtual bool LoadEntry(const AssetArchiveEntry& entry, BufferFile& bufferFile) const = 0;
+};
+
+class NullAssetArchive : public AssetArchiveInterface
+{
+public:
+    [[nodiscard]] const AssetArchiveEntry* FindEntry([[maybe_unused]] const sole::uuid& assetId) const override
+    {
+        return nullptr;
+    }
+    [[nodiscard]] const AssetArchiveEntry* FindEntry([[maybe_unused]] std::string_view path) const override
+    {
+        return nullptr;
+    }
+    [[nodiscard]] std::string_view GetPath([[maybe_unused]] const AssetArchiveEntry& entry) const override
+    {
+        return {};
+    }
+    [[nodiscard]] std::string_view GetMeta([[maybe_unused]] const AssetArchiveEntry& entry) const override
+    {
+        return {};
+    }
+    bool LoadEntry([[maybe_unused]] const AssetArchiveEntry& entry,
+                   [[maybe_unused]] BufferFile& bufferFile) const override
+    {
+        return false;
+    }
+};
+
+/**
+ * \brief Packed assets opened with a single file load, looked up by uuid or by path.
+ * Must stay open while the views returned by LoadEntry are used.
+ */
+class AssetArchive : public AssetArchiveInterface
+{
+public:
+    AssetArchive() = default;
+    ~AssetArchive() override;
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    /**
+     * \brief Load the archive and index its paths
+     * \param rootPath data root path removed from the paths given to FindEntry
+     */
+    bool Open(std::string_view archivePath, std::string_view rootPath);
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return entries_ != nullptr; }
+    [[nodiscard]] std::size_t GetEntriesNmb() const { return entriesNmb_; }
+
+    [[nodiscard]] const AssetArchiveEntry* FindEntry(const sole::uuid& assetId) const override;
+    [[nodiscard]] const AssetArchiveEntry* FindEntry(std::string_view path) const override;
+    [[nodiscard]] std::string_view GetPath(const AssetArchiveEntry& entry) const override;
+    [[nodiscard]] std::string_view GetMeta(const AssetArchiveEntry& entry) const override;
+    bool LoadEntry(const AssetArchiveEntry& entry, BufferFile& bufferFile) const override;
+private:
+    BufferFile archiveFile_;
+    const AssetArchiveEntry* entries_ = nullptr;
+    std::size_t entriesNmb_ = 0;
+    const char* strings_ = nullptr;
+    std::string rootPath_;
+    /**
+     * \brief The keys are views into the string table of the archive
+     */
+    std::unordered_map<std::string_view, std::size_t> pathIndices_;
+};
+
+using AssetArchiveLocator = Locator<AssetArchiveInterface, NullAssetArchive>;
+}
@@ -43,11 +43,36 @@ Java_swiss_sae_gpr5300_MainActivity_load(JNIEnv *env, [[maybe_unused]] jclass cl
 
 namespace neko
 {
+/**
+ * \brief Files smaller than this are read, mapping them costs more than the copy
+ */
+const size_t BUFFER_FILE_MAP_MIN_SIZE = 64u * 1024u;
+
 /**
  * \brief Non RAII structure, please Destroy it
  */
 struct BufferFile
 {
+    enum class LoadMode : std::uint8_t
+    {
+        /**
+         * \brief Copy the file into a heap buffer
+         */
+        READ,
+        /**
+         * \brief Map the file in memory when supported, reading it otherwise
+         */
+        MAP
+    };
+    enum class Storage : std::uint8_t
+    {
+        HEAP,
+        MAPPED,
+        /**
+         * \brief View into memory owned by someone else, like an asset archive
+         */
+        VIEW
+    };
     BufferFile() = default;
     ~BufferFile();
     BufferFile(BufferFile&& bufferFile) noexcept;
@@ -55,10 +80,18 @@ struct BufferFile
     BufferFile(const BufferFile&) = delete;
     BufferFile& operator= (const BufferFile&) = delete;
 
+    /**
+     * \brief Content of the file followed by a null character. A mapped file is a private copy-on-write view
+     * of the page cache, writing to it does not modify the file. A view must not be written.
+     */
     unsigned char* dataBuffer = nullptr;
     size_t dataLength = 0;
+    Storage storage = Storage::HEAP;
 
-    void Load(std::string_view path);
+    /**
+     * \brief Load the file from the mounted asset archive if it contains it, from the disk otherwise
+     */
+    void Load(std::string_view path, LoadMode loadMode = LoadMode::MAP);
     void Destroy();
 
 };
@@ -69,10 +102,19 @@ public:
     void SetFilePath(std::string_view path);
     std::string GetFilePath() const {return filePath_; }
     const BufferFile& GetBufferFile() const {return bufferFile_;}
+    /**
+     * \brief Move the loaded file out of the job, to keep it after the job is reset
+     */
+    BufferFile ReleaseBufferFile() { return std::move(bufferFile_); }
     void Reset() override;
 private:
+    friend class IoService;
     std::string filePath_;
     BufferFile bufferFile_;
+    /**
+     * \brief Set when an I/O service already read the file, the job then only releases its dependent jobs
+     */
+    bool isRead_ = false;
 };
 
 bool FileExists(const std::string_view filename);
@@ -84,12 +126,21 @@ bool IsDirectory(const std::string_view filename);
 void IterateDirectory(const std::string_view dirname, std::function<void(const std::string_view)> func, bool recursive=false);
 
 size_t CalculateFileSize(const std::string& filename);
+/**
+ * \brief Modification time of the file in an unspecified clock, zero when it is not known
+ */
+std::int64_t GetLastWriteTime(const std::string_view filename);
 
 std::string GetCurrentPath();
 
 bool CreateDirectory(const std::string_view dirname);
 
 bool RemoveDirectory(const std::string_view dirname, bool removeAll = true);
+/**
+ * \brief Move the file to newPath, replacing an existing file. On the same filesystem, readers see either
+ * the old or the new file, never a partial one.
+ */
+bool RenameFile(const std::string_view path, const std::string_view newPath);
 
 const std::string LoadFile(const std::string& path);
 
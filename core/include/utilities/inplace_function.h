@@ -0,0 +1,134 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "engine/assert.h"
+
+namespace neko
+{
+
+template<typename Signature, std::size_t Capacity>
+class InplaceFunction;
+
+/**
+ * \brief Move-only callable stored in a fixed inline buffer, it never allocates on the heap.
+ * The callable size is checked at compile time against the Capacity.
+ */
+template<typename R, typename ... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+    InplaceFunction() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+    InplaceFunction(F&& func)
+    {
+        using Callable = std::decay_t<F>;
+        static_assert(sizeof(Callable) <= Capacity, "Callable is too big for the InplaceFunction buffer");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable alignment is not supported");
+        new(&storage_) Callable(std::forward<F>(func));
+        invoke_ = [](void* storage, Args ... args) -> R
+        {
+            return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+        };
+        manage_ = [](void* dst, void* src)
+        {
+            auto* callable = static_cast<Callable*>(src);
+            if (dst != nullptr)
+            {
+                new(dst) Callable(std::move(*callable));
+            }
+            callable->~Callable();
+        };
+    }
+
+    ~InplaceFunction()
+    {
+        Clear();
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    InplaceFunction(InplaceFunction&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Clear();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    R operator()(Args ... args) const
+    {
+        neko_assert(invoke_ != nullptr, "Calling an empty InplaceFunction");
+        return invoke_(&storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+    void Clear()
+    {
+        if (manage_ != nullptr)
+        {
+            manage_(nullptr, &storage_);
+        }
+        invoke_ = nullptr;
+        manage_ = nullptr;
+    }
+
+private:
+    void MoveFrom(InplaceFunction& other)
+    {
+        if (other.manage_ != nullptr)
+        {
+            other.manage_(&storage_, &other.storage_);
+        }
+        invoke_ = other.invoke_;
+        manage_ = other.manage_;
+        other.invoke_ = nullptr;
+        other.manage_ = nullptr;
+    }
+
+    using InvokeFunc = R(*)(void*, Args...);
+    /**
+     * \brief Move the callable from src to dst and destroy src, only destroy src when dst is null
+     */
+    using ManageFunc = void(*)(void*, void*);
+
+    mutable std::aligned_storage_t<Capacity, alignof(std::max_align_t)> storage_;
+    InvokeFunc invoke_ = nullptr;
+    ManageFunc manage_ = nullptr;
+};
+
+}
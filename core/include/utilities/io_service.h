@@ -0,0 +1,140 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "utilities/file_utility.h"
+#include "utilities/service_locator.h"
+
+namespace neko
+{
+enum class IoBackend : std::uint8_t
+{
+    /**
+     * \brief No I/O service, the resource jobs are scheduled on the job threads
+     */
+    NONE,
+    THREAD_POOL,
+    /**
+     * \brief Linux only, falls back to the thread pool when the kernel refuses it or when the ring fails.
+     * It is the default because it is faster for cold loads, where the reads wait for the disk. Files in the
+     * page cache are only copied, and the hand-off to the I/O thread makes them slower than a serial loop
+     * (see bench_io).
+     */
+    IO_URING
+};
+
+/**
+ * \brief Maximum number of reads submitted to io_uring at the same time
+ */
+const std::size_t IO_QUEUE_DEPTH = 64;
+const std::size_t IO_THREAD_POOL_SIZE = 4;
+
+class IoServiceInterface
+{
+public:
+    virtual ~IoServiceInterface() = default;
+    /**
+     * \brief Read the file of the job in the background. The I/O service executes the job when the read is done,
+     * which releases the jobs depending on it.
+     * \return false when the job must be scheduled instead, like for the assets of the mounted archive
+     */
+    virtual bool Read(ResourceJob* job) = 0;
+};
+
+class NullIoService : public IoServiceInterface
+{
+public:
+    bool Read([[maybe_unused]] ResourceJob* job) override
+    {
+        return false;
+    }
+};
+
+struct IoRing;
+
+/**
+ * \brief Keep many file reads in flight, with io_uring on Linux or with blocking preads on a small thread pool.
+ * The files are always read into heap buffers followed by a null character, never mapped.
+ */
+class IoService : public IoServiceInterface
+{
+public:
+    IoService();
+    ~IoService() override;
+    IoService(const IoService&) = delete;
+    IoService& operator=(const IoService&) = delete;
+
+    void Init(IoBackend backend = IoBackend::IO_URING);
+    /**
+     * \brief Finish the pending reads, executing their jobs, then stop the I/O threads.
+     * Must be called before destroying the job system the dependent jobs are scheduled on.
+     */
+    void Destroy();
+    bool Read(ResourceJob* job) override;
+    [[nodiscard]] IoBackend GetBackend() const { return backend_.load(std::memory_order_relaxed); }
+protected:
+    /**
+     * \brief Submit the prepared reads and wait for waitNmb completions, false when the ring cannot be used anymore
+     */
+    virtual bool EnterRing(unsigned waitNmb);
+private:
+    void RunThreadPool();
+    void RunRing();
+    /**
+     * \brief Blocking read used by the thread pool
+     */
+    static void ReadFile(ResourceJob* job);
+    /**
+     * \brief Give the buffer to the job and execute it, a failed read gives a null buffer like BufferFile::Load
+     */
+    static void CompleteRead(ResourceJob* job, unsigned char* buffer, std::size_t length);
+
+    /**
+     * \brief Written by the ring thread when it falls back to the thread pool
+     */
+    std::atomic<IoBackend> backend_{IoBackend::NONE};
+    std::vector<std::thread> threads_;
+    std::mutex pendingMutex_;
+    std::condition_variable pendingCondition_;
+    std::queue<ResourceJob*> pendingJobs_;
+    bool isRunning_ = false;
+    /**
+     * \brief The ring thread waits for the event fd, only the first Read after that wakes it up.
+     * The reads queued while it is busy are submitted together.
+     */
+    bool isRingWaiting_ = false;
+    std::unique_ptr<IoRing> ring_;
+};
+
+using IoServiceLocator = Locator<IoServiceInterface, NullIoService>;
+}
@@ -0,0 +1,668 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "engine/bvh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "engine/assert.h"
+#include "engine/engine.h"
+#include "engine/jobsystem.h"
+#include "engine/transform.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+Aabb3d Union(const Aabb3d& a, const Aabb3d& b)
+{
+    Aabb3d result;
+    result.lowerLeftBound = Vec3f(std::min(a.lowerLeftBound.x, b.lowerLeftBound.x),
+                                  std::min(a.lowerLeftBound.y, b.lowerLeftBound.y),
+                                  std::min(a.lowerLeftBound.z, b.lowerLeftBound.z));
+    result.upperRightBound = Vec3f(std::max(a.upperRightBound.x, b.upperRightBound.x),
+                                   std::max(a.upperRightBound.y, b.upperRightBound.y),
+                                   std::max(a.upperRightBound.z, b.upperRightBound.z));
+    return result;
+}
+
+float SurfaceArea(const Aabb3d& aabb)
+{
+    const Vec3f size = aabb.upperRightBound - aabb.lowerLeftBound;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool Overlap(const Aabb3d& a, const Aabb3d& b)
+{
+    return a.lowerLeftBound.x <= b.upperRightBound.x && b.lowerLeftBound.x <= a.upperRightBound.x &&
+           a.lowerLeftBound.y <= b.upperRightBound.y && b.lowerLeftBound.y <= a.upperRightBound.y &&
+           a.lowerLeftBound.z <= b.upperRightBound.z && b.lowerLeftBound.z <= a.upperRightBound.z;
+}
+
+enum class FrustumTest : std::uint8_t
+{
+    OUTSIDE,
+    INTERSECT,
+    INSIDE
+};
+
+FrustumTest TestFrustum(const Frustum& frustum, const Aabb3d& aabb)
+{
+    const Vec3f center = aabb.CalculateCenter();
+    const Vec3f extends = aabb.CalculateExtends();
+    auto result = FrustumTest::INSIDE;
+    for (const auto& plane : frustum.planes)
+    {
+        const float radius = std::abs(plane.normal.x) * extends.x +
+                             std::abs(plane.normal.y) * extends.y +
+                             std::abs(plane.normal.z) * extends.z;
+        const float distance = plane.SignedDistance(center);
+        if (distance < -radius)
+            return FrustumTest::OUTSIDE;
+        if (distance < radius)
+            result = FrustumTest::INTERSECT;
+    }
+    return result;
+}
+
+/**
+ * \brief Slab test
+ * \return the distance where the ray enters the box, or a negative value if it misses it before maxDistance
+ */
+float RayDistance(const Vec3f& origin, const Vec3f& inverseDirection, float maxDistance, const Aabb3d& aabb)
+{
+    float enter = 0.0f;
+    float exit = maxDistance;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float near = (aabb.lowerLeftBound[axis] - origin[axis]) * inverseDirection[axis];
+        const float far = (aabb.upperRightBound[axis] - origin[axis]) * inverseDirection[axis];
+        enter = std::max(enter, std::min(near, far));
+        exit = std::min(exit, std::max(near, far));
+    }
+    return enter <= exit ? enter : -1.0f;
+}
+}
+
+DynamicBvh::DynamicBvh(float fatMargin) : fatMargin_(fatMargin)
+{
+}
+
+BvhNodeIndex DynamicBvh::AllocateNode()
+{
+    if (freeList_ == INVALID_BVH_NODE)
+    {
+        nodes_.emplace_back();
+        return BvhNodeIndex(nodes_.size() - 1);
+    }
+    //Free nodes are linked by their parent index
+    const auto node = freeList_;
+    freeList_ = nodes_[node].parent;
+    nodes_[node] = Node();
+    return node;
+}
+
+void DynamicBvh::FreeNode(BvhNodeIndex node)
+{
+    nodes_[node] = Node();
+    nodes_[node].parent = freeList_;
+    nodes_[node].height = -1;
+    freeList_ = node;
+}
+
+void DynamicBvh::Insert(Entity entity, const Aabb3d& aabb)
+{
+    if (entity >= entityLeaves_.size())
+    {
+        entityLeaves_.resize(entity + 1, INVALID_BVH_NODE);
+        entityAabbs_.resize(entity + 1);
+    }
+    neko_assert(entityLeaves_[entity] == INVALID_BVH_NODE, "Entity already in the bvh");
+    const auto leaf = AllocateNode();
+    auto& node = nodes_[leaf];
+    node.entity = entity;
+    node.aabb.lowerLeftBound = aabb.lowerLeftBound - Vec3f::one * fatMargin_;
+    node.aabb.upperRightBound = aabb.upperRightBound + Vec3f::one * fatMargin_;
+    entityLeaves_[entity] = leaf;
+    entityAabbs_[entity] = aabb;
+    leavesNmb_++;
+    InsertLeaf(leaf);
+}
+
+void DynamicBvh::Remove(Entity entity)
+{
+    if (!Contains(entity))
+        return;
+    const auto leaf = entityLeaves_[entity];
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    entityLeaves_[entity] = INVALID_BVH_NODE;
+    leavesNmb_--;
+}
+
+bool DynamicBvh::Update(Entity entity, const Aabb3d& aabb)
+{
+    neko_assert(Contains(entity), "Entity not in the bvh");
+    entityAabbs_[entity] = aabb;
+    const auto leaf = entityLeaves_[entity];
+    if (nodes_[leaf].aabb.ContainsAabb(aabb))
+        return false;
+    RemoveLeaf(leaf);
+    nodes_[leaf].aabb.lowerLeftBound = aabb.lowerLeftBound - Vec3f::one * fatMargin_;
+    nodes_[leaf].aabb.upperRightBound = aabb.upperRightBound + Vec3f::one * fatMargin_;
+    InsertLeaf(leaf);
+    return true;
+}
+
+void DynamicBvh::Clear()
+{
+    nodes_.clear();
+    entityLeaves_.clear();
+    entityAabbs_.clear();
+    root_ = INVALID_BVH_NODE;
+    freeList_ = INVALID_BVH_NODE;
+    leavesNmb_ = 0;
+}
+
+bool DynamicBvh::Contains(Entity entity) const
+{
+    return entity < entityLeaves_.size() && entityLeaves_[entity] != INVALID_BVH_NODE;
+}
+
+const Aabb3d& DynamicBvh::GetAabb(Entity entity) const
+{
+    neko_assert(Contains(entity), "Entity not in the bvh");
+    return entityAabbs_[entity];
+}
+
+int DynamicBvh::GetHeight() const
+{
+    return root_ == INVALID_BVH_NODE ? 0 : nodes_[root_].height;
+}
+
+void DynamicBvh::InsertLeaf(BvhNodeIndex leaf)
+{
+    if (root_ == INVALID_BVH_NODE)
+    {
+        root_ = leaf;
+        nodes_[leaf].parent = INVALID_BVH_NODE;
+        return;
+    }
+    //Go down to the sibling with the least surface area increase
+    const Aabb3d leafAabb = nodes_[leaf].aabb;
+    BvhNodeIndex index = root_;
+    while (!nodes_[index].IsLeaf())
+    {
+        const auto& node = nodes_[index];
+        const float area = SurfaceArea(node.aabb);
+        const float combinedArea = SurfaceArea(Union(node.aabb, leafAabb));
+        //Cost of creating a new parent for this node and the leaf
+        const float cost = 2.0f * combinedArea;
+        //Minimum cost of pushing the leaf further down the tree
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+        const auto childCost = [this, &leafAabb, inheritanceCost](BvhNodeIndex child)
+        {
+            const auto& childNode = nodes_[child];
+            const float childArea = SurfaceArea(Union(leafAabb, childNode.aabb));
+            return childNode.IsLeaf() ?
+                   childArea + inheritanceCost :
+                   childArea - SurfaceArea(childNode.aabb) + inheritanceCost;
+        };
+        const float leftCost = childCost(node.left);
+        const float rightCost = childCost(node.right);
+        if (cost < leftCost && cost < rightCost)
+            break;
+        index = leftCost < rightCost ? node.left : node.right;
+    }
+
+    const auto sibling = index;
+    const auto oldParent = nodes_[sibling].parent;
+    const auto newParent = AllocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].aabb = Union(leafAabb, nodes_[sibling].aabb);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].left = sibling;
+    nodes_[newParent].right = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+    if (oldParent == INVALID_BVH_NODE)
+    {
+        root_ = newParent;
+    }
+    else if (nodes_[oldParent].left == sibling)
+    {
+        nodes_[oldParent].left = newParent;
+    }
+    else
+    {
+        nodes_[oldParent].right = newParent;
+    }
+    RefitAncestors(newParent);
+}
+
+void DynamicBvh::RemoveLeaf(BvhNodeIndex leaf)
+{
+    if (leaf == root_)
+    {
+        root_ = INVALID_BVH_NODE;
+        return;
+    }
+    const auto parent = nodes_[leaf].parent;
+    const auto grandParent = nodes_[parent].parent;
+    const auto sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+    FreeNode(parent);
+    nodes_[sibling].parent = grandParent;
+    if (grandParent == INVALID_BVH_NODE)
+    {
+        root_ = sibling;
+        return;
+    }
+    if (nodes_[grandParent].left == parent)
+    {
+        nodes_[grandParent].left = sibling;
+    }
+    else
+    {
+        nodes_[grandParent].right = sibling;
+    }
+    RefitAncestors(grandParent);
+}
+
+void DynamicBvh::RefitNode(BvhNodeIndex node)
+{
+    auto& current = nodes_[node];
+    const auto& left = nodes_[current.left];
+    const auto& right = nodes_[current.right];
+    current.aabb = Union(left.aabb, right.aabb);
+    current.height = 1 + std::max(left.height, right.height);
+}
+
+void DynamicBvh::RefitAncestors(BvhNodeIndex node)
+{
+    while (node != INVALID_BVH_NODE)
+    {
+        node = Balance(node);
+        RefitNode(node);
+        node = nodes_[node].parent;
+    }
+}
+
+BvhNodeIndex DynamicBvh::Balance(BvhNodeIndex indexA)
+{
+    if (nodes_[indexA].IsLeaf() || nodes_[indexA].height < 2)
+        return indexA;
+    const auto indexB = nodes_[indexA].left;
+    const auto indexC = nodes_[indexA].right;
+    const int balance = nodes_[indexC].height - nodes_[indexB].height;
+    if (balance >= -1 && balance <= 1)
+        return indexA;
+
+    //Rotate the higher child up, A takes its lowest grandchild
+    const bool rotateRight = balance > 1;
+    const auto indexUp = rotateRight ? indexC : indexB;
+    const auto indexStay = rotateRight ? indexB : indexC;
+    auto& up = nodes_[indexUp];
+    auto& a = nodes_[indexA];
+    const auto indexF = up.left;
+    const auto indexG = up.right;
+
+    up.left = indexA;
+    up.parent = a.parent;
+    a.parent = indexUp;
+    if (up.parent == INVALID_BVH_NODE)
+    {
+        root_ = indexUp;
+    }
+    else if (nodes_[up.parent].left == indexA)
+    {
+        nodes_[up.parent].left = indexUp;
+    }
+    else
+    {
+        nodes_[up.parent].right = indexUp;
+    }
+
+    const bool keepF = nodes_[indexF].height > nodes_[indexG].height;
+    const auto indexKept = keepF ? indexF : indexG;
+    const auto indexMoved = keepF ? indexG : indexF;
+    up.right = indexKept;
+    if (rotateRight)
+    {
+        a.right = indexMoved;
+    }
+    else
+    {
+        a.left = indexMoved;
+    }
+    nodes_[indexMoved].parent = indexA;
+    a.aabb = Union(nodes_[indexStay].aabb, nodes_[indexMoved].aabb);
+    a.height = 1 + std::max(nodes_[indexStay].height, nodes_[indexMoved].height);
+    up.aabb = Union(a.aabb, nodes_[indexKept].aabb);
+    up.height = 1 + std::max(a.height, nodes_[indexKept].height);
+    return indexUp;
+}
+
+void DynamicBvh::Rebuild(JobSystem* jobSystem)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Rebuild Bvh");
+#endif
+    buildLeaves_.clear();
+    for (Entity entity = 0; entity < entityLeaves_.size(); entity++)
+    {
+        const auto leaf = entityLeaves_[entity];
+        if (leaf == INVALID_BVH_NODE)
+            continue;
+        const auto& aabb = nodes_[leaf].aabb;
+        buildLeaves_.push_back({entity, aabb, aabb.CalculateCenter()});
+    }
+    nodes_.clear();
+    freeList_ = INVALID_BVH_NODE;
+    root_ = INVALID_BVH_NODE;
+    if (buildLeaves_.empty())
+        return;
+    //A binary tree with n leaves has 2n-1 nodes, each subtree gets its own contiguous range
+    nodes_.resize(2 * buildLeaves_.size() - 1);
+    root_ = 0;
+    buildTasks_.clear();
+    upperNodes_.clear();
+    BuildUpperTree(0, buildLeaves_.size(), root_, INVALID_BVH_NODE);
+    const auto buildTask = [this](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const auto& task = buildTasks_[i];
+            BuildSubtree(task.begin, task.end, task.firstNode, task.parent);
+        }
+    };
+    if (jobSystem == nullptr)
+    {
+        buildTask(0, buildTasks_.size());
+    }
+    else
+    {
+        jobSystem->ParallelFor(0, buildTasks_.size(), 1, buildTask);
+    }
+    //The upper nodes are stored children first
+    for (const auto node : upperNodes_)
+    {
+        RefitNode(node);
+    }
+}
+
+void DynamicBvh::BuildUpperTree(std::size_t begin, std::size_t end, BvhNodeIndex firstNode, BvhNodeIndex parent)
+{
+    if (end - begin <= rebuildThreshold)
+    {
+        buildTasks_.push_back({begin, end, firstNode, parent});
+        return;
+    }
+    const auto middle = SplitLeaves(begin, end);
+    auto& node = nodes_[firstNode];
+    node.parent = parent;
+    node.left = firstNode + 1;
+    node.right = firstNode + BvhNodeIndex(2 * (middle - begin));
+    BuildUpperTree(begin, middle, node.left, firstNode);
+    BuildUpperTree(middle, end, node.right, firstNode);
+    upperNodes_.push_back(firstNode);
+}
+
+void DynamicBvh::BuildSubtree(std::size_t begin, std::size_t end, BvhNodeIndex firstNode, BvhNodeIndex parent)
+{
+    auto& node = nodes_[firstNode];
+    node.parent = parent;
+    if (end - begin == 1)
+    {
+        const auto& buildLeaf = buildLeaves_[begin];
+        node.entity = buildLeaf.entity;
+        node.aabb = buildLeaf.aabb;
+        node.height = 0;
+        entityLeaves_[buildLeaf.entity] = firstNode;
+        return;
+    }
+    const auto middle = SplitLeaves(begin, end);
+    node.left = firstNode + 1;
+    node.right = firstNode + BvhNodeIndex(2 * (middle - begin));
+    BuildSubtree(begin, middle, node.left, firstNode);
+    BuildSubtree(middle, end, node.right, firstNode);
+    RefitNode(firstNode);
+}
+
+std::size_t DynamicBvh::SplitLeaves(std::size_t begin, std::size_t end)
+{
+    Vec3f minCenter = buildLeaves_[begin].center;
+    Vec3f maxCenter = minCenter;
+    for (std::size_t i = begin + 1; i < end; i++)
+    {
+        const auto& center = buildLeaves_[i].center;
+        minCenter = Vec3f(std::min(minCenter.x, center.x), std::min(minCenter.y, center.y),
+                          std::min(minCenter.z, center.z));
+        maxCenter = Vec3f(std::max(maxCenter.x, center.x), std::max(maxCenter.y, center.y),
+                          std::max(maxCenter.z, center.z));
+    }
+    const Vec3f size = maxCenter - minCenter;
+    const int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+    const std::size_t middle = begin + (end - begin) / 2;
+    std::nth_element(buildLeaves_.begin() + begin, buildLeaves_.begin() + middle, buildLeaves_.begin() + end,
+                     [axis](const BuildLeaf& a, const BuildLeaf& b)
+                     {
+                         return a.center[axis] < b.center[axis];
+                     });
+    return middle;
+}
+
+void DynamicBvh::AddSubtreeLeaves(BvhNodeIndex node, std::vector<Entity>& result) const
+{
+    if (nodes_[node].IsLeaf())
+    {
+        result.push_back(nodes_[node].entity);
+        return;
+    }
+    AddSubtreeLeaves(nodes_[node].left, result);
+    AddSubtreeLeaves(nodes_[node].right, result);
+}
+
+void DynamicBvh::QueryFrustum(const Frustum& frustum, std::vector<Entity>& result) const
+{
+    if (root_ == INVALID_BVH_NODE)
+        return;
+    std::vector<BvhNodeIndex> stack{root_};
+    while (!stack.empty())
+    {
+        const auto index = stack.back();
+        stack.pop_back();
+        const auto& node = nodes_[index];
+        if (node.IsLeaf())
+        {
+            if (frustum.IntersectAabb(entityAabbs_[node.entity]))
+            {
+                result.push_back(node.entity);
+            }
+            continue;
+        }
+        switch (TestFrustum(frustum, node.aabb))
+        {
+            case FrustumTest::INSIDE:
+                //Every leaf is visible, no more plane tests
+                AddSubtreeLeaves(index, result);
+                break;
+            case FrustumTest::INTERSECT:
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void DynamicBvh::QueryAabb(const Aabb3d& aabb, std::vector<Entity>& result) const
+{
+    if (root_ == INVALID_BVH_NODE)
+        return;
+    std::vector<BvhNodeIndex> stack{root_};
+    while (!stack.empty())
+    {
+        const auto& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (!Overlap(node.aabb, aabb))
+            continue;
+        if (!node.IsLeaf())
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+        else if (Overlap(entityAabbs_[node.entity], aabb))
+        {
+            result.push_back(node.entity);
+        }
+    }
+}
+
+bool DynamicBvh::Raycast(const Vec3f& origin, const Vec3f& direction, float maxDistance, BvhRaycastHit& hit) const
+{
+    if (root_ == INVALID_BVH_NODE)
+        return false;
+    const Vec3f normalizedDirection = direction.Normalized();
+    const Vec3f inverseDirection(1.0f / normalizedDirection.x, 1.0f / normalizedDirection.y,
+                                 1.0f / normalizedDirection.z);
+    hit = BvhRaycastHit();
+    float closestDistance = maxDistance;
+    std::vector<BvhNodeIndex> stack{root_};
+    while (!stack.empty())
+    {
+        const auto& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (node.IsLeaf())
+        {
+            const float distance = RayDistance(origin, inverseDirection, closestDistance,
+                                               entityAabbs_[node.entity]);
+            if (distance >= 0.0f)
+            {
+                closestDistance = distance;
+                hit = {node.entity, distance};
+            }
+            continue;
+        }
+        const float leftDistance = RayDistance(origin, inverseDirection, closestDistance,
+                                               nodes_[node.left].aabb);
+        const float rightDistance = RayDistance(origin, inverseDirection, closestDistance,
+                                                nodes_[node.right].aabb);
+        //The closest child is pushed last to be visited first and shrink the ray early
+        const bool leftFirst = leftDistance >= 0.0f && (rightDistance < 0.0f || leftDistance <= rightDistance);
+        const auto first = leftFirst ? node.left : node.right;
+        const auto second = leftFirst ? node.right : node.left;
+        if ((leftFirst ? rightDistance : leftDistance) >= 0.0f)
+        {
+            stack.push_back(second);
+        }
+        if ((leftFirst ? leftDistance : rightDistance) >= 0.0f)
+        {
+            stack.push_back(first);
+        }
+    }
+    return hit.entity != INVALID_ENTITY;
+}
+
+TransformBvh::TransformBvh(Transform3dManager& transformManager, float fatMargin) :
+    transformManager_(transformManager),
+    bvh_(fatMargin)
+{
+}
+
+Aabb3d TransformBvh::TransformAabb(const Mat4f& transform, const Aabb3d& aabb)
+{
+    const Vec3f center = aabb.CalculateCenter();
+    const Vec3f extends = aabb.CalculateExtends();
+    Vec3f worldCenter(transform[3]);
+    Vec3f worldExtends = Vec3f::zero;
+    for (int column = 0; column < 3; column++)
+    {
+        worldCenter += Vec3f(transform[column]) * center[column];
+        worldExtends += Vec3f(std::abs(transform[column][0]), std::abs(transform[column][1]),
+                              std::abs(transform[column][2])) * extends[column];
+    }
+    Aabb3d result;
+    result.lowerLeftBound = worldCenter - worldExtends;
+    result.upperRightBound = worldCenter + worldExtends;
+    return result;
+}
+
+void TransformBvh::AddEntity(Entity entity, const Aabb3d& localAabb)
+{
+    entities_.push_back(entity);
+    localAabbs_.push_back(localAabb);
+    worldAabbs_.push_back(TransformAabb(transformManager_.GetComponent(entity), localAabb));
+    bvh_.Insert(entity, worldAabbs_.back());
+}
+
+void TransformBvh::RemoveEntity(Entity entity)
+{
+    const auto it = std::find(entities_.begin(), entities_.end(), entity);
+    if (it == entities_.end())
+        return;
+    const auto index = std::size_t(std::distance(entities_.begin(), it));
+    entities_[index] = entities_.back();
+    localAabbs_[index] = localAabbs_.back();
+    worldAabbs_[index] = worldAabbs_.back();
+    entities_.pop_back();
+    localAabbs_.pop_back();
+    worldAabbs_.pop_back();
+    bvh_.Remove(entity);
+}
+
+void TransformBvh::Update()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Update Transform Bvh");
+#endif
+    const auto updateWorldAabbs = [this](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            worldAabbs_[i] = TransformAabb(transformManager_.GetComponent(entities_[i]), localAabbs_[i]);
+        }
+    };
+    auto* engine = BasicEngine::GetInstance();
+    if (engine == nullptr)
+    {
+        updateWorldAabbs(0, entities_.size());
+    }
+    else
+    {
+        engine->ParallelFor(0, entities_.size(), 4'096, updateWorldAabbs);
+    }
+    for (std::size_t i = 0; i < entities_.size(); i++)
+    {
+        bvh_.Update(entities_[i], worldAabbs_[i]);
+    }
+}
+}
@@ -103,7 +103,18 @@ void BasicEngine::Init()
 #endif
 	instance_ = this;
 	logDebug("Current path: " + GetCurrentPath());
+    if (!config.dataArchivePath.empty() && assetArchive_.Open(config.dataArchivePath, config.dataRootPath))
+    {
+        AssetArchiveLocator::provide(&assetArchive_);
+    }
 	jobSystem_.Init();
+#ifndef NEKO_SAMETHREAD
+    if (config.ioBackend != IoBackend::NONE)
+    {
+        ioService_.Init(config.ioBackend);
+        IoServiceLocator::provide(&ioService_);
+    }
+#endif
 }
 
 void BasicEngine::Update(seconds dt)
@@ -113,30 +124,71 @@ void BasicEngine::Update(seconds dt)
 	EASY_BLOCK("Basic Engine Update");
 #endif
 
+#ifndef NEKO_SAMETHREAD
+    const bool isPipelined = config.framePipelineDepth > 1;
+#else
+    const bool isPipelined = false;
+#endif
+    Job* renderJob = renderer_->GetRenderAllJob();
+    Job* swapBufferJob = window_->GetSwapBufferJob();
+    if (isPreviousFramePending_)
+    {
+        //Events and ImGui inputs cannot be touched while the previous frame is rendered
+        renderJob->Join();
+    }
     renderer_->ResetJobs();
-    window_->ResetJobs();
+    if (!isPreviousFramePending_)
+    {
+        window_->ResetJobs();
+    }
+    //Previous frame main thread jobs are all done
+    frameJobPool_.Clear();
 	
-    Job eventJob([this]
+    Job* eventJob = frameJobPool_.CreateJob([this]
     {
 	    ManageEvent();
     });
-    Job updateJob([this, &dt]{updateAction_.Execute(dt);});
-    updateJob.AddDependency(&eventJob);
+    Job* updateJob = frameJobPool_.CreateJob([this, dt]{updateAction_.Execute(dt);});
+    updateJob->AddDependency(eventJob);
 
     Job* rendererSyncJob = renderer_->GetSyncJob();
-    updateJob.AddDependency(rendererSyncJob);
+    updateJob->AddDependency(rendererSyncJob);
 
-    Job* renderJob = renderer_->GetRenderAllJob();
-    renderJob->AddDependency(&eventJob);
+    renderJob->AddDependency(eventJob);
+
+    if (isPipelined)
+    {
+        renderJob->AddDependency(rendererSyncJob);
+        jobSystem_.ScheduleJob(eventJob, JobThreadType::MAIN_THREAD);
+        renderer_->SchedulePipelinedJobs();
+        //The update overlaps the previous frame swap buffer
+        jobSystem_.ScheduleJob(updateJob, JobThreadType::MAIN_THREAD);
+        if (isPreviousFramePending_)
+        {
+            swapBufferJob->Join();
+            window_->ResetJobs();
+        }
+        swapBufferJob->AddDependency(renderJob);
+        swapBufferJob->AddDependency(updateJob);
+        jobSystem_.ScheduleJob(swapBufferJob, JobThreadType::RENDER_THREAD);
+        isPreviousFramePending_ = true;
+        return;
+    }
+    if (isPreviousFramePending_)
+    {
+        //Pipelining was disabled at runtime
+        swapBufferJob->Join();
+        window_->ResetJobs();
+        isPreviousFramePending_ = false;
+    }
 
-    Job* swapBufferJob = window_->GetSwapBufferJob();
     swapBufferJob->AddDependency(renderJob);
-    swapBufferJob->AddDependency(&updateJob);
+    swapBufferJob->AddDependency(updateJob);
 
     renderer_->ScheduleJobs();
     jobSystem_.ScheduleJob(swapBufferJob, JobThreadType::RENDER_THREAD);
-    jobSystem_.ScheduleJob(&eventJob, JobThreadType::MAIN_THREAD);
-    jobSystem_.ScheduleJob(&updateJob, JobThreadType::MAIN_THREAD);
+    jobSystem_.ScheduleJob(eventJob, JobThreadType::MAIN_THREAD);
+    jobSystem_.ScheduleJob(updateJob, JobThreadType::MAIN_THREAD);
 #ifndef NEKO_SAMETHREAD
     swapBufferJob->Join();
 #else
@@ -146,10 +198,20 @@ void BasicEngine::Update(seconds dt)
 
 void BasicEngine::Destroy()
 {
+    if (isPreviousFramePending_)
+    {
+        window_->GetSwapBufferJob()->Join();
+        isPreviousFramePending_ = false;
+    }
 	destroyAction_.Execute();
     renderer_->Destroy();
 	window_->Destroy();
+    //The last reads release their dependent jobs before the job system stops
+    IoServiceLocator::provide(nullptr);
+    ioService_.Destroy();
 	jobSystem_.Destroy();
+    AssetArchiveLocator::provide(nullptr);
+    assetArchive_.Close();
 	instance_ = nullptr;
 }
 
@@ -204,6 +266,10 @@ void BasicEngine::GenerateUiFrame()
 	oss << "App FPS: " << 1.0f / dt_ << '\n'
 		<< '\n';
 	ImGui::Text("%s", oss.str().c_str());
+	if (renderer_ != nullptr)
+	{
+		renderer_->DrawImGui();
+	}
 	ImGui::End();
 	drawImGuiAction_.Execute();
 }
@@ -225,5 +291,19 @@ void BasicEngine::ScheduleJob(Job* job, JobThreadType threadType)
     jobSystem_.ScheduleJob(job, threadType);
 }
 
+void BasicEngine::ScheduleResourceJob(ResourceJob* job, JobThreadType threadType)
+{
+    if (!IoServiceLocator::get().Read(job))
+    {
+        jobSystem_.ScheduleJob(job, threadType);
+    }
+}
+
+void BasicEngine::ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize,
+                              const JobSystem::ParallelForTask& func)
+{
+    jobSystem_.ParallelFor(begin, end, grainSize, func);
+}
+
 
 }
@@ -26,7 +26,6 @@
 #include <algorithm>
 #include <utilities/vector_utility.h>
 #include <engine/component.h>
-#include <sstream>
 #include <engine/log.h>
 
 #include <fmt/format.h>
@@ -39,6 +38,7 @@ EntityManager::EntityManager()
 {
     entityMaskArray_.resize(INIT_ENTITY_NMB);
 	entityHashArray_.resize(INIT_ENTITY_NMB);
+    entityGenerations_.resize(INIT_ENTITY_NMB);
     parentEntities_.resize(INIT_ENTITY_NMB, INVALID_ENTITY);
 }
 
@@ -51,34 +51,38 @@ Entity EntityManager::CreateEntity(Entity entity)
 {
     if(entity == INVALID_ENTITY)
     {
-        const auto entityMaskIt = std::find_if(entityMaskArray_.begin(), entityMaskArray_.end(),
-                                               [](EntityMask entityMask)
-                                               {
-                                                   return entityMask == INVALID_ENTITY_MASK;
-                                               });
-        if (entityMaskIt == entityMaskArray_.end())
+        while (!freeEntities_.empty())
         {
-            const auto newEntity = entityMaskArray_.size();
-            ResizeIfNecessary(entityMaskArray_, newEntity, INVALID_ENTITY_MASK);
-            ResizeIfNecessary(parentEntities_, newEntity, INVALID_ENTITY);
-			ResizeIfNecessary(entityHashArray_, newEntity, INVALID_ENTITY_HASH);
-        	AddComponentType(Entity(newEntity), static_cast<EntityMask>(ComponentType::EMPTY));
-            return Entity(newEntity);
+            const Entity freeEntity = freeEntities_.back();
+            freeEntities_.pop_back();
+            //Skip the entities that were recreated explicitly
+            if (!EntityExists(freeEntity))
+            {
+                AddComponentType(freeEntity, static_cast<EntityMask>(ComponentType::EMPTY));
+                return freeEntity;
+            }
         }
-        else
+        //Skip the entities that received components without being created
+        while (nextEntity_ < entityMaskArray_.size() && EntityExists(nextEntity_))
         {
-            const auto newEntity = entityMaskIt - entityMaskArray_.begin();
-            AddComponentType(Entity(newEntity), static_cast<EntityMask>(ComponentType::EMPTY));
-            return Entity(newEntity);
+            nextEntity_++;
         }
+        const Entity newEntity = nextEntity_++;
+        ResizeEntities(newEntity);
+        AddComponentType(newEntity, static_cast<EntityMask>(ComponentType::EMPTY));
+        return newEntity;
     }
     else
     {
-        ResizeIfNecessary(entityMaskArray_, entity, INVALID_ENTITY_MASK);
-        ResizeIfNecessary(parentEntities_, entity, INVALID_ENTITY);
-		ResizeIfNecessary(entityHashArray_, entity, INVALID_ENTITY_HASH);
+        ResizeEntities(entity);
     	if(!EntityExists(entity))
         {
+            //The entities skipped never existed, the lowest ones are recycled first
+            for (Entity skippedEntity = entity; skippedEntity > nextEntity_; skippedEntity--)
+            {
+                freeEntities_.push_back(skippedEntity - 1);
+            }
+            nextEntity_ = std::max(nextEntity_, entity + 1);
             AddComponentType(entity, static_cast<EntityMask>(ComponentType::EMPTY));
             return entity;
         }
@@ -86,21 +90,54 @@ Entity EntityManager::CreateEntity(Entity entity)
     }
 }
 
+void EntityManager::ResizeEntities(Entity entity)
+{
+    ResizeIfNecessary(entityMaskArray_, entity, INVALID_ENTITY_MASK);
+    ResizeIfNecessary(parentEntities_, entity, INVALID_ENTITY);
+    ResizeIfNecessary(entityHashArray_, entity, INVALID_ENTITY_HASH);
+    ResizeIfNecessary(entityGenerations_, entity, EntityGeneration(0));
+}
+
 void EntityManager::DestroyEntity(Entity entity)
 {
+    //Detach the entity so the hierarchies do not keep it when it is recycled
+    if (parentEntities_[entity] != INVALID_ENTITY)
+    {
+        SetEntityParent(entity, INVALID_ENTITY);
+    }
+    const auto previousMask = entityMaskArray_[entity];
     entityMaskArray_[entity] = INVALID_ENTITY_MASK;
+    UpdateViews(entity, previousMask);
 	entityHashArray_[entity] = INVALID_ENTITY_HASH;
+    entityGenerations_[entity]++;
+    freeEntities_.push_back(entity);
 
 	onDestroyEntity.Execute(entity);
 }
 
+EntityGeneration EntityManager::GetEntityGeneration(Entity entity) const
+{
+    return entityGenerations_[entity];
+}
+
+EntityHandle EntityManager::GetEntityHandle(Entity entity) const
+{
+    return {entity, entityGenerations_[entity]};
+}
+
+bool EntityManager::IsEntityHandleValid(EntityHandle handle) const
+{
+    return handle.entity < entityMaskArray_.size() &&
+           entityMaskArray_[handle.entity] != INVALID_ENTITY_MASK &&
+           entityGenerations_[handle.entity] == handle.generation;
+}
+
 bool EntityManager::HasComponent(Entity entity, EntityMask componentType) const
 {
 	if (entity >= entityMaskArray_.size())
     {
-	    std::ostringstream oss;
-	    oss << "[Error] Accessing entity: "<<entity<<" while entity mask array is of size: "<<entityMaskArray_.size();
-	    logDebug(oss.str());
+	    logDebug(fmt::format("[Error] Accessing entity: {} while entity mask array is of size: {}",
+	        entity, entityMaskArray_.size()));
 	    return false;
     }
     return (entityMaskArray_[entity] & EntityMask(componentType)) == EntityMask(componentType);
@@ -108,12 +145,65 @@ bool EntityManager::HasComponent(Entity entity, EntityMask componentType) const
 
 void EntityManager::AddComponentType(Entity entity, EntityMask componentType)
 {
+    const auto previousMask = entityMaskArray_[entity];
     entityMaskArray_[entity] |= EntityMask(componentType);
+    UpdateViews(entity, previousMask);
 }
 
 void EntityManager::RemoveComponentType(Entity entity, EntityMask componentType)
 {
+    const auto previousMask = entityMaskArray_[entity];
     entityMaskArray_[entity] &= ~EntityMask(componentType);
+    UpdateViews(entity, previousMask);
+}
+
+const std::vector<Entity>& EntityManager::View(EntityMask filterComponents) const
+{
+    neko_assert(filterComponents != INVALID_ENTITY_MASK, "View needs at least one component type");
+    auto viewIt = views_.find(filterComponents);
+    if (viewIt == views_.end())
+    {
+        std::vector<Entity> entities;
+        for (Entity entity = 0; entity < entityMaskArray_.size(); entity++)
+        {
+            if ((entityMaskArray_[entity] & filterComponents) == filterComponents)
+            {
+                entities.push_back(entity);
+            }
+        }
+        viewIt = views_.emplace(filterComponents, std::move(entities)).first;
+    }
+    return viewIt->second;
+}
+
+void EntityManager::UpdateViews(Entity entity, EntityMask previousMask)
+{
+    const auto mask = entityMaskArray_[entity];
+    if (mask == previousMask)
+        return;
+    for (auto& [filterComponents, entities] : views_)
+    {
+        const bool wasInView = (previousMask & filterComponents) == filterComponents;
+        const bool isInView = (mask & filterComponents) == filterComponents;
+        if (wasInView == isInView)
+            continue;
+        //Keep the views sorted, entities are mostly created at the end
+        if (isInView)
+        {
+            if (entities.empty() || entities.back() < entity)
+            {
+                entities.push_back(entity);
+            }
+            else
+            {
+                entities.insert(std::lower_bound(entities.begin(), entities.end(), entity), entity);
+            }
+        }
+        else
+        {
+            entities.erase(std::lower_bound(entities.begin(), entities.end(), entity));
+        }
+    }
 }
 
 void EntityManager::SetEntityName(Entity entity, const std::string& entityName)
@@ -136,39 +226,82 @@ EntityHash EntityManager::HashEntityName(const std::string& entityName)
 	return entityHash;
 }
 
-DirtyManager::DirtyManager(EntityManager& entityManager) : entityManager_(entityManager)
+DirtyManager::DirtyManager(EntityManager& entityManager) :
+    entityManager_(entityManager),
+    entityHierarchy_(entityManager)
 {
 }
 
 void DirtyManager::SetDirty(Entity entity)
 {
-    if (std::find(dirtyEntities_.cbegin(), dirtyEntities_.cend(), entity) == dirtyEntities_.cend())
+    ResizeIfNecessary(dirtyFlags_, entity, false);
+    if (!dirtyFlags_[entity])
     {
+        dirtyFlags_[entity] = true;
     	dirtyEntities_.push_back(entity);
     }
 }
 
+bool DirtyManager::HasDirtyParent(Entity entity) const
+{
+    auto parent = entityManager_.get().GetEntityParent(entity);
+    while (parent != INVALID_ENTITY)
+    {
+        if (parent < dirtyFlags_.size() && dirtyFlags_[parent])
+        {
+            return true;
+        }
+        parent = entityManager_.get().GetEntityParent(parent);
+    }
+    return false;
+}
+
 void DirtyManager::UpdateDirtyEntities()
 {
-    //Fill the dirty entities with all the children in O(n)
-    for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
+    UpdateDirtyLevels([this](const std::vector<Entity>& entities, std::size_t begin, std::size_t end)
     {
-    	if(!entityManager_.get().EntityExists(entity))
-            continue;
-        auto parent = entityManager_.get().GetEntityParent(entity);
-        while (parent != INVALID_ENTITY)
+        for (std::size_t i = begin; i < end; i++)
+        {
+            updateDirtyEntity.Execute(entities[i]);
+        }
+    });
+}
+
+void DirtyManager::UpdateDirtyLevels(const UpdateLevelFunction& updateLevel)
+{
+    //Only the top dirty entities start a subtree, the others are reached through their dirty parent
+    updateQueue_.clear();
+    for (auto entity : dirtyEntities_)
+    {
+        if (entityManager_.get().EntityExists(entity) && !HasDirtyParent(entity))
+        {
+            updateQueue_.push_back(entity);
+        }
+    }
+    //Breadth-first traversal level by level, so parents are always updated before children
+    std::size_t levelBegin = 0;
+    while (levelBegin < updateQueue_.size())
+    {
+        const std::size_t levelEnd = updateQueue_.size();
+        updateLevel(updateQueue_, levelBegin, levelEnd);
+        for (std::size_t i = levelBegin; i < levelEnd; i++)
         {
-            if (std::find(dirtyEntities_.cbegin(), dirtyEntities_.cend(), parent) != dirtyEntities_.end())
+            const Entity entity = updateQueue_[i];
+            if (!entityHierarchy_.HasChildren(entity))
+                continue;
+            for (Entity child : entityHierarchy_.GetChildren(entity))
             {
-                SetDirty(entity);
-                break;
+                if (entityManager_.get().EntityExists(child))
+                {
+                    updateQueue_.push_back(child);
+                }
             }
-            parent = entityManager_.get().GetEntityParent(parent);
         }
+        levelBegin = levelEnd;
     }
     for (auto entity : dirtyEntities_)
     {
-        updateDirtyEntity.Execute(entity);
+        dirtyFlags_[entity] = false;
     }
     dirtyEntities_.clear();
 }
@@ -215,7 +348,7 @@ const std::vector<Entity>& EntityHierarchy::GetChildren(Entity entity)
     return entityHierarchyMap_[entity];
 }
 
-bool EntityHierarchy::HasChildren(Entity entity)
+bool EntityHierarchy::HasChildren(Entity entity) const
 {
 	const auto it = entityHierarchyMap_.find(entity);
 	if(it != entityHierarchyMap_.end())
@@ -413,6 +546,10 @@ size_t EntityManager::GetEntitiesSize() const
 
 std::vector<Entity> EntityManager::FilterEntities(EntityMask filterComponents) const
 {
+    if (filterComponents != INVALID_ENTITY_MASK)
+    {
+        return View(filterComponents);
+    }
 	std::vector<Entity> entities;
 	entities.reserve(entityMaskArray_.size());
 	for(Entity i = 0; i < entityMaskArray_.size();i++)
@@ -475,6 +612,14 @@ void EntityManager::RegisterOnChangeParent(OnChangeParentInterface* onChangeInte
     });
 }
 
+void EntityManager::RegisterOnDestroyEntity(OnDestroyEntityInterface* onDestroyInterface)
+{
+    onDestroyEntity.RegisterCallback([onDestroyInterface](Entity entity)
+    {
+        onDestroyInterface->OnDestroyEntity(entity);
+    });
+}
+
 Entity EntityManager::GetEntityParent(Entity entity)
 {
     return parentEntities_[entity];
@@ -483,7 +628,7 @@ Entity EntityManager::GetEntityParent(Entity entity)
 bool EntityManager::SetEntityParent(Entity child, Entity parent)
 {
 	const auto oldParent = GetEntityParent(child);
-    auto p = GetEntityParent(parent);
+    auto p = parent == INVALID_ENTITY ? INVALID_ENTITY : GetEntityParent(parent);
     while (p != INVALID_ENTITY)
     {
 	    if(p == child)
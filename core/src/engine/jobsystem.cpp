@@ -23,9 +23,22 @@
  */
 
 #include <engine/jobsystem.h>
+#include <engine/assert.h>
+#include <utilities/file_utility.h>
 
+#include <algorithm>
+#include <array>
+#include <climits>
 #include <utility>
 
+#if defined(__linux__) && !defined(NEKO_SAMETHREAD)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
 #ifdef EASY_PROFILE_USE
 #include <easy/profiler.h>
 #endif
@@ -33,11 +46,229 @@
 namespace neko
 {
 
+#ifndef NEKO_SAMETHREAD
+/**
+ * \brief Used to push jobs scheduled from an other worker into its own deque
+ */
+static thread_local const JobSystem* currentJobSystem = nullptr;
+static thread_local std::size_t currentWorkerIndex = 0;
+#endif
+
+JobQueue::JobQueue(std::size_t size) :
+    cells_(std::make_unique<Cell[]>(size)),
+    mask_(size - 1)
+{
+    neko_assert((size & (size - 1)) == 0, "Job Queue size needs to be a power of two");
+    for (std::size_t i = 0; i < size; i++)
+    {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+        cells_[i].job = nullptr;
+    }
+}
+
+bool JobQueue::Push(Job* job)
+{
+    std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;)
+    {
+        cell = &cells_[pos & mask_];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->job = job;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+Job* JobQueue::Pop()
+{
+    std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;)
+    {
+        cell = &cells_[pos & mask_];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return nullptr;
+        }
+        else
+        {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    Job* job = cell->job;
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return job;
+}
+
+bool JobQueue::IsEmpty() const
+{
+    return enqueuePos_.load(std::memory_order_acquire) == dequeuePos_.load(std::memory_order_acquire);
+}
+
+WorkStealingQueue::WorkStealingQueue(std::size_t size) :
+    jobs_(std::make_unique<std::atomic<Job*>[]>(size)),
+    mask_(static_cast<std::int64_t>(size) - 1)
+{
+    neko_assert((size & (size - 1)) == 0, "Work Stealing Queue size needs to be a power of two");
+}
+
+bool WorkStealingQueue::Push(Job* job)
+{
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top > mask_)
+    {
+        return false;
+    }
+    jobs_[bottom & mask_].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* WorkStealingQueue::Pop()
+{
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom)
+    {
+        //Deque was empty
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = jobs_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        //Last job, race against the thieves
+        if (!top_.compare_exchange_strong(top, top + 1,
+                                          std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingQueue::Steal()
+{
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+    Job* job = jobs_[top & mask_].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1,
+                                      std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+bool WorkStealingQueue::IsEmpty() const
+{
+    return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+}
+
+#ifndef NEKO_SAMETHREAD
+void WorkerSignal::AddJob()
+{
+    const std::int32_t pendingJobs = pendingJobs_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    std::int32_t highWater = highWater_.load(std::memory_order_relaxed);
+    while (pendingJobs > highWater &&
+           !highWater_.compare_exchange_weak(highWater, pendingJobs, std::memory_order_relaxed))
+    {
+    }
+    if (sleepingWorkers_.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_one();
+    }
+}
+
+void WorkerSignal::RemoveJob()
+{
+    pendingJobs_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void WorkerSignal::Wait(const std::atomic<std::uint8_t>& status)
+{
+    sleepingWorkers_.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this, &status]
+        {
+            return pendingJobs_.load(std::memory_order_seq_cst) > 0 || status.load() == 0u;
+        });
+    }
+    sleepingWorkers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void WorkerSignal::WakeAll()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
+}
+
+std::int32_t WorkerSignal::GetPendingJobs() const
+{
+    return pendingJobs_.load(std::memory_order_acquire);
+}
+
+std::int32_t WorkerSignal::GetHighWater() const
+{
+    return highWater_.load(std::memory_order_relaxed);
+}
+
+void WorkerSignal::ResetHighWater()
+{
+    highWater_.store(0, std::memory_order_relaxed);
+}
+#endif
+
 JobSystem::JobSystem()
 {
 
 }
 
+JobSystem::JobSystem([[maybe_unused]] std::uint8_t otherWorkersNmb)
+{
+#ifndef NEKO_SAMETHREAD
+    otherWorkersNmb_ = otherWorkersNmb;
+#endif
+}
+
 JobSystem::~JobSystem()
 {
 
@@ -45,109 +276,316 @@ JobSystem::~JobSystem()
 
 void JobSystem::ScheduleJob(Job* func, JobThreadType threadType)
 {
-    auto scheduleJobFunc = [&func](JobQueue& jobQueue)
+    //The schedule count was already removed, the job would wait forever for it
+    const std::uint32_t previousStatus = func->status_.fetch_or(Job::SCHEDULED, std::memory_order_relaxed);
+    neko_assert(!(previousStatus & Job::SCHEDULED), "Job scheduled again without Reset");
+    (void)previousStatus;
+    if (threadType == JobThreadType::MAIN_THREAD)
     {
 #ifndef NEKO_SAMETHREAD
-        std::unique_lock<std::mutex> lock(jobQueue.mutex_);
-        jobQueue.jobs_.push(func);
-        jobQueue.cv_.notify_one();
-#else
-        jobQueue.jobs_.push(func);
+        for (const auto* dep : func->dependencies_)
+        {
+            dep->Join();
+        }
 #endif
+        func->Execute();
+        return;
+    }
+    func->jobSystem_ = this;
+    func->threadType_ = threadType;
+    func->scheduleTime_ = GetProfileTime();
+    //Remove the schedule count, the last dependency done pushes the job otherwise
+    if (func->unfinishedDependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        EnqueueJob(func, threadType);
+    }
+    else
+    {
+        deferredJobs_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
+void JobSystem::ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const ParallelForTask& func)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Parallel For");
+#endif
+    grainSize = std::max<std::size_t>(grainSize, 1);
+    const std::size_t chunksNmb = (end - begin + grainSize - 1) / grainSize;
+#ifdef NEKO_SAMETHREAD
+    (void)chunksNmb;
+    func(begin, end);
+#else
+    const std::size_t helperJobsNmb = std::min({chunksNmb - 1, workerQueues_.size(), MAX_PARALLEL_FOR_JOBS});
+    if (helperJobsNmb == 0 || !IsRunning())
+    {
+        func(begin, end);
+        return;
+    }
+    //Chunks are taken in order by the caller and the helper jobs, whoever is free first
+    std::atomic<std::size_t> nextChunk{0};
+    const auto executeChunks = [&nextChunk, chunksNmb, begin, end, grainSize, &func]
+    {
+        for (;;)
+        {
+            const std::size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunksNmb)
+            {
+                break;
+            }
+            const std::size_t chunkBegin = begin + chunk * grainSize;
+            func(chunkBegin, std::min(end, chunkBegin + grainSize));
+        }
     };
-	switch (threadType)
-	{
-    case JobThreadType::MAIN_THREAD:
+    std::array<Job, MAX_PARALLEL_FOR_JOBS> helperJobs;
+    for (std::size_t i = 0; i < helperJobsNmb; i++)
     {
-        func->Execute();
-        break;
+        helperJobs[i].SetTask([&executeChunks] { executeChunks(); });
+        ScheduleJob(&helperJobs[i], JobThreadType::OTHER_THREAD);
+    }
+    executeChunks();
+    //Helper jobs may still wait in a queue, execute them or any other job instead of sleeping
+    for (std::size_t i = 0; i < helperJobsNmb; i++)
+    {
+        while (!helperJobs[i].IsDone())
+        {
+            if (ExecuteOtherJob())
+            {
+                continue;
+            }
+            if (helperJobs[i].HasStarted())
+            {
+                helperJobs[i].Join();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
     }
+#endif
+}
+
+void JobSystem::EnqueueJob(Job* job, JobThreadType threadType)
+{
+	switch (threadType)
+	{
+#ifndef NEKO_SAMETHREAD
     case JobThreadType::RENDER_THREAD:
 	{
-        scheduleJobFunc(renderJobs_);
+        PushJob(renderJobs_, renderSignal_, job);
         break;
     }
     case JobThreadType::RESOURCE_THREAD:
 	{
-        scheduleJobFunc(resourceJobs_);
+        PushJob(resourceJobs_, resourceSignal_, job);
     	break;
     }
     case JobThreadType::OTHER_THREAD:
 	{
-        scheduleJobFunc(jobs_);
+        //Jobs scheduled by an other worker stay on its deque until they get stolen
+        if (currentJobSystem == this && workerQueues_[currentWorkerIndex]->Push(job))
+        {
+            jobsSignal_.AddJob();
+        }
+        else
+        {
+            PushJob(jobs_, jobsSignal_, job);
+        }
+        break;
+    }
+#else
+    case JobThreadType::RENDER_THREAD:
+    {
+        renderJobs_.Push(job);
+        break;
+    }
+    case JobThreadType::RESOURCE_THREAD:
+    {
+        resourceJobs_.Push(job);
         break;
     }
+    case JobThreadType::OTHER_THREAD:
+    {
+        jobs_.Push(job);
+        break;
+    }
+#endif
 	default: ;
 	}
 }
 #ifdef NEKO_SAMETHREAD
 void JobSystem::KickJobs()
 {
-    Work(resourceJobs_);
-    Work(jobs_);
-    Work(renderJobs_);
+    //Finished jobs can push their successors to the other queues
+    while (!resourceJobs_.IsEmpty() || !jobs_.IsEmpty() || !renderJobs_.IsEmpty())
+    {
+        Work(resourceJobs_, *profiles_[static_cast<int>(JobThreadType::RESOURCE_THREAD)]);
+        Work(jobs_, *profiles_[static_cast<int>(JobThreadType::OTHER_THREAD)]);
+        Work(renderJobs_, *profiles_[static_cast<int>(JobThreadType::RENDER_THREAD)]);
+    }
 }
-#endif
-void JobSystem::Work(JobQueue& jobQueue)
+
+void JobSystem::Work(JobQueue& jobQueue, WorkerProfile& profile)
 {
+    while (IsRunning())
     {
-#ifndef NEKO_SAMETHREAD
-        std::lock_guard<std::mutex> lock(statusMutex_);
-        ++workersStarted_;
-#endif
+        Job* job = jobQueue.Pop();
+        if (job == nullptr)
+        {
+            break;
+        }
+        ExecuteJob(job, &profile);
+    }
+}
+#else
+void JobSystem::PushJob(JobQueue& jobQueue, WorkerSignal& signal, Job* job)
+{
+    while (!jobQueue.Push(job))
+    {
+        //Queue is full, let the workers empty it
+        std::this_thread::yield();
     }
+    signal.AddJob();
+}
+
+void JobSystem::Work(JobQueue& jobQueue, WorkerSignal& signal, WorkerProfile& profile)
+{
+    profile.lastJobEnd = GetProfileTime();
+    ++workersStarted_;
     while (IsRunning())
     {
-        Job* job = nullptr;
-        {// CRITICAL
-#ifndef NEKO_SAMETHREAD
-            std::unique_lock<std::mutex> lock(jobQueue.mutex_);
-#endif
-            if (!jobQueue.jobs_.empty())
-            {
-                job = jobQueue.jobs_.front();
-                jobQueue.jobs_.pop();
-                if (!job->CheckDependenciesStarted())
-                {
-#ifndef NEKO_SAMETHREAD
-                	if(jobQueue.jobs_.empty())
-                	{
-#ifdef EASY_PROFILE_USE
-                        EASY_BLOCK("Wait for Dependencies");
-#endif
+        Job* job = jobQueue.Pop();
+        if (job == nullptr)
+        {
+            signal.Wait(status_);
+            continue;
+        }
+        signal.RemoveJob();
+        ExecuteJob(job, &profile);
+    }
+}
+
+Job* JobSystem::PopOtherJob(std::size_t workerIndex, bool& stolen)
+{
+    stolen = false;
+    Job* job = workerQueues_[workerIndex]->Pop();
+    if (job != nullptr)
+    {
+        return job;
+    }
+    job = jobs_.Pop();
+    if (job != nullptr)
+    {
+        return job;
+    }
+    const std::size_t workerQueuesNmb = workerQueues_.size();
+    for (std::size_t i = 1; i < workerQueuesNmb; i++)
+    {
+        job = workerQueues_[(workerIndex + i) % workerQueuesNmb]->Steal();
+        if (job != nullptr)
+        {
+            stolen = true;
+            return job;
+        }
+    }
+    return nullptr;
+}
 
-                        jobQueue.cv_.wait_for(lock, std::chrono::microseconds(100));
+bool JobSystem::ExecuteOtherJob()
+{
+    Job* job = nullptr;
+    bool stolen = false;
+    if (currentJobSystem == this)
+    {
+        job = PopOtherJob(currentWorkerIndex, stolen);
+    }
+    else
+    {
+        job = jobs_.Pop();
+        for (std::size_t i = 0; i < workerQueues_.size() && job == nullptr; i++)
+        {
+            job = workerQueues_[i]->Steal();
+        }
+    }
+    if (job == nullptr)
+    {
+        return false;
+    }
+    jobsSignal_.RemoveJob();
+    ExecuteJob(job, currentJobSystem == this ? profiles_[currentWorkerIndex + 2].get() : nullptr, stolen);
+    return true;
+}
 
-                	}
-#endif
-                    jobQueue.jobs_.push(job);
-                    continue;
-                }
+void JobSystem::WorkAndSteal(std::size_t workerIndex)
+{
+    currentJobSystem = this;
+    currentWorkerIndex = workerIndex;
+    WorkerProfile& profile = *profiles_[workerIndex + static_cast<std::size_t>(JobThreadType::OTHER_THREAD)];
+    profile.lastJobEnd = GetProfileTime();
+    ++workersStarted_;
+    while (IsRunning())
+    {
+        bool stolen = false;
+        Job* job = PopOtherJob(workerIndex, stolen);
+        if (job == nullptr)
+        {
+            if (jobsSignal_.GetPendingJobs() > 0)
+            {
+                //A job is being pushed or another worker is stealing it
+                std::this_thread::yield();
             }
             else
             {
-#ifdef NEKO_SAMETHREAD
-                break;
-#else
-                if (IsRunning()) // Atomic check.
-                {
-                    jobQueue.cv_.wait(lock); // !CRITICAL
-                }
-            	continue; //Refetch a new job
-#endif
+                jobsSignal_.Wait(status_);
             }
-        }// !CRITICAL
-        job->Execute();
+            continue;
+        }
+        jobsSignal_.RemoveJob();
+        ExecuteJob(job, &profile, stolen);
     }
+    currentJobSystem = nullptr;
 }
+#endif
 
 void JobSystem::Init()
 {
     status_ = RUNNING;
-#ifndef NEKO_SAMETHREAD
-    numberOfWorkers = std::max(3u, std::thread::hardware_concurrency() - 1);
+#ifdef NEKO_SAMETHREAD
+    //One profile per queue, all executed by the main thread
+    const std::size_t profilesNmb = static_cast<std::size_t>(JobThreadType::OTHER_THREAD) + 1;
+    profiles_.clear();
+    for (std::size_t i = 0; i < profilesNmb; ++i)
+    {
+        profiles_.push_back(std::make_unique<WorkerProfile>());
+        profiles_.back()->lastJobEnd = GetProfileTime();
+    }
+#else
+    if (otherWorkersNmb_ > 0)
+    {
+        numberOfWorkers = otherWorkersNmb_ + 2;
+    }
+    else
+    {
+        numberOfWorkers = std::max(3u, std::thread::hardware_concurrency() - 1);
+    }
     workers_.resize(numberOfWorkers);
+    profiles_.clear();
+    for (size_t i = 0; i < numberOfWorkers; ++i)
+    {
+        profiles_.push_back(std::make_unique<WorkerProfile>());
+    }
+    //Render and resource threads do not own a work stealing queue
+    const size_t otherWorkersNmb = numberOfWorkers - 2;
+    workerQueues_.clear();
+    for (size_t i = 0; i < otherWorkersNmb; ++i)
+    {
+        workerQueues_.push_back(std::make_unique<WorkStealingQueue>());
+    }
 
     const size_t len = numberOfWorkers;
     for (size_t i = 0; i < len; ++i)
@@ -156,17 +594,18 @@ void JobSystem::Init()
         {
             case static_cast<int>(JobThreadType::RENDER_THREAD):
             {
-                workers_[i] = std::thread([this] { Work(renderJobs_); }); // Kick the thread => sys call
+                workers_[i] = std::thread([this, i] { Work(renderJobs_, renderSignal_, *profiles_[i]); }); // Kick the thread => sys call
                 break;
             }
             case static_cast<int>(JobThreadType::RESOURCE_THREAD):
             {
-                workers_[i] = std::thread([this] { Work(resourceJobs_); }); // Kick the thread => sys call
+                workers_[i] = std::thread([this, i] { Work(resourceJobs_, resourceSignal_, *profiles_[i]); }); // Kick the thread => sys call
                 break;
             }
             default:
             {
-                workers_[i] = std::thread([this] { Work(jobs_); }); // Kick the thread => sys call
+                const size_t workerIndex = i - static_cast<size_t>(JobThreadType::OTHER_THREAD);
+                workers_[i] = std::thread([this, workerIndex] { WorkAndSteal(workerIndex); }); // Kick the thread => sys call
                 break;
             }
         }
@@ -179,13 +618,12 @@ void JobSystem::Destroy()
 {
 #ifndef NEKO_SAMETHREAD
 // Spin-lock waiting for all threads to become ready for shutdown.
-    std::function<bool()> checkFunc = [this]()
+    const auto checkFunc = [this]()
     {
-        std::lock_guard<std::mutex> lock(statusMutex_);
-        return workersStarted_ != numberOfWorkers ||
-                  !jobs_.jobs_.empty() ||
-                  !renderJobs_.jobs_.empty() ||
-                  !resourceJobs_.jobs_.empty();
+        return CountStartedWorkers() != numberOfWorkers ||
+               jobsSignal_.GetPendingJobs() > 0 ||
+               renderSignal_.GetPendingJobs() > 0 ||
+               resourceSignal_.GetPendingJobs() > 0;
     };
     while (checkFunc())
     {
@@ -194,38 +632,257 @@ void JobSystem::Destroy()
 #endif
     status_ = NONE;
 #ifndef NEKO_SAMETHREAD
-    renderJobs_.cv_.notify_all();
-    resourceJobs_.cv_.notify_all();
-	jobs_.cv_.notify_all(); // Wake all workers.
+    renderSignal_.WakeAll();
+    resourceSignal_.WakeAll();
+    jobsSignal_.WakeAll(); // Wake all workers.
     const size_t len = numberOfWorkers;
     for (size_t i = 0; i < len; ++i)
     {
         workers_[i].join(); // Join all workers.
     }
+    workersStarted_ = 0;
 #endif
 }
 
-bool JobSystem::IsRunning()
+void JobSystem::ExecuteJob(Job* job, WorkerProfile* profile, bool stolen)
 {
+    if (profile == nullptr)
+    {
+        job->Execute();
+        return;
+    }
+    //The counters are recorded before the job is done, a joining thread sees them once Join returns
+    const std::int64_t scheduleTime = job->scheduleTime_;
+    const std::int64_t start = GetProfileTime();
+    profile->executionDepth++;
+    job->ExecuteTask();
+    profile->executionDepth--;
+    const std::int64_t end = GetProfileTime();
+
+    //Only this thread writes the counters, no need for read-modify-write operations
+    const auto add = [](std::atomic<std::int64_t>& counter, std::int64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    profile->executedJobs.store(profile->executedJobs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (stolen)
+    {
+        profile->stolenJobs.store(profile->stolenJobs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    //Nested jobs are already counted in the busy time of the job executing them
+    if (profile->executionDepth == 0)
+    {
+        add(profile->busyTime, end - start);
+        add(profile->idleTime, std::max<std::int64_t>(start - profile->lastJobEnd, 0));
+        profile->lastJobEnd = end;
+    }
+    if (scheduleTime != 0)
+    {
+        const std::int64_t latency = start - scheduleTime;
+        add(profile->totalScheduleLatency, latency);
+        if (latency > profile->maxScheduleLatency.load(std::memory_order_relaxed))
+        {
+            profile->maxScheduleLatency.store(latency, std::memory_order_relaxed);
+        }
+    }
+
+    if (tracing_.load(std::memory_order_acquire))
+    {
+        const std::uint32_t traceSession = traceSession_.load(std::memory_order_relaxed);
+        if (profile->traceSession.load(std::memory_order_relaxed) != traceSession)
+        {
+            profile->traceSession.store(traceSession, std::memory_order_relaxed);
+            profile->traceEventsCount.store(0, std::memory_order_relaxed);
+        }
+        const std::size_t eventIndex = profile->traceEventsCount.load(std::memory_order_relaxed);
+        if (eventIndex < MAX_TRACE_EVENTS)
+        {
+            profile->traceEvents[eventIndex] = {start, end};
+            profile->traceEventsCount.store(eventIndex + 1, std::memory_order_release);
+        }
+    }
+    job->Finish();
+}
+
+std::int64_t JobSystem::GetProfileTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+JobSystemStats JobSystem::GetStats() const
+{
+    JobSystemStats stats;
+    stats.workers.reserve(profiles_.size());
+    for (const auto& profile : profiles_)
+    {
+        WorkerStats workerStats;
+        workerStats.executedJobs = profile->executedJobs.load(std::memory_order_relaxed);
+        workerStats.stolenJobs = profile->stolenJobs.load(std::memory_order_relaxed);
+        workerStats.busyTime = std::chrono::nanoseconds(profile->busyTime.load(std::memory_order_relaxed));
+        workerStats.idleTime = std::chrono::nanoseconds(profile->idleTime.load(std::memory_order_relaxed));
+        workerStats.totalScheduleLatency = std::chrono::nanoseconds(
+                profile->totalScheduleLatency.load(std::memory_order_relaxed));
+        workerStats.maxScheduleLatency = std::chrono::nanoseconds(
+                profile->maxScheduleLatency.load(std::memory_order_relaxed));
+        stats.workers.push_back(workerStats);
+    }
 #ifndef NEKO_SAMETHREAD
-    std::lock_guard<std::mutex> lock(statusMutex_);
+    stats.otherQueueHighWater = jobsSignal_.GetHighWater();
+    stats.renderQueueHighWater = renderSignal_.GetHighWater();
+    stats.resourceQueueHighWater = resourceSignal_.GetHighWater();
 #endif
-    return status_ & Status::RUNNING;
+    stats.deferredJobs = deferredJobs_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JobSystem::ResetStats()
+{
+    //Counters being updated by a worker can miss the reset, they are only statistics
+    for (auto& profile : profiles_)
+    {
+        profile->executedJobs.store(0, std::memory_order_relaxed);
+        profile->stolenJobs.store(0, std::memory_order_relaxed);
+        profile->busyTime.store(0, std::memory_order_relaxed);
+        profile->idleTime.store(0, std::memory_order_relaxed);
+        profile->totalScheduleLatency.store(0, std::memory_order_relaxed);
+        profile->maxScheduleLatency.store(0, std::memory_order_relaxed);
+    }
+#ifndef NEKO_SAMETHREAD
+    jobsSignal_.ResetHighWater();
+    renderSignal_.ResetHighWater();
+    resourceSignal_.ResetHighWater();
+#endif
+    deferredJobs_.store(0, std::memory_order_relaxed);
+}
+
+void JobSystem::StartTrace()
+{
+    if (IsTracing())
+    {
+        return;
+    }
+    //Buffers are only allocated once, no worker writes in them before the first capture
+    for (auto& profile : profiles_)
+    {
+        if (profile->traceEvents == nullptr)
+        {
+            profile->traceEvents = std::make_unique<JobTraceEvent[]>(MAX_TRACE_EVENTS);
+        }
+    }
+    traceStart_ = GetProfileTime();
+    traceSession_.fetch_add(1, std::memory_order_relaxed);
+    tracing_.store(true, std::memory_order_release);
+}
+
+void JobSystem::StopTrace()
+{
+    tracing_.store(false, std::memory_order_release);
+}
+
+bool JobSystem::IsTracing() const
+{
+    return tracing_.load(std::memory_order_acquire);
+}
+
+std::string JobSystem::GenerateChromeTrace() const
+{
+    fmt::memory_buffer buffer;
+    fmt::format_to(buffer, "{{\"traceEvents\":[");
+    bool firstEvent = true;
+    const auto separator = [&firstEvent]
+    {
+        const char* result = firstEvent ? "" : ",";
+        firstEvent = false;
+        return result;
+    };
+    const std::uint32_t traceSession = traceSession_.load(std::memory_order_relaxed);
+    for (std::size_t workerIndex = 0; workerIndex < profiles_.size(); workerIndex++)
+    {
+        const char* threadName = "Other Worker";
+        if (workerIndex == static_cast<std::size_t>(JobThreadType::RENDER_THREAD))
+        {
+            threadName = "Render Thread";
+        }
+        else if (workerIndex == static_cast<std::size_t>(JobThreadType::RESOURCE_THREAD))
+        {
+            threadName = "Resource Thread";
+        }
+        fmt::format_to(buffer,
+                       "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{} {}\"}}}}",
+                       separator(), workerIndex, threadName, workerIndex);
+        const auto& profile = profiles_[workerIndex];
+        //A worker that did not execute any job during the capture still has the events of the previous one
+        if (profile->traceEvents == nullptr ||
+            profile->traceSession.load(std::memory_order_acquire) != traceSession)
+        {
+            continue;
+        }
+        const std::size_t eventsCount = profile->traceEventsCount.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < eventsCount; i++)
+        {
+            const auto& event = profile->traceEvents[i];
+            fmt::format_to(buffer,
+                           "{}{{\"name\":\"Job\",\"cat\":\"job\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                           separator(), workerIndex,
+                           static_cast<double>(event.start - traceStart_) / 1000.0,
+                           static_cast<double>(event.end - event.start) / 1000.0);
+        }
+    }
+    fmt::format_to(buffer, "]}}");
+    return fmt::to_string(buffer);
+}
+
+void JobSystem::DumpChromeTrace(const std::string& path) const
+{
+    WriteStringToFile(path, GenerateChromeTrace());
+}
+
+bool JobSystem::IsRunning() const
+{
+    return status_.load(std::memory_order_acquire) & Status::RUNNING;
 }
 #ifndef NEKO_SAMETHREAD
-std::uint8_t JobSystem::CountStartedWorkers()
+std::uint8_t JobSystem::CountStartedWorkers() const
 {
-    std::lock_guard<std::mutex> lock(statusMutex_);
-    return workersStarted_;
+    return workersStarted_.load(std::memory_order_acquire);
 }
 #endif
 
-Job::Job(std::function<void()> task) :
-        task_(std::move(task)),
 #ifndef NEKO_SAMETHREAD
-        taskDoneFuture_(promise_.get_future()),
+/**
+ * \brief Wake word shared by all the jobs. A job can be destroyed by its joiner as soon as it is done,
+ * so the wake up after DONE must not touch the job itself.
+ */
+static std::atomic<std::uint32_t> jobsDoneEpoch{0};
+
+/**
+ * \brief Sleep while the done epoch is equal to the expected value
+ */
+static void WaitJobsDone(std::uint32_t expected)
+{
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&jobsDoneEpoch), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    if (jobsDoneEpoch.load(std::memory_order_acquire) == expected)
+    {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+static void WakeJobsDone()
+{
+    jobsDoneEpoch.fetch_add(1, std::memory_order_acq_rel);
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&jobsDoneEpoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
 #endif
-        status_(0)
+
+Job::Job(JobTask task) :
+        task_(std::move(task))
 {
 
 }
@@ -233,28 +890,54 @@ Job::Job(std::function<void()> task) :
 Job::Job(Job&& job) noexcept
 {
     dependencies_ = std::move(job.dependencies_);
+    successors_ = std::move(job.successors_);
     task_ = std::move(job.task_);
-    status_ = job.status_;
-#ifndef NEKO_SAMETHREAD
-    promise_ = std::move(job.promise_);
-    taskDoneFuture_ = std::move(job.taskDoneFuture_);
-#endif
+    jobSystem_ = job.jobSystem_;
+    scheduleTime_ = job.scheduleTime_;
+    unfinishedDependencies_ = job.unfinishedDependencies_.load();
+    threadType_ = job.threadType_;
+    status_ = job.status_.load();
 }
 
 Job& Job::operator=(Job&& job) noexcept
 {
     dependencies_ = std::move(job.dependencies_);
+    successors_ = std::move(job.successors_);
     task_ = std::move(job.task_);
-    status_ = job.status_;
+    jobSystem_ = job.jobSystem_;
+    scheduleTime_ = job.scheduleTime_;
+    unfinishedDependencies_ = job.unfinishedDependencies_.load();
+    threadType_ = job.threadType_;
+    status_ = job.status_.load();
     return *this;
 }
 
 void Job::Join() const
 {
 #ifndef NEKO_SAMETHREAD
-    if(!IsDone())
+    std::uint32_t status = status_.load(std::memory_order_acquire);
+    while (!(status & DONE))
     {
-        taskDoneFuture_.get();
+        //Read the epoch before announcing the wait, a job done after that changes it
+        const std::uint32_t epoch = jobsDoneEpoch.load(std::memory_order_acquire);
+        if (!(status & JOIN_WAITING))
+        {
+            if (!status_.compare_exchange_weak(status, status | JOIN_WAITING,
+                                               std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            status = status_.load(std::memory_order_acquire);
+            if (status & DONE)
+            {
+                break;
+            }
+        }
+        WaitJobsDone(epoch);
+        status = status_.load(std::memory_order_acquire);
     }
 #endif
 }
@@ -262,32 +945,80 @@ void Job::Join() const
 
 void Job::Execute()
 {
-#ifndef NEKO_SAMETHREAD
-    for (auto& dep : dependencies_)
+    ExecuteTask();
+    Finish();
+}
+
+void Job::ExecuteTask()
+{
+    status_.fetch_or(STARTED, std::memory_order_release);
+    task_();
+    //Wait for a concurrent AddDependency to finish, no successor can be added after TASK_DONE
+    std::uint32_t status = status_.load(std::memory_order_relaxed);
+    for (;;)
     {
-        if (!dep->IsDone())
+        if (status & SUCCESSORS_LOCK)
         {
-            dep->Join();
+            status = status_.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (status_.compare_exchange_weak(status, status | TASK_DONE,
+                                          std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            break;
         }
     }
-#endif
-
+    for (auto* successor : successors_)
     {
+        successor->ReleaseDependency();
+    }
+}
+
+void Job::Finish()
+{
+    //The joining thread can destroy the job as soon as DONE is set, this is not accessed after
+    const std::uint32_t previousStatus = status_.fetch_or(DONE, std::memory_order_acq_rel);
 #ifndef NEKO_SAMETHREAD
-        std::lock_guard<std::mutex> lock(statusLock_);
+    if (previousStatus & JOIN_WAITING)
+    {
+        WakeJobsDone();
+    }
+#else
+    (void)previousStatus;
 #endif
-        status_ |= STARTED;
+}
+
+void Job::ReleaseDependency()
+{
+    if (unfinishedDependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        jobSystem_->EnqueueJob(this, threadType_);
     }
-    task_();
+}
+
+bool Job::AddSuccessor(Job* successor) const
+{
+    std::uint32_t status = status_.load(std::memory_order_relaxed);
+    for (;;)
     {
-#ifndef NEKO_SAMETHREAD
-        std::lock_guard<std::mutex> lock(statusLock_);
-#endif
-        status_ |= DONE;
+        if (status & TASK_DONE)
+        {
+            return false;
+        }
+        if (status & SUCCESSORS_LOCK)
+        {
+            status = status_.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (status_.compare_exchange_weak(status, status | SUCCESSORS_LOCK,
+                                          std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            break;
+        }
     }
-#ifndef NEKO_SAMETHREAD
-    promise_.set_value();
-#endif
+    successors_.push_back(successor);
+    status_.fetch_and(~SUCCESSORS_LOCK, std::memory_order_release);
+    return true;
 }
 
 bool Job::CheckDependenciesStarted() const
@@ -300,20 +1031,24 @@ bool Job::CheckDependenciesStarted() const
     return true;
 }
 
+bool Job::CheckDependenciesDone() const
+{
+    for (auto& dep : dependencies_)
+    {
+        if (!dep->IsDone())
+            return false;
+    }
+    return true;
+}
+
 bool Job::HasStarted() const
 {
-#ifndef NEKO_SAMETHREAD
-    std::lock_guard<std::mutex> lock(statusLock_);
-#endif
-    return status_ & STARTED;
+    return status_.load(std::memory_order_acquire) & STARTED;
 }
 
 bool Job::IsDone() const
 {
-#ifndef NEKO_SAMETHREAD
-    std::lock_guard<std::mutex> lock(statusLock_);
-#endif
-    return status_ & DONE;
+    return status_.load(std::memory_order_acquire) & DONE;
 }
 
 void Job::AddDependency(const Job* dependentJob)
@@ -335,23 +1070,49 @@ void Job::AddDependency(const Job* dependentJob)
                 }
                 return true;
             };
+    //The job would be enqueued a second time when this dependency is done
+    neko_assert(!(status_.load(std::memory_order_relaxed) & SCHEDULED), "Dependency added to a scheduled job");
     if(checkDependencies(dependencies_, this))
     {
         dependencies_.push_back(dependentJob);
+        //Count the dependency before it becomes visible to the dependency, it can be released right away
+        unfinishedDependencies_.fetch_add(1, std::memory_order_relaxed);
+        if (!dependentJob->AddSuccessor(this))
+        {
+            //The dependency is already done, the job might be scheduled and waiting only on this count
+            ReleaseDependency();
+        }
     }
 }
 
 void Job::Reset()
 {
-#ifndef NEKO_SAMETHREAD
-    promise_ = std::promise<void>();
-    taskDoneFuture_ = promise_.get_future();
-#endif
-    status_ = 0;
+    status_.store(0, std::memory_order_relaxed);
     dependencies_.clear();
+    successors_.clear();
+    jobSystem_ = nullptr;
+    scheduleTime_ = 0;
+    unfinishedDependencies_ = 1;
 }
 
+JobPool::JobPool(std::size_t size) :
+    jobs_(std::make_unique<Job[]>(size)),
+    size_(size)
+{
+}
 
+Job* JobPool::CreateJob(JobTask task)
+{
+    neko_assert(index_ < size_, "Job Pool is full");
+    Job* job = &jobs_[index_++];
+    job->Reset();
+    job->SetTask(std::move(task));
+    return job;
+}
 
+void JobPool::Clear()
+{
+    index_ = 0;
+}
 
 }
@@ -0,0 +1,125 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <engine/jobsystem_viewer.h>
+
+#include <utility>
+
+#include <imgui.h>
+
+namespace neko
+{
+
+JobSystemViewer::JobSystemViewer(JobSystem& jobSystem, std::string tracePath) :
+    jobSystem_(jobSystem),
+    tracePath_(std::move(tracePath))
+{
+}
+
+void JobSystemViewer::DrawImGui()
+{
+    ImGui::Begin("Job System Profile");
+    const auto stats = jobSystem_.GetStats();
+    ImGui::LabelText("Other Queue High Water", "%d", stats.otherQueueHighWater);
+    ImGui::LabelText("Render Queue High Water", "%d", stats.renderQueueHighWater);
+    ImGui::LabelText("Resource Queue High Water", "%d", stats.resourceQueueHighWater);
+    ImGui::LabelText("Deferred Jobs", "%llu", static_cast<unsigned long long>(stats.deferredJobs));
+
+    ImGui::Columns(7, "Workers");
+    ImGui::Separator();
+    ImGui::Text("Worker");
+    ImGui::NextColumn();
+    ImGui::Text("Jobs");
+    ImGui::NextColumn();
+    ImGui::Text("Stolen");
+    ImGui::NextColumn();
+    ImGui::Text("Busy");
+    ImGui::NextColumn();
+    ImGui::Text("Idle (ms)");
+    ImGui::NextColumn();
+    ImGui::Text("Avg Latency (us)");
+    ImGui::NextColumn();
+    ImGui::Text("Max Latency (us)");
+    ImGui::NextColumn();
+    ImGui::Separator();
+    for (std::size_t i = 0; i < stats.workers.size(); i++)
+    {
+        const auto& worker = stats.workers[i];
+        const float busyTime = std::chrono::duration<float>(worker.busyTime).count();
+        const float idleTime = std::chrono::duration<float>(worker.idleTime).count();
+        const float totalTime = busyTime + idleTime;
+        const float avgLatency = worker.executedJobs == 0 ? 0.0f :
+                std::chrono::duration<float, std::micro>(worker.totalScheduleLatency).count() /
+                static_cast<float>(worker.executedJobs);
+        if (i == static_cast<std::size_t>(JobThreadType::RENDER_THREAD))
+        {
+            ImGui::Text("Render");
+        }
+        else if (i == static_cast<std::size_t>(JobThreadType::RESOURCE_THREAD))
+        {
+            ImGui::Text("Resource");
+        }
+        else
+        {
+            ImGui::Text("Other %zu", i - static_cast<std::size_t>(JobThreadType::OTHER_THREAD));
+        }
+        ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(worker.executedJobs));
+        ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(worker.stolenJobs));
+        ImGui::NextColumn();
+        ImGui::Text("%.1f %%", static_cast<double>(totalTime > 0.0f ? busyTime / totalTime * 100.0f : 0.0f));
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", static_cast<double>(idleTime * 1000.0f));
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", static_cast<double>(avgLatency));
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", static_cast<double>(
+                std::chrono::duration<float, std::micro>(worker.maxScheduleLatency).count()));
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::Separator();
+
+    if (ImGui::Button("Reset Counters"))
+    {
+        jobSystem_.ResetStats();
+    }
+    if (jobSystem_.IsTracing())
+    {
+        if (ImGui::Button("Stop Trace"))
+        {
+            jobSystem_.StopTrace();
+            jobSystem_.DumpChromeTrace(tracePath_);
+        }
+    }
+    else if (ImGui::Button("Start Trace"))
+    {
+        jobSystem_.StartTrace();
+    }
+    ImGui::LabelText("Trace Path", "%s", tracePath_.c_str());
+    ImGui::End();
+}
+
+}
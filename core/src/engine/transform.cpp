@@ -24,6 +24,7 @@
 
 #include <engine/transform.h>
 #include "engine/globals.h"
+#include "engine/engine.h"
 #include "mathematics/transform.h"
 #include "imgui.h"
 #include "graphics/graphics.h"
@@ -33,6 +34,43 @@
 #endif
 namespace neko
 {
+namespace
+{
+#ifdef __AVX2__
+using TransformBatchVec3 = EightVec3f;
+using TransformBatchVec4 = EightVec4f;
+#else
+using TransformBatchVec3 = FourVec3f;
+using TransformBatchVec4 = FourVec4f;
+#endif
+const std::size_t TRANSFORM_BATCH_SIZE = sizeof(TransformBatchVec4::xs) / sizeof(float);
+/**
+ * \brief Number of transforms updated by a job of the parallel for
+ */
+const std::size_t TRANSFORM_GRAIN_SIZE = 512;
+
+/**
+ * \brief Call updateTransforms(entities, count) on the level, split in parallel when an engine runs
+ */
+template<typename UpdateTransformsFunc>
+void UpdateLevel(const std::vector<Entity>& entities,
+                 std::size_t begin,
+                 std::size_t end,
+                 UpdateTransformsFunc updateTransforms)
+{
+    auto* engine = BasicEngine::GetInstance();
+    if (engine == nullptr || end - begin <= TRANSFORM_GRAIN_SIZE)
+    {
+        updateTransforms(entities.data() + begin, end - begin);
+        return;
+    }
+    engine->ParallelFor(begin, end, TRANSFORM_GRAIN_SIZE,
+                        [&entities, &updateTransforms](std::size_t chunkBegin, std::size_t chunkEnd)
+                        {
+                            updateTransforms(entities.data() + chunkBegin, chunkEnd - chunkBegin);
+                        });
+}
+}
 
 void Scale2dManager::AddComponent(Entity entity)
 {
@@ -107,7 +145,49 @@ void Transform2dManager::Update()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Update Transform");
 #endif
-    dirtyManager_.UpdateDirtyEntities();
+    dirtyManager_.UpdateDirtyLevels([this](const std::vector<Entity>& entities, std::size_t begin, std::size_t end)
+    {
+        UpdateLevel(entities, begin, end, [this](const Entity* levelEntities, std::size_t count)
+        {
+            UpdateTransforms(levelEntities, count);
+        });
+    });
+}
+
+void Transform2dManager::UpdateTransforms(const Entity* entities, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i += TRANSFORM_BATCH_SIZE)
+    {
+        const std::size_t batchSize = std::min(count - i, TRANSFORM_BATCH_SIZE);
+        TransformBatchVec3 positions;
+        TransformBatchVec3 scales;
+        TransformBatchVec4 rotations;
+        for (std::size_t j = 0; j < batchSize; j++)
+        {
+            const Entity entity = entities[i + j];
+            const auto position = positionManager_.GetComponent(entity);
+            positions.xs[j] = position.x;
+            positions.ys[j] = position.y;
+            const auto scale = scaleManager_.GetComponent(entity);
+            scales.xs[j] = scale.x;
+            scales.ys[j] = scale.y;
+            scales.zs[j] = 1.0f;
+            const auto rotation = Quaternion::FromEuler(
+                    EulerAngles(degree_t(0), degree_t(0), -rotationManager_.GetComponent(entity)));
+            rotations.xs[j] = rotation.x;
+            rotations.ys[j] = rotation.y;
+            rotations.zs[j] = rotation.z;
+            rotations.ws[j] = rotation.w;
+        }
+        std::array<Mat4f, TRANSFORM_BATCH_SIZE> transforms;
+        Transform3d::ComposeTransforms(positions, scales, rotations, transforms.data());
+        for (std::size_t j = 0; j < batchSize; j++)
+        {
+            const Entity entity = entities[i + j];
+            const auto parent = entityManager_.get().GetEntityParent(entity);
+            SetComponent(entity, parent != INVALID_ENTITY ? GetComponent(parent) * transforms[j] : transforms[j]);
+        }
+    }
 }
 
 void Transform2dManager::UpdateTransform(Entity entity)
@@ -217,7 +297,13 @@ void Transform3dManager::SetScale(Entity entity, Vec3f scale)
 
 void Transform3dManager::SetRotation(Entity entity, EulerAngles angles)
 {
-	rotation3DManager_.SetComponent(entity, angles);
+	rotation3DManager_.SetComponent(entity, Quaternion::FromEuler(angles));
+	dirtyManager_.SetDirty(entity);
+}
+
+void Transform3dManager::SetRotation(Entity entity, const Quaternion& rotation)
+{
+	rotation3DManager_.SetComponent(entity, rotation);
 	dirtyManager_.SetDirty(entity);
 }
 
@@ -232,6 +318,11 @@ Vec3f Transform3dManager::GetScale(Entity entity) const
 }
 
 EulerAngles Transform3dManager::GetAngles(Entity entity) const
+{
+	return Quaternion::ToEuler(rotation3DManager_.GetComponent(entity));
+}
+
+Quaternion Transform3dManager::GetRotation(Entity entity) const
 {
 	return rotation3DManager_.GetComponent(entity);
 }
@@ -251,7 +342,49 @@ void Transform3dManager::Update()
 #ifdef EASY_PROFILE_USE
 	EASY_BLOCK("Update Transform");
 #endif
-	dirtyManager_.UpdateDirtyEntities();
+	dirtyManager_.UpdateDirtyLevels([this](const std::vector<Entity>& entities, std::size_t begin, std::size_t end)
+	{
+		UpdateLevel(entities, begin, end, [this](const Entity* levelEntities, std::size_t count)
+		{
+			UpdateTransforms(levelEntities, count);
+		});
+	});
+}
+
+void Transform3dManager::UpdateTransforms(const Entity* entities, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i += TRANSFORM_BATCH_SIZE)
+	{
+		const std::size_t batchSize = std::min(count - i, TRANSFORM_BATCH_SIZE);
+		TransformBatchVec3 positions;
+		TransformBatchVec3 scales;
+		TransformBatchVec4 rotations;
+		for (std::size_t j = 0; j < batchSize; j++)
+		{
+			const Entity entity = entities[i + j];
+			const auto position = position3DManager_.GetComponent(entity);
+			positions.xs[j] = position.x;
+			positions.ys[j] = position.y;
+			positions.zs[j] = position.z;
+			const auto scale = scale3DManager_.GetComponent(entity);
+			scales.xs[j] = scale.x;
+			scales.ys[j] = scale.y;
+			scales.zs[j] = scale.z;
+			const auto& rotation = rotation3DManager_.GetComponent(entity);
+			rotations.xs[j] = rotation.x;
+			rotations.ys[j] = rotation.y;
+			rotations.zs[j] = rotation.z;
+			rotations.ws[j] = rotation.w;
+		}
+		std::array<Mat4f, TRANSFORM_BATCH_SIZE> transforms;
+		Transform3d::ComposeTransforms(positions, scales, rotations, transforms.data());
+		for (std::size_t j = 0; j < batchSize; j++)
+		{
+			const Entity entity = entities[i + j];
+			const auto parent = entityManager_.get().GetEntityParent(entity);
+			SetComponent(entity, parent != INVALID_ENTITY ? GetComponent(parent) * transforms[j] : transforms[j]);
+		}
+	}
 }
 
 void Transform3dManager::AddComponent(Entity entity)
@@ -260,6 +393,8 @@ void Transform3dManager::AddComponent(Entity entity)
 	scale3DManager_.AddComponent(entity);
 	scale3DManager_.SetComponent(entity, Vec3f::one);
 	rotation3DManager_.AddComponent(entity);
+	//Same rotation as the default euler angles
+	rotation3DManager_.SetComponent(entity, Quaternion::FromEuler(EulerAngles()));
 	return DoubleBufferComponentManager::AddComponent(entity);
 }
 }
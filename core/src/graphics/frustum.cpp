@@ -0,0 +1,318 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "graphics/frustum.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "engine/engine.h"
+#include "engine/jobsystem.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+Frustum Frustum::FromMatrix(const Mat4f& viewProjection)
+{
+    const auto row = [&viewProjection](int index)
+    {
+        return Vec4f(viewProjection[0][index], viewProjection[1][index],
+                     viewProjection[2][index], viewProjection[3][index]);
+    };
+    const Vec4f rows[4] = {row(0), row(1), row(2), row(3)};
+    const Vec4f planes[LENGTH] = {
+        rows[3] + rows[0],
+        rows[3] - rows[0],
+        rows[3] + rows[1],
+        rows[3] - rows[1],
+        rows[3] + rows[2],
+        rows[3] - rows[2]
+    };
+    Frustum frustum;
+    for (int i = 0; i < LENGTH; i++)
+    {
+        const Vec3f normal(planes[i].x, planes[i].y, planes[i].z);
+        const float length = normal.Magnitude();
+        frustum.planes[i] = {normal / length, planes[i].w / length};
+    }
+    return frustum;
+}
+
+Frustum Frustum::FromCamera(const Camera3D& camera)
+{
+    return FromMatrix(camera.GenerateProjectionMatrix() * camera.GenerateViewMatrix());
+}
+
+bool Frustum::ContainsSphere(const Sphere& sphere) const
+{
+    return std::all_of(planes.begin(), planes.end(), [&sphere](const Plane& plane)
+    {
+        return plane.SignedDistance(sphere.center_) >= -sphere.radius_;
+    });
+}
+
+bool Frustum::IntersectAabb(const Aabb3d& aabb) const
+{
+    const Vec3f center = aabb.CalculateCenter();
+    const Vec3f extends = aabb.CalculateExtends();
+    return std::all_of(planes.begin(), planes.end(), [&center, &extends](const Plane& plane)
+    {
+        const float radius = std::abs(plane.normal.x) * extends.x +
+                             std::abs(plane.normal.y) * extends.y +
+                             std::abs(plane.normal.z) * extends.z;
+        return plane.SignedDistance(center) >= -radius;
+    });
+}
+
+void BoundingSpheres::Resize(std::size_t newSize)
+{
+    size = newSize;
+    const std::size_t packsNmb = (newSize + CULLING_PACK_SIZE - 1) / CULLING_PACK_SIZE;
+    centers.resize(packsNmb);
+    radii.resize(packsNmb);
+}
+
+void BoundingSpheres::Set(std::size_t index, const Sphere& sphere)
+{
+    const auto pack = index / CULLING_PACK_SIZE;
+    const auto lane = index % CULLING_PACK_SIZE;
+    centers[pack].xs[lane] = sphere.center_.x;
+    centers[pack].ys[lane] = sphere.center_.y;
+    centers[pack].zs[lane] = sphere.center_.z;
+    radii[pack][lane] = sphere.radius_;
+}
+
+void BoundingBoxes::Resize(std::size_t newSize)
+{
+    size = newSize;
+    const std::size_t packsNmb = (newSize + CULLING_PACK_SIZE - 1) / CULLING_PACK_SIZE;
+    centers.resize(packsNmb);
+    extends.resize(packsNmb);
+}
+
+void BoundingBoxes::Set(std::size_t index, const Aabb3d& aabb)
+{
+    const auto pack = index / CULLING_PACK_SIZE;
+    const auto lane = index % CULLING_PACK_SIZE;
+    const auto center = aabb.CalculateCenter();
+    const auto extend = aabb.CalculateExtends();
+    centers[pack].xs[lane] = center.x;
+    centers[pack].ys[lane] = center.y;
+    centers[pack].zs[lane] = center.z;
+    extends[pack].xs[lane] = extend.x;
+    extends[pack].ys[lane] = extend.y;
+    extends[pack].zs[lane] = extend.z;
+}
+
+namespace
+{
+/**
+ * \brief Mask of the lanes of the pack holding a bound, the last pack can be partially filled
+ */
+std::uint32_t PackLanesMask(std::size_t pack, std::size_t size)
+{
+    const std::size_t first = pack * CULLING_PACK_SIZE;
+    if (first + CULLING_PACK_SIZE <= size)
+        return (1u << CULLING_PACK_SIZE) - 1u;
+    return (1u << (size - first)) - 1u;
+}
+
+std::size_t WriteVisibleIndices(std::uint32_t visibleMask, std::size_t pack, std::uint32_t* visibleIndices)
+{
+    //Branchless: every lane is written, only the visible ones advance the output
+    std::size_t count = 0;
+    for (std::uint32_t lane = 0; lane < CULLING_PACK_SIZE; lane++)
+    {
+        visibleIndices[count] = std::uint32_t(pack * CULLING_PACK_SIZE) + lane;
+        count += (visibleMask >> lane) & 1u;
+    }
+    return count;
+}
+
+#ifdef __AVX2__
+/**
+ * \brief Signed distances of the 8 centers to the plane
+ */
+inline __m256 PlaneDistances(const Plane& plane, const EightVec3f& centers)
+{
+    const auto xs = _mm256_load_ps(centers.xs.data());
+    const auto ys = _mm256_load_ps(centers.ys.data());
+    const auto zs = _mm256_load_ps(centers.zs.data());
+    auto distances = _mm256_fmadd_ps(xs, _mm256_set1_ps(plane.normal.x), _mm256_set1_ps(plane.distance));
+    distances = _mm256_fmadd_ps(ys, _mm256_set1_ps(plane.normal.y), distances);
+    return _mm256_fmadd_ps(zs, _mm256_set1_ps(plane.normal.z), distances);
+}
+#endif
+}
+
+std::size_t CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres,
+                        std::size_t beginPack, std::size_t endPack, std::uint32_t* visibleIndices)
+{
+    std::size_t visibleNmb = 0;
+    for (std::size_t pack = beginPack; pack < endPack; pack++)
+    {
+        std::uint32_t visibleMask = PackLanesMask(pack, spheres.size);
+#ifdef __AVX2__
+        const auto radii = _mm256_loadu_ps(spheres.radii[pack].data());
+        for (const auto& plane : frustum.planes)
+        {
+            const auto distances = _mm256_add_ps(PlaneDistances(plane, spheres.centers[pack]), radii);
+            visibleMask &= std::uint32_t(_mm256_movemask_ps(
+                _mm256_cmp_ps(distances, _mm256_setzero_ps(), _CMP_GE_OQ)));
+        }
+#else
+        const auto& centers = spheres.centers[pack];
+        for (std::size_t lane = 0; lane < CULLING_PACK_SIZE; lane++)
+        {
+            const Sphere sphere{Vec3f(centers.xs[lane], centers.ys[lane], centers.zs[lane]),
+                                spheres.radii[pack][lane]};
+            if (!frustum.ContainsSphere(sphere))
+            {
+                visibleMask &= ~(1u << lane);
+            }
+        }
+#endif
+        visibleNmb += WriteVisibleIndices(visibleMask, pack, visibleIndices + visibleNmb);
+    }
+    return visibleNmb;
+}
+
+std::size_t CullBoxes(const Frustum& frustum, const BoundingBoxes& boxes,
+                      std::size_t beginPack, std::size_t endPack, std::uint32_t* visibleIndices)
+{
+    std::size_t visibleNmb = 0;
+    for (std::size_t pack = beginPack; pack < endPack; pack++)
+    {
+        std::uint32_t visibleMask = PackLanesMask(pack, boxes.size);
+        const auto& extends = boxes.extends[pack];
+#ifdef __AVX2__
+        const auto extendsX = _mm256_load_ps(extends.xs.data());
+        const auto extendsY = _mm256_load_ps(extends.ys.data());
+        const auto extendsZ = _mm256_load_ps(extends.zs.data());
+        for (const auto& plane : frustum.planes)
+        {
+            //Projection of the extends on the plane normal
+            auto radii = _mm256_mul_ps(extendsX, _mm256_set1_ps(std::abs(plane.normal.x)));
+            radii = _mm256_fmadd_ps(extendsY, _mm256_set1_ps(std::abs(plane.normal.y)), radii);
+            radii = _mm256_fmadd_ps(extendsZ, _mm256_set1_ps(std::abs(plane.normal.z)), radii);
+            const auto distances = _mm256_add_ps(PlaneDistances(plane, boxes.centers[pack]), radii);
+            visibleMask &= std::uint32_t(_mm256_movemask_ps(
+                _mm256_cmp_ps(distances, _mm256_setzero_ps(), _CMP_GE_OQ)));
+        }
+#else
+        const auto& centers = boxes.centers[pack];
+        for (std::size_t lane = 0; lane < CULLING_PACK_SIZE; lane++)
+        {
+            const Vec3f center(centers.xs[lane], centers.ys[lane], centers.zs[lane]);
+            const Vec3f extend(extends.xs[lane], extends.ys[lane], extends.zs[lane]);
+            Aabb3d aabb;
+            aabb.lowerLeftBound = center - extend;
+            aabb.upperRightBound = center + extend;
+            if (!frustum.IntersectAabb(aabb))
+            {
+                visibleMask &= ~(1u << lane);
+            }
+        }
+#endif
+        visibleNmb += WriteVisibleIndices(visibleMask, pack, visibleIndices + visibleNmb);
+    }
+    return visibleNmb;
+}
+
+FrustumCuller::FrustumCuller(std::size_t grainSize) :
+    grainPacks_(std::max<std::size_t>(1, grainSize / CULLING_PACK_SIZE))
+{
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::Cull(const Frustum& frustum, const BoundingSpheres& spheres)
+{
+    auto* engine = BasicEngine::GetInstance();
+    return CullChunks(frustum, spheres, engine != nullptr ? &engine->GetJobSystem() : nullptr, CullSpheres);
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::Cull(const Frustum& frustum, const BoundingBoxes& boxes)
+{
+    auto* engine = BasicEngine::GetInstance();
+    return CullChunks(frustum, boxes, engine != nullptr ? &engine->GetJobSystem() : nullptr, CullBoxes);
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::Cull(const Frustum& frustum, const BoundingSpheres& spheres,
+                                                      JobSystem& jobSystem)
+{
+    return CullChunks(frustum, spheres, &jobSystem, CullSpheres);
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::Cull(const Frustum& frustum, const BoundingBoxes& boxes,
+                                                      JobSystem& jobSystem)
+{
+    return CullChunks(frustum, boxes, &jobSystem, CullBoxes);
+}
+
+template<typename Bounds, typename CullFunc>
+const std::vector<std::uint32_t>& FrustumCuller::CullChunks(const Frustum& frustum, const Bounds& bounds,
+                                                            JobSystem* jobSystem, CullFunc cullFunc)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Frustum Culling");
+#endif
+    const std::size_t packsNmb = bounds.centers.size();
+    const std::size_t chunksNmb = (packsNmb + grainPacks_ - 1) / grainPacks_;
+    //Each chunk writes its visible indices at the start of its own range, compacted afterwards
+    visibleIndices_.resize(packsNmb * CULLING_PACK_SIZE);
+    chunkVisibleNmb_.assign(chunksNmb, 0);
+    const auto cullChunk = [&](std::size_t beginPack, std::size_t endPack)
+    {
+        chunkVisibleNmb_[beginPack / grainPacks_] = cullFunc(frustum, bounds, beginPack, endPack,
+            visibleIndices_.data() + beginPack * CULLING_PACK_SIZE);
+    };
+    if (jobSystem == nullptr || chunksNmb <= 1)
+    {
+        for (std::size_t beginPack = 0; beginPack < packsNmb; beginPack += grainPacks_)
+        {
+            cullChunk(beginPack, std::min(beginPack + grainPacks_, packsNmb));
+        }
+    }
+    else
+    {
+        jobSystem->ParallelFor(0, packsNmb, grainPacks_, cullChunk);
+    }
+    std::size_t visibleNmb = chunkVisibleNmb_.empty() ? 0 : chunkVisibleNmb_[0];
+    for (std::size_t chunk = 1; chunk < chunksNmb; chunk++)
+    {
+        const auto chunkBegin = visibleIndices_.begin() + chunk * grainPacks_ * CULLING_PACK_SIZE;
+        std::copy(chunkBegin, chunkBegin + chunkVisibleNmb_[chunk], visibleIndices_.begin() + visibleNmb);
+        visibleNmb += chunkVisibleNmb_[chunk];
+    }
+    visibleIndices_.resize(visibleNmb);
+    return visibleIndices_;
+}
+}
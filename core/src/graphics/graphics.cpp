@@ -31,6 +31,8 @@
 #include "engine/log.h"
 #include "engine/component.h"
 
+#include <fmt/format.h>
+
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
 #endif
@@ -49,14 +51,17 @@ Renderer::Renderer() :
         }),
     syncJob_([this] { SyncBuffers(); })
 {
-    currentCommandBuffer_.reserve(MAX_COMMAND_NMB);
-    nextCommandBuffer_.reserve(MAX_COMMAND_NMB);
 }
 
 
 void Renderer::Render(RenderCommandInterface* command)
 {
-    nextCommandBuffer_.push_back(command);
+    nextCommandQueue_->Push(command, 0);
+}
+
+void Renderer::Render(RenderCommandInterface* command, RenderSortKey key)
+{
+    nextCommandQueue_->Push(command, key);
 }
 
 void Renderer::RenderAll()
@@ -64,9 +69,30 @@ void Renderer::RenderAll()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("RenderAllCPU");
 #endif
-    for (auto* renderCommand : currentCommandBuffer_)
     {
-        renderCommand->Render();
+#ifdef EASY_PROFILE_USE
+        EASY_BLOCK("Sort Render Commands");
+#endif
+        currentCommandQueue_->Sort();
+    }
+    //Zero means unknown, the command binds the state itself
+    std::uint32_t boundShader = 0;
+    std::uint32_t boundTexture = 0;
+    for (const auto& renderCommand : *currentCommandQueue_)
+    {
+        const auto shader = render_key::GetShader(renderCommand.key);
+        if (shader != 0 && shader != boundShader)
+        {
+            BindShader(shader);
+        }
+        const auto texture = render_key::GetTexture(renderCommand.key);
+        if (texture != 0 && texture != boundTexture)
+        {
+            BindTexture(texture);
+        }
+        boundShader = shader;
+        boundTexture = texture;
+        renderCommand.command->Render();
     }
 }
 
@@ -87,6 +113,14 @@ void Renderer::ScheduleJobs()
     engine->ScheduleJob(&renderAllJob_, JobThreadType::RENDER_THREAD);
 }
 
+void Renderer::SchedulePipelinedJobs()
+{
+    auto* engine = BasicEngine::GetInstance();
+    //Otherwise the sync job would wait behind the previous swap buffer in the render queue
+    engine->ScheduleJob(&syncJob_, JobThreadType::MAIN_THREAD);
+    engine->ScheduleJob(&renderAllJob_, JobThreadType::RENDER_THREAD);
+}
+
 void Renderer::RegisterSyncBuffersFunction(SyncBuffersInterface* syncBuffersInterface)
 {
     syncBuffersAction_.RegisterCallback([syncBuffersInterface]
@@ -100,45 +134,42 @@ void Renderer::SyncBuffers()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Swapping Render Command");
 #endif
-    std::swap(currentCommandBuffer_, nextCommandBuffer_);
-    nextCommandBuffer_.clear();
+    std::swap(currentCommandQueue_, nextCommandQueue_);
+    nextCommandQueue_->Clear();
+    if (currentCommandQueue_->GetDroppedCommandsNmb() > 0)
+    {
+        logDebug(fmt::format("[Warning] Render queue full, {} render commands dropped, growing the queues",
+                             currentCommandQueue_->GetDroppedCommandsNmb()));
+        //The current queue grows when it is cleared, the next one must not drop the same commands meanwhile
+        nextCommandQueue_->Reserve(currentCommandQueue_->Size() + currentCommandQueue_->GetDroppedCommandsNmb());
+    }
     syncBuffersAction_.Execute();
 
 }
 
 void Renderer::PreRender()
 {
-    using namespace std::chrono_literals;
-    microseconds availableLoadingTime(8000);
-    while (availableLoadingTime < 8001us)
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Pre Render Jobs");
+#endif
+    const auto start = std::chrono::steady_clock::now();
+    //The first job is always executed, the next ones only while the budget is not spent
+    do
     {
-        std::chrono::time_point<std::chrono::system_clock> start =
-            std::chrono::system_clock::now();
-
-
         Job* job = nullptr;
         {
             std::lock_guard<std::mutex> lock(preRenderJobsMutex_);
-            if (!preRenderJobs_.empty())
+            if (preRenderJobs_.empty() || !preRenderJobs_.front()->CheckDependenciesDone())
             {
-                job = preRenderJobs_.front();
-                preRenderJobs_.erase(preRenderJobs_.begin());
+                //A job waiting for its dependencies stays in front to keep the submission order,
+                //Execute does not join them
+                break;
             }
+            job = preRenderJobs_.front();
+            preRenderJobs_.erase(preRenderJobs_.begin());
         }
-
-        if (job != nullptr && job->CheckDependenciesStarted())
-        {
-            job->Execute();
-        }
-        else
-        {
-            break;
-        }
-
-        std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
-        const auto duration = std::chrono::duration_cast<microseconds>(end - start);
-        availableLoadingTime -= duration;
-    }
+        job->Execute();
+    } while (std::chrono::steady_clock::now() - start < preRenderBudget_);
 }
 
 void Renderer::Destroy()
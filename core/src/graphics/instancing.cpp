@@ -0,0 +1,152 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "graphics/instancing.h"
+
+#include <algorithm>
+
+#include "engine/assert.h"
+#include "engine/transform.h"
+
+namespace neko
+{
+InstancedBatchRenderer::InstancedBatchRenderer(EntityManager& entityManager, Transform3dManager& transformManager) :
+    transformManager_(transformManager)
+{
+    entityManager.RegisterOnDestroyEntity(this);
+}
+
+void InstancedBatchRenderer::Init()
+{
+    RendererLocator::get().RegisterSyncBuffersFunction(this);
+}
+
+void InstancedBatchRenderer::Update([[maybe_unused]] seconds dt)
+{
+    //Each batch binds its own shader and material, only the pass is known here
+    RendererLocator::get().Render(this, render_key::MakeKey(render_key::OPAQUE_PASS, 0, 0, 0));
+}
+
+void InstancedBatchRenderer::Destroy()
+{
+    batches_.clear();
+    entityBatches_.clear();
+    entityIndices_.clear();
+    renderBatches_.clear();
+}
+
+InstancedBatchId InstancedBatchRenderer::GetBatch(const InstancedBatchKey& key)
+{
+    const auto it = std::find_if(batches_.begin(), batches_.end(), [&key](const Batch& batch)
+    {
+        return batch.key == key;
+    });
+    if (it != batches_.end())
+    {
+        return InstancedBatchId(std::distance(batches_.begin(), it));
+    }
+    batches_.push_back({key, {}, true});
+    return InstancedBatchId(batches_.size() - 1);
+}
+
+void InstancedBatchRenderer::AddInstance(Entity entity, InstancedBatchId batchId)
+{
+    neko_assert(batchId < batches_.size(), "Invalid instanced batch");
+    if (entity >= entityBatches_.size())
+    {
+        entityBatches_.resize(entity + 1, INVALID_INSTANCED_BATCH_ID);
+        entityIndices_.resize(entity + 1, 0);
+    }
+    if (entityBatches_[entity] == batchId)
+        return;
+    RemoveInstance(entity);
+    auto& batch = batches_[batchId];
+    entityBatches_[entity] = batchId;
+    entityIndices_[entity] = std::uint32_t(batch.entities.size());
+    batch.entities.push_back(entity);
+    batch.dirty = true;
+}
+
+void InstancedBatchRenderer::RemoveInstance(Entity entity)
+{
+    if (entity >= entityBatches_.size() || entityBatches_[entity] == INVALID_INSTANCED_BATCH_ID)
+        return;
+    auto& batch = batches_[entityBatches_[entity]];
+    //Swap with the last instance to keep the entities packed
+    const auto index = entityIndices_[entity];
+    const Entity lastEntity = batch.entities.back();
+    batch.entities[index] = lastEntity;
+    entityIndices_[lastEntity] = index;
+    batch.entities.pop_back();
+    batch.dirty = true;
+    entityBatches_[entity] = INVALID_INSTANCED_BATCH_ID;
+}
+
+void InstancedBatchRenderer::OnDestroyEntity(Entity entity)
+{
+    //Otherwise the batch would keep drawing the transform of a recycled entity
+    RemoveInstance(entity);
+}
+
+std::size_t InstancedBatchRenderer::GetInstancesNmb(InstancedBatchId batchId) const
+{
+    neko_assert(batchId < batches_.size(), "Invalid instanced batch");
+    return batches_[batchId].entities.size();
+}
+
+InstancedBatchId InstancedBatchRenderer::GetInstanceBatch(Entity entity) const
+{
+    if (entity >= entityBatches_.size())
+        return INVALID_INSTANCED_BATCH_ID;
+    return entityBatches_[entity];
+}
+
+void InstancedBatchRenderer::SyncBuffers()
+{
+    renderBatches_.resize(batches_.size());
+    for (std::size_t i = 0; i < batches_.size(); i++)
+    {
+        auto& batch = batches_[i];
+        if (!batch.dirty)
+            continue;
+        renderBatches_[i].assign(batch.entities.begin(), batch.entities.end());
+        batch.dirty = false;
+    }
+}
+
+std::size_t InstancedBatchRenderer::CopyInstanceTransforms(InstancedBatchId batchId, Mat4f* dst) const
+{
+    if (batchId >= renderBatches_.size())
+        return 0;
+    const auto& transforms = transformManager_.GetCurrentComponentsVector();
+    const auto& entities = renderBatches_[batchId];
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        neko_assert(entities[i] < transforms.size(), "Instanced entity has no transform");
+        dst[i] = transforms[entities[i]];
+    }
+    return entities.size();
+}
+}
@@ -0,0 +1,143 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "graphics/render_queue.h"
+
+#include <algorithm>
+#include <array>
+
+#include "engine/assert.h"
+
+namespace neko
+{
+namespace render_key
+{
+RenderSortKey MakeKey(std::uint32_t pass, std::uint32_t shader, std::uint32_t material, std::uint32_t texture,
+                      float depth)
+{
+    neko_assert(pass < (1u << PASS_BITS), "Render pass does not fit in the sort key");
+    neko_assert(shader < (1u << SHADER_BITS), "Shader program does not fit in the sort key");
+    neko_assert(material < (1u << MATERIAL_BITS), "Material does not fit in the sort key");
+    neko_assert(texture < (1u << TEXTURE_BITS), "Texture does not fit in the sort key");
+    const float maxDepth = float((1u << DEPTH_BITS) - 1u);
+    const auto quantizedDepth = std::uint32_t(std::clamp(depth, 0.0f, 1.0f) * maxDepth);
+    return RenderSortKey(pass) << PASS_SHIFT |
+           RenderSortKey(shader) << SHADER_SHIFT |
+           RenderSortKey(material) << MATERIAL_SHIFT |
+           RenderSortKey(texture) << TEXTURE_SHIFT |
+           RenderSortKey(quantizedDepth) << DEPTH_SHIFT;
+}
+}
+
+RenderQueue::RenderQueue(std::size_t capacity) :
+    commands_(capacity),
+    sortBuffer_(capacity)
+{
+}
+
+void RenderQueue::Push(RenderCommandInterface* command, RenderSortKey key)
+{
+    const auto index = commandsNmb_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= commands_.size())
+    {
+        droppedCommandsNmb_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    commands_[index] = {key, command};
+}
+
+void RenderQueue::Sort()
+{
+    const std::size_t size = Size();
+    if (size < 2)
+    {
+        return;
+    }
+    const std::size_t radixBits = 8;
+    const std::size_t bucketsNmb = 1u << radixBits;
+    const std::size_t passesNmb = sizeof(RenderSortKey) * 8 / radixBits;
+    //All the byte histograms are built in one pass over the keys
+    std::array<std::array<std::size_t, bucketsNmb>, passesNmb> histograms{};
+    for (std::size_t i = 0; i < size; i++)
+    {
+        const auto key = commands_[i].key;
+        for (std::size_t pass = 0; pass < passesNmb; pass++)
+        {
+            histograms[pass][(key >> (pass * radixBits)) & (bucketsNmb - 1)]++;
+        }
+    }
+    RenderCommand* source = commands_.data();
+    RenderCommand* destination = sortBuffer_.data();
+    for (std::size_t pass = 0; pass < passesNmb; pass++)
+    {
+        const std::size_t shift = pass * radixBits;
+        auto& histogram = histograms[pass];
+        //Every command has the same byte, the order would not change
+        if (histogram[(source[0].key >> shift) & (bucketsNmb - 1)] == size)
+        {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (auto& count : histogram)
+        {
+            const auto bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (std::size_t i = 0; i < size; i++)
+        {
+            destination[histogram[(source[i].key >> shift) & (bucketsNmb - 1)]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+    if (source != commands_.data())
+    {
+        std::copy(source, source + size, commands_.data());
+    }
+}
+
+void RenderQueue::Reserve(std::size_t capacity)
+{
+    if (capacity <= commands_.size())
+    {
+        return;
+    }
+    const std::size_t newCapacity = std::max(capacity, commands_.size() * 2);
+    commands_.resize(newCapacity);
+    sortBuffer_.resize(newCapacity);
+}
+
+void RenderQueue::Clear()
+{
+    //The pushed count includes the dropped commands, the next frame has room for all of them
+    Reserve(commandsNmb_.load(std::memory_order_relaxed));
+    commandsNmb_.store(0, std::memory_order_relaxed);
+    droppedCommandsNmb_.store(0, std::memory_order_relaxed);
+}
+
+std::size_t RenderQueue::Size() const
+{
+    return std::min(commandsNmb_.load(std::memory_order_relaxed), commands_.size());
+}
+}
@@ -4,6 +4,14 @@
 
 #include "graphics/sprite.h"
 
+#include <algorithm>
+
+#include "engine/transform.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
 namespace neko
 {
 void SpriteManager::SetTexture(neko::Entity entity, neko::TextureId textureId)
@@ -17,15 +25,126 @@ void SpriteManager::SetTexture(neko::Entity entity, neko::TextureId textureId)
 void SpriteManager::Update([[maybe_unused]]neko::seconds dt)
 {
     //Update sprite if textureName is INVALID
-    for(Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
+    for(Entity entity : entityManager_.get().View(static_cast<EntityMask>(ComponentType::SPRITE2D)))
+    {
+        auto& sprite = components_[entity];
+        if(sprite.textureId != INVALID_TEXTURE_ID && sprite.texture.name == INVALID_TEXTURE_NAME)
+        {
+            sprite.texture = textureManager_.GetTexture(sprite.textureId);
+        }
+    }
+    BuildSpriteBatches();
+}
+
+void SpriteManager::SyncBuffers()
+{
+    std::swap(renderFrame_.vertices, currentFrame_.vertices);
+    std::swap(renderFrame_.batches, currentFrame_.batches);
+    //The copies are kept until the render thread does them
+    atlasRegionsToCopy_.insert(atlasRegionsToCopy_.end(), newAtlasRegions_.begin(), newAtlasRegions_.end());
+    newAtlasRegions_.clear();
+    for (const TextureId& textureId : failedAtlasCopies_)
+    {
+        auto& region = atlasRegions_[textureId];
+        region.atlasIndex = INVALID_SPRITE_ATLAS;
+        region.position = Vec2i();
+        region.uvMin = Vec2f();
+        region.uvMax = Vec2f::one;
+    }
+    failedAtlasCopies_.clear();
+}
+
+const SpriteAtlasRegion& SpriteManager::GetAtlasRegion(TextureId textureId, const Texture& texture)
+{
+    const auto it = atlasRegions_.find(textureId);
+    if (it != atlasRegions_.end())
+    {
+        return it->second;
+    }
+    SpriteAtlasRegion region;
+    region.textureId = textureId;
+    region.texture = texture.name;
+    region.size = texture.size;
+    //Big textures like backgrounds would waste the atlases, they are drawn from their own texture
+    const bool fitsInAtlas = texture.isRgba8 && texture.size.x > 0 && texture.size.y > 0 &&
+        texture.size.x <= ATLAS_SIZE / 2 && texture.size.y <= ATLAS_SIZE / 2;
+    const Vec2i paddedSize = texture.size + Vec2i(2 * ATLAS_PADDING, 2 * ATLAS_PADDING);
+    for (SpriteAtlasIndex i = 0; fitsInAtlas; i++)
+    {
+        if (i == atlasPackers_.size())
+        {
+            atlasPackers_.emplace_back(Vec2i(ATLAS_SIZE, ATLAS_SIZE));
+        }
+        if (atlasPackers_[i].Insert(paddedSize, region.position))
+        {
+            region.atlasIndex = i;
+            region.position += Vec2i(ATLAS_PADDING, ATLAS_PADDING);
+            region.uvMin = Vec2f(region.position) / float(ATLAS_SIZE);
+            region.uvMax = Vec2f(region.position + region.size) / float(ATLAS_SIZE);
+            newAtlasRegions_.push_back(region);
+            break;
+        }
+    }
+    return atlasRegions_.emplace(textureId, region).first->second;
+}
+
+void SpriteManager::BuildSpriteBatches()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Build Sprite Batches");
+#endif
+    //Sort by layer, then by atlas, the sign bit of the layer is flipped to sort negative layers first
+    sortedSprites_.clear();
+    for (Entity entity : entityManager_.get().View(static_cast<EntityMask>(ComponentType::SPRITE2D)))
+    {
+        const auto& sprite = components_[entity];
+        if (sprite.texture.name == INVALID_TEXTURE_NAME)
+            continue;
+        const auto& region = GetAtlasRegion(sprite.textureId, sprite.texture);
+        const std::uint32_t textureKey = region.atlasIndex != INVALID_SPRITE_ATLAS ?
+            region.atlasIndex : (1u << 31u) | region.texture;
+        const auto layerKey = std::uint32_t(sprite.layer) ^ (1u << 31u);
+        sortedSprites_.emplace_back(std::uint64_t(layerKey) << 32u | textureKey, entity);
+    }
+    std::sort(sortedSprites_.begin(), sortedSprites_.end());
+
+    auto& vertices = currentFrame_.vertices;
+    auto& batches = currentFrame_.batches;
+    vertices.resize(sortedSprites_.size() * 4);
+    batches.clear();
+    const Vec2f corners[4] = {
+        Vec2f(0.5f, 0.5f),
+        Vec2f(0.5f, -0.5f),
+        Vec2f(-0.5f, -0.5f),
+        Vec2f(-0.5f, 0.5f)
+    };
+    std::uint64_t batchKey = 0;
+    for (std::size_t i = 0; i < sortedSprites_.size(); i++)
     {
-        if(entityManager_.get().HasComponent(entity, static_cast<EntityMask>(ComponentType::SPRITE2D)))
+        const auto [key, entity] = sortedSprites_[i];
+        const auto& sprite = components_[entity];
+        const auto& region = atlasRegions_.find(sprite.textureId)->second;
+        if (batches.empty() || key != batchKey)
+        {
+            batches.push_back({sprite.layer, region.atlasIndex, region.texture, std::uint32_t(i), 0});
+            batchKey = key;
+        }
+        batches.back().spritesNmb++;
+
+        const bool hasTransform = entityManager_.get().HasComponent(entity,
+            EntityMask(ComponentType::TRANSFORM2D));
+        const Mat4f& transform = hasTransform ? transformManager_.GetComponent(entity) : Mat4f::Identity;
+        const Vec2f uvs[4] = {
+            region.uvMax,
+            Vec2f(region.uvMax.x, region.uvMin.y),
+            region.uvMin,
+            Vec2f(region.uvMin.x, region.uvMax.y)
+        };
+        for (int corner = 0; corner < 4; corner++)
         {
-            auto& sprite = components_[entity];
-            if(sprite.textureId != INVALID_TEXTURE_ID && sprite.texture.name == INVALID_TEXTURE_NAME)
-            {
-                sprite.texture = textureManager_.GetTexture(sprite.textureId);
-            }
+            const Vec4f position = transform[3] +
+                transform[0] * corners[corner].x + transform[1] * corners[corner].y;
+            vertices[i * 4 + corner] = {Vec3f(position), uvs[corner], sprite.color};
         }
     }
 }
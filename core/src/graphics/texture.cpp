@@ -21,11 +21,16 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
+#include <cstdio>
+#include <fstream>
+
 #include "graphics/graphics.h"
 #include "graphics/texture.h"
+#include "graphics/texture_cache.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "engine/engine.h"
+#include "utilities/asset_archive.h"
 #include "utilities/file_utility.h"
 #include <fmt/format.h>
 
@@ -63,8 +68,57 @@ TextureLoader::TextureLoader(TextureManager& textureManager) :
 	convertImageJob_([this]
     {
 	    logDebug("[Texture Manager] Convert buffer file to image");
-        image_ = StbImageConvert(diskLoadJob_.GetBufferFile(), flags_ & Texture::FLIP_Y, flags_ & Texture::HDR);
-        TextureInfo textureInfo{ textureId_, std::move(image_), flags_ };
+        const auto convertStart = std::chrono::steady_clock::now();
+        TextureInfo textureInfo;
+        textureInfo.textureId = textureId_;
+        textureInfo.flags = flags_;
+        const bool isCacheEnabled = !textureManager_.GetCacheFolder().empty();
+        const std::string stamp = isCacheEnabled ? GetTextureCacheStamp(sourcePath_, flags_) : std::string();
+        if (isCacheRead_)
+        {
+            textureInfo.isCacheHit = ReadTextureCache(diskLoadJob_.ReleaseBufferFile(), stamp,
+                                                      textureInfo.cachedTexture);
+            if (!textureInfo.isCacheHit)
+            {
+                //The cached texture is outdated, the source image is read here instead of on the I/O service
+                BufferFile sourceFile;
+                sourceFile.Load(sourcePath_);
+                image_ = StbImageConvert(sourceFile, flags_ & Texture::FLIP_Y, flags_ & Texture::HDR);
+                sourceFile.Destroy();
+            }
+        }
+        else
+        {
+            image_ = StbImageConvert(diskLoadJob_.GetBufferFile(), flags_ & Texture::FLIP_Y, flags_ & Texture::HDR);
+        }
+        if (!textureInfo.isCacheHit && isCacheEnabled && textureManager_.IsCacheWritable() && image_.data != nullptr)
+        {
+            //The mip chain built for the cache is uploaded instead of being generated on the GPU
+            auto cacheFile = WriteTextureCache(image_, flags_, stamp);
+            const auto cachePath = textureManager_.GetCachePath(textureId_);
+            //Written aside then renamed, a crash or another process never leaves a truncated file at the cache path
+            const auto tempPath = fmt::format("{}.{}.tmp", cachePath, sole::uuid4().str());
+            bool isWritten;
+            {
+                std::ofstream cacheStream(tempPath, std::ofstream::binary);
+                cacheStream.write(reinterpret_cast<const char*>(cacheFile.dataBuffer), cacheFile.dataLength);
+                cacheStream.close();
+                isWritten = static_cast<bool>(cacheStream);
+            }
+            if (!isWritten || !RenameFile(tempPath, cachePath))
+            {
+                logDebug(fmt::format("[Error] Could not write texture cache: {}", cachePath));
+                std::remove(tempPath.c_str());
+            }
+            if (ReadTextureCache(std::move(cacheFile), stamp, textureInfo.cachedTexture))
+            {
+                image_.Destroy();
+            }
+        }
+        textureInfo.image = std::move(image_);
+        textureInfo.readDuration = std::chrono::duration_cast<microseconds>(convertStart - loadStart_);
+        textureInfo.decodeDuration = std::chrono::duration_cast<microseconds>(
+            std::chrono::steady_clock::now() - convertStart);
         textureManager_.UploadToGpu(std::move(textureInfo));
         logDebug("[Texture Manager] Finish converting buffer file to image");
     })
@@ -74,17 +128,22 @@ TextureLoader::TextureLoader(TextureManager& textureManager) :
 void TextureLoader::SetTextureId(TextureId textureId)
 {
 	textureId_ = textureId;
-	const auto path = textureManager_.GetPath(textureId_);
-	diskLoadJob_.SetFilePath(path);
+	sourcePath_ = textureManager_.GetPath(textureId_);
+	const auto cachePath = textureManager_.GetCachePath(textureId_);
+	isCacheRead_ = !cachePath.empty() && FileExists(cachePath);
+	diskLoadJob_.SetFilePath(isCacheRead_ ? cachePath : sourcePath_);
 }
 
 void TextureLoader::LoadFromDisk()
 {
     if (textureId_ != INVALID_TEXTURE_ID)
     {
+        loadStart_ = std::chrono::steady_clock::now();
 #ifndef NEKO_SAMETHREAD
-        BasicEngine::GetInstance()->ScheduleJob(&diskLoadJob_, JobThreadType::RESOURCE_THREAD);
+        //Linked before the read is submitted, the I/O service can complete it right away
         convertImageJob_.AddDependency(&diskLoadJob_);
+        //Without an I/O service the loaders read on the worker threads, the single resource thread would serialize them
+        BasicEngine::GetInstance()->ScheduleResourceJob(&diskLoadJob_, JobThreadType::OTHER_THREAD);
         BasicEngine::GetInstance()->ScheduleJob(&convertImageJob_, JobThreadType::OTHER_THREAD);
 #else
         diskLoadJob_.Execute();
@@ -101,29 +160,41 @@ void TextureLoader::Reset()
 
 
 
-TextureManager::TextureManager() : textureLoader_(*this), uploadToGpuJob_([this]()
+TextureManager::TextureManager() : uploadToGpuJob_([this]()
 {
-	CreateTexture();
-	currentUploadedTexture_.textureId = INVALID_TEXTURE_ID;
+	UploadTextures();
 })
 {
-
+    textureLoaders_.reserve(TEXTURE_LOADERS_NMB);
+    for (std::size_t i = 0; i < TEXTURE_LOADERS_NMB; i++)
+    {
+        textureLoaders_.push_back(std::make_unique<TextureLoader>(*this));
+    }
 }
 
 TextureId TextureManager::LoadTexture(std::string_view path, Texture::TextureFlags flags)
 {
 	
-	const std::string metaPath = std::string(path) + ".meta";
-    auto metaJson = LoadJson(metaPath);
     TextureId textureId = INVALID_TEXTURE_ID;
-	if(CheckJsonExists(metaJson, "uuid"))
-	{
-        textureId = sole::rebuild(metaJson["uuid"].get<std::string>());
-	}
+    //The archive table of contents already has the texture id, no meta file to parse
+    const auto* archiveEntry = AssetArchiveLocator::get().FindEntry(path);
+    if (archiveEntry != nullptr)
+    {
+        textureId = sole::rebuild(archiveEntry->uuidAb, archiveEntry->uuidCd);
+    }
     else
     {
-        logDebug("[Error] Could not find texture id in json file");
-        return textureId;
+        const std::string metaPath = std::string(path) + ".meta";
+        auto metaJson = LoadJson(metaPath);
+        if (CheckJsonExists(metaJson, "uuid"))
+        {
+            textureId = sole::rebuild(metaJson["uuid"].get<std::string>());
+        }
+        else
+        {
+            logDebug("[Error] Could not find texture id in json file");
+            return textureId;
+        }
     }
 
     if (textureId == INVALID_TEXTURE_ID)
@@ -141,6 +212,15 @@ TextureId TextureManager::LoadTexture(std::string_view path, Texture::TextureFla
 	logDebug(fmt::format("[Texture Manager] Loading texture path: {}", path));
 
     texturePathMap_[textureId] = std::string(path.data());
+    {
+        std::lock_guard<std::mutex> lock(metricsMutex_);
+        if (pendingTexturesNmb_ == 0)
+        {
+            batchStart_ = std::chrono::steady_clock::now();
+        }
+        pendingTexturesNmb_++;
+        metrics_.requestedNmb++;
+    }
 #ifndef NEKO_SAMETHREAD
 	//Put texture in queue
     TextureInfo textureInfo;
@@ -148,15 +228,13 @@ TextureId TextureManager::LoadTexture(std::string_view path, Texture::TextureFla
     textureInfo.flags = flags;
     texturesToLoad_.push(std::move(textureInfo));
 #else
-    textureLoader_.Reset();
+    auto& textureLoader = *textureLoaders_.front();
+    textureLoader.Reset();
 
-    textureLoader_.SetTextureId(textureId);
-    textureLoader_.SetTextureFlags(flags);
-    textureLoader_.LoadFromDisk();
+    textureLoader.SetTextureId(textureId);
+    textureLoader.SetTextureFlags(flags);
+    textureLoader.LoadFromDisk();
 
-    auto& textureInfo = texturesToUpload_.front();
-    currentUploadedTexture_ = std::move(textureInfo);
-    texturesToUpload_.pop();
     uploadToGpuJob_.Reset();
     uploadToGpuJob_.Execute();
 #endif
@@ -176,50 +254,152 @@ std::string TextureManager::GetPath(TextureId textureId) const
 void TextureManager::Init()
 {
     TextureManagerLocator::provide(this);
+    const auto* engine = BasicEngine::GetInstance();
+    if (cacheFolder_.empty() && engine != nullptr && !engine->config.textureCacheFolder.empty())
+    {
+        cacheFolder_ = engine->config.dataRootPath + engine->config.textureCacheFolder;
+    }
+#if !defined(__ANDROID__) && !defined(EMSCRIPTEN)
+    if (!cacheFolder_.empty() && !IsDirectory(cacheFolder_))
+    {
+        CreateDirectory(cacheFolder_);
+    }
+#endif
+}
+
+std::string TextureManager::GetCachePath(TextureId textureId) const
+{
+    if (cacheFolder_.empty())
+    {
+        return "";
+    }
+    const char* separator = cacheFolder_.back() == '/' ? "" : "/";
+    return fmt::format("{}{}{}{}", cacheFolder_, separator, textureId.str(), TEXTURE_CACHE_EXTENSION);
 }
 
 void TextureManager::Update([[maybe_unused]]seconds dt)
 {
 #ifndef NEKO_SAMETHREAD
-    if (!texturesToLoad_.empty())
+    for (auto& textureLoader : textureLoaders_)
     {
-        if (textureLoader_.IsLoaded() || !textureLoader_.HasStarted())
-        {
-            logDebug("[Texture Manager] Loading a texture from disk");
-            textureLoader_.Reset();
-            const auto& textureInfo = texturesToLoad_.front();
-            textureLoader_.SetTextureId(textureInfo.textureId);
-            textureLoader_.SetTextureFlags(textureInfo.flags);
-            textureLoader_.LoadFromDisk();
-            texturesToLoad_.pop();
-        }
+        if (texturesToLoad_.empty())
+            break;
+        if (!textureLoader->IsFree())
+            continue;
+        logDebug("[Texture Manager] Loading a texture from disk");
+        textureLoader->Reset();
+        const auto& textureInfo = texturesToLoad_.front();
+        textureLoader->SetTextureId(textureInfo.textureId);
+        textureLoader->SetTextureFlags(textureInfo.flags);
+        textureLoader->LoadFromDisk();
+        texturesToLoad_.pop();
     }
-	if(!texturesToUpload_.empty() && currentUploadedTexture_.textureId == INVALID_TEXTURE_ID)
+    //The upload job is scheduled again only when the previous one was executed by the renderer
+    if (isUploadScheduled_ && !uploadToGpuJob_.IsDone())
+        return;
+    bool hasTexturesToUpload;
+    {
+        std::lock_guard<std::mutex> lock(uploadMutex_);
+        hasTexturesToUpload = !texturesToUpload_.empty();
+    }
+    if (hasTexturesToUpload)
     {
-
-        logDebug("[Texture Manager] Uploading a texture to the GPU");
-		auto& textureInfo = texturesToUpload_.front();
-        currentUploadedTexture_ = std::move(textureInfo);
-	    texturesToUpload_.pop();
         uploadToGpuJob_.Reset();
-	    RendererLocator::get().AddPreRenderJob(&uploadToGpuJob_);
-	}
+        RendererLocator::get().AddPreRenderJob(&uploadToGpuJob_);
+        isUploadScheduled_ = true;
+    }
 #endif
 }
 
 void TextureManager::Destroy()
 {
     texturePathMap_.clear();
+    std::lock_guard<std::mutex> lock(textureMapMutex_);
     textureMap_.clear();
 }
 
 void TextureManager::UploadToGpu(TextureInfo&& texture)
 {
+    std::lock_guard<std::mutex> lock(uploadMutex_);
 	texturesToUpload_.push(std::move(texture));
 }
 
+/**
+ * \brief Bytes sent to the GPU for the texture, the cached levels or the decoded image
+ */
+static std::size_t GetUploadSize(const TextureInfo& textureInfo)
+{
+    const auto& image = textureInfo.image;
+    if (textureInfo.cachedTexture.levels.empty() && image.data != nullptr)
+    {
+        return std::size_t(image.width) * image.height * image.nbChannels *
+            (textureInfo.flags & Texture::HDR ? sizeof(float) : 1);
+    }
+    return textureInfo.cachedTexture.GetDataSize();
+}
+
+void TextureManager::UploadTextures()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Upload Textures");
+#endif
+    std::size_t uploadedBytes = 0;
+    //At least one texture per frame, even when it is bigger than the budget
+    for (std::size_t uploadedNmb = 0;; uploadedNmb++)
+    {
+        std::size_t imageSize = 0;
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex_);
+            if (texturesToUpload_.empty())
+                break;
+            //The next texture waits for the next frame if it would go over the budget
+            imageSize = GetUploadSize(texturesToUpload_.front());
+            if (uploadedNmb > 0 && uploadedBytes + imageSize > uploadBudget_)
+                break;
+            currentUploadedTexture_ = std::move(texturesToUpload_.front());
+            texturesToUpload_.pop();
+        }
+        logDebug("[Texture Manager] Uploading a texture to the GPU");
+        const auto uploadStart = std::chrono::steady_clock::now();
+        CreateTexture();
+        const auto uploadEnd = std::chrono::steady_clock::now();
+        uploadedBytes += imageSize;
+
+        std::lock_guard<std::mutex> lock(metricsMutex_);
+        metrics_.uploadedNmb++;
+        metrics_.uploadedBytes += imageSize;
+        metrics_.cacheHitsNmb += currentUploadedTexture_.isCacheHit;
+        metrics_.readDuration += currentUploadedTexture_.readDuration;
+        metrics_.decodeDuration += currentUploadedTexture_.decodeDuration;
+        metrics_.uploadDuration += std::chrono::duration_cast<microseconds>(uploadEnd - uploadStart);
+        //Textures pushed directly with UploadToGpu were not counted as pending
+        if (pendingTexturesNmb_ > 0 && --pendingTexturesNmb_ == 0)
+        {
+            metrics_.lastBatchDuration = std::chrono::duration_cast<microseconds>(uploadEnd - batchStart_);
+            metrics_.batchesDuration += metrics_.lastBatchDuration;
+            logDebug(fmt::format("[Texture Manager] Loaded {} textures ({} cached) in {} ms (read: {} ms, decode: {} ms, upload: {} ms)",
+                                 metrics_.uploadedNmb,
+                                 metrics_.cacheHitsNmb,
+                                 metrics_.batchesDuration.count() / 1000,
+                                 metrics_.readDuration.count() / 1000,
+                                 metrics_.decodeDuration.count() / 1000,
+                                 metrics_.uploadDuration.count() / 1000));
+        }
+    }
+    currentUploadedTexture_.textureId = INVALID_TEXTURE_ID;
+    currentUploadedTexture_.image.Destroy();
+    currentUploadedTexture_.cachedTexture.Destroy();
+}
+
+TextureLoadMetrics TextureManager::GetLoadMetrics() const
+{
+    std::lock_guard<std::mutex> lock(metricsMutex_);
+    return metrics_;
+}
+
 Texture TextureManager::GetTexture(TextureId index) const
 {
+    std::lock_guard<std::mutex> lock(textureMapMutex_);
     const auto it = textureMap_.find(index);
 	if(it != textureMap_.end())
 	{
@@ -230,10 +410,30 @@ Texture TextureManager::GetTexture(TextureId index) const
 
 bool TextureManager::IsTextureLoaded(TextureId textureId) const
 {
+    std::lock_guard<std::mutex> lock(textureMapMutex_);
     return textureMap_.find(textureId) != textureMap_.end();
 }
 
 
+std::size_t CachedTexture::GetDataSize() const
+{
+    std::size_t dataSize = 0;
+    for (const auto& level : levels)
+    {
+        dataSize += level.size;
+    }
+    return dataSize;
+}
+
+void CachedTexture::Destroy()
+{
+    file.Destroy();
+    levels.clear();
+    glInternalFormat = 0;
+    glFormat = 0;
+    glType = 0;
+}
+
 Image::Image(Image&& image) noexcept
 {
 	data = image.data;
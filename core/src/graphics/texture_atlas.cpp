@@ -0,0 +1,67 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "graphics/texture_atlas.h"
+
+namespace neko
+{
+AtlasPacker::AtlasPacker(Vec2i size, int padding) : size_(size), padding_(padding)
+{
+}
+
+bool AtlasPacker::Insert(Vec2i rectSize, Vec2i& position)
+{
+    const int width = rectSize.x + padding_;
+    const int height = rectSize.y + padding_;
+    if (rectSize.x <= 0 || rectSize.y <= 0 || width > size_.x || height > size_.y)
+        return false;
+    //Best fit: the shelf wasting the least height
+    Shelf* bestShelf = nullptr;
+    for (auto& shelf : shelves_)
+    {
+        if (shelf.height >= height && shelf.width + width <= size_.x &&
+            (bestShelf == nullptr || shelf.height < bestShelf->height))
+        {
+            bestShelf = &shelf;
+        }
+    }
+    if (bestShelf == nullptr)
+    {
+        const int y = shelves_.empty() ? 0 : shelves_.back().y + shelves_.back().height;
+        if (y + height > size_.y)
+            return false;
+        shelves_.push_back({y, height, 0});
+        bestShelf = &shelves_.back();
+    }
+    position = Vec2i(bestShelf->width, bestShelf->y);
+    bestShelf->width += width;
+    return true;
+}
+
+void AtlasPacker::Clear()
+{
+    shelves_.clear();
+}
+}
@@ -0,0 +1,432 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "graphics/texture_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "utilities/asset_archive.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+const std::array<unsigned char, 12> KTX_IDENTIFIER =
+    {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+const std::uint32_t KTX_ENDIANNESS = 0x04030201u;
+
+//OpenGL values, the core does not include the OpenGL headers
+const std::uint32_t GL_UNSIGNED_BYTE_VALUE = 0x1401u;
+const std::uint32_t GL_FLOAT_VALUE = 0x1406u;
+const std::uint32_t GL_HALF_FLOAT_VALUE = 0x140Bu;
+const std::uint32_t GL_RED_VALUE = 0x1903u;
+const std::uint32_t GL_RG_VALUE = 0x8227u;
+const std::uint32_t GL_RGB_VALUE = 0x1907u;
+const std::uint32_t GL_RGBA_VALUE = 0x1908u;
+const std::uint32_t GL_COMPRESSED_R11_EAC_VALUE = 0x9270u;
+const std::uint32_t GL_COMPRESSED_RGB8_ETC2_VALUE = 0x9274u;
+const std::uint32_t GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC_VALUE = 0x9279u;
+const std::uint32_t GL_ETC1_RGB8_OES_VALUE = 0x8D64u;
+
+struct KtxHeader
+{
+    std::array<unsigned char, 12> identifier = KTX_IDENTIFIER;
+    std::uint32_t endianness = KTX_ENDIANNESS;
+    std::uint32_t glType = 0;
+    std::uint32_t glTypeSize = 0;
+    std::uint32_t glFormat = 0;
+    std::uint32_t glInternalFormat = 0;
+    std::uint32_t glBaseInternalFormat = 0;
+    std::uint32_t pixelWidth = 0;
+    std::uint32_t pixelHeight = 0;
+    std::uint32_t pixelDepth = 0;
+    std::uint32_t numberOfArrayElements = 0;
+    std::uint32_t numberOfFaces = 1;
+    std::uint32_t numberOfMipmapLevels = 1;
+    std::uint32_t bytesOfKeyValueData = 0;
+};
+static_assert(sizeof(KtxHeader) == 64);
+
+std::size_t AlignKtx(std::size_t size)
+{
+    return (size + 3u) & ~std::size_t(3u);
+}
+
+std::uint32_t GetGlFormat(int nbChannels)
+{
+    switch (nbChannels)
+    {
+        case 1:
+            return GL_RED_VALUE;
+        case 2:
+            return GL_RG_VALUE;
+        case 3:
+            return GL_RGB_VALUE;
+        case 4:
+            return GL_RGBA_VALUE;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * \brief Same internal formats as the decoded images uploaded by the gl texture manager
+ */
+std::uint32_t GetGlInternalFormat(int nbChannels, Texture::TextureFlags flags)
+{
+    if (flags & Texture::HDR)
+    {
+        //R16F, RG16F, RGB16F, RGBA16F
+        const std::array<std::uint32_t, 4> hdrFormats{0x822Du, 0x822Fu, 0x881Bu, 0x881Au};
+        return hdrFormats[nbChannels - 1];
+    }
+    const bool isSrgb = flags & Texture::GAMMA_CORRECTION;
+    //R8, RG8, RGB8 or SRGB8, RGBA8 or SRGB8_ALPHA8
+    const std::array<std::uint32_t, 4> formats{0x8229u, 0x822Bu, isSrgb ? 0x8C41u : 0x8051u,
+                                               isSrgb ? 0x8C43u : 0x8058u};
+    return formats[nbChannels - 1];
+}
+
+float SrgbToLinear(unsigned char value)
+{
+    static const auto table = []
+    {
+        std::array<float, 256> values{};
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            const float srgb = static_cast<float>(i) / 255.0f;
+            values[i] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table[value];
+}
+
+unsigned char LinearToSrgb(float value)
+{
+    const float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<unsigned char>(std::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+/**
+ * \brief Tightly packed level of the mip chain
+ */
+template<typename T>
+struct MipLevel
+{
+    std::vector<T> pixels;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * \brief 2x2 box filter, the last row and column are repeated for odd sizes
+ */
+template<typename T>
+MipLevel<T> Downsample(const MipLevel<T>& source, int nbChannels, bool isSrgb)
+{
+    MipLevel<T> level;
+    level.width = std::max(1, source.width / 2);
+    level.height = std::max(1, source.height / 2);
+    level.pixels.resize(std::size_t(level.width) * level.height * nbChannels);
+    for (int y = 0; y < level.height; y++)
+    {
+        const std::size_t row0 = std::size_t(std::min(2 * y, source.height - 1)) * source.width;
+        const std::size_t row1 = std::size_t(std::min(2 * y + 1, source.height - 1)) * source.width;
+        for (int x = 0; x < level.width; x++)
+        {
+            const std::size_t column0 = std::min(2 * x, source.width - 1);
+            const std::size_t column1 = std::min(2 * x + 1, source.width - 1);
+            const std::array<std::size_t, 4> samples{
+                (row0 + column0) * nbChannels, (row0 + column1) * nbChannels,
+                (row1 + column0) * nbChannels, (row1 + column1) * nbChannels};
+            T* pixel = &level.pixels[(std::size_t(y) * level.width + x) * nbChannels];
+            for (int channel = 0; channel < nbChannels; channel++)
+            {
+                if constexpr (std::is_same_v<T, float>)
+                {
+                    float sum = 0.0f;
+                    for (const auto sample : samples)
+                    {
+                        sum += source.pixels[sample + channel];
+                    }
+                    pixel[channel] = sum * 0.25f;
+                }
+                else if (isSrgb && channel < 3)
+                {
+                    float sum = 0.0f;
+                    for (const auto sample : samples)
+                    {
+                        sum += SrgbToLinear(source.pixels[sample + channel]);
+                    }
+                    pixel[channel] = LinearToSrgb(sum * 0.25f);
+                }
+                else
+                {
+                    unsigned sum = 2u;
+                    for (const auto sample : samples)
+                    {
+                        sum += source.pixels[sample + channel];
+                    }
+                    pixel[channel] = static_cast<T>(sum / 4u);
+                }
+            }
+        }
+    }
+    return level;
+}
+
+template<typename T>
+std::vector<MipLevel<T>> GenerateMipChain(const Image& image, Texture::TextureFlags flags)
+{
+    std::vector<MipLevel<T>> levels(1);
+    auto& baseLevel = levels.front();
+    baseLevel.width = image.width;
+    baseLevel.height = image.height;
+    const auto* pixels = reinterpret_cast<const T*>(image.data);
+    baseLevel.pixels.assign(pixels, pixels + std::size_t(image.width) * image.height * image.nbChannels);
+    if (!(flags & Texture::MIPMAPS_TEXTURE))
+    {
+        return levels;
+    }
+    const bool isSrgb = (flags & Texture::GAMMA_CORRECTION) && image.nbChannels >= 3;
+    while (levels.back().width > 1 || levels.back().height > 1)
+    {
+        levels.push_back(Downsample(levels.back(), image.nbChannels, isSrgb));
+    }
+    return levels;
+}
+
+template<typename T>
+BufferFile WriteKtx(const Image& image, Texture::TextureFlags flags, std::string_view stamp)
+{
+    const auto levels = GenerateMipChain<T>(image, flags);
+    KtxHeader header;
+    header.glType = std::is_same_v<T, float> ? GL_FLOAT_VALUE : GL_UNSIGNED_BYTE_VALUE;
+    header.glTypeSize = sizeof(T);
+    header.glFormat = GetGlFormat(image.nbChannels);
+    header.glInternalFormat = GetGlInternalFormat(image.nbChannels, flags);
+    header.glBaseInternalFormat = header.glFormat;
+    header.pixelWidth = static_cast<std::uint32_t>(image.width);
+    header.pixelHeight = static_cast<std::uint32_t>(image.height);
+    header.numberOfMipmapLevels = static_cast<std::uint32_t>(levels.size());
+    //Key and value are null terminated
+    const std::size_t keyValueSize = TEXTURE_CACHE_STAMP_KEY.size() + 1 + stamp.size() + 1;
+    header.bytesOfKeyValueData = static_cast<std::uint32_t>(sizeof(std::uint32_t) + AlignKtx(keyValueSize));
+
+    //The rows are aligned to 4 bytes, the KTX unpack alignment
+    const auto getRowSize = [&image](int width)
+    {
+        return AlignKtx(std::size_t(width) * image.nbChannels * sizeof(T));
+    };
+    std::size_t fileSize = sizeof(KtxHeader) + header.bytesOfKeyValueData;
+    for (const auto& level : levels)
+    {
+        fileSize += sizeof(std::uint32_t) + getRowSize(level.width) * level.height;
+    }
+
+    BufferFile file;
+    file.dataLength = fileSize;
+    file.dataBuffer = new unsigned char[fileSize + 1];
+    std::memset(file.dataBuffer, 0, fileSize + 1);
+    unsigned char* cursor = file.dataBuffer;
+    std::memcpy(cursor, &header, sizeof(KtxHeader));
+    cursor += sizeof(KtxHeader);
+    const auto keyValueByteSize = static_cast<std::uint32_t>(keyValueSize);
+    std::memcpy(cursor, &keyValueByteSize, sizeof(std::uint32_t));
+    cursor += sizeof(std::uint32_t);
+    std::memcpy(cursor, TEXTURE_CACHE_STAMP_KEY.data(), TEXTURE_CACHE_STAMP_KEY.size());
+    std::memcpy(cursor + TEXTURE_CACHE_STAMP_KEY.size() + 1, stamp.data(), stamp.size());
+    cursor += AlignKtx(keyValueSize);
+    for (const auto& level : levels)
+    {
+        const std::size_t packedRowSize = std::size_t(level.width) * image.nbChannels * sizeof(T);
+        const std::size_t rowSize = getRowSize(level.width);
+        const auto imageSize = static_cast<std::uint32_t>(rowSize * level.height);
+        std::memcpy(cursor, &imageSize, sizeof(std::uint32_t));
+        cursor += sizeof(std::uint32_t);
+        const auto* pixels = reinterpret_cast<const unsigned char*>(level.pixels.data());
+        for (int y = 0; y < level.height; y++)
+        {
+            std::memcpy(cursor + y * rowSize, pixels + y * packedRowSize, packedRowSize);
+        }
+        cursor += imageSize;
+    }
+    return file;
+}
+
+bool IsSupportedCompressedFormat(std::uint32_t glInternalFormat)
+{
+    return glInternalFormat == GL_ETC1_RGB8_OES_VALUE ||
+           (glInternalFormat >= GL_COMPRESSED_R11_EAC_VALUE &&
+            glInternalFormat <= GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC_VALUE);
+}
+}
+
+std::string GetTextureCacheStamp(std::string_view sourcePath, Texture::TextureFlags flags)
+{
+    //Only the flags changing the cached data
+    const unsigned cachedFlags = flags & (Texture::MIPMAPS_TEXTURE | Texture::GAMMA_CORRECTION |
+                                          Texture::FLIP_Y | Texture::HDR);
+    const auto* archiveEntry = AssetArchiveLocator::get().FindEntry(sourcePath);
+    if (archiveEntry != nullptr)
+    {
+        //Archives have no modification time, an edited asset of the same size changes its checksum
+        return fmt::format("{}:crc{:08x}:{}", archiveEntry->originalSize, archiveEntry->contentCrc, cachedFlags);
+    }
+    return fmt::format("{}:{}:{}", CalculateFileSize(std::string(sourcePath)), GetLastWriteTime(sourcePath),
+                       cachedFlags);
+}
+
+BufferFile WriteTextureCache(const Image& image, Texture::TextureFlags flags, std::string_view stamp)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Write Texture Cache");
+#endif
+    neko_assert(image.data != nullptr && image.nbChannels >= 1 && image.nbChannels <= 4,
+                "[Texture Cache] Invalid image");
+    if (flags & Texture::HDR)
+    {
+        return WriteKtx<float>(image, flags, stamp);
+    }
+    return WriteKtx<unsigned char>(image, flags, stamp);
+}
+
+bool ReadTextureCache(BufferFile&& file, std::string_view stamp, CachedTexture& cachedTexture)
+{
+    cachedTexture.Destroy();
+    cachedTexture.file = std::move(file);
+    const unsigned char* data = cachedTexture.file.dataBuffer;
+    const std::size_t length = cachedTexture.file.dataLength;
+    KtxHeader header;
+    if (data == nullptr || length < sizeof(KtxHeader))
+    {
+        cachedTexture.Destroy();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(KtxHeader));
+    if (header.identifier != KTX_IDENTIFIER || header.endianness != KTX_ENDIANNESS ||
+        header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 ||
+        header.numberOfArrayElements != 0 || header.numberOfFaces != 1 ||
+        header.bytesOfKeyValueData > length - sizeof(KtxHeader))
+    {
+        logDebug("[Texture Cache] Unsupported KTX file");
+        cachedTexture.Destroy();
+        return false;
+    }
+
+    std::size_t offset = sizeof(KtxHeader);
+    const std::size_t keyValueEnd = offset + header.bytesOfKeyValueData;
+    while (offset + sizeof(std::uint32_t) <= keyValueEnd)
+    {
+        std::uint32_t keyValueSize;
+        std::memcpy(&keyValueSize, data + offset, sizeof(std::uint32_t));
+        offset += sizeof(std::uint32_t);
+        if (keyValueSize > keyValueEnd - offset)
+        {
+            break;
+        }
+        const std::string_view keyValue(reinterpret_cast<const char*>(data + offset), keyValueSize);
+        const auto keyEnd = keyValue.find('\0');
+        if (keyEnd != std::string_view::npos && keyValue.substr(0, keyEnd) == TEXTURE_CACHE_STAMP_KEY)
+        {
+            auto fileStamp = keyValue.substr(keyEnd + 1);
+            fileStamp = fileStamp.substr(0, fileStamp.find('\0'));
+            if (fileStamp != stamp)
+            {
+                logDebug("[Texture Cache] Cached texture is outdated");
+                cachedTexture.Destroy();
+                return false;
+            }
+        }
+        offset += AlignKtx(keyValueSize);
+    }
+    offset = keyValueEnd;
+
+    if (header.glFormat == 0)
+    {
+        if (!IsSupportedCompressedFormat(header.glInternalFormat))
+        {
+            logDebug(fmt::format("[Texture Cache] Unsupported compressed format: {:#x}", header.glInternalFormat));
+            cachedTexture.Destroy();
+            return false;
+        }
+    }
+    else if (header.glType != GL_UNSIGNED_BYTE_VALUE && header.glType != GL_FLOAT_VALUE &&
+             header.glType != GL_HALF_FLOAT_VALUE)
+    {
+        logDebug(fmt::format("[Texture Cache] Unsupported data type: {:#x}", header.glType));
+        cachedTexture.Destroy();
+        return false;
+    }
+    //ETC1 data is valid ETC2 data
+    cachedTexture.glInternalFormat = header.glInternalFormat == GL_ETC1_RGB8_OES_VALUE ?
+        GL_COMPRESSED_RGB8_ETC2_VALUE : header.glInternalFormat;
+    cachedTexture.glFormat = header.glFormat;
+    cachedTexture.glType = header.glType;
+
+    //Zero levels asks to generate the mipmaps, only the base level is stored
+    const std::uint32_t levelsNmb = std::max(header.numberOfMipmapLevels, 1u);
+    cachedTexture.levels.reserve(levelsNmb);
+    for (std::uint32_t i = 0; i < levelsNmb; i++)
+    {
+        std::uint32_t imageSize;
+        if (length - offset < sizeof(std::uint32_t))
+        {
+            break;
+        }
+        std::memcpy(&imageSize, data + offset, sizeof(std::uint32_t));
+        offset += sizeof(std::uint32_t);
+        if (imageSize > length - offset)
+        {
+            break;
+        }
+        TextureLevel level;
+        level.data = data + offset;
+        level.size = imageSize;
+        level.width = static_cast<int>(std::max(header.pixelWidth >> i, 1u));
+        level.height = static_cast<int>(std::max(header.pixelHeight >> i, 1u));
+        cachedTexture.levels.push_back(level);
+        offset += AlignKtx(imageSize);
+    }
+    if (cachedTexture.levels.size() != levelsNmb)
+    {
+        logDebug("[Texture Cache] Truncated KTX file");
+        cachedTexture.Destroy();
+        return false;
+    }
+    return true;
+}
+}
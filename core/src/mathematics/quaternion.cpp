@@ -0,0 +1,217 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "mathematics/quaternion.h"
+
+namespace neko
+{
+namespace
+{
+template<int N>
+Quaternion GetQuaternion(const NVec4<float, N>& quaternions, int i)
+{
+    return Quaternion(quaternions.xs[i], quaternions.ys[i], quaternions.zs[i], quaternions.ws[i]);
+}
+
+template<int N>
+void SetQuaternion(NVec4<float, N>& quaternions, int i, const Quaternion& quaternion)
+{
+    quaternions.xs[i] = quaternion.x;
+    quaternions.ys[i] = quaternion.y;
+    quaternions.zs[i] = quaternion.z;
+    quaternions.ws[i] = quaternion.w;
+}
+
+template<int N>
+NVec4<float, N> NlerpScalar(const NVec4<float, N>& a, const NVec4<float, N>& b, float t)
+{
+    NVec4<float, N> result;
+    for (int i = 0; i < N; i++)
+    {
+        SetQuaternion(result, i, Quaternion::Nlerp(GetQuaternion(a, i), GetQuaternion(b, i), t));
+    }
+    return result;
+}
+
+template<int N>
+NVec4<float, N> SlerpScalar(const NVec4<float, N>& a, const NVec4<float, N>& b, float t)
+{
+    NVec4<float, N> result;
+    for (int i = 0; i < N; i++)
+    {
+        SetQuaternion(result, i, Quaternion::Slerp(GetQuaternion(a, i), GetQuaternion(b, i), t));
+    }
+    return result;
+}
+
+/**
+ * \brief Slerp weights of a and b from the absolute dot products, nlerp weights when the rotations are too close
+ */
+template<int N>
+void SlerpWeights(const std::array<float, N>& cosThetas, float t, std::array<float, N>& weightsA, std::array<float, N>& weightsB)
+{
+    for (int i = 0; i < N; i++)
+    {
+        if (cosThetas[i] > Quaternion::slerpThreshold)
+        {
+            weightsA[i] = 1.0f - t;
+            weightsB[i] = t;
+            continue;
+        }
+        const float theta = std::acos(cosThetas[i]);
+        const float sinTheta = std::sin(theta);
+        weightsA[i] = std::sin((1.0f - t) * theta) / sinTheta;
+        weightsB[i] = std::sin(t * theta) / sinTheta;
+    }
+}
+}
+
+#ifdef __SSE__
+namespace
+{
+/**
+ * \brief a * weightA + b * weightB normalized, with b negated on the lanes where the dot product is negative
+ */
+FourVec4f InterpolateIntrinsics(const FourVec4f& a, const FourVec4f& b, __m128 signs, __m128 weightsA, __m128 weightsB)
+{
+    const auto ax = _mm_load_ps(a.xs.data());
+    const auto ay = _mm_load_ps(a.ys.data());
+    const auto az = _mm_load_ps(a.zs.data());
+    const auto aw = _mm_load_ps(a.ws.data());
+    weightsB = _mm_xor_ps(weightsB, signs);
+    auto x = _mm_add_ps(_mm_mul_ps(ax, weightsA), _mm_mul_ps(_mm_load_ps(b.xs.data()), weightsB));
+    auto y = _mm_add_ps(_mm_mul_ps(ay, weightsA), _mm_mul_ps(_mm_load_ps(b.ys.data()), weightsB));
+    auto z = _mm_add_ps(_mm_mul_ps(az, weightsA), _mm_mul_ps(_mm_load_ps(b.zs.data()), weightsB));
+    auto w = _mm_add_ps(_mm_mul_ps(aw, weightsA), _mm_mul_ps(_mm_load_ps(b.ws.data()), weightsB));
+    const auto magnitude = _mm_sqrt_ps(_mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+            _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+    FourVec4f result;
+    _mm_store_ps(result.xs.data(), _mm_div_ps(x, magnitude));
+    _mm_store_ps(result.ys.data(), _mm_div_ps(y, magnitude));
+    _mm_store_ps(result.zs.data(), _mm_div_ps(z, magnitude));
+    _mm_store_ps(result.ws.data(), _mm_div_ps(w, magnitude));
+    return result;
+}
+
+__m128 DotIntrinsics(const FourVec4f& a, const FourVec4f& b)
+{
+    return _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(a.xs.data()), _mm_load_ps(b.xs.data())),
+                       _mm_mul_ps(_mm_load_ps(a.ys.data()), _mm_load_ps(b.ys.data()))),
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(a.zs.data()), _mm_load_ps(b.zs.data())),
+                       _mm_mul_ps(_mm_load_ps(a.ws.data()), _mm_load_ps(b.ws.data()))));
+}
+}
+#endif
+
+#ifdef __AVX2__
+namespace
+{
+EightVec4f InterpolateIntrinsics(const EightVec4f& a, const EightVec4f& b, __m256 signs, __m256 weightsA, __m256 weightsB)
+{
+    const auto ax = _mm256_load_ps(a.xs.data());
+    const auto ay = _mm256_load_ps(a.ys.data());
+    const auto az = _mm256_load_ps(a.zs.data());
+    const auto aw = _mm256_load_ps(a.ws.data());
+    weightsB = _mm256_xor_ps(weightsB, signs);
+    auto x = _mm256_add_ps(_mm256_mul_ps(ax, weightsA), _mm256_mul_ps(_mm256_load_ps(b.xs.data()), weightsB));
+    auto y = _mm256_add_ps(_mm256_mul_ps(ay, weightsA), _mm256_mul_ps(_mm256_load_ps(b.ys.data()), weightsB));
+    auto z = _mm256_add_ps(_mm256_mul_ps(az, weightsA), _mm256_mul_ps(_mm256_load_ps(b.zs.data()), weightsB));
+    auto w = _mm256_add_ps(_mm256_mul_ps(aw, weightsA), _mm256_mul_ps(_mm256_load_ps(b.ws.data()), weightsB));
+    const auto magnitude = _mm256_sqrt_ps(_mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+            _mm256_add_ps(_mm256_mul_ps(z, z), _mm256_mul_ps(w, w))));
+    EightVec4f result;
+    _mm256_store_ps(result.xs.data(), _mm256_div_ps(x, magnitude));
+    _mm256_store_ps(result.ys.data(), _mm256_div_ps(y, magnitude));
+    _mm256_store_ps(result.zs.data(), _mm256_div_ps(z, magnitude));
+    _mm256_store_ps(result.ws.data(), _mm256_div_ps(w, magnitude));
+    return result;
+}
+
+__m256 DotIntrinsics(const EightVec4f& a, const EightVec4f& b)
+{
+    return _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(a.xs.data()), _mm256_load_ps(b.xs.data())),
+                          _mm256_mul_ps(_mm256_load_ps(a.ys.data()), _mm256_load_ps(b.ys.data()))),
+            _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(a.zs.data()), _mm256_load_ps(b.zs.data())),
+                          _mm256_mul_ps(_mm256_load_ps(a.ws.data()), _mm256_load_ps(b.ws.data()))));
+}
+}
+#endif
+
+FourVec4f Quaternion::Nlerp(const FourVec4f& a, const FourVec4f& b, float t)
+{
+#ifdef __SSE__
+    const auto signs = _mm_and_ps(DotIntrinsics(a, b), _mm_set1_ps(-0.0f));
+    return InterpolateIntrinsics(a, b, signs, _mm_set1_ps(1.0f - t), _mm_set1_ps(t));
+#else
+    return NlerpScalar(a, b, t);
+#endif
+}
+
+EightVec4f Quaternion::Nlerp(const EightVec4f& a, const EightVec4f& b, float t)
+{
+#ifdef __AVX2__
+    const auto signs = _mm256_and_ps(DotIntrinsics(a, b), _mm256_set1_ps(-0.0f));
+    return InterpolateIntrinsics(a, b, signs, _mm256_set1_ps(1.0f - t), _mm256_set1_ps(t));
+#else
+    return NlerpScalar(a, b, t);
+#endif
+}
+
+FourVec4f Quaternion::Slerp(const FourVec4f& a, const FourVec4f& b, float t)
+{
+#ifdef __SSE__
+    const auto dot = DotIntrinsics(a, b);
+    const auto signs = _mm_and_ps(dot, _mm_set1_ps(-0.0f));
+    alignas(4 * sizeof(float)) std::array<float, 4> cosThetas;
+    _mm_store_ps(cosThetas.data(), _mm_xor_ps(dot, signs));
+    //The angles trigonometry is done per lane, the interpolation is vectorized
+    alignas(4 * sizeof(float)) std::array<float, 4> weightsA;
+    alignas(4 * sizeof(float)) std::array<float, 4> weightsB;
+    SlerpWeights<4>(cosThetas, t, weightsA, weightsB);
+    return InterpolateIntrinsics(a, b, signs, _mm_load_ps(weightsA.data()), _mm_load_ps(weightsB.data()));
+#else
+    return SlerpScalar(a, b, t);
+#endif
+}
+
+EightVec4f Quaternion::Slerp(const EightVec4f& a, const EightVec4f& b, float t)
+{
+#ifdef __AVX2__
+    const auto dot = DotIntrinsics(a, b);
+    const auto signs = _mm256_and_ps(dot, _mm256_set1_ps(-0.0f));
+    alignas(8 * sizeof(float)) std::array<float, 8> cosThetas;
+    _mm256_store_ps(cosThetas.data(), _mm256_xor_ps(dot, signs));
+    alignas(8 * sizeof(float)) std::array<float, 8> weightsA;
+    alignas(8 * sizeof(float)) std::array<float, 8> weightsB;
+    SlerpWeights<8>(cosThetas, t, weightsA, weightsB);
+    return InterpolateIntrinsics(a, b, signs, _mm256_load_ps(weightsA.data()), _mm256_load_ps(weightsB.data()));
+#else
+    return SlerpScalar(a, b, t);
+#endif
+}
+}
@@ -157,20 +157,22 @@ Mat4<float> const RotationMatrixFrom(const EulerAngles cardinalRotation)
 
 Mat4f const RotationMatrixFrom(const Quaternion& q)
 {
-    const Mat4f left = Mat4f(std::array<Vec4f, 4>{
-        Vec4f(q.w,-q.z,q.y,-q.x),
-    	Vec4f(q.z,q.w,-q.x,-q.y),
-    	Vec4f(-q.y,q.x,q.w,-q.z),
-    	Vec4f(q.x,q.y,q.z,q.w)
-    });
-    const Mat4f right = Mat4f(std::array<Vec4f, 4>{
-        Vec4f(q.w,-q.z,q.y,q.x),
-    	Vec4f(q.z,q.w,-q.x,q.y),
-    	Vec4f(-q.y,q.x,q.w,q.z),
-    	Vec4f(-q.x,-q.y,-q.z,q.w)
+    //Expanded product of the left and right quaternion matrices, only valid for unit quaternions
+    const float xx = q.x * q.x;
+    const float yy = q.y * q.y;
+    const float zz = q.z * q.z;
+    const float xy = q.x * q.y;
+    const float xz = q.x * q.z;
+    const float yz = q.y * q.z;
+    const float xw = q.x * q.w;
+    const float yw = q.y * q.w;
+    const float zw = q.z * q.w;
+    return Mat4f(std::array<Vec4f, 4>{
+        Vec4f(1.0f - 2.0f * (yy + zz), 2.0f * (xy - zw), 2.0f * (xz + yw), 0.0f),
+        Vec4f(2.0f * (xy + zw), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - xw), 0.0f),
+        Vec4f(2.0f * (xz - yw), 2.0f * (yz + xw), 1.0f - 2.0f * (xx + yy), 0.0f),
+        Vec4f(0.0f, 0.0f, 0.0f, 1.0f)
     });
-
-    return left*right;
 }
 
 
@@ -214,6 +216,184 @@ Mat4f Rotate(const Mat4f& transform, const EulerAngles eulerAngles)
 
 
 
+namespace
+{
+/**
+ * \brief Scaled rotation matrix columns from a unit quaternion, the scale multiplies the rows
+ */
+template<int N>
+void ComposeTransformsScalar(const NVec3<float, N>& positions,
+                             const NVec3<float, N>& scales,
+                             const NVec4<float, N>& rotations,
+                             Mat4f* transforms)
+{
+    for (int i = 0; i < N; i++)
+    {
+        const float x = rotations.xs[i];
+        const float y = rotations.ys[i];
+        const float z = rotations.zs[i];
+        const float w = rotations.ws[i];
+        const float sx = scales.xs[i];
+        const float sy = scales.ys[i];
+        const float sz = scales.zs[i];
+        transforms[i] = Mat4f(
+                std::array<Vec4f, 4>
+                        {
+                                Vec4f(sx * (1.0f - 2.0f * (y * y + z * z)),
+                                      sy * 2.0f * (x * y - z * w),
+                                      sz * 2.0f * (x * z + y * w), 0),
+                                Vec4f(sx * 2.0f * (x * y + z * w),
+                                      sy * (1.0f - 2.0f * (x * x + z * z)),
+                                      sz * 2.0f * (y * z - x * w), 0),
+                                Vec4f(sx * 2.0f * (x * z - y * w),
+                                      sy * 2.0f * (y * z + x * w),
+                                      sz * (1.0f - 2.0f * (x * x + y * y)), 0),
+                                Vec4f(positions.xs[i], positions.ys[i], positions.zs[i], 1)});
+    }
+}
+
+#ifdef __SSE__
+/**
+ * \brief Transpose the rows of four matrices column into the matrices
+ */
+inline void StoreColumn(__m128 row0, __m128 row1, __m128 row2, __m128 row3, Mat4f* transforms, int column)
+{
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+    _mm_storeu_ps(&transforms[0][column][0], row0);
+    _mm_storeu_ps(&transforms[1][column][0], row1);
+    _mm_storeu_ps(&transforms[2][column][0], row2);
+    _mm_storeu_ps(&transforms[3][column][0], row3);
+}
+#endif
+}
+
+void ComposeTransforms(const FourVec3f& positions,
+                       const FourVec3f& scales,
+                       const FourVec4f& rotations,
+                       Mat4f* transforms)
+{
+#ifdef __SSE__
+    const auto x = _mm_load_ps(rotations.xs.data());
+    const auto y = _mm_load_ps(rotations.ys.data());
+    const auto z = _mm_load_ps(rotations.zs.data());
+    const auto w = _mm_load_ps(rotations.ws.data());
+    const auto sx = _mm_load_ps(scales.xs.data());
+    const auto sy = _mm_load_ps(scales.ys.data());
+    const auto sz = _mm_load_ps(scales.zs.data());
+    const auto one = _mm_set1_ps(1.0f);
+    const auto two = _mm_set1_ps(2.0f);
+    const auto zero = _mm_setzero_ps();
+
+    const auto xx = _mm_mul_ps(x, x);
+    const auto yy = _mm_mul_ps(y, y);
+    const auto zz = _mm_mul_ps(z, z);
+    const auto xy = _mm_mul_ps(x, y);
+    const auto xz = _mm_mul_ps(x, z);
+    const auto yz = _mm_mul_ps(y, z);
+    const auto xw = _mm_mul_ps(x, w);
+    const auto yw = _mm_mul_ps(y, w);
+    const auto zw = _mm_mul_ps(z, w);
+
+    StoreColumn(
+            _mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)))),
+            _mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(xy, zw))),
+            _mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(xz, yw))),
+            zero, transforms, 0);
+    StoreColumn(
+            _mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xy, zw))),
+            _mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)))),
+            _mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(yz, xw))),
+            zero, transforms, 1);
+    StoreColumn(
+            _mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(xz, yw))),
+            _mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(yz, xw))),
+            _mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)))),
+            zero, transforms, 2);
+    StoreColumn(
+            _mm_load_ps(positions.xs.data()),
+            _mm_load_ps(positions.ys.data()),
+            _mm_load_ps(positions.zs.data()),
+            one, transforms, 3);
+#else
+    ComposeTransformsScalar(positions, scales, rotations, transforms);
+#endif
+}
+
+void ComposeTransforms(const EightVec3f& positions,
+                       const EightVec3f& scales,
+                       const EightVec4f& rotations,
+                       Mat4f* transforms)
+{
+#ifdef __AVX2__
+    const auto x = _mm256_load_ps(rotations.xs.data());
+    const auto y = _mm256_load_ps(rotations.ys.data());
+    const auto z = _mm256_load_ps(rotations.zs.data());
+    const auto w = _mm256_load_ps(rotations.ws.data());
+    const auto sx = _mm256_load_ps(scales.xs.data());
+    const auto sy = _mm256_load_ps(scales.ys.data());
+    const auto sz = _mm256_load_ps(scales.zs.data());
+    const auto one = _mm256_set1_ps(1.0f);
+    const auto two = _mm256_set1_ps(2.0f);
+    const auto zero = _mm256_setzero_ps();
+
+    const auto xx = _mm256_mul_ps(x, x);
+    const auto yy = _mm256_mul_ps(y, y);
+    const auto zz = _mm256_mul_ps(z, z);
+    const auto xy = _mm256_mul_ps(x, y);
+    const auto xz = _mm256_mul_ps(x, z);
+    const auto yz = _mm256_mul_ps(y, z);
+    const auto xw = _mm256_mul_ps(x, w);
+    const auto yw = _mm256_mul_ps(y, w);
+    const auto zw = _mm256_mul_ps(z, w);
+
+    const __m256 columns[4][4] = {
+            {
+                _mm256_mul_ps(sx, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz)))),
+                _mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_sub_ps(xy, zw))),
+                _mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_add_ps(xz, yw))),
+                zero
+            },
+            {
+                _mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_add_ps(xy, zw))),
+                _mm256_mul_ps(sy, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz)))),
+                _mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_sub_ps(yz, xw))),
+                zero
+            },
+            {
+                _mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_sub_ps(xz, yw))),
+                _mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_add_ps(yz, xw))),
+                _mm256_mul_ps(sz, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy)))),
+                zero
+            },
+            {
+                _mm256_load_ps(positions.xs.data()),
+                _mm256_load_ps(positions.ys.data()),
+                _mm256_load_ps(positions.zs.data()),
+                one
+            }
+    };
+    //The low and high halves are the first and last four matrices
+    for (int column = 0; column < 4; column++)
+    {
+        const auto& rows = columns[column];
+        StoreColumn(
+                _mm256_castps256_ps128(rows[0]),
+                _mm256_castps256_ps128(rows[1]),
+                _mm256_castps256_ps128(rows[2]),
+                _mm256_castps256_ps128(rows[3]),
+                transforms, column);
+        StoreColumn(
+                _mm256_extractf128_ps(rows[0], 1),
+                _mm256_extractf128_ps(rows[1], 1),
+                _mm256_extractf128_ps(rows[2], 1),
+                _mm256_extractf128_ps(rows[3], 1),
+                transforms + 4, column);
+    }
+#else
+    ComposeTransformsScalar(positions, scales, rotations, transforms);
+#endif
+}
+
 Mat4f Perspective(radian_t fovy, float aspect, float nearPlane, float farPlane)
 {
     neko_assert(fabsf(aspect - std::numeric_limits<float>::epsilon()) > 0.0f, "Aspect should not be zero");
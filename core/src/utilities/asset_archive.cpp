@@ -0,0 +1,217 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "utilities/asset_archive.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "engine/log.h"
+
+#ifdef NEKO_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+bool IsLess(const AssetArchiveEntry& entry, const sole::uuid& assetId)
+{
+    return entry.uuidAb < assetId.ab || (entry.uuidAb == assetId.ab && entry.uuidCd < assetId.cd);
+}
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(std::string_view archivePath, std::string_view rootPath)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Open Asset Archive");
+#endif
+    Close();
+    archiveFile_.Load(archivePath);
+    const auto* data = archiveFile_.dataBuffer;
+    const auto dataLength = archiveFile_.dataLength;
+    AssetArchiveHeader header;
+    if (data == nullptr || dataLength < sizeof(AssetArchiveHeader))
+    {
+        logDebug(fmt::format("[Error] Could not open asset archive: {}", archivePath));
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(AssetArchiveHeader));
+    if (header.magic != ASSET_ARCHIVE_MAGIC || header.version != ASSET_ARCHIVE_VERSION)
+    {
+        logDebug(fmt::format("[Error] Asset archive: {} has an invalid header or version", archivePath));
+        Close();
+        return false;
+    }
+    const auto entriesSize = std::uint64_t(header.entriesNmb) * sizeof(AssetArchiveEntry);
+    if (header.entriesOffset % alignof(AssetArchiveEntry) != 0 ||
+        header.entriesOffset + entriesSize > header.stringsOffset ||
+        header.stringsOffset > dataLength)
+    {
+        logDebug(fmt::format("[Error] Asset archive: {} has an invalid table of contents", archivePath));
+        Close();
+        return false;
+    }
+    const auto* entries = reinterpret_cast<const AssetArchiveEntry*>(data + header.entriesOffset);
+    const auto stringsLength = dataLength - header.stringsOffset;
+    for (std::size_t i = 0; i < header.entriesNmb; i++)
+    {
+        const auto& entry = entries[i];
+        //Uncompressed entries are loaded as views, they need the zero written after the blob
+        const std::uint64_t blobLength = entry.size + (entry.compression == AssetCompression::NONE ? 1u : 0u);
+        if (entry.offset > dataLength || blobLength > dataLength - entry.offset ||
+            (entry.compression == AssetCompression::NONE && data[entry.offset + entry.size] != 0) ||
+            std::uint64_t(entry.pathOffset) + entry.pathLength > stringsLength ||
+            std::uint64_t(entry.metaOffset) + entry.metaLength > stringsLength)
+        {
+            logDebug(fmt::format("[Error] Asset archive: {} has an entry out of bounds", archivePath));
+            Close();
+            return false;
+        }
+    }
+    entries_ = entries;
+    entriesNmb_ = header.entriesNmb;
+    strings_ = reinterpret_cast<const char*>(data + header.stringsOffset);
+    rootPath_ = MakeGeneric(std::string(rootPath));
+    pathIndices_.reserve(entriesNmb_);
+    for (std::size_t i = 0; i < entriesNmb_; i++)
+    {
+        pathIndices_.emplace(GetPath(entries_[i]), i);
+    }
+    logDebug(fmt::format("[Asset Archive] Opened {} with {} assets", archivePath, entriesNmb_));
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    pathIndices_.clear();
+    entries_ = nullptr;
+    entriesNmb_ = 0;
+    strings_ = nullptr;
+    archiveFile_.Destroy();
+}
+
+const AssetArchiveEntry* AssetArchive::FindEntry(const sole::uuid& assetId) const
+{
+    const auto* end = entries_ + entriesNmb_;
+    const auto* it = std::lower_bound(entries_, end, assetId, IsLess);
+    if (it == end || it->uuidAb != assetId.ab || it->uuidCd != assetId.cd)
+    {
+        return nullptr;
+    }
+    return it;
+}
+
+const AssetArchiveEntry* AssetArchive::FindEntry(std::string_view path) const
+{
+    if (pathIndices_.empty())
+    {
+        return nullptr;
+    }
+    std::string key(path);
+    std::replace(key.begin(), key.end(), '\\', '/');
+    std::string_view relativePath = key;
+    if (relativePath.substr(0, rootPath_.size()) == rootPath_)
+    {
+        relativePath.remove_prefix(rootPath_.size());
+    }
+    while (relativePath.substr(0, 2) == "./")
+    {
+        relativePath.remove_prefix(2);
+    }
+    const auto it = pathIndices_.find(relativePath);
+    if (it == pathIndices_.end())
+    {
+        return nullptr;
+    }
+    return &entries_[it->second];
+}
+
+std::string_view AssetArchive::GetPath(const AssetArchiveEntry& entry) const
+{
+    return {strings_ + entry.pathOffset, entry.pathLength};
+}
+
+std::string_view AssetArchive::GetMeta(const AssetArchiveEntry& entry) const
+{
+    return {strings_ + entry.metaOffset, entry.metaLength};
+}
+
+bool AssetArchive::LoadEntry(const AssetArchiveEntry& entry, BufferFile& bufferFile) const
+{
+    bufferFile.Destroy();
+    auto* blob = archiveFile_.dataBuffer + entry.offset;
+    switch (entry.compression)
+    {
+        case AssetCompression::NONE:
+        {
+            //The packer writes a zero after each blob, the view is null terminated like a loaded file
+            bufferFile.dataBuffer = blob;
+            bufferFile.dataLength = entry.size;
+            bufferFile.storage = BufferFile::Storage::VIEW;
+            return true;
+        }
+        case AssetCompression::ZSTD:
+        {
+#ifdef NEKO_ZSTD
+#ifdef EASY_PROFILE_USE
+            EASY_BLOCK("Decompress Asset");
+#endif
+            auto* data = new unsigned char[entry.originalSize + 1];
+            const auto result = ZSTD_decompress(data, entry.originalSize, blob, entry.size);
+            if (ZSTD_isError(result) || result != entry.originalSize)
+            {
+                logDebug(fmt::format("[Error] Could not decompress asset: {}", GetPath(entry)));
+                delete[] data;
+                return false;
+            }
+            data[entry.originalSize] = 0;
+            bufferFile.dataBuffer = data;
+            bufferFile.dataLength = entry.originalSize;
+            bufferFile.storage = BufferFile::Storage::HEAP;
+            return true;
+#else
+            logDebug(fmt::format("[Error] Asset: {} is compressed with zstd, build with Neko_Zstd",
+                                 GetPath(entry)));
+            return false;
+#endif
+        }
+        default:
+            return false;
+    }
+}
+}
@@ -22,6 +22,7 @@
  SOFTWARE.
  */
 #include <utilities/file_utility.h>
+#include <utilities/asset_archive.h>
 #include <sstream>
 #include <functional>
 #include "engine/log.h"
@@ -51,7 +52,7 @@ Java_swiss_sae_gpr5300_MainActivity_load(JNIEnv *env, [[maybe_unused]] jclass cl
 }
 namespace neko
 {
-ResourceJob::ResourceJob() : Job([this]{bufferFile_.Load(filePath_);})
+ResourceJob::ResourceJob() : Job([this]{if (!isRead_) bufferFile_.Load(filePath_);})
 {
 }
 void ResourceJob::SetFilePath(std::string_view path)
@@ -81,6 +82,19 @@ std::string GetCurrentPath()
 {
 	return "";
 }
+std::int64_t GetLastWriteTime([[maybe_unused]] const std::string_view filename)
+{
+	return 0;
+}
+size_t CalculateFileSize(const std::string& filename)
+{
+	AAsset* file = AAssetManager_open(assetManager, filename.c_str(), AASSET_MODE_UNKNOWN);
+	if (file == nullptr)
+		return 0;
+	const auto size = static_cast<size_t>(AAsset_getLength64(file));
+	AAsset_close(file);
+	return size;
+}
 const std::string LoadFile(const std::string& path)
 {
 	AAsset* file = AAssetManager_open(assetManager, path.c_str(), AASSET_MODE_BUFFER);
@@ -102,8 +116,12 @@ const std::string LoadFile(const std::string& path)
 }
 
 
-void BufferFile::Load(std::string_view path)
+void BufferFile::Load(std::string_view path, [[maybe_unused]] LoadMode loadMode)
 {
+	const auto& assetArchive = AssetArchiveLocator::get();
+	const auto* archiveEntry = assetArchive.FindEntry(path);
+	if (archiveEntry != nullptr && assetArchive.LoadEntry(*archiveEntry, *this))
+		return;
 	AAsset* file = AAssetManager_open(assetManager, path.data(), AASSET_MODE_BUFFER);
 	if (file == nullptr)
 		return;
@@ -121,9 +139,11 @@ void BufferFile::Load(std::string_view path)
 
 void BufferFile::Destroy()
 {
-	delete[] dataBuffer;
+	if (storage == Storage::HEAP)
+		delete[] dataBuffer;
 	dataBuffer = nullptr;
 	dataLength = 0;
+	storage = Storage::HEAP;
 }
 
 
@@ -136,6 +156,7 @@ void ResourceJob::Reset()
 {
 	Job::Reset();
 	bufferFile_.Destroy();
+	isRead_ = false;
 }
 }
 
@@ -157,10 +178,21 @@ namespace fs = std::filesystem;
 namespace fs = std::filesystem;
 #endif
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace neko
 {
 ResourceJob::ResourceJob() : Job([this]
 {
+    if (isRead_)
+    {
+        return;
+    }
 #ifdef EASY_PROFILE_USE
 		EASY_BLOCK("Load Resource");
 #endif
@@ -179,15 +211,70 @@ void ResourceJob::Reset()
 {
     Job::Reset();
     bufferFile_.Destroy();
+    isRead_ = false;
 }
 
 
-void BufferFile::Load(std::string_view path)
+#if defined(__linux__)
+/**
+ * \brief Map the file privately, the pages past the end of the file are zero filled
+ * \return false when the file should be read instead
+ */
+static bool MapBufferFile(std::string_view path, BufferFile& bufferFile)
+{
+    const int fd = open(path.data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat fileStat{};
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (fstat(fd, &fileStat) != 0 ||
+        !S_ISREG(fileStat.st_mode) ||
+        static_cast<size_t>(fileStat.st_size) < BUFFER_FILE_MAP_MIN_SIZE ||
+        //No zero filled page tail for the terminating null character
+        static_cast<size_t>(fileStat.st_size) % pageSize == 0)
+    {
+        close(fd);
+        return false;
+    }
+    const auto fileSize = static_cast<size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    //The mapping keeps its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    //The decoders read the whole file, start the read ahead now
+    madvise(data, fileSize, MADV_WILLNEED);
+    bufferFile.dataBuffer = static_cast<unsigned char*>(data);
+    bufferFile.dataLength = fileSize;
+    bufferFile.storage = BufferFile::Storage::MAPPED;
+    return true;
+}
+#endif
+
+void BufferFile::Load(std::string_view path, LoadMode loadMode)
 {
     if(dataBuffer != nullptr)
     {
         Destroy();
     }
+    const auto& assetArchive = AssetArchiveLocator::get();
+    const auto* archiveEntry = assetArchive.FindEntry(path);
+    if (archiveEntry != nullptr && assetArchive.LoadEntry(*archiveEntry, *this))
+    {
+        return;
+    }
+#if defined(__linux__)
+    if (loadMode == LoadMode::MAP && MapBufferFile(path, *this))
+    {
+        return;
+    }
+#else
+    (void) loadMode;
+#endif
     std::ifstream is(path.data(),std::ifstream::binary);
     if(!is)
     {
@@ -211,9 +298,22 @@ void BufferFile::Destroy()
 {
     if(dataBuffer != nullptr)
     {
-        delete[] dataBuffer;
+        switch (storage)
+        {
+            case Storage::HEAP:
+                delete[] dataBuffer;
+                break;
+#if defined(__linux__)
+            case Storage::MAPPED:
+                munmap(dataBuffer, dataLength);
+                break;
+#endif
+            default:
+                break;
+        }
         dataBuffer = nullptr;
         dataLength = 0;
+        storage = Storage::HEAP;
     }
 }
 
@@ -226,21 +326,30 @@ BufferFile::BufferFile(BufferFile&& bufferFile) noexcept
 {
     this->dataBuffer = bufferFile.dataBuffer;
     this->dataLength = bufferFile.dataLength;
+    this->storage = bufferFile.storage;
     bufferFile.dataBuffer = nullptr;
     bufferFile.dataLength = 0;
+    bufferFile.storage = Storage::HEAP;
 }
 
 BufferFile& BufferFile::operator=(BufferFile&& bufferFile) noexcept
 {
+    Destroy();
     this->dataBuffer = bufferFile.dataBuffer;
     this->dataLength = bufferFile.dataLength;
+    this->storage = bufferFile.storage;
     bufferFile.dataBuffer = nullptr;
     bufferFile.dataLength = 0;
+    bufferFile.storage = Storage::HEAP;
     return *this;
 }
 
 bool FileExists(const std::string_view filename)
 {
+    if (AssetArchiveLocator::get().FindEntry(filename) != nullptr)
+    {
+        return true;
+    }
 #ifdef __APPLE__
 	const fs::path p = std::string(filename);
 #else
@@ -303,6 +412,19 @@ size_t CalculateFileSize(const std::string& filename)
 	return static_cast<size_t>(in.tellg());
 }
 
+std::int64_t GetLastWriteTime(const std::string_view filename)
+{
+#ifdef __APPLE__
+	boost::system::error_code error;
+	const auto time = fs::last_write_time(std::string(filename), error);
+	return error ? 0 : static_cast<std::int64_t>(time);
+#else
+	std::error_code error;
+	const auto time = fs::last_write_time(filename, error);
+	return error ? 0 : static_cast<std::int64_t>(time.time_since_epoch().count());
+#endif
+}
+
 bool CreateDirectory(const std::string_view dirname)
 {
 #ifdef __APPLE__
@@ -332,6 +454,18 @@ bool RemoveDirectory(const std::string_view dirname, bool removeAll)
 	}
 	}
 
+bool RenameFile(const std::string_view path, const std::string_view newPath)
+{
+#ifdef __APPLE__
+	boost::system::error_code error;
+	fs::rename(std::string(path), std::string(newPath), error);
+#else
+	std::error_code error;
+	fs::rename(path, newPath, error);
+#endif
+	return !error;
+}
+
 
 std::string GetFilenameExtension(const std::string_view path)
 {
@@ -0,0 +1,643 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "utilities/io_service.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "engine/assert.h"
+#include "engine/log.h"
+#include "utilities/asset_archive.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if __has_include(<linux/io_uring.h>)
+#define NEKO_IO_URING
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+#if defined(__linux__)
+/**
+ * \brief Open a regular file and allocate its buffer, with one more byte for the null character
+ */
+static bool OpenFile(const std::string& path, int& fd, unsigned char*& buffer, std::size_t& size)
+{
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        logDebug(fmt::format("[Error] Could not open file: {}  for BufferFile", path));
+        return false;
+    }
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        logDebug(fmt::format("[Error] Could not open file: {}  for BufferFile", path));
+        close(fd);
+        fd = -1;
+        return false;
+    }
+    size = static_cast<std::size_t>(fileStat.st_size);
+    buffer = new unsigned char[size + 1];
+    return true;
+}
+#endif
+
+#ifdef NEKO_IO_URING
+/**
+ * \brief Read in flight, the slot index plus one is the user data of its submission
+ */
+struct IoRequest
+{
+    ResourceJob* job = nullptr;
+    int fd = -1;
+    unsigned char* buffer = nullptr;
+    std::size_t size = 0;
+    std::size_t offset = 0;
+    iovec iov{};
+};
+
+/**
+ * \brief io_uring used through the raw system calls, only the I/O thread touches it once created
+ */
+struct IoRing
+{
+    ~IoRing();
+    bool Init(unsigned entries);
+    io_uring_sqe* GetSqe();
+    /**
+     * \brief Publish the prepared submissions and wait for at least waitNmb completions
+     */
+    bool Enter(unsigned waitNmb);
+
+    int ringFd = -1;
+    /**
+     * \brief Written by Read to wake up the I/O thread waiting for completions
+     */
+    int eventFd = -1;
+    std::uint64_t eventValue = 0;
+    void* sqRing = nullptr;
+    std::size_t sqRingSize = 0;
+    void* cqRing = nullptr;
+    std::size_t cqRingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    std::size_t sqesSize = 0;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned toSubmit = 0;
+
+    IoRequest requests[IO_QUEUE_DEPTH];
+    std::vector<std::size_t> freeRequests;
+    /**
+     * \brief Buffers of the reads left in flight when the ring failed, the kernel may still write to them
+     */
+    std::vector<unsigned char*> abandonedBuffers;
+};
+
+IoRing::~IoRing()
+{
+    if (sqes != nullptr)
+    {
+        munmap(sqes, sqesSize);
+    }
+    if (cqRing != nullptr && cqRing != sqRing)
+    {
+        munmap(cqRing, cqRingSize);
+    }
+    if (sqRing != nullptr)
+    {
+        munmap(sqRing, sqRingSize);
+    }
+    if (ringFd >= 0)
+    {
+        close(ringFd);
+    }
+    if (eventFd >= 0)
+    {
+        close(eventFd);
+    }
+    for (auto* buffer : abandonedBuffers)
+    {
+        delete[] buffer;
+    }
+}
+
+bool IoRing::Init(unsigned entries)
+{
+    io_uring_params params{};
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd < 0)
+    {
+        logDebug(fmt::format("[IoService] io_uring is not available: {}", std::strerror(errno)));
+        return false;
+    }
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        sqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+    {
+        sqRing = nullptr;
+        return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        cqRing = sqRing;
+    }
+    else
+    {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+        {
+            cqRing = nullptr;
+            return false;
+        }
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ringFd, IORING_OFF_SQES);
+    if (sqesPtr == MAP_FAILED)
+    {
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqesPtr);
+
+    auto* sqPtr = static_cast<char*>(sqRing);
+    sqTail = reinterpret_cast<unsigned*>(sqPtr + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sqPtr + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sqPtr + params.sq_off.array);
+    auto* cqPtr = static_cast<char*>(cqRing);
+    cqHead = reinterpret_cast<unsigned*>(cqPtr + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cqPtr + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cqPtr + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cqPtr + params.cq_off.cqes);
+
+    eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (eventFd < 0)
+    {
+        return false;
+    }
+    freeRequests.reserve(IO_QUEUE_DEPTH);
+    for (std::size_t i = IO_QUEUE_DEPTH; i > 0; i--)
+    {
+        freeRequests.push_back(i - 1);
+    }
+    return true;
+}
+
+io_uring_sqe* IoRing::GetSqe()
+{
+    //The I/O thread is the only producer and never has more submissions than entries
+    const unsigned tail = *sqTail;
+    const unsigned index = tail & *sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    toSubmit++;
+    return sqe;
+}
+
+bool IoRing::Enter(unsigned waitNmb)
+{
+    for (;;)
+    {
+        const long result = syscall(__NR_io_uring_enter, ringFd, toSubmit, waitNmb,
+                                    waitNmb > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+        if (result >= 0)
+        {
+            toSubmit -= static_cast<unsigned>(result);
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            logDebug(fmt::format("[Error] io_uring_enter failed: {}", std::strerror(errno)));
+            return false;
+        }
+    }
+}
+
+/**
+ * \brief Read the rest of the file into its buffer
+ */
+static void PrepareRead(IoRing& ring, std::size_t requestIndex)
+{
+    IoRequest& request = ring.requests[requestIndex];
+    request.iov.iov_base = request.buffer + request.offset;
+    request.iov.iov_len = request.size - request.offset;
+    io_uring_sqe* sqe = ring.GetSqe();
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = request.fd;
+    sqe->off = request.offset;
+    sqe->addr = reinterpret_cast<std::uint64_t>(&request.iov);
+    sqe->len = 1;
+    sqe->user_data = requestIndex + 1;
+}
+
+/**
+ * \brief Wait for the event fd to be readable, its completion has a null user data
+ */
+static void PreparePollEvent(IoRing& ring)
+{
+    io_uring_sqe* sqe = ring.GetSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = ring.eventFd;
+    sqe->poll_events = POLLIN;
+    sqe->user_data = 0;
+}
+#else
+struct IoRing
+{
+};
+#endif
+
+IoService::IoService() = default;
+
+IoService::~IoService()
+{
+    Destroy();
+}
+
+void IoService::Init(IoBackend backend)
+{
+    neko_assert(!isRunning_, "[IoService] Init called twice");
+    backend_ = backend;
+    if (backend_ == IoBackend::NONE)
+    {
+        return;
+    }
+    if (backend_ == IoBackend::IO_URING)
+    {
+#ifdef NEKO_IO_URING
+        ring_ = std::make_unique<IoRing>();
+        //One more entry for the event fd poll
+        if (!ring_->Init(static_cast<unsigned>(IO_QUEUE_DEPTH + 1)))
+        {
+            ring_ = nullptr;
+            backend_ = IoBackend::THREAD_POOL;
+        }
+#else
+        backend_ = IoBackend::THREAD_POOL;
+#endif
+    }
+    logDebug(fmt::format("[IoService] Started with {}",
+                         backend_ == IoBackend::IO_URING ? "io_uring" : "a thread pool"));
+    //A failing ring thread adds the thread pool to the threads
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    isRunning_ = true;
+    if (backend_ == IoBackend::IO_URING)
+    {
+        threads_.emplace_back([this] { RunRing(); });
+    }
+    else
+    {
+        for (std::size_t i = 0; i < IO_THREAD_POOL_SIZE; i++)
+        {
+            threads_.emplace_back([this] { RunThreadPool(); });
+        }
+    }
+}
+
+void IoService::Destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        if (!isRunning_)
+        {
+            return;
+        }
+        isRunning_ = false;
+    }
+    pendingCondition_.notify_all();
+#ifdef NEKO_IO_URING
+    if (ring_ != nullptr)
+    {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto written = write(ring_->eventFd, &one, sizeof(one));
+    }
+#endif
+    for (auto& thread : threads_)
+    {
+        thread.join();
+    }
+    threads_.clear();
+    ring_ = nullptr;
+    backend_ = IoBackend::NONE;
+}
+
+bool IoService::Read(ResourceJob* job)
+{
+    //The archive serves its assets from memory
+    if (AssetArchiveLocator::get().FindEntry(job->filePath_) != nullptr)
+    {
+        return false;
+    }
+    job->bufferFile_.Destroy();
+    job->isRead_ = false;
+    bool isRing;
+    bool wakeUpRing;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        if (!isRunning_)
+        {
+            return false;
+        }
+        pendingJobs_.push(job);
+        //Checked with the push, the ring thread switches to the thread pool under the same lock
+        isRing = backend_.load(std::memory_order_relaxed) == IoBackend::IO_URING;
+        wakeUpRing = isRingWaiting_;
+        isRingWaiting_ = false;
+    }
+#ifdef NEKO_IO_URING
+    if (isRing)
+    {
+        if (wakeUpRing)
+        {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const auto written = write(ring_->eventFd, &one, sizeof(one));
+        }
+        return true;
+    }
+#else
+    (void) isRing;
+    (void) wakeUpRing;
+#endif
+    pendingCondition_.notify_one();
+    return true;
+}
+
+void IoService::RunThreadPool()
+{
+    for (;;)
+    {
+        ResourceJob* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex_);
+            pendingCondition_.wait(lock, [this] { return !pendingJobs_.empty() || !isRunning_; });
+            //The pending reads are finished before stopping
+            if (pendingJobs_.empty())
+            {
+                return;
+            }
+            job = pendingJobs_.front();
+            pendingJobs_.pop();
+        }
+        ReadFile(job);
+    }
+}
+
+void IoService::RunRing()
+{
+#ifdef NEKO_IO_URING
+    IoRing& ring = *ring_;
+    std::vector<ResourceJob*> newJobs;
+    newJobs.reserve(IO_QUEUE_DEPTH);
+    std::size_t readsInFlight = 0;
+    bool isPollArmed = false;
+    for (;;)
+    {
+        bool isStopping;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            while (!pendingJobs_.empty() && newJobs.size() < ring.freeRequests.size())
+            {
+                newJobs.push_back(pendingJobs_.front());
+                pendingJobs_.pop();
+            }
+            //The pending reads are finished before stopping
+            isStopping = !isRunning_ && pendingJobs_.empty();
+            isRingWaiting_ = pendingJobs_.empty();
+        }
+        for (auto* job : newJobs)
+        {
+            const std::size_t requestIndex = ring.freeRequests.back();
+            IoRequest& request = ring.requests[requestIndex];
+            if (!OpenFile(job->filePath_, request.fd, request.buffer, request.size))
+            {
+                CompleteRead(job, nullptr, 0);
+                continue;
+            }
+            ring.freeRequests.pop_back();
+            request.job = job;
+            request.offset = 0;
+            PrepareRead(ring, requestIndex);
+            readsInFlight++;
+        }
+        newJobs.clear();
+        if (isStopping && readsInFlight == 0)
+        {
+            //Closing the ring cancels the event fd poll
+            return;
+        }
+        if (!isPollArmed)
+        {
+            PreparePollEvent(ring);
+            isPollArmed = true;
+        }
+        if (!EnterRing(1))
+        {
+            //The reads in flight are done again with blocking reads
+            std::vector<ResourceJob*> retriedJobs;
+            for (auto& request : ring.requests)
+            {
+                if (request.job == nullptr)
+                {
+                    continue;
+                }
+                close(request.fd);
+                request.fd = -1;
+                ring.abandonedBuffers.push_back(request.buffer);
+                request.buffer = nullptr;
+                retriedJobs.push_back(request.job);
+                request.job = nullptr;
+            }
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex_);
+                for (auto* job : retriedJobs)
+                {
+                    pendingJobs_.push(job);
+                }
+                backend_.store(IoBackend::THREAD_POOL, std::memory_order_relaxed);
+                //Destroy joins the threads once it stopped the service, no thread is added after
+                if (isRunning_)
+                {
+                    for (std::size_t i = 1; i < IO_THREAD_POOL_SIZE; i++)
+                    {
+                        threads_.emplace_back([this] { RunThreadPool(); });
+                    }
+                }
+            }
+            logDebug("[Error] io_uring cannot be used anymore, the reads fall back to a thread pool");
+            pendingCondition_.notify_all();
+            RunThreadPool();
+            return;
+        }
+#ifdef EASY_PROFILE_USE
+        EASY_BLOCK("Complete Reads");
+#endif
+        unsigned head = *ring.cqHead;
+        const unsigned tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++)
+        {
+            const io_uring_cqe& cqe = ring.cqes[head & *ring.cqMask];
+            if (cqe.user_data == 0)
+            {
+                std::uint64_t value;
+                [[maybe_unused]] const auto readSize = ::read(ring.eventFd, &value, sizeof(value));
+                isPollArmed = false;
+                continue;
+            }
+            const std::size_t requestIndex = cqe.user_data - 1;
+            IoRequest& request = ring.requests[requestIndex];
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+            {
+                PrepareRead(ring, requestIndex);
+                continue;
+            }
+            if (cqe.res < 0)
+            {
+                logDebug(fmt::format("[Error] Could not read file: {} {}",
+                                     request.job->filePath_, std::strerror(-cqe.res)));
+                delete[] request.buffer;
+                request.buffer = nullptr;
+                request.size = 0;
+            }
+            else if (cqe.res == 0)
+            {
+                //The file was truncated since it was opened
+                request.size = request.offset;
+            }
+            else
+            {
+                request.offset += static_cast<std::size_t>(cqe.res);
+                if (request.offset < request.size)
+                {
+                    PrepareRead(ring, requestIndex);
+                    continue;
+                }
+            }
+            close(request.fd);
+            request.fd = -1;
+            ResourceJob* job = request.job;
+            request.job = nullptr;
+            ring.freeRequests.push_back(requestIndex);
+            readsInFlight--;
+            CompleteRead(job, request.buffer, request.size);
+        }
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+    }
+#endif
+}
+
+bool IoService::EnterRing([[maybe_unused]] unsigned waitNmb)
+{
+#ifdef NEKO_IO_URING
+    return ring_->Enter(waitNmb);
+#else
+    return false;
+#endif
+}
+
+void IoService::ReadFile(ResourceJob* job)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Read File");
+#endif
+#if defined(__linux__)
+    int fd = -1;
+    unsigned char* buffer = nullptr;
+    std::size_t size = 0;
+    if (!OpenFile(job->filePath_, fd, buffer, size))
+    {
+        CompleteRead(job, nullptr, 0);
+        return;
+    }
+    std::size_t offset = 0;
+    while (offset < size)
+    {
+        const ssize_t readSize = pread(fd, buffer + offset, size - offset, static_cast<off_t>(offset));
+        if (readSize < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (readSize < 0)
+        {
+            logDebug(fmt::format("[Error] Could not read file: {} {}", job->filePath_, std::strerror(errno)));
+        }
+        if (readSize <= 0)
+        {
+            break;
+        }
+        offset += static_cast<std::size_t>(readSize);
+    }
+    close(fd);
+    CompleteRead(job, buffer, offset);
+#else
+    job->bufferFile_.Load(job->filePath_, BufferFile::LoadMode::READ);
+    job->isRead_ = true;
+    job->Execute();
+#endif
+}
+
+void IoService::CompleteRead(ResourceJob* job, unsigned char* buffer, std::size_t length)
+{
+    if (buffer != nullptr)
+    {
+        buffer[length] = 0;
+    }
+    job->bufferFile_.Destroy();
+    job->bufferFile_.dataBuffer = buffer;
+    job->bufferFile_.dataLength = length;
+    job->bufferFile_.storage = BufferFile::Storage::HEAP;
+    job->isRead_ = true;
+    job->Execute();
+}
+}
@@ -100,8 +100,10 @@ json LoadJson(const std::string_view jsonPath)
         return jsonContent;
     }
 
-    const auto jsonStrContent = LoadFile(jsonPath.data());
-    jsonContent = json::parse(jsonStrContent, nullptr, false);
+    //Parse the file buffer directly, without a copy to a string
+    BufferFile jsonFile;
+    jsonFile.Load(jsonPath);
+    jsonContent = json::parse(jsonFile.dataBuffer, jsonFile.dataBuffer + jsonFile.dataLength, nullptr, false);
 
     return jsonContent;
 }
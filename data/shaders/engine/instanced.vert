@@ -0,0 +1,21 @@
+#version 300 es
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoords;
+layout(location = 2) in vec3 aNormal;
+layout(location = 5) in mat4 aModel;
+
+out vec2 TexCoords;
+out vec3 Normal;
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+};
+
+void main()
+{
+    TexCoords = aTexCoords;
+    Normal = mat3(aModel) * aNormal;
+    gl_Position = projection * view * aModel * vec4(aPos, 1.0);
+}
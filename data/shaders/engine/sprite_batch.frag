@@ -0,0 +1,12 @@
+#version 300 es
+precision mediump float;
+
+out vec4 FragColor;
+in vec2 TexCoords;
+in vec4 SpriteColor;
+uniform sampler2D spriteTexture;
+
+void main()
+{
+    FragColor = texture(spriteTexture, TexCoords) * SpriteColor;
+}
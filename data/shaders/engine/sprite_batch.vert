@@ -0,0 +1,20 @@
+#version 300 es
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoords;
+layout(location = 2) in vec4 aColor;
+
+out vec2 TexCoords;
+out vec4 SpriteColor;
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+};
+
+void main()
+{
+    TexCoords = aTexCoords;
+    SpriteColor = aColor;
+    gl_Position = projection * view * vec4(aPos, 1.0);
+}
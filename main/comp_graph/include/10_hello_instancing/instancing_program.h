@@ -61,6 +61,10 @@ private:
 	const size_t uniformChunkSize_ = 254;
 	size_t instanceChunkSize_ = 1'000;
 	size_t asteroidNmb_ = 1000;
+	/**
+	 * Number of asteroids updated by one parallel for chunk
+	 */
+	const size_t asteroidGrainSize_ = 1'000;
 
 	gl::Shader singleDrawShader_;
 	gl::Shader uniformInstancingShader_;
@@ -22,10 +22,12 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
+
 #include "comp_graph/sample_program.h"
 #include "gl/model.h"
 #include "gl/shader.h"
 #include "gl/shape.h"
+#include "graphics/frustum.h"
 #include "sdl_engine/sdl_camera.h"
 
 namespace neko
@@ -43,7 +45,7 @@ private:
 	void CalculateForce(size_t begin, size_t end);
 	void CalculateVelocity(size_t begin, size_t end);
 	void CalculatePositions(size_t begin, size_t end);
-	void Culling(size_t begin, size_t end);
+	void UpdateBounds(size_t begin, size_t end);
 
 
 	sdl::Camera3D camera_;
@@ -54,6 +56,10 @@ private:
 	const size_t minAsteroidNmb_ = 1'000;
 	size_t instanceChunkSize_ = 1'000;
 	size_t asteroidNmb_ = 1000;
+	/**
+	 * Number of asteroids updated by one parallel for chunk
+	 */
+	const size_t asteroidGrainSize_ = 1'000;
 
 	size_t culledAsteroids_ = 0;
 
@@ -67,6 +73,8 @@ private:
 	 * Used by frustum culling before sending to GPU
 	 */
 	std::vector<Vec3f> asteroidCulledPositions_;
+	BoundingSpheres asteroidBounds_;
+	FrustumCuller asteroidCuller_;
 
 
 	unsigned int instanceVBO_ = 0;
@@ -0,0 +1,71 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include <vector>
+
+#include "comp_graph/sample_program.h"
+#include "engine/entity.h"
+#include "engine/transform.h"
+#include "gl/instancing.h"
+#include "gl/model.h"
+#include "gl/model_renderer.h"
+#include "gl/shader.h"
+#include "sdl_engine/sdl_camera.h"
+
+namespace neko
+{
+/**
+ * \brief Stress test of the instanced batching, a ring of orbiting rock entities with a ModelRenderer component.
+ * All the rocks end up in the same batch and are drawn with one instanced draw call per mesh of the model.
+ */
+class HelloModelBatchProgram : public SampleProgram
+{
+public:
+	HelloModelBatchProgram();
+	void Init() override;
+	void Update(seconds dt) override;
+	void Destroy() override;
+	void DrawImGui() override;
+	void Render() override;
+	void OnEvent(const SDL_Event& event) override;
+private:
+	void ResizeRocks(std::size_t rocksNmb);
+
+	static constexpr int maxRocksNmb = 200'000;
+
+	EntityManager entityManager_;
+	Transform3dManager transformManager_;
+	gl::InstancedBatchRenderer batchRenderer_;
+	assimp::ModelRendererManager modelRendererManager_;
+	assimp::Model model_;
+	gl::Shader shader_;
+	sdl::Camera3D camera_;
+
+	std::vector<float> radiuses_;
+	std::vector<float> heights_;
+	std::vector<degree_t> angles_;
+	int rocksNmb_ = 100'000;
+	float frameTime_ = 0.0f;
+};
+}
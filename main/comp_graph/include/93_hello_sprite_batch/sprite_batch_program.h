@@ -0,0 +1,67 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include <vector>
+
+#include "comp_graph/sample_program.h"
+#include "engine/entity.h"
+#include "engine/transform.h"
+#include "gl/sprite.h"
+#include "gl/texture.h"
+#include "graphics/camera.h"
+
+namespace neko
+{
+/**
+ * \brief Stress test of the sprite batching, moving sprites with a few textures packed in the same atlas.
+ * Can grow the sprites count until the frame rate goes below 60 FPS.
+ */
+class HelloSpriteBatchProgram : public SampleProgram
+{
+public:
+	HelloSpriteBatchProgram();
+	void Init() override;
+	void Update(seconds dt) override;
+	void Destroy() override;
+	void DrawImGui() override;
+	void Render() override;
+	void OnEvent(const SDL_Event& event) override;
+private:
+	void ResizeSprites(std::size_t spritesNmb);
+
+	EntityManager entityManager_;
+	Transform2dManager transformManager_;
+	gl::TextureManager textureManager_;
+	gl::SpriteManager spriteManager_;
+	Camera2D camera_;
+
+	std::vector<TextureId> textureIds_;
+	std::vector<Vec2f> velocities_;
+	int spritesNmb_ = 1'000;
+	float frameTime_ = 0.0f;
+	bool findMaxSprites_ = false;
+	int maxSpritesAt60Fps_ = 0;
+	int framesSinceResize_ = 0;
+};
+}
@@ -27,6 +27,7 @@
 #include <engine/engine.h>
 #include "01_hello_triangle/triangle_program.h"
 #include "engine/log.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -41,10 +42,10 @@ void HelloTriangleProgram::Init()
 	glGenVertexArrays(1, &triangleProgram_.VAO);
     // ..:: Initialization code (done once (unless your object frequently changes)) :: ..
 	// 1. bind Vertex Array Object
-    glBindVertexArray(triangleProgram_.VAO);
+    gl::BindVertexArray(triangleProgram_.VAO);
     // 2. copy our vertices array in a buffer for OpenGL to use
 	glGenBuffers(1, &triangleProgram_.VBO); 
-    glBindBuffer(GL_ARRAY_BUFFER, triangleProgram_.VBO);
+    gl::BindBuffer(GL_ARRAY_BUFFER, triangleProgram_.VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(triangleProgram_.vertices), &triangleProgram_.vertices, GL_STATIC_DRAW);
     // 3. then set our vertex attributes pointers
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
@@ -60,9 +61,9 @@ void HelloTriangleProgram::Init()
     glGenBuffers(1, &vaoProgam_.VBO);
     glGenVertexArrays(1, &vaoProgam_.VAO);
     // 1. bind Vertex Array Object
-    glBindVertexArray(vaoProgam_.VAO);
+    gl::BindVertexArray(vaoProgam_.VAO);
     // 2. copy our vertices array in a buffer for OpenGL to use
-    glBindBuffer(GL_ARRAY_BUFFER, vaoProgam_.VBO);
+    gl::BindBuffer(GL_ARRAY_BUFFER, vaoProgam_.VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vaoProgam_.vertexData), vaoProgam_.vertexData, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -76,18 +77,18 @@ void HelloTriangleProgram::Init()
     glGenBuffers(1, &eboProgram_.EBO);
     glGenVertexArrays(1, &eboProgram_.VAO);
     // 1. bind Vertex Array Object
-    glBindVertexArray(eboProgram_.VAO);
+    gl::BindVertexArray(eboProgram_.VAO);
     // 2. copy our vertices array in a buffer for OpenGL to use
-    glBindBuffer(GL_ARRAY_BUFFER, eboProgram_.VBO[0]);
+    gl::BindBuffer(GL_ARRAY_BUFFER, eboProgram_.VBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(eboProgram_.vertices), eboProgram_.vertices, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*) 0);
     glEnableVertexAttribArray(0);
     // 2. copy our colors array in a buffer for OpenGL to use
-    glBindBuffer(GL_ARRAY_BUFFER, eboProgram_.VBO[1]);
+    gl::BindBuffer(GL_ARRAY_BUFFER, eboProgram_.VBO[1]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(eboProgram_.colors), eboProgram_.colors, GL_STATIC_DRAW);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*) 0);
     glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboProgram_.EBO);
+    gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboProgram_.EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(eboProgram_.indices), eboProgram_.indices, GL_STATIC_DRAW);
 
     nekoShader_.LoadFromFile(
@@ -96,7 +97,7 @@ void HelloTriangleProgram::Init()
     quad_.Init();
     circle_.Init();
 
-    glEnable(GL_DEPTH_TEST);
+    gl::Enable(GL_DEPTH_TEST);
     glCheckError();
 }
 
@@ -116,7 +117,7 @@ void HelloTriangleProgram::Render()
     case RenderType::Triangle:
 	    {
 	        triangleProgram_.shader.Bind();
-	        glBindVertexArray(triangleProgram_.VAO);
+	        gl::BindVertexArray(triangleProgram_.VAO);
 	        glDrawArrays(GL_TRIANGLES, 0, 3);
 	        break;
 	    }
@@ -126,7 +127,7 @@ void HelloTriangleProgram::Render()
             const float colorValue = (std::cos(timeSinceInit_.count()) + 1.0f) / 2.0f;
             shader_.SetFloat("colorCoeff", colorValue);
 
-            glBindVertexArray(vaoProgam_.VAO);
+            gl::BindVertexArray(vaoProgam_.VAO);
             glDrawArrays(GL_TRIANGLES, 0, 6);
 
             break;
@@ -137,7 +138,7 @@ void HelloTriangleProgram::Render()
             const float colorValue = (std::cos(timeSinceInit_.count()) + 1.0f) / 2.0f;
             shader_.SetFloat("colorCoeff", colorValue);
 
-            glBindVertexArray(eboProgram_.VAO);
+            gl::BindVertexArray(eboProgram_.VAO);
             glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
             break;
@@ -169,16 +170,16 @@ void HelloTriangleProgram::Render()
 
 void HelloTriangleProgram::Destroy()
 {
-    glDeleteVertexArrays(1, &triangleProgram_.VAO);
-    glDeleteBuffers(1, &triangleProgram_.VBO);
+    gl::DeleteVertexArrays(1, &triangleProgram_.VAO);
+    gl::DeleteBuffers(1, &triangleProgram_.VBO);
     triangleProgram_.shader.Destroy();
 	
-    glDeleteVertexArrays(1, &eboProgram_.VAO);
-    glDeleteBuffers(2, &eboProgram_.VBO[0]);
-    glDeleteBuffers(1, &eboProgram_.EBO);
+    gl::DeleteVertexArrays(1, &eboProgram_.VAO);
+    gl::DeleteBuffers(2, &eboProgram_.VBO[0]);
+    gl::DeleteBuffers(1, &eboProgram_.EBO);
 
-    glDeleteVertexArrays(1, &vaoProgam_.VAO);
-    glDeleteBuffers(1, &vaoProgam_.VBO);
+    gl::DeleteVertexArrays(1, &vaoProgam_.VAO);
+    gl::DeleteBuffers(1, &vaoProgam_.VBO);
 
     quad_.Destroy();
     circle_.Destroy();
@@ -25,6 +25,7 @@
 #include <gl/texture.h>
 #include "02_hello_texture/texture_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 namespace neko
 {
 
@@ -42,7 +43,7 @@ void HelloTextureProgram::Init()
     textureKtx_ = gl::CreateTextureFromKTX(
         config.dataRootPath + "sprites/wall.jpg.ktx");
 	//textureId_ = neko::gl::stbCreateTexture(texturePath);
-    glEnable(GL_DEPTH_TEST);
+    gl::Enable(GL_DEPTH_TEST);
 }
 
 void HelloTextureProgram::Update(seconds dt)
@@ -72,17 +73,17 @@ void HelloTextureProgram::Render()
 	}
     shader_.Bind();
     shader_.SetInt("ourTexture", 0);//set the texture slot
-    glActiveTexture(GL_TEXTURE0);//activate the texture slot
+    gl::ActiveTexture(GL_TEXTURE0);//activate the texture slot
     switch (textureType_)
     {
     case TextureType::STB_TEXTURE:
     {
-        glBindTexture(GL_TEXTURE_2D, texture_);//bind texture id to texture slot
+        gl::BindTexture(GL_TEXTURE_2D, texture_);//bind texture id to texture slot
         break;
     }
     case TextureType::KTX_TEXTURE:
     {
-        glBindTexture(GL_TEXTURE_2D, textureKtx_);//bind texture id to texture slot
+        gl::BindTexture(GL_TEXTURE_2D, textureKtx_);//bind texture id to texture slot
         break;
     }
     default: ;
@@ -27,6 +27,7 @@
 #include <imgui.h>
 #include "03_hello_transform/transform_program.h"
 #include "mathematics/transform.h"
+#include "gl/state_cache.h"
 
 #define ROTATE_OVER_TIME
 
@@ -55,7 +56,7 @@ void HelloTransformProgram::Render()
 
     shaderProgram_.SetMat4("transform", transform_);
 
-    glBindTexture(GL_TEXTURE_2D, textureWall_);
+    gl::BindTexture(GL_TEXTURE_2D, textureWall_);
     switch (shape_)
     {
 
@@ -69,7 +70,7 @@ void HelloTransformProgram::Render()
             break;
     }
 
-    glEnable(GL_DEPTH_TEST);
+    gl::Enable(GL_DEPTH_TEST);
 
 }
 
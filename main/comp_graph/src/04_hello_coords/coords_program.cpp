@@ -28,6 +28,7 @@
 
 #include "mathematics/matrix.h"
 #include "mathematics/transform.h"
+#include "gl/state_cache.h"
 namespace neko
 {
 
@@ -47,7 +48,7 @@ void HelloCoordsProgram::Init()
     view = Transform3d::Translate(view, Vec3f(0.0f, 0.0f, -3.0f));
 
 
-    glEnable(GL_DEPTH_TEST);
+    gl::Enable(GL_DEPTH_TEST);
 
 }
 
@@ -78,7 +79,7 @@ void HelloCoordsProgram::Render()
     }
     std::lock_guard<std::mutex> lock(updateMutex_);
     shader_.Bind();
-    glBindTexture(GL_TEXTURE_2D, textureWall_);
+    gl::BindTexture(GL_TEXTURE_2D, textureWall_);
     shader_.SetMat4("view", view);
     shader_.SetMat4("projection", projection);
 
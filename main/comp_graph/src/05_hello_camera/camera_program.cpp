@@ -27,6 +27,7 @@
 #include <sstream>
 #include <fmt/format.h>
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -166,7 +167,7 @@ void HelloCameraProgram::Render()
 
 	std::lock_guard<std::mutex> lock(updateMutex_);
 	shader_.Bind();
-	glBindTexture(GL_TEXTURE_2D, textureWall_);
+	gl::BindTexture(GL_TEXTURE_2D, textureWall_);
 	shader_.SetMat4("view", camera_.GenerateViewMatrix());
 	shader_.SetMat4("projection", projection_);
 
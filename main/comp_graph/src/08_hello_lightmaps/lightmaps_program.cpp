@@ -25,6 +25,7 @@
 #include "08_hello_lightmaps/lightmaps_program.h"
 #include "gl/texture.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -104,11 +105,11 @@ void HelloLightMapsProgram::Render()
 	containerShader_.SetVec3("viewPos", camera_.position);
 
 	containerShader_.SetInt("objectMaterial.diffuse", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, containerDiffuse_);
+	gl::ActiveTexture(GL_TEXTURE0);
+	gl::BindTexture(GL_TEXTURE_2D, containerDiffuse_);
 	containerShader_.SetInt("objectMaterial.specular", 1);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, containerSpecular_);
+	gl::ActiveTexture(GL_TEXTURE1);
+	gl::BindTexture(GL_TEXTURE_2D, containerSpecular_);
 	containerShader_.SetInt("objectMaterial.shininess", specularPow_);
 
 	containerShader_.SetFloat("ambientStrength", ambientStrength_);
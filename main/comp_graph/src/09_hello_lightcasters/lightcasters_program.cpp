@@ -25,6 +25,7 @@
 #include "09_hello_lightcasters/lightcasters_program.h"
 #include "imgui.h"
 #include "gl/texture.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -218,11 +219,11 @@ void HelloLightCastersProgram::Render()
 	containerShader.SetVec3("viewPos", camera_.position);
 
 	containerShader.SetInt("objectMaterial.diffuse", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, containerDiffuse_);
+	gl::ActiveTexture(GL_TEXTURE0);
+	gl::BindTexture(GL_TEXTURE_2D, containerDiffuse_);
 	containerShader.SetInt("objectMaterial.specular", 1);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, containerSpecular_);
+	gl::ActiveTexture(GL_TEXTURE1);
+	gl::BindTexture(GL_TEXTURE_2D, containerSpecular_);
 	containerShader.SetInt("objectMaterial.shininess", specularPow_);
 
 	containerShader.SetFloat("ambientStrength", ambientStrength_);
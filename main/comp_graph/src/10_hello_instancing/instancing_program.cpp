@@ -24,6 +24,7 @@
 
 #include "10_hello_instancing/instancing_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -86,9 +87,12 @@ void HelloInstancingProgram::Update(seconds dt)
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Calculate Positions");
 #endif
-    CalculateForce(0, asteroidNmb_);
-    CalculateVelocity(0, asteroidNmb_);
-    CalculatePositions(0, asteroidNmb_);
+    engine->ParallelFor(0, asteroidNmb_, asteroidGrainSize_, [this](size_t begin, size_t end)
+    {
+        CalculateForce(begin, end);
+        CalculateVelocity(begin, end);
+        CalculatePositions(begin, end);
+    });
 #ifdef EASY_PROFILE_USE
     EASY_END_BLOCK;
 #endif
@@ -142,15 +146,15 @@ void HelloInstancingProgram::Render()
     {
         const auto& asteroidMesh = model_.GetMesh(0);
 
-        glBindVertexArray(asteroidMesh.GetVao());
+        gl::BindVertexArray(asteroidMesh.GetVao());
         glGenBuffers(1, &instanceVBO_);
 
-        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+        gl::BindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
         glEnableVertexAttribArray(5);
         glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3f), (void*)0);
         glVertexAttribDivisor(5, 1);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        gl::BindBuffer(GL_ARRAY_BUFFER, 0);
+        gl::BindVertexArray(0);
 
     }
 
@@ -202,10 +206,10 @@ void HelloInstancingProgram::Render()
 #endif
                 if (chunkEndIndex > chunkBeginIndex)
                 {
-                    glBindVertexArray(asteroidMesh.GetVao());
+                    gl::BindVertexArray(asteroidMesh.GetVao());
                     glDrawElementsInstanced(GL_TRIANGLES, asteroidMesh.GetElementsCount(), GL_UNSIGNED_INT, 0,
                                             chunkEndIndex - chunkBeginIndex);
-                    glBindVertexArray(0);
+                    gl::BindVertexArray(0);
                 }
             }
             break;
@@ -231,18 +235,18 @@ void HelloInstancingProgram::Render()
 #ifdef EASY_PROFILE_USE
                     EASY_BLOCK("Set VBO Model Matrices");
 #endif
-                    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+                    gl::BindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
                     glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3f) * chunkSize, &asteroidPositions_[chunkBeginIndex], GL_DYNAMIC_DRAW);
-                    glBindBuffer(GL_ARRAY_BUFFER, 0);
+                    gl::BindBuffer(GL_ARRAY_BUFFER, 0);
 #ifdef EASY_PROFILE_USE
                     EASY_END_BLOCK
                     EASY_BLOCK("Draw Mesh");
 
 #endif
-                    glBindVertexArray(asteroidMesh.GetVao());
+                    gl::BindVertexArray(asteroidMesh.GetVao());
                     glDrawElementsInstanced(GL_TRIANGLES, asteroidMesh.GetElementsCount(), GL_UNSIGNED_INT, 0,
                                             chunkSize);
-                    glBindVertexArray(0);
+                    gl::BindVertexArray(0);
                 }
             }
 
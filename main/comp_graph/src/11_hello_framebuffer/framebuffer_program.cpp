@@ -25,6 +25,7 @@
 #include "gl/shape.h"
 #include "11_hello_framebuffer/framebuffer_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -44,14 +45,14 @@ void HelloFramebufferProgram::Init()
     cube_.Init();
 	//Create Screen FBO
     glGenFramebuffers(1, &fbo_);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
     //Generate Color Buffer for FBO
     glGenTextures(1, &fboColorBufferTexture_);
-    glBindTexture(GL_TEXTURE_2D, fboColorBufferTexture_);
+    gl::BindTexture(GL_TEXTURE_2D, fboColorBufferTexture_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, config.windowSize.x, config.windowSize.y, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl::BindTexture(GL_TEXTURE_2D, 0);
     //Bind the Color Buffer
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fboColorBufferTexture_, 0);
     //Generate the Depth-Stencil RenderBuffer Object
@@ -65,7 +66,7 @@ void HelloFramebufferProgram::Init()
     {
         logDebug("[Error] Framebuffer is not complete!");
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     screenShader_.LoadFromFile(
             config.dataRootPath + "shaders/11_hello_framebuffer/screen.vert",
@@ -103,8 +104,8 @@ void HelloFramebufferProgram::Destroy()
 {
     textureManager_.Destroy();
 
-    glDeleteFramebuffers(1, &fbo_);
-    glDeleteTextures(1, &fboColorBufferTexture_);
+    gl::DeleteFramebuffers(1, &fbo_);
+    gl::DeleteTextures(1, &fboColorBufferTexture_);
     glDeleteRenderbuffers(1, &rbo_);
 
     cube_.Destroy();
@@ -149,20 +150,20 @@ void HelloFramebufferProgram::Render()
     if(hasScreenResize_)
     {
         //When the screen resize, we need to resize
-        glDeleteFramebuffers(1, &fbo_);
-        glDeleteTextures(1, &fboColorBufferTexture_);
+        gl::DeleteFramebuffers(1, &fbo_);
+        gl::DeleteTextures(1, &fboColorBufferTexture_);
         glDeleteRenderbuffers(1, &rbo_);
 
         const auto& config = BasicEngine::GetInstance()->config;
         glGenFramebuffers(1, &fbo_);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+        gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
         glGenTextures(1, &fboColorBufferTexture_);
-        glBindTexture(GL_TEXTURE_2D, fboColorBufferTexture_);
+        gl::BindTexture(GL_TEXTURE_2D, fboColorBufferTexture_);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, config.windowSize.x, config.windowSize.y, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl::BindTexture(GL_TEXTURE_2D, 0);
 
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fboColorBufferTexture_, 0);
 
@@ -175,17 +176,17 @@ void HelloFramebufferProgram::Render()
         {
             logDebug("[Error] Framebuffer is not complete afetr resize!");
         }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
         hasScreenResize_ = false;
 
         logDebug("Framebuffer resized with size: "+std::to_string(config.windowSize.x)+", "+std::to_string(config.windowSize.y));
     }
 
     //Bind framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_DEPTH_TEST);
+    gl::Enable(GL_DEPTH_TEST);
     //Draw scene
     modelShader_.Bind();
     modelShader_.SetMat4("model", Mat4f::Identity);
@@ -193,8 +194,8 @@ void HelloFramebufferProgram::Render()
     modelShader_.SetMat4("projection", camera_.GenerateProjectionMatrix());
 
     modelShader_.SetInt("texture_diffuse1", 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, containerTexture_);
+    gl::ActiveTexture(GL_TEXTURE0);
+    gl::BindTexture(GL_TEXTURE_2D, containerTexture_);
     cube_.Draw();
 
     //Bind backbuffer
@@ -219,12 +220,12 @@ void HelloFramebufferProgram::Render()
         default:
             break;
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     currentShader->Bind();
-    glDisable(GL_DEPTH_TEST);
+    gl::Disable(GL_DEPTH_TEST);
     currentShader->SetInt("screenTexture", 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, fboColorBufferTexture_);
+    gl::ActiveTexture(GL_TEXTURE0);
+    gl::BindTexture(GL_TEXTURE_2D, fboColorBufferTexture_);
     screenFrame_.Draw();
 
 
@@ -24,6 +24,7 @@
 
 #include "12_hello_stencil/stencil_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -89,7 +90,7 @@ void HelloStencilProgam::Render()
 	}
 	std::lock_guard<std::mutex> lock(updateMutex_);
 	//Draw upper cube
-	glEnable(GL_DEPTH_TEST);
+	gl::Enable(GL_DEPTH_TEST);
 	const auto view = camera_.GenerateViewMatrix();
 	const auto projection = camera_.GenerateProjectionMatrix();
 
@@ -104,14 +105,14 @@ void HelloStencilProgam::Render()
 	cubeShader_.SetVec3("overrideColor", Vec3f::one);
 
 	cubeShader_.SetInt("ourTexture", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, cubeTexture_);
+	gl::ActiveTexture(GL_TEXTURE0);
+	gl::BindTexture(GL_TEXTURE_2D, cubeTexture_);
 
 	cube_.Draw();
 	if(flags_ & USE_STENCIL)
 	{
 		// Draw floor
-		glEnable(GL_STENCIL_TEST);
+		gl::Enable(GL_STENCIL_TEST);
 
 		glStencilFunc(GL_ALWAYS, 1, 0xFF); // Set any stencil to 1
 		glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE); //only put stencil value if depth pass
@@ -121,7 +122,7 @@ void HelloStencilProgam::Render()
 	}
 	if(flags_ & REMOVE_ONLY_DEPTH)
 	{
-		glDepthMask(GL_FALSE); // Don't write to depth buffer, but still checking depth
+		gl::DepthMask(GL_FALSE); // Don't write to depth buffer, but still checking depth
 	}
 	floorShader_.Bind();
 	floorShader_.SetMat4("view", view);
@@ -139,7 +140,7 @@ void HelloStencilProgam::Render()
 	}
 	if(flags_ & REMOVE_ONLY_DEPTH)
 	{
-		glDepthMask(GL_TRUE); // Write to depth buffer
+		gl::DepthMask(GL_TRUE); // Write to depth buffer
 	}
 	cubeShader_.Bind();
 	model = Mat4f::Identity;
@@ -150,7 +151,7 @@ void HelloStencilProgam::Render()
 	cube_.Draw();
 	if(flags_ & USE_STENCIL)
 	{
-		glDisable(GL_STENCIL_TEST);
+		gl::Disable(GL_STENCIL_TEST);
 	}
 
 }
@@ -24,6 +24,7 @@
 
 #include "13_hello_depth/depth_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -35,26 +36,26 @@ void HelloDepthProgram::Init()
 	screenPlane_.Init();
 
 	glGenFramebuffers(1, &fbo_);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
 	
 	glGenTextures(1, &screenTexture_);
-	glBindTexture(GL_TEXTURE_2D, screenTexture_);
+	gl::BindTexture(GL_TEXTURE_2D, screenTexture_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, config.windowSize.x, config.windowSize.y, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, screenTexture_, 0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	gl::BindTexture(GL_TEXTURE_2D, 0);
 	
 	glGenTextures(1, &depthTexture_);
-	glBindTexture(GL_TEXTURE_2D, depthTexture_);
+	gl::BindTexture(GL_TEXTURE_2D, depthTexture_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, config.windowSize.x, config.windowSize.y, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTexture_, 0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	gl::BindTexture(GL_TEXTURE_2D, 0);
 	
 	glCheckFramebuffer();
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     sceneShader_.LoadFromFile(config.dataRootPath + "shaders/99_hello_scene/cube.vert",
                               config.dataRootPath + "shaders/99_hello_scene/cube.frag");
@@ -83,9 +84,9 @@ void HelloDepthProgram::Destroy()
 	floor_.Destroy();
 
 
-	glDeleteFramebuffers(1, &fbo_);
-	glDeleteTextures(1, &screenTexture_);
-	glDeleteTextures(1, &depthTexture_);
+	gl::DeleteFramebuffers(1, &fbo_);
+	gl::DeleteTextures(1, &screenTexture_);
+	gl::DeleteTextures(1, &depthTexture_);
 
 }
 
@@ -110,14 +111,14 @@ void HelloDepthProgram::Render()
 	std::lock_guard<std::mutex> lock(updateMutex_);
 
 	//Bind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glEnable(GL_DEPTH_TEST);
+	gl::Enable(GL_DEPTH_TEST);
 	//Draw scene
 	DrawScene();
-	glDisable(GL_DEPTH_TEST);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::Disable(GL_DEPTH_TEST);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	if (flags_ & DEPTH_ONLY)
 	{
 		depthOnlyShader_.Bind();
@@ -125,19 +126,19 @@ void HelloDepthProgram::Render()
 		depthOnlyShader_.SetFloat("far", camera_.farPlane);
 		depthOnlyShader_.SetInt("depthTexture", 0);
 		depthOnlyShader_.SetBool("linearDepth", flags_ & LINEAR_DEPTH);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, depthTexture_);
+		gl::ActiveTexture(GL_TEXTURE0);
+		gl::BindTexture(GL_TEXTURE_2D, depthTexture_);
 		screenPlane_.Draw();
 	}
 	else
 	{
 		screenShader_.Bind();
 		screenShader_.SetInt("screenTexture", 0);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, screenTexture_);
+		gl::ActiveTexture(GL_TEXTURE0);
+		gl::BindTexture(GL_TEXTURE_2D, screenTexture_);
 		screenPlane_.Draw();
 	}
-	glEnable(GL_DEPTH_TEST);
+	gl::Enable(GL_DEPTH_TEST);
 }
 
 void HelloDepthProgram::OnEvent(const SDL_Event& event)
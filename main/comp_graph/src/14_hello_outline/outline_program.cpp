@@ -24,6 +24,7 @@
 
 #include "14_hello_outline/outline_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -93,7 +94,7 @@ void HelloOutlineProgram::Render()
 	//Draw cube
 	if(flags_ & USE_STENCIL)
 	{
-		glEnable(GL_STENCIL_TEST);
+		gl::Enable(GL_STENCIL_TEST);
 		glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE); //write only when depth pass
 		glStencilFunc(GL_ALWAYS, 1, 0xFF); // all fragments should pass the stencil test
 		glStencilMask(0xFF); // enable writing to the stencil buffer
@@ -105,8 +106,8 @@ void HelloOutlineProgram::Render()
 	modelShader_.SetMat4("model", Mat4f::Identity);
 
 	modelShader_.SetInt("texture_diffuse1", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, cubeTexture_);
+	gl::ActiveTexture(GL_TEXTURE0);
+	gl::BindTexture(GL_TEXTURE_2D, cubeTexture_);
 
 	cube_.Draw();
 
@@ -129,7 +130,7 @@ void HelloOutlineProgram::Render()
 	}
 	if(flags_ & USE_STENCIL)
 	{
-		glDisable(GL_STENCIL_TEST);
+		gl::Disable(GL_STENCIL_TEST);
 	}
 }
 
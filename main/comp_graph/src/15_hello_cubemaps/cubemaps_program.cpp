@@ -24,6 +24,7 @@
 
 #include "15_hello_cubemaps/cubemaps_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -67,7 +68,7 @@ void HelloCubemapsProgram::Update(seconds dt)
 
 void HelloCubemapsProgram::Destroy()
 {
-	glDeleteTextures(1, &skyboxTexture_);
+	gl::DeleteTextures(1, &skyboxTexture_);
 	skyboxCube_.Destroy();
 	skyboxShader_.Destroy();
 
@@ -138,8 +139,8 @@ void HelloCubemapsProgram::Render()
 		model = Mat4f::Identity;
 		model = Transform3d::Translate(model, Vec3f::left * 2.0f);
 		modelShader_.SetMat4("model", model);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, cubeTexture_);
+		gl::ActiveTexture(GL_TEXTURE0);
+		gl::BindTexture(GL_TEXTURE_2D, cubeTexture_);
 		cube_.Draw();
 		break;
 	}
@@ -155,14 +156,14 @@ void HelloCubemapsProgram::Render()
 		modelReflectionShader_.SetInt("skybox", 2);
 		modelReflectionShader_.SetVec3("cameraPos", camera_.position);
 		modelReflectionShader_.SetFloat("reflectionValue", reflectionValue_);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
+		gl::ActiveTexture(GL_TEXTURE2);
+		gl::BindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
 		model_.Draw(modelReflectionShader_);
 		model = Mat4f::Identity;
 		model = Transform3d::Translate(model, Vec3f::left * 2.0f);
 		modelReflectionShader_.SetMat4("model", model);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, cubeTexture_);
+		gl::ActiveTexture(GL_TEXTURE0);
+		gl::BindTexture(GL_TEXTURE_2D, cubeTexture_);
 		cube_.Draw();
 		break;
 	}
@@ -180,14 +181,14 @@ void HelloCubemapsProgram::Render()
 		modelRefractionShader_.SetFloat("refractionValue", refractionValue_);
 		modelRefractionShader_.SetVec3("cameraPos", camera_.position);
 		modelRefractionShader_.SetInt("skybox", 2);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
+		gl::ActiveTexture(GL_TEXTURE2);
+		gl::BindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
 		model_.Draw(modelRefractionShader_);
 		model = Mat4f::Identity;
 		model = Transform3d::Translate(model, Vec3f::left * 2.0f);
 		modelRefractionShader_.SetMat4("model", model);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, cubeTexture_);
+		gl::ActiveTexture(GL_TEXTURE0);
+		gl::BindTexture(GL_TEXTURE_2D, cubeTexture_);
 		cube_.Draw();
 		break;
 	}
@@ -195,15 +196,15 @@ void HelloCubemapsProgram::Render()
 	}
 	
 	//Draw skybox
-	glDepthFunc(GL_LEQUAL);
+	gl::DepthFunc(GL_LEQUAL);
 	skyboxShader_.Bind();
 	skyboxShader_.SetMat4("view", Mat4f(view.ToMat3()));
 	skyboxShader_.SetMat4("projection", projection);
 	skyboxShader_.SetInt("skybox", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
+	gl::ActiveTexture(GL_TEXTURE0);
+	gl::BindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
 	skyboxCube_.Draw();
-	glDepthFunc(GL_LESS);
+	gl::DepthFunc(GL_LESS);
 }
 
 void HelloCubemapsProgram::OnEvent(const SDL_Event& event)
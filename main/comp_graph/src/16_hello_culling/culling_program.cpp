@@ -24,6 +24,7 @@
 
 #include "16_hello_culling/culling_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -95,8 +96,8 @@ void HelloCullingProgram::Render()
 	std::lock_guard<std::mutex> lock(updateMutex_);
 	if (flags_ & CULLING)
 	{
-		glEnable(GL_CULL_FACE);
-		glCullFace(flags_ & BACK_CULLING ? GL_BACK : GL_FRONT);
+		gl::Enable(GL_CULL_FACE);
+		gl::CullFace(flags_ & BACK_CULLING ? GL_BACK : GL_FRONT);
 		glFrontFace(flags_ & CCW ? GL_CCW : GL_CW);
 	}
 	modelShader_.Bind();
@@ -110,13 +111,13 @@ void HelloCullingProgram::Render()
 	model = Mat4f::Identity;
 	model = Transform3d::Translate(model, Vec3f::left * 2.0f);
 	modelShader_.SetMat4("model", model);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, cubeTexture_);
+	gl::ActiveTexture(GL_TEXTURE0);
+	gl::BindTexture(GL_TEXTURE_2D, cubeTexture_);
 	cube_.Draw();
 	
 	if(flags_ & CULLING)
 	{
-		glDisable(GL_CULL_FACE);
+		gl::Disable(GL_CULL_FACE);
 	}
 }
 
@@ -24,6 +24,7 @@
 
 #include "17_hello_frustum/frustum_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -77,14 +78,14 @@ void HelloFrustumProgram::Init()
 
     //Create Screen FBO
     glGenFramebuffers(1, &fbo_);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
     //Generate Color Buffer for FBO
     glGenTextures(1, &overViewTexture_);
-    glBindTexture(GL_TEXTURE_2D, overViewTexture_);
+    gl::BindTexture(GL_TEXTURE_2D, overViewTexture_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1024,1024, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl::BindTexture(GL_TEXTURE_2D, 0);
     //Bind the Color Buffer
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, overViewTexture_, 0);
 
@@ -99,7 +100,7 @@ void HelloFrustumProgram::Init()
     {
         logDebug("[Error] Framebuffer is not complete!");
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void HelloFrustumProgram::Update(seconds dt)
@@ -119,12 +120,20 @@ void HelloFrustumProgram::Update(seconds dt)
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Calculate Positions");
 #endif
-    asteroidCulledPositions_.clear();
-    
-    CalculateForce(0, asteroidNmb_);
-    CalculateVelocity(0, asteroidNmb_);
-    CalculatePositions(0, asteroidNmb_);
-    Culling(0, asteroidNmb_);
+    asteroidBounds_.Resize(asteroidNmb_);
+    engine->ParallelFor(0, asteroidNmb_, asteroidGrainSize_, [this](size_t begin, size_t end)
+    {
+        CalculateForce(begin, end);
+        CalculateVelocity(begin, end);
+        CalculatePositions(begin, end);
+        UpdateBounds(begin, end);
+    });
+    const auto& visibleIndices = asteroidCuller_.Cull(Frustum::FromCamera(camera_), asteroidBounds_);
+    asteroidCulledPositions_.resize(visibleIndices.size());
+    for (size_t i = 0; i < visibleIndices.size(); i++)
+    {
+        asteroidCulledPositions_[i] = asteroidPositions_[visibleIndices[i]];
+    }
 	
 #ifdef EASY_PROFILE_USE
     EASY_END_BLOCK;
@@ -139,8 +148,8 @@ void HelloFrustumProgram::Destroy()
     vertexInstancingDrawShader_.Destroy();
     screenShader_.Destroy();
     mainPlane_.Destroy();
-    glDeleteFramebuffers(1, &fbo_);
-    glDeleteTextures(1, &overViewTexture_);
+    gl::DeleteFramebuffers(1, &fbo_);
+    gl::DeleteTextures(1, &overViewTexture_);
     glDeleteRenderbuffers(1, &rbo_);
 }
 
@@ -173,15 +182,15 @@ void HelloFrustumProgram::Render()
     {
         const auto& asteroidMesh = model_.GetMesh(0);
 
-        glBindVertexArray(asteroidMesh.GetVao());
+        gl::BindVertexArray(asteroidMesh.GetVao());
         glGenBuffers(1, &instanceVBO_);
 
-        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+        gl::BindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
         glEnableVertexAttribArray(5);
         glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3f), (void*)0);
         glVertexAttribDivisor(5, 1);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        gl::BindBuffer(GL_ARRAY_BUFFER, 0);
+        gl::BindVertexArray(0);
 
     }
 
@@ -206,30 +215,30 @@ void HelloFrustumProgram::Render()
 #ifdef EASY_PROFILE_USE
                 EASY_BLOCK("Set VBO Model Matrices");
 #endif
-                glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+                gl::BindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
                 glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3f) * chunkSize, &asteroidCulledPositions_[chunkBeginIndex], GL_DYNAMIC_DRAW);
-                glBindBuffer(GL_ARRAY_BUFFER, 0);
+                gl::BindBuffer(GL_ARRAY_BUFFER, 0);
 #ifdef EASY_PROFILE_USE
                 EASY_END_BLOCK
                     EASY_BLOCK("Draw Mesh");
 
 #endif
-                glBindVertexArray(asteroidMesh.GetVao());
+                gl::BindVertexArray(asteroidMesh.GetVao());
                 glDrawElementsInstanced(GL_TRIANGLES, asteroidMesh.GetElementsCount(), GL_UNSIGNED_INT, 0,
                     chunkSize);
-                glBindVertexArray(0);
+                gl::BindVertexArray(0);
             }
         }
     };
 	//Draw overview on framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
     glViewport(0, 0, 1024, 1024);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     vertexInstancingDrawShader_.SetMat4("view", overCamera_.GenerateViewMatrix());
     vertexInstancingDrawShader_.SetMat4("projection", overCamera_.GenerateProjectionMatrix());
     drawAsteroids();
 	//Draw the true astroids view
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     const auto& config = BasicEngine::GetInstance()->config;
     glViewport(0, 0, config.windowSize.x, config.windowSize.y);
@@ -238,17 +247,17 @@ void HelloFrustumProgram::Render()
     drawAsteroids();
 	
 	//Draw the mini view on top left
-    glDisable(GL_DEPTH_TEST);
+    gl::Disable(GL_DEPTH_TEST);
     screenShader_.Bind();
     const float miniMapSize = 0.2f;
     screenShader_.SetVec2("offset", Vec2f((1.0f - miniMapSize/camera_.aspect) , 1.0f - miniMapSize));
     screenShader_.SetVec2("scale", Vec2f( miniMapSize/camera_.aspect, miniMapSize));
 
     screenShader_.SetInt("screenTexture", 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, overViewTexture_);
+    gl::ActiveTexture(GL_TEXTURE0);
+    gl::BindTexture(GL_TEXTURE_2D, overViewTexture_);
     mainPlane_.Draw();
-    glEnable(GL_DEPTH_TEST);
+    gl::Enable(GL_DEPTH_TEST);
 
 }
 
@@ -298,85 +307,14 @@ void HelloFrustumProgram::CalculatePositions(size_t begin, size_t end)
     }
 }
 
-void HelloFrustumProgram::Culling(size_t begin, size_t end)
+void HelloFrustumProgram::UpdateBounds(size_t begin, size_t end)
 {
-#ifdef EASY_PROFILE_USE
-    EASY_BLOCK("Culling");
-#endif
 	const auto asteroidRadius = model_.GetMesh(0).GenerateBoundingSphere().radius_;
-    const auto cameraDir = -camera_.reverseDir;
-    const auto cameraRight = camera_.rightDir;
-    const auto cameraUp = camera_.upDir;
-    const auto fovX = camera_.GetFovX();
-	
-    const auto rightQuaternion = Quaternion::AngleAxis(fovX / 2.0f, cameraUp);
-    const auto rightNormal = Vec3f(Transform3d::RotationMatrixFrom(rightQuaternion) * Vec4f(cameraRight));
-    const auto leftQuaternion = Quaternion::AngleAxis(-fovX / 2.0f, cameraUp);
-    const auto leftNormal = Vec3f(Transform3d::RotationMatrixFrom(leftQuaternion) * Vec4f(-cameraRight));
-    const auto topQuaternion = Quaternion::AngleAxis(camera_.fovY / 2.0f, cameraRight);
-    const auto topNormal = Vec3f(Transform3d::RotationMatrixFrom(topQuaternion) * Vec4f(-cameraUp));
-    const auto bottomQuaternion = Quaternion::AngleAxis(-camera_.fovY / 2.0f, cameraRight);
-    const auto bottomNormal = Vec3f(Transform3d::RotationMatrixFrom(bottomQuaternion) * Vec4f(cameraUp));
-    
-    for (size_t i = begin; i < end; i++)
+    const size_t endCount = std::min(end, asteroidNmb_);
+    for (auto i = begin; i < endCount; i++)
     {
-
-        const auto asteroidPos = asteroidPositions_[i];
-        //Near
-        {
-            const auto planePos = camera_.position + cameraDir * camera_.nearPlane;
-            const auto asterPos = asteroidPos - planePos;
-            const auto v = Vec3f::Dot(cameraDir, asterPos);
-        	if( v < -asteroidRadius)
-                continue;
-        }
-    	//Far
-        {
-            const auto planePos = camera_.position + cameraDir * camera_.farPlane;
-            const auto asterPos = asteroidPos - planePos;
-            const auto v = Vec3f::Dot(camera_.reverseDir, asterPos);
-            if (v < -asteroidRadius)
-                continue;
-        }
-        const auto asterPos = asteroidPos - camera_.position;
-    	//Right
-        {
-            const auto v = Vec3f::Dot(rightNormal, asterPos);
-        	if(v < -asteroidRadius)
-        	{
-                continue;
-        	}
-        }
-    	//Left
-        {
-            const auto v = Vec3f::Dot(leftNormal, asterPos);
-            if (v < -asteroidRadius)
-            {
-                continue;
-            }
-        }
-    	//Top
-        {
-
-            
-            const auto v = Vec3f::Dot(topNormal, asterPos);
-            if (v < -asteroidRadius)
-            {
-                continue;
-            }
-        }
-        //Bottom
-        {
-            const auto v = Vec3f::Dot(bottomNormal, asterPos);
-            if (v < -asteroidRadius)
-            {
-                continue;
-            }
-        }
-
-        asteroidCulledPositions_.push_back(asteroidPositions_[i]);
+        asteroidBounds_.Set(i, {asteroidPositions_[i], asteroidRadius});
     }
-	
 }
 }
 
@@ -24,6 +24,7 @@
 
 #include "18_hello_normal/normal_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -147,11 +148,11 @@ void HelloNormalProgram::Render()
 			if (flag != ENABLE_MODEL)
 			{
 				normalShader_.SetInt("material.texture_diffuse1", 0);
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, diffuseTex_);
+				gl::ActiveTexture(GL_TEXTURE0);
+				gl::BindTexture(GL_TEXTURE_2D, diffuseTex_);
 				normalShader_.SetInt("material.texture_normal1", 1);
-				glActiveTexture(GL_TEXTURE1);
-				glBindTexture(GL_TEXTURE_2D, normalTex_);
+				gl::ActiveTexture(GL_TEXTURE1);
+				gl::BindTexture(GL_TEXTURE_2D, normalTex_);
 			}
 		}
 		else
@@ -167,8 +168,8 @@ void HelloNormalProgram::Render()
 			if (flag != ENABLE_MODEL)
 			{
 				diffuseShader_.SetInt("material.texture_diffuse1", 0);
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, diffuseTex_);
+				gl::ActiveTexture(GL_TEXTURE0);
+				gl::BindTexture(GL_TEXTURE_2D, diffuseTex_);
 			}
 		}
 		switch (flag)
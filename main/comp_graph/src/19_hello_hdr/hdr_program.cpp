@@ -24,6 +24,7 @@
 
 #include "19_hello_hdr/hdr_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -68,8 +69,8 @@ void HelloHdrProgram::Destroy()
     cubeShader_.Destroy();
     cube_.Destroy();
 
-    glDeleteFramebuffers(1, &hdrFbo_);
-    glDeleteTextures(1, &hdrColorBuffer_);
+    gl::DeleteFramebuffers(1, &hdrFbo_);
+    gl::DeleteTextures(1, &hdrColorBuffer_);
     glDeleteRenderbuffers(1, &hdrRbo_);
 }
 
@@ -94,8 +95,8 @@ void HelloHdrProgram::Render()
     }
 	if(flags_ & RESIZE_FRAMEBUFFER)
 	{
-        glDeleteFramebuffers(1, &hdrFbo_);
-        glDeleteTextures(1, &hdrColorBuffer_);
+        gl::DeleteFramebuffers(1, &hdrFbo_);
+        gl::DeleteTextures(1, &hdrColorBuffer_);
         glDeleteRenderbuffers(1, &hdrRbo_);
         CreateFramebuffer();
         flags_ = flags_ & ~RESIZE_FRAMEBUFFER;
@@ -104,7 +105,7 @@ void HelloHdrProgram::Render()
 	
     std::lock_guard<std::mutex> lock(updateMutex_);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     cubeShader_.Bind();
@@ -113,8 +114,8 @@ void HelloHdrProgram::Render()
     cubeShader_.SetMat4("model", Mat4f::Identity);
     cubeShader_.SetMat4("transposeInverseModel", Mat4f::Identity);
     cubeShader_.SetInt("diffuseTexture", 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, cubeTexture_);
+    gl::ActiveTexture(GL_TEXTURE0);
+    gl::BindTexture(GL_TEXTURE_2D, cubeTexture_);
     for(size_t i = 0; i < lights_.size(); i++)
     {
         cubeShader_.SetVec3("lights["+std::to_string(i)+"].Position", lights_[i].lightPos_);
@@ -123,7 +124,7 @@ void HelloHdrProgram::Render()
     cubeShader_.SetInt("lightNmb", lights_.size());
     cubeShader_.SetBool("inverseNormals", true);
     cube_.Draw();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     hdrShader_.Bind();
     hdrShader_.SetTexture("hdrBuffer", hdrColorBuffer_);
@@ -151,24 +152,24 @@ void HelloHdrProgram::CreateFramebuffer()
     glGenFramebuffers(1, &hdrFbo_);
     // create floating point color buffer
     glGenTextures(1, &hdrColorBuffer_);
-    glBindTexture(GL_TEXTURE_2D, hdrColorBuffer_);
+    gl::BindTexture(GL_TEXTURE_2D, hdrColorBuffer_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl::BindTexture(GL_TEXTURE_2D, 0);
     // create depth buffer (renderbuffer)
     glGenRenderbuffers(1, &hdrRbo_);
     glBindRenderbuffer(GL_RENDERBUFFER, hdrRbo_);
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, config.windowSize.x, config.windowSize.y);
     // attach buffers
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, hdrColorBuffer_, 0);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, hdrRbo_);
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
     {
         logDebug("[Error] Framebuffer not complete!");
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     glCheckError();
 }
 }
@@ -24,6 +24,7 @@
 
 #include "20_hello_bloom/bloom_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -79,11 +80,11 @@ void HelloBloomProgram::Destroy()
 	cube_.Destroy();
     screenPlane_.Destroy();
 
-    glDeleteFramebuffers(1, &hdrFbo_);
-    glDeleteFramebuffers(2, &pingpongFbo_[0]);
+    gl::DeleteFramebuffers(1, &hdrFbo_);
+    gl::DeleteFramebuffers(2, &pingpongFbo_[0]);
 
-    glDeleteTextures(2, &colorBuffers_[0]);
-    glDeleteTextures(2, &pingpongColorBuffers_[0]);
+    gl::DeleteTextures(2, &colorBuffers_[0]);
+    gl::DeleteTextures(2, &pingpongColorBuffers_[0]);
 
     glDeleteRenderbuffers(1, &rbo_);
 }
@@ -110,11 +111,11 @@ void HelloBloomProgram::Render()
 	}
 	if(flags_ & RESIZE_FRAMEBUFFER)
 	{
-        glDeleteFramebuffers(1, &hdrFbo_);
-        glDeleteFramebuffers(2, &pingpongFbo_[0]);
+        gl::DeleteFramebuffers(1, &hdrFbo_);
+        gl::DeleteFramebuffers(2, &pingpongFbo_[0]);
 
-        glDeleteTextures(2, &colorBuffers_[0]);
-        glDeleteTextures(2, &pingpongColorBuffers_[0]);
+        gl::DeleteTextures(2, &colorBuffers_[0]);
+        gl::DeleteTextures(2, &pingpongColorBuffers_[0]);
 
         glDeleteRenderbuffers(1, &rbo_);
         CreateFramebuffer();
@@ -123,7 +124,7 @@ void HelloBloomProgram::Render()
     const auto view = camera_.GenerateViewMatrix();
     const auto projection = camera_.GenerateProjectionMatrix();
 	//1. hdr pass
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     cubeShader_.Bind();
     cubeShader_.SetMat4("view", view);
@@ -160,7 +161,7 @@ void HelloBloomProgram::Render()
         lightShader_.SetVec3("lightColor", light.color_);
         cube_.Draw();
 	}
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     // 2. blur bright fragments with two-pass Gaussian Blur 
     // --------------------------------------------------
     //
@@ -171,17 +172,17 @@ void HelloBloomProgram::Render()
         blurShader_.SetInt("image", 0);
         for (int i = 0; i < blurAmount_; i++)
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, pingpongFbo_[horizontal]);
+            gl::BindFramebuffer(GL_FRAMEBUFFER, pingpongFbo_[horizontal]);
             blurShader_.SetInt("horizontal", horizontal);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, firstIteration ? colorBuffers_[1] : pingpongColorBuffers_[!horizontal]);  // bind texture of other framebuffer (or scene if first iteration)
+            gl::ActiveTexture(GL_TEXTURE0);
+            gl::BindTexture(GL_TEXTURE_2D, firstIteration ? colorBuffers_[1] : pingpongColorBuffers_[!horizontal]);  // bind texture of other framebuffer (or scene if first iteration)
             screenPlane_.Draw();
             horizontal = !horizontal;
             if (firstIteration)
                 firstIteration = false;
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     }
     // 3. now render floating point color buffer to 2D quad and tonemap HDR colors to default framebuffer's (clamped) color range
     // --------------------------------------------------------------------------------------------------------------------------
@@ -200,19 +201,19 @@ void HelloBloomProgram::CreateFramebuffer()
     // ---------------------------------------
 
     glGenFramebuffers(1, &hdrFbo_);
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, hdrFbo_);
     // create 2 floating point color buffers (1 for normal rendering, other for brightness treshold values)
 
     glGenTextures(2, colorBuffers_);
     for (unsigned int i = 0; i < 2; i++)
     {
-        glBindTexture(GL_TEXTURE_2D, colorBuffers_[i]);
+        gl::BindTexture(GL_TEXTURE_2D, colorBuffers_[i]);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);  // we clamp to the edge as the blur filter would otherwise sample repeated texture values!
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        gl::BindTexture(GL_TEXTURE_2D, 0);
         // attach texture to framebuffer
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, colorBuffers_[i], 0);
     }
@@ -234,8 +235,8 @@ void HelloBloomProgram::CreateFramebuffer()
     glGenTextures(2, &pingpongColorBuffers_[0]);
     for (unsigned int i = 0; i < 2; i++)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingpongFbo_[i]);
-        glBindTexture(GL_TEXTURE_2D, pingpongColorBuffers_[i]);
+        gl::BindFramebuffer(GL_FRAMEBUFFER, pingpongFbo_[i]);
+        gl::BindTexture(GL_TEXTURE_2D, pingpongColorBuffers_[i]);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
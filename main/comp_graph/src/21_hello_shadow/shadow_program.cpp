@@ -24,6 +24,7 @@
 
 #include "21_hello_shadow/shadow_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -43,7 +44,7 @@ void HelloShadowProgram::Init()
 
 	glGenFramebuffers(1, &depthMapFbo_);
 	glGenTextures(1, &depthMap_);
-	glBindTexture(GL_TEXTURE_2D, depthMap_);
+	gl::BindTexture(GL_TEXTURE_2D, depthMap_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16,
 		SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -54,8 +55,8 @@ void HelloShadowProgram::Init()
 		GL_COMPARE_REF_TO_TEXTURE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC,
 		GL_LEQUAL);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glBindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
+	gl::BindTexture(GL_TEXTURE_2D, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap_, 0);
     GLenum drawBuffers =  GL_NONE ;
     glDrawBuffers(1, &drawBuffers);
@@ -63,7 +64,7 @@ void HelloShadowProgram::Init()
 
 	glCheckFramebuffer();
 	glCheckError();
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	depthCamera_.SetExtends(Vec2f::one * 4.0f);
 	depthCamera_.position = light_.lightPos;
 	depthCamera_.WorldLookAt(light_.lightPos+light_.lightDir);
@@ -98,9 +99,9 @@ void HelloShadowProgram::Destroy()
 
 	textureManager_.Destroy();
 	
-	glDeleteFramebuffers(1, &depthMapFbo_);
-	glDeleteTextures(1, &depthMap_);
-	glDisable(GL_CULL_FACE);
+	gl::DeleteFramebuffers(1, &depthMapFbo_);
+	gl::DeleteTextures(1, &depthMap_);
+	gl::Disable(GL_CULL_FACE);
 	
 }
 
@@ -160,8 +161,8 @@ void HelloShadowProgram::Render()
 	}
 	std::lock_guard<std::mutex> lock(updateMutex_);
 	glCheckError();
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
+	gl::Enable(GL_CULL_FACE);
+	gl::CullFace(GL_BACK);
 	const auto& config = BasicEngine::GetInstance()->config;
 	const auto lightView = depthCamera_.GenerateViewMatrix();
 	const auto lightProjection = depthCamera_.GenerateProjectionMatrix();
@@ -170,22 +171,22 @@ void HelloShadowProgram::Render()
 	{
 		//Render depth buffer from light
 		glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-		glBindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
+		gl::BindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
 		glClear(GL_DEPTH_BUFFER_BIT);
 		simpleDepthShader_.Bind();
 
 		simpleDepthShader_.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
 		if(flags_ & ENABLE_PETER_PANNING)
 		{
-			glCullFace(GL_FRONT);
+			gl::CullFace(GL_FRONT);
 		}
 		RenderScene(simpleDepthShader_);
 		if(flags_ & ENABLE_PETER_PANNING)
 		{
-			glCullFace(GL_BACK);
+			gl::CullFace(GL_BACK);
 		}
 		//Render scene with shadow
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 		glCheckError();
 		glViewport(0, 0, config.windowSize.x, config.windowSize.y);
 	}
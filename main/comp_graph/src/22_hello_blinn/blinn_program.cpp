@@ -24,6 +24,7 @@
 
 #include "22_hello_blinn/blinn_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -122,8 +123,8 @@ void HelloBlinnProgram::Render()
 	shader.SetFloat("material.resolution", floorResolution_);
 
 	shader.SetFloat("material.shininess", static_cast<float>(specularPow_));
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, floorTexture_);
+	gl::ActiveTexture(GL_TEXTURE0);
+	gl::BindTexture(GL_TEXTURE_2D, floorTexture_);
 	floor_.Draw();
 }
 
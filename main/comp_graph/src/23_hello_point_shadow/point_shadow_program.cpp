@@ -23,6 +23,7 @@
  */
 #include "23_hello_point_shadow/point_shadow_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -48,7 +49,7 @@ void HelloPointShadowProgram::Init()
 	glGenFramebuffers(1, &depthMapFbo_);
 	// create depth cubemap texture
 	glGenTextures(1, &depthCubemap_);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, depthCubemap_);
+	gl::BindTexture(GL_TEXTURE_CUBE_MAP, depthCubemap_);
 	for (unsigned int i = 0; i < 6; ++i)
 	{
 		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT16, 
@@ -59,16 +60,16 @@ void HelloPointShadowProgram::Init()
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	gl::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 	// attach depth texture as FBO's depth buffer
-	glBindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
 	GLenum drawBuffers[] = { GL_NONE };
 	glDrawBuffers(1, drawBuffers);
 	glReadBuffer(GL_NONE);
 	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X, depthCubemap_, 0);
 
 	glCheckFramebuffer();
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
 	camera3D_.position = Vec3f::one * 3.0f;
 	camera3D_.WorldLookAt(Vec3f::zero);
@@ -94,8 +95,8 @@ void HelloPointShadowProgram::Update(seconds dt)
 
 void HelloPointShadowProgram::Destroy()
 {
-	glDeleteFramebuffers(1, &depthMapFbo_);
-	glDeleteTextures(1, &depthCubemap_);
+	gl::DeleteFramebuffers(1, &depthMapFbo_);
+	gl::DeleteTextures(1, &depthCubemap_);
 
 	cube_.Destroy();
 	lightCubeShader_.Destroy();
@@ -120,7 +121,7 @@ void HelloPointShadowProgram::Render()
 		return;
 	}
 	std::lock_guard<std::mutex> lock(updateMutex_);
-	glBindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, depthMapFbo_);
 
 	const Vec3f lightDirs[6] =
 	{
@@ -156,7 +157,7 @@ void HelloPointShadowProgram::Render()
 		simpleDepthShader_.SetVec3("lightDir", lightDirs[i]);
 		RenderScene(simpleDepthShader_);
 	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	const auto& config = BasicEngine::GetInstance()->config;
 	glViewport(0, 0, config.windowSize.x, config.windowSize.y);
 	cubeShader_.Bind();
@@ -172,10 +173,10 @@ void HelloPointShadowProgram::Render()
 	//Render the scene with shadow
 	cubeShader_.SetTexture("material.texture_diffuse1", cubeTexture_, 0);
 	cubeShader_.SetInt("shadowMap", 1);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, depthCubemap_);
+	gl::ActiveTexture(GL_TEXTURE1);
+	gl::BindTexture(GL_TEXTURE_CUBE_MAP, depthCubemap_);
 	RenderScene(cubeShader_);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	gl::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 	//Render the white light cube
 	lightCubeShader_.Bind();
 	lightCubeShader_.SetVec3("lightColor", Vec3f::one);
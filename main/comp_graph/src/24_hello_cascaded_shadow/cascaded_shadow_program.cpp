@@ -25,6 +25,7 @@
 #include "24_hello_cascaded_shadow/cascaded_shadow_program.h"
 #include "imgui.h"
 #include "mathematics/aabb.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -43,7 +44,7 @@ void HelloCascadedShadowProgram::Init()
 
     for (auto shadowMap : shadowMaps_)
     {
-        glBindTexture(GL_TEXTURE_2D, shadowMap);
+        gl::BindTexture(GL_TEXTURE_2D, shadowMap);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16,
                      SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -53,7 +54,7 @@ void HelloCascadedShadowProgram::Init()
 
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMaps_[0], 0);
 
     // Disable writes to the color buffer
@@ -63,7 +64,7 @@ void HelloCascadedShadowProgram::Init()
 
     glCheckFramebuffer();
     glCheckError();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     simpleDepthShader_.LoadFromFile(
             config.dataRootPath + "shaders/24_hello_cascaded_shadow/simple_depth.vert",
@@ -77,7 +78,7 @@ void HelloCascadedShadowProgram::Init()
 
     dragonModel_.LoadModel(config.dataRootPath + "model/dragon/dragon.obj");
     glGenTextures(1, &whiteTexture_);
-    glBindTexture(GL_TEXTURE_2D, whiteTexture_);
+    gl::BindTexture(GL_TEXTURE_2D, whiteTexture_);
     unsigned char white[] = {255, 255, 255};
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -103,8 +104,8 @@ void HelloCascadedShadowProgram::Destroy()
 {
     simpleDepthShader_.Destroy();
     shadowShader_.Destroy();
-    glDeleteFramebuffers(1, &fbo_);
-    glDeleteTextures(shadowMaps_.size(), &shadowMaps_[0]);
+    gl::DeleteFramebuffers(1, &fbo_);
+    gl::DeleteTextures(shadowMaps_.size(), &shadowMaps_[0]);
     dragonModel_.Destroy();
     plane_.Destroy();
     textureManager_.Destroy();
@@ -148,7 +149,7 @@ void HelloCascadedShadowProgram::Render()
     glCheckError();
     //Cascade Shadow Pass
     glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, fbo_);
     simpleDepthShader_.Bind();
     for (int i = 0; i < 3; i++)
     {
@@ -157,7 +158,7 @@ void HelloCascadedShadowProgram::Render()
     //Render scene from camera
     const auto& config = BasicEngine::GetInstance()->config;
     glViewport(0, 0, config.windowSize.x, config.windowSize.y);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     shadowShader_.Bind();
 
     shadowShader_.SetMat4("view", camera_.GenerateViewMatrix());
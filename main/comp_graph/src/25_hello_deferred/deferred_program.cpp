@@ -23,6 +23,7 @@
  */
 #include "25_hello_deferred/deferred_progam.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -54,7 +55,7 @@ void HelloDeferredProgram::Init()
     );
 
     glGenTextures(1, &whiteTexture_);
-    glBindTexture(GL_TEXTURE_2D, whiteTexture_);
+    gl::BindTexture(GL_TEXTURE_2D, whiteTexture_);
     unsigned char white[] = {255, 255, 255};
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -96,17 +97,17 @@ void HelloDeferredProgram::Update(seconds dt)
 
 void HelloDeferredProgram::Destroy()
 {
-    glDeleteFramebuffers(1, &gBuffer_);
-    glDeleteTextures(1, &gPosition_);
-    glDeleteTextures(1, &gNormal_);
-    glDeleteTextures(1, &gAlbedoSpec_);
+    gl::DeleteFramebuffers(1, &gBuffer_);
+    gl::DeleteTextures(1, &gPosition_);
+    gl::DeleteTextures(1, &gNormal_);
+    gl::DeleteTextures(1, &gAlbedoSpec_);
     floor_.Destroy();
     screenQuad_.Destroy();
     model_.Destroy();
     cube_.Destroy();
-    glDeleteBuffers(1, &rbo_);
+    gl::DeleteBuffers(1, &rbo_);
 
-    glDeleteTextures(1, &whiteTexture_);
+    gl::DeleteTextures(1, &whiteTexture_);
 
     textureManager_.Destroy();
 }
@@ -146,12 +147,12 @@ void HelloDeferredProgram::Render()
     glCheckError();
     if(flags_ & RESIZE_SCREEN)
     {
-        glDeleteFramebuffers(1, &gBuffer_);
-        glDeleteTextures(1, &gPosition_);
-        glDeleteTextures(1, &gNormal_);
-        glDeleteTextures(1, &gAlbedoSpec_);
+        gl::DeleteFramebuffers(1, &gBuffer_);
+        gl::DeleteTextures(1, &gPosition_);
+        gl::DeleteTextures(1, &gNormal_);
+        gl::DeleteTextures(1, &gAlbedoSpec_);
 
-        glDeleteBuffers(1, &rbo_);
+        gl::DeleteBuffers(1, &rbo_);
         CreateFramebuffer();
         flags_ = flags_ & ~RESIZE_SCREEN;
     }
@@ -178,14 +179,14 @@ void HelloDeferredProgram::Render()
         EASY_BLOCK("Deferred Rendering");
 #endif
         //G-Buffer pass
-        glBindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
+        gl::BindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         deferredShader_.Bind();
         deferredShader_.SetMat4("view", camera_.GenerateViewMatrix());
         deferredShader_.SetMat4("projection", camera_.GenerateProjectionMatrix());
 
         RenderScene(deferredShader_);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
         lightingShader_.Bind();
         for(int i = 0; i < 32; i++)
         {
@@ -218,11 +219,11 @@ void HelloDeferredProgram::CreateFramebuffer()
     const auto& config = BasicEngine::GetInstance()->config;
     glCheckError();
     glGenFramebuffers(1, &gBuffer_);
-    glBindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
 
 // - position color buffer
     glGenTextures(1, &gPosition_);
-    glBindTexture(GL_TEXTURE_2D, gPosition_);
+    gl::BindTexture(GL_TEXTURE_2D, gPosition_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -230,7 +231,7 @@ void HelloDeferredProgram::CreateFramebuffer()
 
 // - normal color buffer
     glGenTextures(1, &gNormal_);
-    glBindTexture(GL_TEXTURE_2D, gNormal_);
+    gl::BindTexture(GL_TEXTURE_2D, gNormal_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -238,7 +239,7 @@ void HelloDeferredProgram::CreateFramebuffer()
 
 // - color + specular color buffer
     glGenTextures(1, &gAlbedoSpec_);
-    glBindTexture(GL_TEXTURE_2D, gAlbedoSpec_);
+    gl::BindTexture(GL_TEXTURE_2D, gAlbedoSpec_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -258,7 +259,7 @@ void HelloDeferredProgram::CreateFramebuffer()
     glCheckFramebuffer();
 
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     glCheckError();
 }
 
@@ -24,6 +24,8 @@
 
 #include "26_hello_ssao/ssao_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
+
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
 #endif
@@ -39,7 +41,7 @@ void HelloSsaoProgram::Init()
     CreateFramebuffer();
 	//Crate white texture
     glGenTextures(1, &whiteTexture_);
-    glBindTexture(GL_TEXTURE_2D, whiteTexture_);
+    gl::BindTexture(GL_TEXTURE_2D, whiteTexture_);
     unsigned char white[] = { 255, 255, 255 };
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -86,7 +88,7 @@ void HelloSsaoProgram::Init()
         noise = noiseValue;
 	}
     glGenTextures(1, &noiseTexture_);
-    glBindTexture(GL_TEXTURE_2D, noiseTexture_);
+    gl::BindTexture(GL_TEXTURE_2D, noiseTexture_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, 4, 4, 0, GL_RGB, GL_FLOAT, &ssaoNoise[0]);
     glCheckError();
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -112,8 +114,8 @@ void HelloSsaoProgram::Update(seconds dt)
 void HelloSsaoProgram::Destroy()
 {
     DestroyFramebuffer();
-    glDeleteTextures(1, &whiteTexture_);
-    glDeleteTextures(1, &noiseTexture_);
+    gl::DeleteTextures(1, &whiteTexture_);
+    gl::DeleteTextures(1, &noiseTexture_);
     ssaoBlurShader_.Destroy();
     ssaoGeometryShader_.Destroy();
     ssaoShader_.Destroy();
@@ -160,7 +162,7 @@ void HelloSsaoProgram::Render()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Geometry Pass");
 #endif
-    glBindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     ssaoGeometryShader_.Bind();
     
@@ -173,7 +175,7 @@ void HelloSsaoProgram::Render()
     EASY_END_BLOCK;
     EASY_BLOCK("Generate SSAO Texture");
 #endif
-    glBindFramebuffer(GL_FRAMEBUFFER, ssaoFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, ssaoFbo_);
     glClear(GL_COLOR_BUFFER_BIT);
     ssaoShader_.Bind();
 	for(unsigned int i = 0; i < 64; i++)
@@ -195,13 +197,13 @@ void HelloSsaoProgram::Render()
     EASY_END_BLOCK;
     EASY_BLOCK("Blur SSAO Texture");
 #endif
-    glBindFramebuffer(GL_FRAMEBUFFER, ssaoBlurFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, ssaoBlurFbo_);
     glClear(GL_COLOR_BUFFER_BIT);
     ssaoBlurShader_.Bind();
     ssaoBlurShader_.SetTexture("ssaoInput", ssaoColorBuffer_, 0);
     screenPlane_.Draw();
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     // 4. lighting pass: traditional deferred Blinn-Phong lighting with added screen-space ambient occlusion
 #ifdef EASY_PROFILE_USE
     EASY_END_BLOCK;
@@ -240,16 +242,16 @@ void HelloSsaoProgram::OnEvent(const SDL_Event& event)
 
 void HelloSsaoProgram::DestroyFramebuffer()
 {
-    glDeleteFramebuffers(1, &gBuffer_);
-    glDeleteTextures(1, &gPosition_);
-    glDeleteTextures(1, &gNormal_);
-    glDeleteTextures(1, &gAlbedoSpec_);
+    gl::DeleteFramebuffers(1, &gBuffer_);
+    gl::DeleteTextures(1, &gPosition_);
+    gl::DeleteTextures(1, &gNormal_);
+    gl::DeleteTextures(1, &gAlbedoSpec_);
     glDeleteRenderbuffers(1, &rbo_);
 
-    glDeleteFramebuffers(1, &ssaoFbo_);
-    glDeleteFramebuffers(1, &ssaoBlurFbo_);
-    glDeleteTextures(1, &ssaoColorBuffer_);
-    glDeleteTextures(1, &ssaoColorBufferBlur_);
+    gl::DeleteFramebuffers(1, &ssaoFbo_);
+    gl::DeleteFramebuffers(1, &ssaoBlurFbo_);
+    gl::DeleteTextures(1, &ssaoColorBuffer_);
+    gl::DeleteTextures(1, &ssaoColorBufferBlur_);
 
 }
 
@@ -258,11 +260,11 @@ void HelloSsaoProgram::CreateFramebuffer()
     const auto& config = BasicEngine::GetInstance()->config;
     glCheckError();
     glGenFramebuffers(1, &gBuffer_);
-    glBindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, gBuffer_);
 
     // - position color buffer
     glGenTextures(1, &gPosition_);
-    glBindTexture(GL_TEXTURE_2D, gPosition_);
+    gl::BindTexture(GL_TEXTURE_2D, gPosition_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -270,7 +272,7 @@ void HelloSsaoProgram::CreateFramebuffer()
     glCheckError();
     // - normal color buffer
     glGenTextures(1, &gNormal_);
-    glBindTexture(GL_TEXTURE_2D, gNormal_);
+    gl::BindTexture(GL_TEXTURE_2D, gNormal_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -278,7 +280,7 @@ void HelloSsaoProgram::CreateFramebuffer()
     glCheckError();
     // - color + specular color buffer
     glGenTextures(1, &gAlbedoSpec_);
-    glBindTexture(GL_TEXTURE_2D, gAlbedoSpec_);
+    gl::BindTexture(GL_TEXTURE_2D, gAlbedoSpec_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, config.windowSize.x, config.windowSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -298,16 +300,16 @@ void HelloSsaoProgram::CreateFramebuffer()
     glCheckFramebuffer();
     glCheckError();
 	
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     // also create framebuffer to hold SSAO processing stage 
 	// -----------------------------------------------------
 
     glGenFramebuffers(1, &ssaoFbo_);  glGenFramebuffers(1, &ssaoBlurFbo_);
-    glBindFramebuffer(GL_FRAMEBUFFER, ssaoFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, ssaoFbo_);
 
     // SSAO color buffer
     glGenTextures(1, &ssaoColorBuffer_);
-    glBindTexture(GL_TEXTURE_2D, ssaoColorBuffer_);
+    gl::BindTexture(GL_TEXTURE_2D, ssaoColorBuffer_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, config.windowSize.x, config.windowSize.y, 0, GL_RED, GL_FLOAT, NULL);
     glCheckError();
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -318,9 +320,9 @@ void HelloSsaoProgram::CreateFramebuffer()
     glCheckFramebuffer();
     glCheckError();
     // and blur stage
-    glBindFramebuffer(GL_FRAMEBUFFER, ssaoBlurFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, ssaoBlurFbo_);
     glGenTextures(1, &ssaoColorBufferBlur_);
-    glBindTexture(GL_TEXTURE_2D, ssaoColorBufferBlur_);
+    gl::BindTexture(GL_TEXTURE_2D, ssaoColorBufferBlur_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, config.windowSize.x, config.windowSize.y, 0, GL_RED, GL_FLOAT, NULL);
     glCheckError();
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -330,7 +332,7 @@ void HelloSsaoProgram::CreateFramebuffer()
     glCheckFramebuffer();
     glCheckError();
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
     glCheckError();
 }
 
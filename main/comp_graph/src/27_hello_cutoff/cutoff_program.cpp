@@ -24,6 +24,7 @@
 
 #include "27_hello_cutoff/cutoff_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -46,7 +47,7 @@ namespace neko
 		cube_.Init();
 
 		glGenTextures(1, &whiteTexture_);
-		glBindTexture(GL_TEXTURE_2D, whiteTexture_);
+		gl::BindTexture(GL_TEXTURE_2D, whiteTexture_);
 		unsigned char white[] = { 255, 255, 255 };
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
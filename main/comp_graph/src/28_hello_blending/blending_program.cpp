@@ -24,6 +24,7 @@
 
 #include "28_hello_blending/blending_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -42,7 +43,7 @@ void HelloBlendingProgram::Init()
 	cube_.Init();
 
 	glGenTextures(1, &whiteTexture_);
-	glBindTexture(GL_TEXTURE_2D, whiteTexture_);
+	gl::BindTexture(GL_TEXTURE_2D, whiteTexture_);
 	unsigned char white[] = { 255, 255, 255 };
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -103,8 +104,8 @@ void HelloBlendingProgram::Render()
 	std::lock_guard<std::mutex> lock(updateMutex_);
 	if(flags_ & ENABLE_BLENDING)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		gl::Enable(GL_BLEND);
+		gl::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	}
 	cutoffShader_.Bind();
 	cutoffShader_.SetMat4("view", camera_.GenerateViewMatrix());
@@ -171,7 +172,7 @@ void HelloBlendingProgram::Render()
 	}
 	if(flags_ & ENABLE_BLENDING)
 	{
-		glDisable(GL_BLEND);
+		gl::Disable(GL_BLEND);
 	}
 
 }
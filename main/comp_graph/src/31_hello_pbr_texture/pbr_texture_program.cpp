@@ -23,6 +23,7 @@
  */
 
 #include "31_hello_pbr_texture/pbr_texture_program.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -47,7 +48,7 @@ void HelloPbrTextureProgram::Init()
 	};
 	//Create white texture
 	glGenTextures(1, &ao_);
-	glBindTexture(GL_TEXTURE_2D, ao_);
+	gl::BindTexture(GL_TEXTURE_2D, ao_);
 	unsigned char white[] = { 255, 255, 255 };
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -24,6 +24,8 @@
 
 #include "32_hello_ibl/ibl_program.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
+
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
 #endif
@@ -106,13 +108,13 @@ void HelloIblProgram::Destroy()
 	pbrShader_.Destroy();
 	brdfShader_.Destroy();
 
-	glDeleteFramebuffers(1, &captureFbo_);
+	gl::DeleteFramebuffers(1, &captureFbo_);
 	glDeleteRenderbuffers(1, &captureRbo_);
 
-	glDeleteTextures(1, &envCubemap_);
-	glDeleteTextures(1, &irradianceMap_);
-	glDeleteTextures(1, &prefilterMap_);
-	glDeleteTextures(1, &brdfLUTTexture_);
+	gl::DeleteTextures(1, &envCubemap_);
+	gl::DeleteTextures(1, &irradianceMap_);
+	gl::DeleteTextures(1, &prefilterMap_);
+	gl::DeleteTextures(1, &brdfLUTTexture_);
 }
 
 void HelloIblProgram::DrawImGui()
@@ -163,12 +165,12 @@ void HelloIblProgram::Render()
 #ifdef EASY_PROFILE_USE
 		EASY_BLOCK("Generate IBL textures");
 #endif
-		glDepthFunc(GL_LEQUAL);
+		gl::DepthFunc(GL_LEQUAL);
 		GenerateCubemap();
 		GenerateDiffuseIrradiance();
 		GeneratePrefilter();
 		GenerateLUT();
-		glDepthFunc(GL_LESS);
+		gl::DepthFunc(GL_LESS);
 		const auto& config = BasicEngine::GetInstance()->config;
 		glViewport(0, 0, config.windowSize.x, config.windowSize.y);
 		flags_ = flags_ & ~FIRST_FRAME;
@@ -222,14 +224,14 @@ void HelloIblProgram::Render()
 		}
 	}
 	//Render skybox
-	glDepthFunc(GL_LEQUAL);
+	gl::DepthFunc(GL_LEQUAL);
 	skyboxShader_.Bind();
 	skyboxShader_.SetMat4("view", view);
 	skyboxShader_.SetMat4("projection", projection);
 	skyboxShader_.SetCubemap("environmentMap", 
 		flags_ & SHOW_PREFILTER? prefilterMap_ : (flags_ & SHOW_IRRADIANCE ? irradianceMap_ : envCubemap_), 0);
 	skybox_.Draw();
-	glDepthFunc(GL_LESS);
+	gl::DepthFunc(GL_LESS);
 	glCheckError();
 }
 
@@ -244,9 +246,9 @@ void HelloIblProgram::GenerateCubemap()
 	EASY_BLOCK("Generate Cubemap");
 #endif
 	logDebug("Generate Cubemap");
-    glBindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
     glGenTextures(1, &envCubemap_);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap_);
+    gl::BindTexture(GL_TEXTURE_CUBE_MAP, envCubemap_);
     for (unsigned int i = 0; i < 6; ++i)
     {
         glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 1024, 1024, 0, GL_RGB, GL_FLOAT, nullptr);
@@ -256,7 +258,7 @@ void HelloIblProgram::GenerateCubemap()
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    gl::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     glCheckError();
 
 	glBindRenderbuffer(GL_RENDERBUFFER, captureRbo_);
@@ -277,7 +279,7 @@ void HelloIblProgram::GenerateCubemap()
 	equiToCubemap_.SetTexture("equirectangularMap", hdrTexture_, 0);
 	equiToCubemap_.SetMat4("projection", captureCamera.GenerateProjectionMatrix());
 	glViewport(0, 0, 1024,1024);
-	glBindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
 	for (unsigned int i = 0; i < 6; ++i)
 	{
 		captureCamera.WorldLookAt(viewDirs[i], upDirs[i]);
@@ -291,7 +293,7 @@ void HelloIblProgram::GenerateCubemap()
 	}
 
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void HelloIblProgram::GenerateDiffuseIrradiance()
@@ -301,9 +303,9 @@ void HelloIblProgram::GenerateDiffuseIrradiance()
 #endif
 	logDebug("Generate DIffuse Irradiance");
 
-    glBindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
     glGenTextures(1, &irradianceMap_);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap_);
+    gl::BindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap_);
     for (unsigned int i = 0; i < 6; ++i)
     {
         glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
@@ -313,7 +315,7 @@ void HelloIblProgram::GenerateDiffuseIrradiance()
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    gl::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     glCheckError();
 	glBindRenderbuffer(GL_RENDERBUFFER, captureRbo_);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X, irradianceMap_, 0);
@@ -334,7 +336,7 @@ void HelloIblProgram::GenerateDiffuseIrradiance()
 	irradianceShader_.SetCubemap("environmentMap", envCubemap_, 0);
 
 	glViewport(0, 0, 32, 32);
-	glBindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
 	for(int i = 0; i < 6; i++)
 	{
 		captureCamera.WorldLookAt(viewDirs[i], upDirs[i]);
@@ -345,7 +347,7 @@ void HelloIblProgram::GenerateDiffuseIrradiance()
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		skybox_.Draw();
 	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	glCheckError();
 	
 }
@@ -363,9 +365,9 @@ void HelloIblProgram::GeneratePrefilter()
 	captureCamera.nearPlane = 0.1f;
 	captureCamera.farPlane = 10.0f;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
+    gl::BindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
 	glGenTextures(1, &prefilterMap_);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, prefilterMap_);
+	gl::BindTexture(GL_TEXTURE_CUBE_MAP, prefilterMap_);
 	for (unsigned int i = 0; i < 6; ++i)
 	{
 		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
@@ -378,7 +380,7 @@ void HelloIblProgram::GeneratePrefilter()
 	glCheckError();
 	// generate mipmaps for the cubemap so OpenGL automatically allocates the required memory.
 	glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	gl::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 	glCheckError();
 	prefilterShader_.Bind();
 	prefilterShader_.SetCubemap("environmentMap",envCubemap_, 0);
@@ -413,7 +415,7 @@ void HelloIblProgram::GeneratePrefilter()
 		}
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
 	glCheckError();
 }
@@ -428,7 +430,7 @@ void HelloIblProgram::GenerateLUT()
 	glGenTextures(1, &brdfLUTTexture_);
 
 	// pre-allocate enough memory for the LUT texture.
-	glBindTexture(GL_TEXTURE_2D, brdfLUTTexture_);
+	gl::BindTexture(GL_TEXTURE_2D, brdfLUTTexture_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, 512, 512, 0, GL_RG, GL_FLOAT, 0);
 	// be sure to set wrapping mode to GL_CLAMP_TO_EDGE
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -437,7 +439,7 @@ void HelloIblProgram::GenerateLUT()
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 	// then re-configure capture framebuffer object and render screen-space quad with BRDF shader.
-	glBindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, captureFbo_);
 	glBindRenderbuffer(GL_RENDERBUFFER, captureRbo_);
 	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, 512, 512);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, brdfLUTTexture_, 0);
@@ -447,7 +449,7 @@ void HelloIblProgram::GenerateLUT()
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	quad_.Draw();
 	glCheckFramebuffer();
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	glCheckError();
 }
 }
@@ -0,0 +1,148 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "92_hello_model_batch/model_batch_program.h"
+
+#include <random>
+
+#include "engine/engine.h"
+#include "imgui.h"
+#include "mathematics/transform.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+HelloModelBatchProgram::HelloModelBatchProgram() :
+	transformManager_(entityManager_),
+	batchRenderer_(entityManager_, transformManager_),
+	modelRendererManager_(entityManager_, batchRenderer_)
+{
+}
+
+void HelloModelBatchProgram::Init()
+{
+	const auto& config = BasicEngine::GetInstance()->config;
+	transformManager_.Init();
+	batchRenderer_.Init();
+	model_.LoadModel(config.dataRootPath + "model/rock/rock.obj");
+	shader_.LoadFromFile(config.dataRootPath + "shaders/engine/instanced.vert",
+	                     config.dataRootPath + "shaders/engine/instanced.frag");
+
+	camera_.position = Vec3f(0.0f, 500.0f, -500.0f);
+	camera_.farPlane = 1'000.0f;
+	camera_.WorldLookAt(Vec3f::zero);
+}
+
+void HelloModelBatchProgram::Update(seconds dt)
+{
+	std::lock_guard<std::mutex> lock(updateMutex_);
+	frameTime_ = frameTime_ + (dt.count() - frameTime_) * 0.05f;
+	ResizeRocks(std::size_t(rocksNmb_));
+#ifdef EASY_PROFILE_USE
+	EASY_BLOCK("Move Rocks");
+#endif
+	//The inner rocks orbit faster
+	for (Entity entity = 0; entity < angles_.size(); entity++)
+	{
+		angles_[entity] += degree_t(1'000.0f / radiuses_[entity] * dt.count());
+		const auto rotation = Transform3d::RotationMatrixFrom(angles_[entity], Vec3f::up);
+		const Vec3f position = Vec3f(rotation * Vec4f(Vec3f::forward)) * radiuses_[entity];
+		transformManager_.SetPosition(entity, Vec3f(position.x, heights_[entity], position.z));
+	}
+#ifdef EASY_PROFILE_USE
+	EASY_END_BLOCK;
+#endif
+	transformManager_.Update();
+	//Puts the rocks in their batch once the model is loaded
+	modelRendererManager_.Update();
+
+	const auto& config = BasicEngine::GetInstance()->config;
+	camera_.SetAspect(config.windowSize.x, config.windowSize.y);
+	camera_.Update(dt);
+}
+
+void HelloModelBatchProgram::ResizeRocks(std::size_t rocksNmb)
+{
+	while (angles_.size() > rocksNmb)
+	{
+		entityManager_.DestroyEntity(Entity(angles_.size() - 1));
+		angles_.pop_back();
+		radiuses_.pop_back();
+		heights_.pop_back();
+	}
+	std::mt19937 generator(std::uint32_t(angles_.size()));
+	std::uniform_real_distribution<float> radiusDistribution(100.0f, 300.0f);
+	std::uniform_real_distribution<float> heightDistribution(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> angleDistribution(0.0f, 360.0f);
+	while (angles_.size() < rocksNmb)
+	{
+		const Entity entity = entityManager_.CreateEntity();
+		transformManager_.AddComponent(entity);
+		transformManager_.SetRotation(entity, EulerAngles(
+			degree_t(angleDistribution(generator)),
+			degree_t(angleDistribution(generator)),
+			degree_t(angleDistribution(generator))));
+		modelRendererManager_.AddComponent(entity);
+		modelRendererManager_.SetModel(entity, model_, shader_);
+		radiuses_.push_back(radiusDistribution(generator));
+		heights_.push_back(heightDistribution(generator));
+		angles_.push_back(degree_t(angleDistribution(generator)));
+	}
+}
+
+void HelloModelBatchProgram::Destroy()
+{
+	ResizeRocks(0);
+	modelRendererManager_.Destroy();
+	batchRenderer_.Destroy();
+	model_.Destroy();
+	shader_.Destroy();
+}
+
+void HelloModelBatchProgram::DrawImGui()
+{
+	ImGui::Begin("Model Batch");
+	ImGui::SliderInt("Rocks", &rocksNmb_, 0, maxRocksNmb);
+	ImGui::Text("Frame time: %.2f ms (%.0f FPS)", frameTime_ * 1000.0f, 1.0f / frameTime_);
+	ImGui::Text("Batches: %zu, draw calls: %zu, rocks waiting for the model: %zu",
+		batchRenderer_.GetBatchesNmb(), batchRenderer_.GetDrawCallsNmb(), modelRendererManager_.GetPendingNmb());
+	ImGui::End();
+}
+
+void HelloModelBatchProgram::Render()
+{
+	std::lock_guard<std::mutex> lock(updateMutex_);
+	//Drawn inside the sample instead of being pushed by its Update, so it uses the camera provided here
+	CameraLocator::provide(&camera_);
+	batchRenderer_.Render();
+}
+
+void HelloModelBatchProgram::OnEvent(const SDL_Event& event)
+{
+	camera_.OnEvent(event);
+}
+}
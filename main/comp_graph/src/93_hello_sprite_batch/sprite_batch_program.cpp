@@ -0,0 +1,174 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "93_hello_sprite_batch/sprite_batch_program.h"
+
+#include <random>
+
+#include "engine/engine.h"
+#include "gl/state_cache.h"
+#include "imgui.h"
+
+namespace neko
+{
+namespace
+{
+constexpr float targetFrameTime = 1.0f / 60.0f;
+constexpr int spritesStep = 1'000;
+//Let the frame time average settle before growing again
+constexpr int framesBetweenSteps = 30;
+const Vec2f spriteSize = Vec2f(16.0f, 16.0f);
+}
+
+HelloSpriteBatchProgram::HelloSpriteBatchProgram() :
+	transformManager_(entityManager_),
+	spriteManager_(entityManager_, textureManager_, transformManager_)
+{
+}
+
+void HelloSpriteBatchProgram::Init()
+{
+	const auto& config = BasicEngine::GetInstance()->config;
+	textureManager_.Init();
+	spriteManager_.Init();
+	for (const auto* path : {
+		"sprites/asteroid/bullet.png",
+		"sprites/asteroid/circleWithSpike.png",
+		"sprites/grass.png",
+		"sprites/blending_transparent_window.png"})
+	{
+		textureIds_.push_back(textureManager_.LoadTexture(config.dataRootPath + path));
+	}
+	camera_.SetExtends(Vec2f(config.windowSize));
+	camera_.position = Vec3f(0, 0, 1);
+	camera_.WorldLookAt(Vec3f::zero);
+	gl::Disable(GL_DEPTH_TEST);
+	gl::Enable(GL_BLEND);
+	gl::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void HelloSpriteBatchProgram::Update(seconds dt)
+{
+	std::lock_guard<std::mutex> lock(updateMutex_);
+	textureManager_.Update(dt);
+	frameTime_ = frameTime_ + (dt.count() - frameTime_) * 0.05f;
+	framesSinceResize_++;
+	if (findMaxSprites_ && framesSinceResize_ > framesBetweenSteps)
+	{
+		if (frameTime_ < targetFrameTime)
+		{
+			maxSpritesAt60Fps_ = spritesNmb_;
+			spritesNmb_ += spritesStep;
+		}
+		else
+		{
+			findMaxSprites_ = false;
+			spritesNmb_ = maxSpritesAt60Fps_;
+		}
+	}
+	ResizeSprites(spritesNmb_);
+
+	const Vec2f extends = Vec2f(BasicEngine::GetInstance()->config.windowSize) / 2.0f;
+	for (Entity entity = 0; entity < velocities_.size(); entity++)
+	{
+		auto position = transformManager_.GetPosition(entity) + velocities_[entity] * dt.count();
+		if (position.x < -extends.x || position.x > extends.x)
+		{
+			velocities_[entity].x = -velocities_[entity].x;
+		}
+		if (position.y < -extends.y || position.y > extends.y)
+		{
+			velocities_[entity].y = -velocities_[entity].y;
+		}
+		transformManager_.SetPosition(entity, position);
+	}
+	transformManager_.Update();
+	spriteManager_.Update(dt);
+}
+
+void HelloSpriteBatchProgram::ResizeSprites(std::size_t spritesNmb)
+{
+	if (spritesNmb == velocities_.size())
+		return;
+	framesSinceResize_ = 0;
+	while (velocities_.size() > spritesNmb)
+	{
+		entityManager_.DestroyEntity(Entity(velocities_.size() - 1));
+		velocities_.pop_back();
+	}
+	std::mt19937 generator(std::uint32_t(velocities_.size()));
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	const Vec2f extends = Vec2f(BasicEngine::GetInstance()->config.windowSize) / 2.0f;
+	while (velocities_.size() < spritesNmb)
+	{
+		const Entity entity = entityManager_.CreateEntity();
+		transformManager_.AddComponent(entity);
+		transformManager_.SetPosition(entity,
+			Vec2f(distribution(generator) * extends.x, distribution(generator) * extends.y));
+		transformManager_.SetScale(entity, spriteSize);
+		spriteManager_.AddComponent(entity);
+		spriteManager_.SetTexture(entity, textureIds_[entity % textureIds_.size()]);
+		auto sprite = spriteManager_.GetComponent(entity);
+		sprite.layer = int(entity % 2);
+		spriteManager_.SetComponent(entity, sprite);
+		velocities_.push_back(Vec2f(distribution(generator), distribution(generator)) * 100.0f);
+	}
+}
+
+void HelloSpriteBatchProgram::Destroy()
+{
+	spriteManager_.Destroy();
+	textureManager_.Destroy();
+	gl::Disable(GL_BLEND);
+	gl::Enable(GL_DEPTH_TEST);
+}
+
+void HelloSpriteBatchProgram::DrawImGui()
+{
+	ImGui::Begin("Sprite Batch");
+	ImGui::SliderInt("Sprites", &spritesNmb_, 0, 500'000);
+	ImGui::Text("Frame time: %.2f ms (%.0f FPS)", frameTime_ * 1000.0f, 1.0f / frameTime_);
+	ImGui::Text("Sprites: %zu, draw calls: %zu",
+		spriteManager_.GetSpritesNmb(), spriteManager_.GetBatchesNmb());
+	if (ImGui::Button("Find max sprites at 60 FPS"))
+	{
+		findMaxSprites_ = true;
+		maxSpritesAt60Fps_ = 0;
+		spritesNmb_ = spritesStep;
+	}
+	ImGui::Text("Max sprites at 60 FPS: %d", maxSpritesAt60Fps_);
+	ImGui::End();
+}
+
+void HelloSpriteBatchProgram::Render()
+{
+	std::lock_guard<std::mutex> lock(updateMutex_);
+	CameraLocator::provide(&camera_);
+	spriteManager_.Render();
+}
+
+void HelloSpriteBatchProgram::OnEvent(const SDL_Event& event)
+{
+}
+}
@@ -24,6 +24,7 @@
 
 #include "96_hello_text/text_program.h"
 #include "mathematics/transform.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -35,8 +36,8 @@ void HelloTextProgram::Init()
 	
 
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	gl::Enable(GL_BLEND);
+	gl::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	projection_ = Transform3d::Orthographic(0.0f, config.windowSize.x, 0.0f, config.windowSize.y);
 	textShader_.Bind();
 	textShader_.SetMat4("projection", projection_);
@@ -71,7 +72,7 @@ void HelloTextProgram::Init()
         // generate texture
         unsigned int texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        gl::BindTexture(GL_TEXTURE_2D, texture);
         glTexImage2D(
             GL_TEXTURE_2D,
             0,
@@ -97,7 +98,7 @@ void HelloTextProgram::Init()
         };
         characters_[c] = character;
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl::BindTexture(GL_TEXTURE_2D, 0);
     // destroy FreeType once we're finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
@@ -107,13 +108,13 @@ void HelloTextProgram::Init()
     // -----------------------------------
     glGenVertexArrays(1, &textureQuad_.VAO);
     glGenBuffers(1, &textureQuad_.VBO[0]);
-    glBindVertexArray(textureQuad_.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
+    gl::BindVertexArray(textureQuad_.VAO);
+    gl::BindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    gl::BindBuffer(GL_ARRAY_BUFFER, 0);
+    gl::BindVertexArray(0);
 }
 
 void HelloTextProgram::Update(seconds dt)
@@ -126,7 +127,7 @@ void HelloTextProgram::Update(seconds dt)
 
 void HelloTextProgram::Destroy()
 {
-    glDisable(GL_BLEND);
+    gl::Disable(GL_BLEND);
 }
 
 void HelloTextProgram::DrawImGui()
@@ -143,7 +144,7 @@ void HelloTextProgram::Render()
     textShader_.SetMat4("projection", projection_);
     RenderText(textShader_, "Neko Engine!", 25.0f, 25.0f, 1.0f, Color3(0.5, 0.8f, 0.2f));
     RenderText(textShader_, "Meow!", config.windowSize.x/2.0f, config.windowSize.y/2.0f,0.5f, Color3(0.3, 0.7f, 0.9f));
-    glEnable(GL_DEPTH_TEST);
+    gl::Enable(GL_DEPTH_TEST);
 }
 
 void HelloTextProgram::OnEvent(const SDL_Event& event)
@@ -155,8 +156,8 @@ void HelloTextProgram::RenderText(gl::Shader& shader, std::string_view text, flo
     // activate corresponding render state	
     shader.Bind();
     shader.SetVec3("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(textureQuad_.VAO);
+    gl::ActiveTexture(GL_TEXTURE0);
+    gl::BindVertexArray(textureQuad_.VAO);
 
     // iterate through all characters
     for (const auto* c = text.data(); *c != 0; c++)
@@ -179,18 +180,18 @@ void HelloTextProgram::RenderText(gl::Shader& shader, std::string_view text, flo
             { xpos + w, ypos + h,   1.0f, 0.0f }
         };
         // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.textureID);
+        gl::BindTexture(GL_TEXTURE_2D, ch.textureID);
         // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
+        gl::BindBuffer(GL_ARRAY_BUFFER, textureQuad_.VBO[0]);
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // be sure to use glBufferSubData and not glBufferData
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        gl::BindBuffer(GL_ARRAY_BUFFER, 0);
         // render quad
         glDrawArrays(GL_TRIANGLES, 0, 6);
         // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
         x += (ch.advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
     }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl::BindVertexArray(0);
+    gl::BindTexture(GL_TEXTURE_2D, 0);
 }
 }
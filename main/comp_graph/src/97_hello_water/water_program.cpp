@@ -23,6 +23,7 @@
  */
 
 #include "97_hello_water/water_program.h"
+#include "gl/state_cache.h"
 
 namespace neko
 {
@@ -74,22 +75,22 @@ void HelloWaterProgram::Update(seconds dt)
 void HelloWaterProgram::Destroy()
 {
 	skyboxCube_.Destroy();
-	glDeleteTextures(1, &skyboxTexture_);
+	gl::DeleteTextures(1, &skyboxTexture_);
 	quad_.Destroy();
 	skyboxShader_.Destroy();
 	modelShader_.Destroy();
 	waterShader_.Destroy();
 	textureManager_.Destroy();
 	//Destroy framebuffers
-	glDeleteFramebuffers(1, &reflectionFramebuffer_);
-	glDeleteFramebuffers(1, &refractionFramebuffer_);
-	glDeleteTextures(1, &reflectionColorBuffer_);
-	glDeleteTextures(1, &refractionColorBuffer_);
+	gl::DeleteFramebuffers(1, &reflectionFramebuffer_);
+	gl::DeleteFramebuffers(1, &refractionFramebuffer_);
+	gl::DeleteTextures(1, &reflectionColorBuffer_);
+	gl::DeleteTextures(1, &refractionColorBuffer_);
 	glDeleteRenderbuffers(1, &reflectionDepthBuffer_);
 	glDeleteRenderbuffers(1, &refractionDepthBuffer_);
 
-	glDeleteFramebuffers(1, &depthFramebuffer_);
-	glDeleteTextures(1, &depthBuffer_);
+	gl::DeleteFramebuffers(1, &depthFramebuffer_);
+	gl::DeleteTextures(1, &depthBuffer_);
 }
 
 void HelloWaterProgram::DrawImGui()
@@ -119,8 +120,8 @@ void HelloWaterProgram::Render()
 	glCheckError();
 	if(resizeScreen_)
 	{
-		glDeleteFramebuffers(1, &depthFramebuffer_);
-		glDeleteTextures(1, &depthBuffer_);
+		gl::DeleteFramebuffers(1, &depthFramebuffer_);
+		gl::DeleteTextures(1, &depthBuffer_);
 		CreateDepthbuffer();
 		resizeScreen_ = false;
 	}
@@ -141,15 +142,15 @@ void HelloWaterProgram::Render()
 		modelShader_.SetInt("passType", passType);
 		model_.Draw(modelShader_);
 		//Render skybox
-		glDepthFunc(GL_LEQUAL);
+		gl::DepthFunc(GL_LEQUAL);
 		skyboxShader_.Bind();
 		skyboxShader_.SetMat4("view", Mat4f(view.ToMat3()));
 		skyboxShader_.SetMat4("projection", projection);
 		skyboxShader_.SetInt("skybox", 2);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
+		gl::ActiveTexture(GL_TEXTURE2);
+		gl::BindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexture_);
 		skyboxCube_.Draw();
-		glDepthFunc(GL_LESS);
+		gl::DepthFunc(GL_LESS);
 		glCheckError();
 	};
 	//Reflection
@@ -158,22 +159,22 @@ void HelloWaterProgram::Render()
 	underWaterCamera.position.y = underWaterCamera.position.y - 2.0f * std::abs(underWaterCamera.position.y - waterHeight_);
 	underWaterCamera.WorldLookAt(underWaterCamera.position - underWaterCamera.reverseDir, Vec3f::up);
 	glViewport(0, 0, reflectionFrameSize.x, reflectionFrameSize.y);
-	glBindFramebuffer(GL_FRAMEBUFFER, reflectionFramebuffer_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, reflectionFramebuffer_);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	renderScene(1, underWaterCamera.GenerateViewMatrix(), underWaterCamera.GenerateProjectionMatrix());
 	//Refraction
 	glViewport(0, 0, refractionFrameSize.x, refractionFrameSize.y);
-	glBindFramebuffer(GL_FRAMEBUFFER, refractionFramebuffer_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, refractionFramebuffer_);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	renderScene(2, view, projection);
 	//Render Scene
 	const auto& config = BasicEngine::GetInstance()->config;
 	glViewport(0, 0, config.windowSize.x, config.windowSize.y);
 	//Depth pass
-	glBindFramebuffer(GL_FRAMEBUFFER, depthFramebuffer_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, depthFramebuffer_);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	renderScene(0, view, projection);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	renderScene(0, view, projection);
 	//Draw water
@@ -213,10 +214,10 @@ void HelloWaterProgram::CreateFramebuffer()
 {
 	glCheckError();
 	glGenFramebuffers(1, &reflectionFramebuffer_);
-	glBindFramebuffer(GL_FRAMEBUFFER, reflectionFramebuffer_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, reflectionFramebuffer_);
 
 	glGenTextures(1, &reflectionColorBuffer_);
-	glBindTexture(GL_TEXTURE_2D, reflectionColorBuffer_);
+	gl::BindTexture(GL_TEXTURE_2D, reflectionColorBuffer_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, reflectionFrameSize.x, reflectionFrameSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -234,10 +235,10 @@ void HelloWaterProgram::CreateFramebuffer()
 	glCheckFramebuffer();
 
 	glGenFramebuffers(1, &refractionFramebuffer_);
-	glBindFramebuffer(GL_FRAMEBUFFER, refractionFramebuffer_);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, refractionFramebuffer_);
 
 	glGenTextures(1, &refractionColorBuffer_);
-	glBindTexture(GL_TEXTURE_2D, refractionColorBuffer_);
+	gl::BindTexture(GL_TEXTURE_2D, refractionColorBuffer_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, refractionFrameSize.x, refractionFrameSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -253,7 +254,7 @@ void HelloWaterProgram::CreateFramebuffer()
 
 	glCheckFramebuffer();
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	glCheckError();
 
 	
@@ -264,7 +265,7 @@ void HelloWaterProgram::CreateDepthbuffer()
 	const auto& config = BasicEngine::GetInstance()->config;
 	glGenFramebuffers(1, &depthFramebuffer_);
 	glGenTextures(1, &depthBuffer_);
-	glBindTexture(GL_TEXTURE_2D, depthBuffer_);
+	gl::BindTexture(GL_TEXTURE_2D, depthBuffer_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16,
 		config.windowSize.x,config.windowSize.y, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -275,8 +276,8 @@ void HelloWaterProgram::CreateDepthbuffer()
 		GL_COMPARE_REF_TO_TEXTURE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC,
 		GL_LEQUAL);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glBindFramebuffer(GL_FRAMEBUFFER, depthFramebuffer_);
+	gl::BindTexture(GL_TEXTURE_2D, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, depthFramebuffer_);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthBuffer_, 0);
 	GLenum drawBuffers = GL_NONE;
 	glDrawBuffers(1, &drawBuffers);
@@ -284,7 +285,7 @@ void HelloWaterProgram::CreateDepthbuffer()
 
 	glCheckFramebuffer();
 	glCheckError();
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 }
@@ -57,6 +57,8 @@
 #include "31_hello_pbr_texture/pbr_texture_program.h"
 #include "32_hello_ibl/ibl_program.h"
 
+#include "92_hello_model_batch/model_batch_program.h"
+#include "93_hello_sprite_batch/sprite_batch_program.h"
 #include "95_hello_2dgame/game2d_program.h"
 #include "96_hello_text/text_program.h"
 #include "97_hello_water/water_program.h"
@@ -101,6 +103,8 @@ void SampleBrowser::Init()
     RegisterRenderProgram("31 Hello Texture Pbr", std::make_unique<HelloPbrTextureProgram>());
     RegisterRenderProgram("32 Hello IBL", std::make_unique<HelloIblProgram>());
 
+    RegisterRenderProgram("92 Hello Model Batch", std::make_unique<HelloModelBatchProgram>());
+    RegisterRenderProgram("93 Hello Sprite Batch", std::make_unique<HelloSpriteBatchProgram>());
     RegisterRenderProgram("95 Hello 2d Game", std::make_unique<Hello2dGameProgram>());
     RegisterRenderProgram("96 Hello Text", std::make_unique<HelloTextProgram>());
     RegisterRenderProgram("97 Hello Water", std::make_unique<HelloWaterProgram>());
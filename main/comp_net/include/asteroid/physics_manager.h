@@ -55,11 +55,13 @@ public:
     virtual void OnCollision(Entity entity1, Entity entity2) = 0;
 };
 
-class BodyManager : public ComponentManager<Body, EntityMask(neko::ComponentType::BODY2D)>
+class BodyManager :
+    public ComponentManager<Body, EntityMask(neko::ComponentType::BODY2D), ComponentStorage::SPARSE_SET>
 {
     using ComponentManager::ComponentManager;
 };
-class BoxManager : public ComponentManager<Box, EntityMask(neko::ComponentType::BOX_COLLIDER2D)>
+class BoxManager :
+    public ComponentManager<Box, EntityMask(neko::ComponentType::BOX_COLLIDER2D), ComponentStorage::SPARSE_SET>
 {
     using ComponentManager::ComponentManager;
 };
@@ -27,6 +27,7 @@
 #include <gl/gles3_window.h>
 #include <gl/graphics.h>
 #include "asteroid_net/network_client.h"
+#include "gl/state_cache.h"
 
 namespace neko::asteroid
 {
@@ -42,8 +43,8 @@ public:
                 windowSize_ = config.windowSize;
                 client_.SetWindowSize(windowSize_);
                 client_.Init();
-                glEnable(GL_BLEND);
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                gl::Enable(GL_BLEND);
+                gl::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             });
         BasicEngine::GetInstance()->ScheduleJob(&initJob, JobThreadType::RENDER_THREAD);
         initJob.Join();
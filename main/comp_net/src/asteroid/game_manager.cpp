@@ -101,10 +101,8 @@ net::PlayerNumber GameManager::CheckWinner() const
     int alivePlayer = 0;
     net::PlayerNumber winner = net::INVALID_PLAYER;
     const auto& playerManager = rollbackManager_.GetPlayerCharacterManager();
-    for(Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    for(Entity entity : entityManager_.View(EntityMask(ComponentType::PLAYER_CHARACTER)))
     {
-        if(!entityManager_.HasComponent(entity, EntityMask(ComponentType::PLAYER_CHARACTER)))
-            continue;
         const auto& player = playerManager.GetComponent(entity);
         if(player.health > 0)
         {
@@ -155,39 +153,36 @@ void ClientGameManager::Update(seconds dt)
     {
         rollbackManager_.SimulateToCurrentFrame();
         //Copy rollback transform position to our own
-        for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        for (Entity entity : entityManager_.View(
+            EntityMask(ComponentType::PLAYER_CHARACTER) |
+            EntityMask(neko::ComponentType::SPRITE2D)))
         {
-            if (entityManager_.HasComponent(entity,
-                EntityMask(ComponentType::PLAYER_CHARACTER) |
-                EntityMask(neko::ComponentType::SPRITE2D)))
+            const auto& player = rollbackManager_.GetPlayerCharacterManager().GetComponent(entity);
+            auto sprite = spriteManager_.GetComponent(entity);
+            if (player.invincibilityTime > 0.0f)
             {
-                const auto& player = rollbackManager_.GetPlayerCharacterManager().GetComponent(entity);
-                auto sprite = spriteManager_.GetComponent(entity);
-                if (player.invincibilityTime > 0.0f)
-                {
-                    auto leftV = std::fmod(player.invincibilityTime, invincibilityFlashPeriod);
-                    auto rightV = invincibilityFlashPeriod / 2.0f;
-                    //logDebug(fmt::format("Comparing {} and {} with time: {}", leftV, rightV, player.invincibilityTime));
-                }
-                if (player.invincibilityTime > 0.0f &&
-                    std::fmod(player.invincibilityTime, invincibilityFlashPeriod)
-                    > invincibilityFlashPeriod / 2.0f)
-                {
-                    sprite.color = Color4(Color::black, 1.0f);
-                }
-                else
-                {
-                    sprite.color = playerColors[player.playerNumber];
-                }
-                spriteManager_.SetComponent(entity, sprite);
+                auto leftV = std::fmod(player.invincibilityTime, invincibilityFlashPeriod);
+                auto rightV = invincibilityFlashPeriod / 2.0f;
+                //logDebug(fmt::format("Comparing {} and {} with time: {}", leftV, rightV, player.invincibilityTime));
             }
-            if (entityManager_.HasComponent(entity, EntityMask(neko::ComponentType::TRANSFORM2D)))
+            if (player.invincibilityTime > 0.0f &&
+                std::fmod(player.invincibilityTime, invincibilityFlashPeriod)
+                > invincibilityFlashPeriod / 2.0f)
             {
-                transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
-                transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
-                transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
-                transformManager_.UpdateDirtyComponent(entity);
+                sprite.color = Color4(Color::black, 1.0f);
             }
+            else
+            {
+                sprite.color = playerColors[player.playerNumber];
+            }
+            spriteManager_.SetComponent(entity, sprite);
+        }
+        for (Entity entity : entityManager_.View(EntityMask(neko::ComponentType::TRANSFORM2D)))
+        {
+            transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
+            transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
+            transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
+            transformManager_.UpdateDirtyComponent(entity);
         }
     }
     fixedTimer_ += dt.count();
@@ -43,11 +43,9 @@ namespace neko::asteroid
 
     void PhysicsManager::FixedUpdate(seconds dt)
     {
-        for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
+        //Only walks the live bodies
+        bodyManager_.ForEach([dt](Entity, Body& body)
         {
-            if (!entityManager_.get().HasComponent(entity, EntityMask(neko::ComponentType::BODY2D)))
-                continue;
-            auto body = bodyManager_.GetComponent(entity);
             if (body.velocity.y <= -3.0f) {body.velocity.y = -3.0f;} // Stop players from going too fast in x or y
             if (body.velocity.y >= 4.0f) {body.velocity.y = 4.0f;}
             if (body.velocity.x >= 6.0f) {body.velocity.x = 6.0f;}
@@ -74,21 +72,25 @@ namespace neko::asteroid
             }
             body.position += body.velocity * dt.count();
             body.rotation += body.angularVelocity * dt.count();
-            bodyManager_.SetComponent(entity, body);
-        }
-        for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
+        });
+        const EntityMask colliderMask =
+            EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D);
+        //Copy the colliding entities as collision callbacks can destroy entities
+        const auto entities = entityManager_.get().FilterEntities(colliderMask);
+        for (size_t i = 0; i < entities.size(); i++)
         {
-            if (!entityManager_.get().HasComponent(entity,
-                EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D)) ||
+            const Entity entity = entities[i];
+            if (!entityManager_.get().HasComponent(entity, colliderMask) ||
                 entityManager_.get().HasComponent(entity, EntityMask(neko::asteroid::ComponentType::DESTROYED)))
                 continue;
-            for (Entity otherEntity = entity; otherEntity < entityManager_.get().GetEntitiesSize(); otherEntity++)
+            for (size_t j = i + 1; j < entities.size(); j++)
             {
-                if (entity == otherEntity)
-                    continue;
-                if (!entityManager_.get().HasComponent(otherEntity,
-                    EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D)) ||
-                    entityManager_.get().HasComponent(entity, EntityMask(neko::asteroid::ComponentType::DESTROYED)))
+                //A collision callback can destroy the entity, it then stops colliding
+                if (entityManager_.get().HasComponent(entity, EntityMask(neko::asteroid::ComponentType::DESTROYED)))
+                    break;
+                const Entity otherEntity = entities[j];
+                if (!entityManager_.get().HasComponent(otherEntity, colliderMask) ||
+                    entityManager_.get().HasComponent(otherEntity, EntityMask(neko::asteroid::ComponentType::DESTROYED)))
                     continue;
                 const Body& body1 = bodyManager_.GetComponent(entity);
                 const Box& box1 = boxManager_.GetComponent(entity);
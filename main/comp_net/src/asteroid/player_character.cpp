@@ -39,11 +39,8 @@ namespace neko::asteroid
    
     void PlayerCharacterManager::FixedUpdate(seconds dt)
     {	
-        for (Entity playerEntity = 0; playerEntity < entityManager_.get().GetEntitiesSize(); playerEntity++)
+        for (Entity playerEntity : entityManager_.get().View(EntityMask(ComponentType::PLAYER_CHARACTER)))
         {
-            if (!entityManager_.get().HasComponent(playerEntity,
-                EntityMask(ComponentType::PLAYER_CHARACTER)))
-                continue;
             auto playerBody = physicsManager_.get().GetBody(playerEntity);
             auto playerCharacter = GetComponent(playerEntity);
             const auto input = playerCharacter.input;
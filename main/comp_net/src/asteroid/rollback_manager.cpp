@@ -65,12 +65,9 @@ void RollbackManager::SimulateToCurrentFrame()
     }
     createdEntities_.clear();
     //Remove DESTROY flags
-    for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    for (Entity entity : entityManager_.FilterEntities(EntityMask(ComponentType::DESTROYED)))
     {
-        if (entityManager_.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
-        {
-            entityManager_.RemoveComponentType(entity, EntityMask(ComponentType::DESTROYED));
-        }
+        entityManager_.RemoveComponentType(entity, EntityMask(ComponentType::DESTROYED));
     }
 
     createdEntities_.clear();
@@ -95,12 +92,10 @@ void RollbackManager::SimulateToCurrentFrame()
         currentPhysicsManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
     }
     //Copy the physics states to the transforms
-    for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    for (Entity entity : entityManager_.View(
+        EntityMask(neko::ComponentType::BODY2D) |
+        EntityMask(neko::ComponentType::TRANSFORM2D)))
     {
-        if (!entityManager_.HasComponent(entity,
-            EntityMask(neko::ComponentType::BODY2D) |
-            EntityMask(neko::ComponentType::TRANSFORM2D)))
-            continue;
         const auto body = currentPhysicsManager_.GetBody(entity);
         currentTransformManager_.SetPosition(entity, body.position);
         currentTransformManager_.SetRotation(entity, body.rotation);
@@ -166,13 +161,9 @@ void RollbackManager::ValidateFrame(net::Frame newValidateFrame)
     }
     createdEntities_.clear();
     //Remove DESTROYED flag
-    for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    for (Entity entity : entityManager_.FilterEntities(EntityMask(ComponentType::DESTROYED)))
     {
-        if (entityManager_.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
-        {
-            entityManager_.RemoveComponentType(entity, EntityMask(ComponentType::DESTROYED));
-        }
-
+        entityManager_.RemoveComponentType(entity, EntityMask(ComponentType::DESTROYED));
     }
     createdEntities_.clear();
     //We check that we got all the inputs
@@ -206,12 +197,9 @@ void RollbackManager::ValidateFrame(net::Frame newValidateFrame)
         currentPhysicsManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
     }
     //Definitely remove DESTROY entities
-    for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    for (Entity entity : entityManager_.FilterEntities(EntityMask(ComponentType::DESTROYED)))
     {
-        if (entityManager_.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
-        {
-            entityManager_.DestroyEntity(entity);
-        }
+        entityManager_.DestroyEntity(entity);
     }
     //Copy back the new validate game state to the last validated game state
     lastValidatePlayerManager_ = currentPlayerManager_;
@@ -24,6 +24,7 @@
 
 #include "asteroid_net/debug_net_app.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko::net
 {
@@ -54,8 +55,8 @@ void NetworkDebugApp::Init()
             {
                 client.Init();
             }
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            gl::Enable(GL_BLEND);
+            gl::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         });
     BasicEngine::GetInstance()->ScheduleJob(&initJob, JobThreadType::RENDER_THREAD);
     initJob.Join();
@@ -97,7 +98,7 @@ void NetworkDebugApp::Destroy()
         client.Destroy();
     }
 
-    glDisable(GL_BLEND);
+    gl::Disable(GL_BLEND);
 }
 
 void NetworkDebugApp::DrawImGui()
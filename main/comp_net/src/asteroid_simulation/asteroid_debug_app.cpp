@@ -25,6 +25,7 @@
 #include "asteroid_simulation/asteroid_debug_app.h"
 #include "mathematics/transform.h"
 #include "imgui.h"
+#include "gl/state_cache.h"
 
 namespace neko::net
 {
@@ -65,8 +66,8 @@ void SimulationDebugApp::Init()
                 client->Init();
             }
             server_.Init();
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            gl::Enable(GL_BLEND);
+            gl::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         });
     BasicEngine::GetInstance()->ScheduleJob(&initJob, JobThreadType::RENDER_THREAD);
     initJob.Join();
@@ -108,7 +109,7 @@ void SimulationDebugApp::Destroy()
         client->Destroy();
     }
     server_.Destroy();
-    glDisable(GL_BLEND);
+    gl::Disable(GL_BLEND);
 }
 
 void SimulationDebugApp::DrawImGui()
@@ -5,6 +5,7 @@
 #include "gl/gles3_window.h"
 
 #include <custom_allocator_viewer.h>
+#include <engine/jobsystem_viewer.h>
 
 int main(int argc, char** argv)
 {
@@ -16,12 +17,14 @@ int main(int argc, char** argv)
   neko::editor::CustomAllocatorTester customAllocatorTester(customAllocatorViewer);
 
   neko::editor::ModelViewer modelViewer;
+  neko::JobSystemViewer jobSystemViewer(engine.GetJobSystem());
 
 
   /*engine.RegisterOnDrawUi(customAllocatorViewer);
   engine.RegisterOnDrawUi(customAllocatorTester);*/
   engine.RegisterSystem(modelViewer);
   engine.RegisterOnDrawUi(modelViewer);
+  engine.RegisterOnDrawUi(jobSystemViewer);
 
   engine.SetWindowAndRenderer(&window, &renderer);
   engine.Init();
@@ -1,9 +1,24 @@
 #!/usr/bin/env python3
 
 import validator.asset_validator
-import sys
+import argparse
+import json
 import os
 import shutil
+import struct
+import uuid
+import zlib
+
+# Layout shared with core/include/utilities/asset_archive.h
+ARCHIVE_MAGIC = 0x4B504B4E
+ARCHIVE_VERSION = 2
+ARCHIVE_HEADER = struct.Struct("<IIIIQQ")
+ARCHIVE_ENTRY = struct.Struct("<QQQQQIIIIII")
+ARCHIVE_ALIGNMENT = 16
+COMPRESSION_NONE = 0
+COMPRESSION_ZSTD = 1
+# Entries are only stored compressed when it saves at least this ratio
+MIN_COMPRESSION_GAIN = 0.1
 
 
 def iterate_over_folder(path):
@@ -24,12 +39,107 @@ def iterate_over_folder(path):
             validator.asset_validator.validate_asset(filepath, out_file)
 
 
+def load_compressor(level):
+    if level <= 0:
+        return None
+    try:
+        import zstandard
+    except ImportError:
+        print("[Warning] zstandard python module not found, the archive is not compressed")
+        return None
+    return zstandard.ZstdCompressor(level=level)
+
+
+def align(offset):
+    return (offset + ARCHIVE_ALIGNMENT - 1) // ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT
+
+
+def collect_archive_entries(root_dir, compressor):
+    entries = []
+    for folder, _, files in os.walk(root_dir):
+        for filename in files:
+            if filename.endswith(".meta"):
+                continue
+            filepath = os.path.join(folder, filename)
+            rel_path = os.path.relpath(filepath, root_dir).replace(os.sep, "/")
+            meta_content = {}
+            if os.path.isfile(filepath + ".meta"):
+                with open(filepath + ".meta", "r") as meta_file:
+                    meta_content = json.loads(meta_file.read())
+            if "uuid" in meta_content:
+                asset_id = uuid.UUID(meta_content["uuid"])
+            else:
+                # Assets without meta file get a stable id from their path
+                asset_id = uuid.uuid5(uuid.NAMESPACE_URL, rel_path)
+            with open(filepath, "rb") as asset_file:
+                data = asset_file.read()
+            original_size = len(data)
+            content_crc = zlib.crc32(data) & 0xFFFFFFFF
+            compression = COMPRESSION_NONE
+            if compressor is not None and original_size > 0:
+                compressed_data = compressor.compress(data)
+                if len(compressed_data) <= original_size * (1.0 - MIN_COMPRESSION_GAIN):
+                    data = compressed_data
+                    compression = COMPRESSION_ZSTD
+            entries.append({
+                "uuid": asset_id,
+                "path": rel_path.encode("utf-8"),
+                "meta": json.dumps(meta_content, separators=(",", ":")).encode("utf-8") if meta_content else b"",
+                "data": data,
+                "original_size": original_size,
+                "content_crc": content_crc,
+                "compression": compression
+            })
+    # Sorted by uuid for the binary search of the loader
+    entries.sort(key=lambda entry: entry["uuid"].int)
+    return entries
+
+
+def write_archive(root_dir, archive_path, compression_level):
+    entries = collect_archive_entries(root_dir, load_compressor(compression_level))
+    entries_offset = align(ARCHIVE_HEADER.size)
+    strings_offset = entries_offset + len(entries) * ARCHIVE_ENTRY.size
+    strings = bytearray()
+    for entry in entries:
+        entry["path_offset"] = len(strings)
+        strings += entry["path"]
+        entry["meta_offset"] = len(strings)
+        strings += entry["meta"]
+    # Each blob is followed by at least one zero, the loader hands them as null terminated buffers
+    blob_offset = align(strings_offset + len(strings) + 1)
+    for entry in entries:
+        entry["offset"] = blob_offset
+        blob_offset = align(blob_offset + len(entry["data"]) + 1)
+
+    with open(archive_path, "wb") as archive:
+        archive.write(ARCHIVE_HEADER.pack(ARCHIVE_MAGIC, ARCHIVE_VERSION, len(entries), 0,
+                                          entries_offset, strings_offset))
+        archive.write(bytes(entries_offset - ARCHIVE_HEADER.size))
+        for entry in entries:
+            asset_id = entry["uuid"].int
+            archive.write(ARCHIVE_ENTRY.pack(asset_id >> 64, asset_id & 0xFFFFFFFFFFFFFFFF,
+                                             entry["offset"], len(entry["data"]), entry["original_size"],
+                                             entry["path_offset"], len(entry["path"]),
+                                             entry["meta_offset"], len(entry["meta"]),
+                                             entry["compression"], entry["content_crc"]))
+        archive.write(strings)
+        for entry in entries:
+            archive.write(bytes(entry["offset"] - archive.tell()))
+            archive.write(entry["data"])
+        archive.write(bytes(align(archive.tell() + 1) - archive.tell()))
+    print("Archive: {} with {} assets".format(archive_path, len(entries)))
+
+
 if __name__ == "__main__":
-    if len(sys.argv) >= 3:
-        data_dir = sys.argv[1]
-        data_out_dir = sys.argv[2]
-    else:
-        data_dir = "../data/"
-        data_out_dir = "../data_out/"
+    parser = argparse.ArgumentParser(description="Validate the data folder and optionally pack it in an archive")
+    parser.add_argument("data_dir", nargs="?", default="../data/")
+    parser.add_argument("data_out_dir", nargs="?", default="../data_out/")
+    parser.add_argument("--archive", help="Path of the packed asset archive written from the output folder")
+    parser.add_argument("--zstd_level", type=int, default=0,
+                        help="Zstd compression level of the archive entries, 0 to store them uncompressed")
+    args = parser.parse_args()
+    data_dir = args.data_dir
+    data_out_dir = args.data_out_dir
     iterate_over_folder(data_dir)
-
+    if args.archive is not None:
+        write_archive(data_out_dir, args.archive, args.zstd_level)
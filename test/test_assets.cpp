@@ -21,11 +21,16 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include <xxhash.hpp>
 #include <sole.hpp>
 #include <gtest/gtest.h>
+#include "utilities/asset_archive.h"
 #include "utilities/file_utility.h"
 #include "engine/engine.h"
 
@@ -68,4 +73,122 @@ TEST(Engine, TestAssetImport)
 	EXPECT_NE(fileHashes[0], fileHashes[1]);
 	EXPECT_NE(fileHashes[1], fileHashes[2]);
 	EXPECT_NE(fileHashes[2], fileHashes[0]);
-}
\ No newline at end of file
+}
+
+//Same layout as scripts/data_folder_generator.py --archive, with uncompressed entries
+static void WriteTestArchive(const std::string& archivePath,
+                             const std::vector<std::pair<std::string, std::string>>& assets,
+                             const std::vector<sole::uuid>& assetIds)
+{
+    const auto align = [](std::uint64_t offset) { return (offset + 15u) / 16u * 16u; };
+    std::vector<std::size_t> order(assets.size());
+    for (std::size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&assetIds](std::size_t a, std::size_t b)
+    {
+        return assetIds[a].ab < assetIds[b].ab || (assetIds[a].ab == assetIds[b].ab && assetIds[a].cd < assetIds[b].cd);
+    });
+    neko::AssetArchiveHeader header;
+    header.entriesNmb = static_cast<std::uint32_t>(assets.size());
+    header.entriesOffset = sizeof(neko::AssetArchiveHeader);
+    header.stringsOffset = header.entriesOffset + assets.size() * sizeof(neko::AssetArchiveEntry);
+    std::string strings;
+    std::vector<neko::AssetArchiveEntry> entries;
+    for (const auto index : order)
+    {
+        neko::AssetArchiveEntry entry;
+        entry.uuidAb = assetIds[index].ab;
+        entry.uuidCd = assetIds[index].cd;
+        entry.pathOffset = static_cast<std::uint32_t>(strings.size());
+        entry.pathLength = static_cast<std::uint32_t>(assets[index].first.size());
+        strings += assets[index].first;
+        entry.size = assets[index].second.size();
+        entry.originalSize = entry.size;
+        entries.push_back(entry);
+    }
+    std::uint64_t blobOffset = align(header.stringsOffset + strings.size() + 1);
+    for (auto& entry : entries)
+    {
+        entry.offset = blobOffset;
+        blobOffset = align(blobOffset + entry.size + 1);
+    }
+    std::string archive(blobOffset, '\0');
+    std::memcpy(archive.data(), &header, sizeof(header));
+    std::memcpy(archive.data() + header.entriesOffset, entries.data(), entries.size() * sizeof(neko::AssetArchiveEntry));
+    std::memcpy(archive.data() + header.stringsOffset, strings.data(), strings.size());
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        const auto& content = assets[order[i]].second;
+        std::memcpy(archive.data() + entries[i].offset, content.data(), content.size());
+    }
+    std::ofstream file(archivePath, std::ofstream::binary);
+    file.write(archive.data(), archive.size());
+}
+
+TEST(Engine, TestAssetArchive)
+{
+    const std::string archivePath =
+        (std::filesystem::temp_directory_path() / "neko_test_archive.npak").string();
+    const std::vector<std::pair<std::string, std::string>> assets =
+    {
+        {"sprites/wall.jpg", "wall content"},
+        {"shaders/engine/line.vert", "#version 300 es"},
+        {"scenes/test.scene", "{}"},
+    };
+    const std::vector<sole::uuid> assetIds = {sole::uuid4(), sole::uuid4(), sole::uuid4()};
+    WriteTestArchive(archivePath, assets, assetIds);
+
+    neko::AssetArchive archive;
+    ASSERT_TRUE(archive.Open(archivePath, "../data/"));
+    EXPECT_EQ(archive.GetEntriesNmb(), assets.size());
+    for (std::size_t i = 0; i < assets.size(); i++)
+    {
+        const auto* entry = archive.FindEntry(assetIds[i]);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(archive.GetPath(*entry), assets[i].first);
+        //Paths are looked up with or without the data root path
+        EXPECT_EQ(archive.FindEntry("../data/" + assets[i].first), entry);
+        EXPECT_EQ(archive.FindEntry(assets[i].first), entry);
+        neko::BufferFile bufferFile;
+        ASSERT_TRUE(archive.LoadEntry(*entry, bufferFile));
+        EXPECT_EQ(bufferFile.storage, neko::BufferFile::Storage::VIEW);
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(bufferFile.dataBuffer)), assets[i].second);
+        bufferFile.Destroy();
+    }
+    EXPECT_EQ(archive.FindEntry(sole::uuid4()), nullptr);
+    EXPECT_EQ(archive.FindEntry("../data/sprites/missing.jpg"), nullptr);
+
+    //Once mounted, the buffer files are loaded from the archive, the file does not exist on disk
+    neko::AssetArchiveLocator::provide(&archive);
+    EXPECT_TRUE(neko::FileExists("../data/scenes/test.scene"));
+    neko::BufferFile sceneFile;
+    sceneFile.Load("../data/scenes/test.scene");
+    EXPECT_EQ(sceneFile.dataLength, 2u);
+    sceneFile.Destroy();
+    neko::AssetArchiveLocator::provide(nullptr);
+    archive.Close();
+    std::filesystem::remove(archivePath);
+}
+
+TEST(Engine, TestAssetArchiveTruncated)
+{
+    const std::string archivePath =
+        (std::filesystem::temp_directory_path() / "neko_test_truncated_archive.npak").string();
+    const std::vector<std::pair<std::string, std::string>> assets = {{"scenes/test.scene", "{}"}};
+    const std::vector<sole::uuid> assetIds = {sole::uuid4()};
+    WriteTestArchive(archivePath, assets, assetIds);
+    neko::AssetArchive archive;
+    ASSERT_TRUE(archive.Open(archivePath, "../data/"));
+    const auto* entry = archive.FindEntry(assetIds[0]);
+    ASSERT_NE(entry, nullptr);
+    const auto blobEnd = entry->offset + entry->size;
+    archive.Close();
+
+    //The blob fits, but not the zero the buffer file view relies on
+    std::filesystem::resize_file(archivePath, blobEnd);
+    EXPECT_FALSE(archive.Open(archivePath, "../data/"));
+    EXPECT_EQ(archive.GetEntriesNmb(), 0u);
+    std::filesystem::remove(archivePath);
+}
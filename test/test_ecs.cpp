@@ -25,6 +25,7 @@
 #include <gtest/gtest.h>
 #include <engine/entity.h>
 #include <engine/transform.h>
+#include <mathematics/transform.h>
 
 TEST(Entity, EntityManager)
 {
@@ -68,3 +69,264 @@ TEST(Entity, EntityManager)
     EXPECT_EQ(entityManager.GetLastEntity(), entityNmb-1);
 }
 
+TEST(Entity, EntityRecycling)
+{
+    neko::EntityManager entityManager;
+    const neko::Index entityNmb = 16u;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        EXPECT_EQ(entityManager.CreateEntity(), i);
+    }
+    const auto handle = entityManager.GetEntityHandle(5);
+    EXPECT_TRUE(entityManager.IsEntityHandleValid(handle));
+
+    //The last destroyed entity is recycled first
+    entityManager.DestroyEntity(5);
+    entityManager.DestroyEntity(3);
+    EXPECT_FALSE(entityManager.IsEntityHandleValid(handle));
+    EXPECT_EQ(entityManager.CreateEntity(), 3);
+    EXPECT_EQ(entityManager.CreateEntity(), 5);
+    EXPECT_EQ(entityManager.GetEntityGeneration(5), handle.generation + 1);
+    //The recycled entity does not validate the old handle
+    EXPECT_FALSE(entityManager.IsEntityHandleValid(handle));
+    EXPECT_TRUE(entityManager.IsEntityHandleValid(entityManager.GetEntityHandle(5)));
+    EXPECT_EQ(entityManager.CreateEntity(), entityNmb);
+
+    //An explicit entity already destroyed is not given twice
+    entityManager.DestroyEntity(7);
+    EXPECT_EQ(entityManager.CreateEntity(7), 7);
+    EXPECT_EQ(entityManager.CreateEntity(), entityNmb + 1);
+
+    //The entities skipped by an explicit entity are created afterwards
+    EXPECT_EQ(entityManager.CreateEntity(entityNmb + 4), entityNmb + 4);
+    EXPECT_EQ(entityManager.CreateEntity(), entityNmb + 2);
+    EXPECT_EQ(entityManager.CreateEntity(), entityNmb + 3);
+    EXPECT_EQ(entityManager.CreateEntity(), entityNmb + 5);
+    //An existing explicit entity creates a new one
+    EXPECT_EQ(entityManager.CreateEntity(0), entityNmb + 6);
+}
+
+TEST(Entity, EntityView)
+{
+    neko::EntityManager entityManager;
+    const neko::Index entityNmb = 16u;
+    const neko::EntityMask componentType1 = 1 << 1;
+    const neko::EntityMask componentType2 = 1 << 2;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (entity % 2 == 0)
+        {
+            entityManager.AddComponentType(entity, componentType1);
+        }
+    }
+    //The view is built from the existing entities
+    const auto& view = entityManager.View(componentType1 | componentType2);
+    EXPECT_TRUE(view.empty());
+    EXPECT_EQ(entityManager.View(componentType1).size(), entityNmb / 2);
+
+    //And then kept sorted when the masks change
+    entityManager.AddComponentType(6, componentType2);
+    entityManager.AddComponentType(2, componentType2);
+    entityManager.AddComponentType(3, componentType2);
+    entityManager.AddComponentType(10, componentType2);
+    const std::vector<neko::Entity> expectedEntities = {2, 6, 10};
+    EXPECT_EQ(view, expectedEntities);
+
+    entityManager.RemoveComponentType(6, componentType1);
+    entityManager.DestroyEntity(10);
+    EXPECT_EQ(view, std::vector<neko::Entity>{2});
+    EXPECT_EQ(entityManager.View(componentType1).size(), entityNmb / 2 - 2);
+    EXPECT_EQ(entityManager.FilterEntities(componentType2), (std::vector<neko::Entity>{2, 3, 6}));
+
+    //A recycled entity is empty
+    EXPECT_EQ(entityManager.CreateEntity(), 10);
+    EXPECT_EQ(view, std::vector<neko::Entity>{2});
+}
+
+
+TEST(Entity, SparseSetComponentManager)
+{
+    const neko::EntityMask componentType = 1 << 0;
+    using SparseManager = neko::ComponentManager<int, componentType, neko::ComponentStorage::SPARSE_SET>;
+    neko::EntityManager entityManager;
+    SparseManager sparseManager(entityManager);
+    const neko::Index entityNmb = 16u;
+
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        //Only one entity out of four has the component
+        if (entity % 4 == 0)
+        {
+            sparseManager.AddComponent(entity);
+            sparseManager.SetComponent(entity, int(entity));
+            EXPECT_TRUE(entityManager.HasComponent(entity, componentType));
+        }
+    }
+    EXPECT_EQ(sparseManager.GetComponentsNmb(), entityNmb / 4);
+    EXPECT_EQ(sparseManager.GetComponent(8), 8);
+    EXPECT_EQ(sparseManager.GetComponentPtr(1), nullptr);
+
+    //The last component takes the place of the destroyed one
+    entityManager.DestroyEntity(0);
+    EXPECT_FALSE(sparseManager.HasComponentData(0));
+    EXPECT_EQ(sparseManager.GetComponentsNmb(), entityNmb / 4 - 1);
+    EXPECT_EQ(sparseManager.GetDenseEntities().front(), entityNmb - 4);
+    EXPECT_EQ(sparseManager.GetComponent(entityNmb - 4), int(entityNmb - 4));
+
+    size_t visitedComponents = 0;
+    sparseManager.ForEach([&visitedComponents](neko::Entity entity, int& component)
+    {
+        EXPECT_EQ(int(entity), component);
+        component++;
+        visitedComponents++;
+    });
+    EXPECT_EQ(visitedComponents, entityNmb / 4 - 1);
+    EXPECT_EQ(sparseManager.GetComponent(4), 5);
+}
+
+TEST(Entity, DoubleBufferComponentManager)
+{
+    const neko::EntityMask componentType = 1 << 0;
+    using DoubleBufferManager = neko::DoubleBufferComponentManager<int, componentType>;
+    neko::EntityManager entityManager;
+    DoubleBufferManager doubleBufferManager(entityManager);
+    const neko::Index entityNmb = 16u;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        doubleBufferManager.AddComponent(entity);
+        doubleBufferManager.SetComponent(entity, int(entity));
+    }
+    doubleBufferManager.SyncBuffers();
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        EXPECT_EQ(doubleBufferManager.GetCurrentComponent(i), int(i));
+    }
+
+    //Only the changed components are copied, the render side keeps the old values until the sync
+    doubleBufferManager.SetComponent(3, 30);
+    doubleBufferManager.SetComponent(4, 40);
+    doubleBufferManager.SetComponent(10, 100);
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponent(3), 3);
+    doubleBufferManager.SyncBuffers();
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponent(3), 30);
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponent(4), 40);
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponent(5), 5);
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponent(10), 100);
+    EXPECT_EQ(doubleBufferManager.GetComponent(10), 100);
+
+    doubleBufferManager.ForEach([](neko::Entity, int& component) { component = -component; });
+    doubleBufferManager.SyncBuffers();
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponent(5), -5);
+
+    //Entities added after the first sync grow the current buffer
+    const auto lastEntity = entityManager.CreateEntity(neko::INIT_ENTITY_NMB + 1);
+    doubleBufferManager.AddComponent(lastEntity);
+    doubleBufferManager.SetComponent(lastEntity, 1);
+    doubleBufferManager.SyncBuffers();
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponent(lastEntity), 1);
+    EXPECT_EQ(doubleBufferManager.GetCurrentComponentsVector().size(),
+              doubleBufferManager.GetComponentsVector().size());
+}
+
+namespace neko
+{
+//Each entity stores its depth in the hierarchy, computed from its parent when dirty
+class DepthManager : public ComponentManager<int, EntityMask(1u << 1u)>
+{
+public:
+    explicit DepthManager(EntityManager& entityManager) : ComponentManager(entityManager), dirtyManager_(entityManager)
+    {
+        dirtyManager_.RegisterComponentManager(this);
+    }
+    void SetDirty(Entity entity) { dirtyManager_.SetDirty(entity); }
+    void Update() { dirtyManager_.UpdateDirtyEntities(); }
+    void UpdateDirtyComponent(Entity entity) override
+    {
+        const auto parent = entityManager_.get().GetEntityParent(entity);
+        SetComponent(entity, parent == INVALID_ENTITY ? 0 : GetComponent(parent) + 1);
+        updatedEntities.push_back(entity);
+    }
+    std::vector<Entity> updatedEntities;
+private:
+    DirtyManager dirtyManager_;
+};
+}
+
+TEST(Entity, DirtyManager)
+{
+    neko::EntityManager entityManager;
+    neko::DepthManager depthManager(entityManager);
+    //A chain where each entity is the parent of the previous one, the root being the last entity
+    const neko::Index entityNmb = 8u;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        depthManager.AddComponent(entity);
+    }
+    for (neko::Index i = 0u; i < entityNmb - 1; i++)
+    {
+        entityManager.SetEntityParent(i, i + 1);
+    }
+    //The children are set dirty before the root, but they are updated after it
+    depthManager.SetDirty(0);
+    depthManager.SetDirty(3);
+    depthManager.SetDirty(entityNmb - 1);
+    depthManager.SetDirty(3);
+    depthManager.Update();
+    ASSERT_EQ(depthManager.updatedEntities.size(), entityNmb);
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        EXPECT_EQ(depthManager.updatedEntities[i], entityNmb - 1 - i);
+        EXPECT_EQ(depthManager.GetComponent(i), int(entityNmb - 1 - i));
+    }
+
+    //Only the dirty subtree is updated
+    depthManager.updatedEntities.clear();
+    depthManager.SetDirty(2);
+    depthManager.Update();
+    EXPECT_EQ(depthManager.updatedEntities, (std::vector<neko::Entity>{2, 1, 0}));
+
+    //A destroyed entity leaves its parent children
+    depthManager.updatedEntities.clear();
+    entityManager.DestroyEntity(0);
+    depthManager.SetDirty(1);
+    depthManager.Update();
+    EXPECT_EQ(depthManager.updatedEntities, (std::vector<neko::Entity>{1}));
+}
+
+TEST(Entity, Transform3dManagerHierarchy)
+{
+    neko::EntityManager entityManager;
+    neko::Transform3dManager transformManager(entityManager);
+    //Enough entities to have several SIMD batches by hierarchy level
+    const neko::Index entityNmb = 64u;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        transformManager.AddComponent(entity);
+        transformManager.SetPosition(entity, neko::Vec3f(float(i), 1.0f, 0.0f));
+        transformManager.SetScale(entity, neko::Vec3f(1.0f, 2.0f, 1.0f));
+        transformManager.SetRotation(entity, neko::EulerAngles(
+                neko::degree_t(float(i)), neko::degree_t(0), neko::degree_t(45)));
+        //Each entity is the child of the one created entityNmb / 4 before
+        if (i >= entityNmb / 4)
+        {
+            entityManager.SetEntityParent(entity, i - entityNmb / 4);
+        }
+    }
+    transformManager.Update();
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        auto expected = neko::Transform3d::Rotate(neko::Mat4f::Identity, transformManager.GetRotation(i));
+        expected = neko::Transform3d::Scale(expected, transformManager.GetScale(i));
+        expected = neko::Transform3d::Translate(expected, transformManager.GetPosition(i));
+        if (i >= entityNmb / 4)
+        {
+            expected = transformManager.GetComponent(i - entityNmb / 4) * expected;
+        }
+        EXPECT_LT(neko::Mat4f::MatrixDifference(transformManager.GetComponent(i), expected), 0.01f);
+    }
+}
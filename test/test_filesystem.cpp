@@ -3,9 +3,16 @@
 //
 
 #include "utilities/file_utility.h"
+#include "utilities/io_service.h"
+#include "engine/jobsystem.h"
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
 namespace fs = std::filesystem;
 
 TEST(Engine, TestFilesystem)
@@ -27,4 +34,162 @@ TEST(Engine, TestPathCompare)
     //EXPECT_TRUE(fs::absolute(texture1) == fs::absolute(texture2));
     EXPECT_TRUE(texture1 != texture3);
 	
-}
\ No newline at end of file
+}
+TEST(Engine, TestBufferFileMap)
+{
+    const std::string path = (fs::temp_directory_path() / "neko_buffer_file_test.bin").string();
+    //Bigger than the map threshold and not a multiple of the page size
+    std::string content(neko::BUFFER_FILE_MAP_MIN_SIZE + 123, '\0');
+    for (size_t i = 0; i < content.size(); i++)
+    {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+    {
+        std::ofstream file(path, std::ofstream::binary);
+        file.write(content.data(), content.size());
+    }
+
+    neko::BufferFile mappedFile;
+    mappedFile.Load(path, neko::BufferFile::LoadMode::MAP);
+    neko::BufferFile readFile;
+    readFile.Load(path, neko::BufferFile::LoadMode::READ);
+#if defined(__linux__)
+    EXPECT_EQ(mappedFile.storage, neko::BufferFile::Storage::MAPPED);
+#endif
+    EXPECT_EQ(readFile.storage, neko::BufferFile::Storage::HEAP);
+    ASSERT_EQ(mappedFile.dataLength, content.size());
+    ASSERT_EQ(readFile.dataLength, content.size());
+    EXPECT_EQ(std::memcmp(mappedFile.dataBuffer, content.data(), content.size()), 0);
+    EXPECT_EQ(std::memcmp(readFile.dataBuffer, content.data(), content.size()), 0);
+    //Both modes are null terminated for the text parsers
+    EXPECT_EQ(mappedFile.dataBuffer[mappedFile.dataLength], 0);
+    EXPECT_EQ(readFile.dataBuffer[readFile.dataLength], 0);
+
+    //The mapping is private, writing to it does not change the file
+    mappedFile.dataBuffer[0] = 'z';
+    neko::BufferFile movedFile = std::move(mappedFile);
+    EXPECT_EQ(mappedFile.dataBuffer, nullptr);
+    EXPECT_EQ(movedFile.dataBuffer[0], 'z');
+    movedFile.Destroy();
+    movedFile.Load(path);
+    EXPECT_EQ(movedFile.dataBuffer[0], 'a');
+    movedFile.Destroy();
+    readFile.Destroy();
+    fs::remove(path);
+}
+
+TEST(Engine, TestIoService)
+{
+    const fs::path folder = fs::temp_directory_path() / "neko_io_service_test";
+    fs::create_directories(folder);
+    //More files than the io_uring queue depth, with empty, small and big files
+    const std::size_t filesNmb = neko::IO_QUEUE_DEPTH * 2 + 3;
+    std::vector<std::string> paths;
+    std::vector<std::string> contents;
+    for (std::size_t i = 0; i < filesNmb; i++)
+    {
+        paths.push_back((folder / ("file" + std::to_string(i) + ".txt")).string());
+        std::string content((i * i * 97) % (3 * neko::BUFFER_FILE_MAP_MIN_SIZE), '\0');
+        for (std::size_t j = 0; j < content.size(); j++)
+        {
+            content[j] = static_cast<char>('a' + (i + j) % 26);
+        }
+        std::ofstream file(paths.back(), std::ofstream::binary);
+        file.write(content.data(), content.size());
+        contents.push_back(std::move(content));
+    }
+    paths.push_back((folder / "missing.txt").string());
+    contents.emplace_back();
+
+    for (const auto backend : {neko::IoBackend::IO_URING, neko::IoBackend::THREAD_POOL})
+    {
+        neko::JobSystem jobSystem;
+        jobSystem.Init();
+        neko::IoService ioService;
+        ioService.Init(backend);
+        if (backend == neko::IoBackend::THREAD_POOL)
+        {
+            EXPECT_EQ(ioService.GetBackend(), neko::IoBackend::THREAD_POOL);
+        }
+
+        std::unique_ptr<neko::ResourceJob[]> readJobs(new neko::ResourceJob[paths.size()]);
+        std::vector<std::unique_ptr<neko::Job>> checkJobs;
+        std::atomic<std::size_t> validFilesNmb{0};
+        for (std::size_t i = 0; i < paths.size(); i++)
+        {
+            auto& readJob = readJobs[i];
+            readJob.SetFilePath(paths[i]);
+            checkJobs.push_back(std::make_unique<neko::Job>([&readJob, &contents, &validFilesNmb, i]
+            {
+                const auto& bufferFile = readJob.GetBufferFile();
+                const auto& content = contents[i];
+                if (bufferFile.dataLength == content.size() &&
+                    (bufferFile.dataBuffer == nullptr ||
+                     (bufferFile.dataBuffer[content.size()] == 0 &&
+                      std::memcmp(bufferFile.dataBuffer, content.data(), content.size()) == 0)))
+                {
+                    validFilesNmb++;
+                }
+            }));
+            EXPECT_TRUE(ioService.Read(&readJob));
+            //The read can complete before the dependency is added
+            checkJobs.back()->AddDependency(&readJob);
+            jobSystem.ScheduleJob(checkJobs.back().get(), neko::JobThreadType::OTHER_THREAD);
+        }
+        for (auto& checkJob : checkJobs)
+        {
+            checkJob->Join();
+        }
+        EXPECT_EQ(validFilesNmb.load(), paths.size());
+        EXPECT_EQ(readJobs[paths.size() - 1].GetBufferFile().dataBuffer, nullptr);
+
+        ioService.Destroy();
+        neko::ResourceJob lateJob;
+        lateJob.SetFilePath(paths[0]);
+        EXPECT_FALSE(ioService.Read(&lateJob));
+        jobSystem.Destroy();
+    }
+    fs::remove_all(folder);
+}
+
+namespace
+{
+//The ring fails on its second submission, usually with the first read in flight
+class FailingRingIoService : public neko::IoService
+{
+protected:
+    bool EnterRing(unsigned waitNmb) override
+    {
+        return enterNmb_++ == 0 && IoService::EnterRing(waitNmb);
+    }
+private:
+    int enterNmb_ = 0;
+};
+}
+
+TEST(Engine, TestIoServiceRingFailure)
+{
+    const std::string path = (fs::temp_directory_path() / "neko_io_ring_failure_test.txt").string();
+    const std::string content = "ring failure";
+    {
+        std::ofstream file(path, std::ofstream::binary);
+        file.write(content.data(), content.size());
+    }
+    FailingRingIoService ioService;
+    ioService.Init(neko::IoBackend::IO_URING);
+    //The reads submitted before and after the failure are done by the thread pool
+    for (int i = 0; i < 2; i++)
+    {
+        neko::ResourceJob readJob;
+        readJob.SetFilePath(path);
+        ASSERT_TRUE(ioService.Read(&readJob));
+        readJob.Join();
+        const auto& bufferFile = readJob.GetBufferFile();
+        ASSERT_EQ(bufferFile.dataLength, content.size());
+        EXPECT_EQ(std::memcmp(bufferFile.dataBuffer, content.data(), content.size()), 0);
+    }
+    EXPECT_EQ(ioService.GetBackend(), neko::IoBackend::THREAD_POOL);
+    //Stopped before the override is destroyed, the ring thread calls it
+    ioService.Destroy();
+    fs::remove(path);
+}
@@ -0,0 +1,954 @@
+/*
+ MIT License
+
+ Copyright (c) 2019 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include <graphics/camera.h>
+#include <graphics/graphics.h>
+#include <graphics/frustum.h>
+#include <graphics/instancing.h>
+#include <graphics/texture.h>
+#include <graphics/texture_cache.h>
+#include <graphics/texture_atlas.h>
+#include <utilities/asset_archive.h>
+#include <engine/bvh.h>
+#include <engine/jobsystem.h>
+#include <engine/transform.h>
+#include <gl/instancing.h>
+#include <gl/shader.h>
+#include <gl/state_cache.h>
+
+namespace
+{
+class IndexCommand : public neko::RenderCommandInterface
+{
+public:
+    void Render() override {}
+    int index = 0;
+};
+
+#if defined(NEKO_GLES3) && !defined(EMSCRIPTEN)
+//Driver calls that went through the state cache, the glad pointers are replaced as there is no context
+std::size_t driverCallsNmb = 0;
+void APIENTRY CountUseProgram(GLuint) { driverCallsNmb++; }
+void APIENTRY CountBindBuffer(GLenum, GLuint) { driverCallsNmb++; }
+void APIENTRY CountEnable(GLenum) { driverCallsNmb++; }
+void APIENTRY CountDeleteProgram(GLuint) { driverCallsNmb++; }
+void APIENTRY CountDeleteBuffers(GLsizei, const GLuint*) { driverCallsNmb++; }
+
+//Active uniforms of a fake linked program, the block member has no location
+struct FakeUniform
+{
+    std::string_view name;
+    GLint arraySize;
+    GLint location;
+};
+const std::array<FakeUniform, 4> fakeUniforms =
+{{
+    {"model", 1, 0},
+    {"lights[0]", 3, 1},
+    {"view", 1, -1},
+    {"material.diffuse", 1, 4}
+}};
+
+void APIENTRY FakeGetProgramiv(GLuint, GLenum pname, GLint* params)
+{
+    *params = pname == GL_ACTIVE_UNIFORMS ? GLint(fakeUniforms.size()) : GLint(sizeof("material.diffuse"));
+}
+
+void APIENTRY FakeGetActiveUniform(GLuint, GLuint index, GLsizei, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    const auto& uniform = fakeUniforms[index];
+    std::copy(uniform.name.begin(), uniform.name.end(), name);
+    *length = GLsizei(uniform.name.size());
+    *size = uniform.arraySize;
+    *type = GL_FLOAT;
+}
+
+GLint APIENTRY FakeGetUniformLocation(GLuint, const GLchar* name)
+{
+    const std::string_view uniformName(name);
+    for (const auto& uniform : fakeUniforms)
+    {
+        if (uniform.name == uniformName)
+        {
+            return uniform.location;
+        }
+    }
+    if (uniformName == "lights[1]")
+        return 2;
+    if (uniformName == "lights[2]")
+        return 3;
+    return -1;
+}
+
+GLenum APIENTRY FakeGetError() { return GL_NO_ERROR; }
+
+//Instanced draws issued without a context, as (elements count, instances count)
+std::vector<std::pair<GLsizei, GLsizei>> instancedDraws;
+std::array<neko::Mat4f, 16> mappedInstances{};
+void APIENTRY FakeGenBuffers(GLsizei n, GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        buffers[i] = GLuint(i + 1);
+    }
+}
+void APIENTRY FakeBufferData(GLenum, GLsizeiptr, const void*, GLenum) {}
+void APIENTRY FakeBufferSubData(GLenum, GLintptr, GLsizeiptr, const void*) {}
+void APIENTRY FakeBindBufferBase(GLenum, GLuint, GLuint) {}
+void* APIENTRY FakeMapBufferRange(GLenum, GLintptr, GLsizeiptr, GLbitfield) { return mappedInstances.data(); }
+GLboolean APIENTRY FakeUnmapBuffer(GLenum) { return GL_TRUE; }
+GLuint APIENTRY FakeGetUniformBlockIndex(GLuint, const GLchar*) { return 0; }
+void APIENTRY FakeUniformBlockBinding(GLuint, GLuint, GLuint) {}
+void APIENTRY FakeBindVertexArray(GLuint) {}
+void APIENTRY FakeVertexAttribArray(GLuint) {}
+void APIENTRY FakeVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+void APIENTRY FakeVertexAttribDivisor(GLuint, GLuint) {}
+void APIENTRY FakeDrawElementsInstanced(GLenum, GLsizei count, GLenum, const void*, GLsizei instanceCount)
+{
+    instancedDraws.emplace_back(count, instanceCount);
+}
+
+class TestShader : public neko::gl::Shader
+{
+public:
+    void Reflect(GLuint program)
+    {
+        shaderProgram_ = program;
+        ReflectUniforms();
+        //Nothing to delete in the driver
+        shaderProgram_ = 0;
+    }
+};
+#endif
+}
+
+TEST(Graphics, RenderSortKey)
+{
+    const auto key = neko::render_key::MakeKey(2, 17, 5, 300, 1.0f);
+    EXPECT_EQ(neko::render_key::GetPass(key), 2u);
+    EXPECT_EQ(neko::render_key::GetShader(key), 17u);
+    EXPECT_EQ(neko::render_key::GetMaterial(key), 5u);
+    EXPECT_EQ(neko::render_key::GetTexture(key), 300u);
+    EXPECT_EQ(neko::render_key::GetDepth(key), (1u << neko::render_key::DEPTH_BITS) - 1u);
+    //The pass has priority over all the other fields
+    EXPECT_LT(neko::render_key::MakeKey(neko::render_key::DEFAULT_PASS, 4095, 4095, 65535, 1.0f),
+              neko::render_key::MakeKey(neko::render_key::OPAQUE_PASS, 0, 0, 0));
+    EXPECT_LT(neko::render_key::MakeKey(1, 4095, 4095, 65535, 1.0f), neko::render_key::MakeKey(2, 0, 0, 0));
+}
+
+TEST(Graphics, RenderQueueSort)
+{
+    const std::size_t commandsNmb = 1024;
+    neko::RenderQueue renderQueue(commandsNmb);
+    std::vector<IndexCommand> commands(commandsNmb);
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<std::uint32_t> shaderDistribution(1, 8);
+    std::uniform_real_distribution<float> depthDistribution(0.0f, 1.0f);
+    for (std::size_t i = 0; i < commandsNmb; i++)
+    {
+        commands[i].index = int(i);
+        //A quarter of the commands have the same key to check the submission order is kept
+        const auto key = i % 4 == 0 ?
+                         neko::render_key::MakeKey(1, 3, 0, 0) :
+                         neko::render_key::MakeKey(1, shaderDistribution(generator), 0, 0,
+                                                   depthDistribution(generator));
+        renderQueue.Push(&commands[i], key);
+    }
+    renderQueue.Sort();
+    ASSERT_EQ(renderQueue.Size(), commandsNmb);
+    const neko::RenderCommand* previous = nullptr;
+    for (const auto& renderCommand : renderQueue)
+    {
+        if (previous != nullptr)
+        {
+            EXPECT_LE(previous->key, renderCommand.key);
+            if (previous->key == renderCommand.key)
+            {
+                EXPECT_LT(static_cast<IndexCommand*>(previous->command)->index,
+                          static_cast<IndexCommand*>(renderCommand.command)->index);
+            }
+        }
+        previous = &renderCommand;
+    }
+
+    //Full queue drops the new commands
+    renderQueue.Push(&commands[0], 0);
+    EXPECT_EQ(renderQueue.Size(), commandsNmb);
+    EXPECT_EQ(renderQueue.GetDroppedCommandsNmb(), 1u);
+    renderQueue.Clear();
+    EXPECT_EQ(renderQueue.Size(), 0u);
+    //The next frame has room for the dropped command
+    EXPECT_GT(renderQueue.Capacity(), commandsNmb);
+    for (std::size_t i = 0; i <= commandsNmb; i++)
+    {
+        renderQueue.Push(&commands[i % commandsNmb], 0);
+    }
+    EXPECT_EQ(renderQueue.Size(), commandsNmb + 1);
+    EXPECT_EQ(renderQueue.GetDroppedCommandsNmb(), 0u);
+}
+
+TEST(Graphics, RenderQueueConcurrentPush)
+{
+    const std::size_t threadsNmb = 4;
+    const std::size_t commandsPerThread = 1000;
+    neko::RenderQueue renderQueue(threadsNmb * commandsPerThread);
+    std::vector<IndexCommand> commands(threadsNmb * commandsPerThread);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threadsNmb; t++)
+    {
+        threads.emplace_back([&renderQueue, &commands, t, commandsPerThread]
+        {
+            for (std::size_t i = 0; i < commandsPerThread; i++)
+            {
+                auto& command = commands[t * commandsPerThread + i];
+                command.index = int(t * commandsPerThread + i);
+                renderQueue.Push(&command, neko::render_key::MakeKey(0, std::uint32_t(t + 1), 0, 0));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    renderQueue.Sort();
+    ASSERT_EQ(renderQueue.Size(), threadsNmb * commandsPerThread);
+    //Each thread commands end up together, in their submission order
+    std::size_t i = 0;
+    for (const auto& renderCommand : renderQueue)
+    {
+        EXPECT_EQ(static_cast<IndexCommand*>(renderCommand.command)->index, int(i));
+        i++;
+    }
+}
+
+TEST(Graphics, UniformHandle)
+{
+    static constexpr neko::gl::UniformHandle modelUniform("model");
+    static_assert(modelUniform.hash == neko::gl::HashUniformName("model"));
+    const std::string modelName = "model";
+    EXPECT_EQ(neko::gl::UniformHandle(modelName).hash, modelUniform.hash);
+    EXPECT_NE(neko::gl::UniformHandle("view").hash, modelUniform.hash);
+    EXPECT_NE(neko::gl::UniformHandle("lights[1]").hash, neko::gl::UniformHandle("lights[0]").hash);
+}
+
+class TestInstancedBatchRenderer : public neko::InstancedBatchRenderer
+{
+public:
+    using neko::InstancedBatchRenderer::InstancedBatchRenderer;
+    void Render() override {}
+};
+
+#if defined(NEKO_GLES3) && !defined(EMSCRIPTEN)
+TEST(Graphics, StateCache)
+{
+    const auto useProgram = glad_glUseProgram;
+    const auto bindBuffer = glad_glBindBuffer;
+    const auto enable = glad_glEnable;
+    const auto deleteProgram = glad_glDeleteProgram;
+    const auto deleteBuffers = glad_glDeleteBuffers;
+    glad_glUseProgram = &CountUseProgram;
+    glad_glBindBuffer = &CountBindBuffer;
+    glad_glEnable = &CountEnable;
+    glad_glDeleteProgram = &CountDeleteProgram;
+    glad_glDeleteBuffers = &CountDeleteBuffers;
+    neko::gl::InvalidateStateCache();
+    neko::gl::ResetStateCacheStats();
+    driverCallsNmb = 0;
+
+    neko::gl::UseProgram(3);
+    neko::gl::UseProgram(3);
+    neko::gl::Enable(GL_BLEND);
+    neko::gl::Enable(GL_BLEND);
+    neko::gl::BindBuffer(GL_ARRAY_BUFFER, 5);
+    neko::gl::BindBuffer(GL_ARRAY_BUFFER, 5);
+    EXPECT_EQ(driverCallsNmb, 3u);
+    //Capabilities out of the cache are always issued
+    neko::gl::Enable(GL_DITHER);
+    neko::gl::Enable(GL_DITHER);
+    EXPECT_EQ(driverCallsNmb, 5u);
+    auto stats = neko::gl::GetStateCacheStats();
+    EXPECT_EQ(stats.issuedCalls, 5u);
+    EXPECT_EQ(stats.filteredCalls, 3u);
+
+    neko::gl::InvalidateStateCache();
+    neko::gl::UseProgram(3);
+    neko::gl::Enable(GL_BLEND);
+    neko::gl::BindBuffer(GL_ARRAY_BUFFER, 5);
+    EXPECT_EQ(driverCallsNmb, 8u);
+
+    //The driver can give the deleted names to new objects
+    const GLuint buffer = 5;
+    neko::gl::DeleteProgram(3);
+    neko::gl::DeleteBuffers(1, &buffer);
+    neko::gl::UseProgram(3);
+    neko::gl::BindBuffer(GL_ARRAY_BUFFER, 5);
+    neko::gl::Enable(GL_BLEND);
+    EXPECT_EQ(driverCallsNmb, 12u);
+    stats = neko::gl::GetStateCacheStats();
+    EXPECT_EQ(stats.issuedCalls, 10u);
+    EXPECT_EQ(stats.filteredCalls, 4u);
+
+    neko::gl::InvalidateStateCache();
+    neko::gl::ResetStateCacheStats();
+    glad_glUseProgram = useProgram;
+    glad_glBindBuffer = bindBuffer;
+    glad_glEnable = enable;
+    glad_glDeleteProgram = deleteProgram;
+    glad_glDeleteBuffers = deleteBuffers;
+}
+#endif
+
+#if defined(NEKO_GLES3) && !defined(EMSCRIPTEN)
+TEST(Graphics, ShaderUniformReflection)
+{
+    const auto getProgramiv = glad_glGetProgramiv;
+    const auto getActiveUniform = glad_glGetActiveUniform;
+    const auto getUniformLocation = glad_glGetUniformLocation;
+    const auto getError = glad_glGetError;
+    glad_glGetProgramiv = &FakeGetProgramiv;
+    glad_glGetActiveUniform = &FakeGetActiveUniform;
+    glad_glGetUniformLocation = &FakeGetUniformLocation;
+    glad_glGetError = &FakeGetError;
+
+    TestShader shader;
+    shader.Reflect(1);
+    static constexpr neko::gl::UniformHandle modelUniform("model");
+    EXPECT_EQ(shader.GetUniformLocation(modelUniform), 0);
+    EXPECT_EQ(shader.GetUniformLocation("material.diffuse"), 4);
+    //Arrays are found with and without the index
+    EXPECT_EQ(shader.GetUniformLocation("lights"), 1);
+    EXPECT_EQ(shader.GetUniformLocation("lights[0]"), 1);
+    EXPECT_EQ(shader.GetUniformLocation("lights[1]"), 2);
+    EXPECT_EQ(shader.GetUniformLocation("lights[2]"), 3);
+    EXPECT_EQ(shader.GetUniformLocation("lights[3]"), neko::gl::INVALID_UNIFORM_LOCATION);
+    EXPECT_EQ(shader.GetUniformLocation("view"), neko::gl::INVALID_UNIFORM_LOCATION);
+    EXPECT_EQ(shader.GetUniformLocation("projection"), neko::gl::INVALID_UNIFORM_LOCATION);
+    shader.Destroy();
+    EXPECT_EQ(shader.GetUniformLocation(modelUniform), neko::gl::INVALID_UNIFORM_LOCATION);
+
+    glad_glGetProgramiv = getProgramiv;
+    glad_glGetActiveUniform = getActiveUniform;
+    glad_glGetUniformLocation = getUniformLocation;
+    glad_glGetError = getError;
+}
+#endif
+
+TEST(Graphics, InstancedBatchRenderer)
+{
+    neko::EntityManager entityManager;
+    neko::Transform3dManager transformManager(entityManager);
+    TestInstancedBatchRenderer batchRenderer(entityManager, transformManager);
+    const neko::Index entityNmb = 16u;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        transformManager.AddComponent(entity);
+        transformManager.SetPosition(entity, neko::Vec3f(float(i), 0.0f, 0.0f));
+    }
+    transformManager.Update();
+    transformManager.SyncBuffers();
+
+    //Entities sharing the same mesh and material end up in the same batch
+    const auto cubeBatch = batchRenderer.GetBatch({1u, 1u, 0u});
+    const auto sphereBatch = batchRenderer.GetBatch({2u, 1u, 0u});
+    EXPECT_NE(cubeBatch, sphereBatch);
+    EXPECT_EQ(batchRenderer.GetBatch({1u, 1u, 0u}), cubeBatch);
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        batchRenderer.AddInstance(i, i % 4 == 0 ? sphereBatch : cubeBatch);
+    }
+    EXPECT_EQ(batchRenderer.GetInstancesNmb(sphereBatch), entityNmb / 4);
+    EXPECT_EQ(batchRenderer.GetInstancesNmb(cubeBatch), entityNmb - entityNmb / 4);
+
+    std::vector<neko::Mat4f> instances(entityNmb);
+    //The render thread does not see the instances before the sync
+    EXPECT_EQ(batchRenderer.CopyInstanceTransforms(cubeBatch, instances.data()), 0u);
+    batchRenderer.SyncBuffers();
+    ASSERT_EQ(batchRenderer.CopyInstanceTransforms(sphereBatch, instances.data()), entityNmb / 4);
+    for (neko::Index i = 0u; i < entityNmb / 4; i++)
+    {
+        EXPECT_LT(neko::Mat4f::MatrixDifference(instances[i], transformManager.GetCurrentComponent(i * 4)),
+                  0.0001f);
+    }
+
+    //Moving an instance to another batch
+    batchRenderer.AddInstance(1u, sphereBatch);
+    batchRenderer.RemoveInstance(2u);
+    EXPECT_EQ(batchRenderer.GetInstanceBatch(1u), sphereBatch);
+    EXPECT_EQ(batchRenderer.GetInstanceBatch(2u), neko::INVALID_INSTANCED_BATCH_ID);
+    batchRenderer.SyncBuffers();
+    EXPECT_EQ(batchRenderer.CopyInstanceTransforms(sphereBatch, instances.data()), entityNmb / 4 + 1);
+    EXPECT_LT(neko::Mat4f::MatrixDifference(instances[entityNmb / 4], transformManager.GetCurrentComponent(1u)),
+              0.0001f);
+    EXPECT_EQ(batchRenderer.CopyInstanceTransforms(cubeBatch, instances.data()), entityNmb - entityNmb / 4 - 2);
+
+    //Destroyed entities leave their batch
+    entityManager.DestroyEntity(1u);
+    EXPECT_EQ(batchRenderer.GetInstanceBatch(1u), neko::INVALID_INSTANCED_BATCH_ID);
+    EXPECT_EQ(batchRenderer.GetInstancesNmb(sphereBatch), entityNmb / 4);
+    batchRenderer.SyncBuffers();
+    EXPECT_EQ(batchRenderer.CopyInstanceTransforms(sphereBatch, instances.data()), entityNmb / 4);
+}
+
+#if defined(NEKO_GLES3) && !defined(EMSCRIPTEN)
+TEST(Graphics, InstancedModelBatch)
+{
+    const auto genBuffers = glad_glGenBuffers;
+    const auto bindBuffer = glad_glBindBuffer;
+    const auto bufferData = glad_glBufferData;
+    const auto bufferSubData = glad_glBufferSubData;
+    const auto bindBufferBase = glad_glBindBufferBase;
+    const auto mapBufferRange = glad_glMapBufferRange;
+    const auto unmapBuffer = glad_glUnmapBuffer;
+    const auto deleteBuffers = glad_glDeleteBuffers;
+    const auto getUniformBlockIndex = glad_glGetUniformBlockIndex;
+    const auto uniformBlockBinding = glad_glUniformBlockBinding;
+    const auto useProgram = glad_glUseProgram;
+    const auto bindVertexArray = glad_glBindVertexArray;
+    const auto enableVertexAttribArray = glad_glEnableVertexAttribArray;
+    const auto disableVertexAttribArray = glad_glDisableVertexAttribArray;
+    const auto vertexAttribPointer = glad_glVertexAttribPointer;
+    const auto vertexAttribDivisor = glad_glVertexAttribDivisor;
+    const auto drawElementsInstanced = glad_glDrawElementsInstanced;
+    const auto getError = glad_glGetError;
+    glad_glGenBuffers = &FakeGenBuffers;
+    glad_glBindBuffer = &CountBindBuffer;
+    glad_glBufferData = &FakeBufferData;
+    glad_glBufferSubData = &FakeBufferSubData;
+    glad_glBindBufferBase = &FakeBindBufferBase;
+    glad_glMapBufferRange = &FakeMapBufferRange;
+    glad_glUnmapBuffer = &FakeUnmapBuffer;
+    glad_glDeleteBuffers = &CountDeleteBuffers;
+    glad_glGetUniformBlockIndex = &FakeGetUniformBlockIndex;
+    glad_glUniformBlockBinding = &FakeUniformBlockBinding;
+    glad_glUseProgram = &CountUseProgram;
+    glad_glBindVertexArray = &FakeBindVertexArray;
+    glad_glEnableVertexAttribArray = &FakeVertexAttribArray;
+    glad_glDisableVertexAttribArray = &FakeVertexAttribArray;
+    glad_glVertexAttribPointer = &FakeVertexAttribPointer;
+    glad_glVertexAttribDivisor = &FakeVertexAttribDivisor;
+    glad_glDrawElementsInstanced = &FakeDrawElementsInstanced;
+    glad_glGetError = &FakeGetError;
+    neko::gl::InvalidateStateCache();
+    neko::Camera3D camera;
+    neko::CameraLocator::provide(&camera);
+
+    neko::EntityManager entityManager;
+    neko::Transform3dManager transformManager(entityManager);
+    neko::gl::InstancedBatchRenderer batchRenderer(entityManager, transformManager);
+    batchRenderer.Init();
+    const neko::Index entityNmb = neko::Index(mappedInstances.size());
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        transformManager.AddComponent(entity);
+        transformManager.SetPosition(entity, neko::Vec3f(0.0f, float(i), 0.0f));
+    }
+    transformManager.Update();
+    transformManager.SyncBuffers();
+
+    //A model made of two meshes, each one binds its own textures
+    std::size_t boundMeshesNmb = 0;
+    const auto bindMesh = [&boundMeshesNmb](const neko::gl::Shader&) { boundMeshesNmb++; };
+    const std::vector<neko::gl::InstancedMesh> meshes =
+    {
+        {1u, 36, GL_TRIANGLES, bindMesh},
+        {2u, 12, GL_TRIANGLES, bindMesh}
+    };
+    neko::gl::Shader shader;
+    const auto modelBatch = batchRenderer.AddBatch(meshes, shader);
+    EXPECT_EQ(batchRenderer.AddBatch(meshes, shader), modelBatch);
+    EXPECT_EQ(batchRenderer.GetDrawCallsNmb(), 0u);
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        batchRenderer.AddInstance(i, modelBatch);
+    }
+    EXPECT_EQ(batchRenderer.GetDrawCallsNmb(), meshes.size());
+
+    batchRenderer.SyncBuffers();
+    instancedDraws.clear();
+    batchRenderer.Render();
+    //One draw per mesh for all the instances
+    ASSERT_EQ(instancedDraws.size(), meshes.size());
+    EXPECT_EQ(instancedDraws[0], std::make_pair(GLsizei(36), GLsizei(entityNmb)));
+    EXPECT_EQ(instancedDraws[1], std::make_pair(GLsizei(12), GLsizei(entityNmb)));
+    EXPECT_EQ(boundMeshesNmb, meshes.size());
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        EXPECT_LT(neko::Mat4f::MatrixDifference(mappedInstances[i], transformManager.GetCurrentComponent(i)),
+                  0.0001f);
+    }
+    batchRenderer.Destroy();
+
+    neko::CameraLocator::provide(nullptr);
+    neko::gl::InvalidateStateCache();
+    glad_glGenBuffers = genBuffers;
+    glad_glBindBuffer = bindBuffer;
+    glad_glBufferData = bufferData;
+    glad_glBufferSubData = bufferSubData;
+    glad_glBindBufferBase = bindBufferBase;
+    glad_glMapBufferRange = mapBufferRange;
+    glad_glUnmapBuffer = unmapBuffer;
+    glad_glDeleteBuffers = deleteBuffers;
+    glad_glGetUniformBlockIndex = getUniformBlockIndex;
+    glad_glUniformBlockBinding = uniformBlockBinding;
+    glad_glUseProgram = useProgram;
+    glad_glBindVertexArray = bindVertexArray;
+    glad_glEnableVertexAttribArray = enableVertexAttribArray;
+    glad_glDisableVertexAttribArray = disableVertexAttribArray;
+    glad_glVertexAttribPointer = vertexAttribPointer;
+    glad_glVertexAttribDivisor = vertexAttribDivisor;
+    glad_glDrawElementsInstanced = drawElementsInstanced;
+    glad_glGetError = getError;
+}
+#endif
+
+TEST(Graphics, AtlasPacker)
+{
+    const neko::Vec2i atlasSize(64, 64);
+    neko::AtlasPacker packer(atlasSize);
+    std::vector<std::pair<neko::Vec2i, neko::Vec2i>> rects;
+    neko::Vec2i position;
+    //Mixed heights to fill several shelves
+    for (int i = 0; i < 64; i++)
+    {
+        const neko::Vec2i size(7 + i % 3, 5 + i % 5);
+        if (!packer.Insert(size, position))
+            break;
+        EXPECT_LE(position.x + size.x, atlasSize.x);
+        EXPECT_LE(position.y + size.y, atlasSize.y);
+        rects.emplace_back(position, size);
+    }
+    EXPECT_GT(rects.size(), 16u);
+    for (std::size_t i = 0; i < rects.size(); i++)
+    {
+        for (std::size_t j = i + 1; j < rects.size(); j++)
+        {
+            const auto& [positionA, sizeA] = rects[i];
+            const auto& [positionB, sizeB] = rects[j];
+            const bool overlap = positionA.x < positionB.x + sizeB.x && positionB.x < positionA.x + sizeA.x &&
+                                 positionA.y < positionB.y + sizeB.y && positionB.y < positionA.y + sizeA.y;
+            EXPECT_FALSE(overlap);
+        }
+    }
+    EXPECT_FALSE(packer.Insert(atlasSize, position));
+    packer.Clear();
+    EXPECT_TRUE(packer.Insert(neko::Vec2i(32, 32), position));
+    EXPECT_EQ(position.x, 0);
+    EXPECT_EQ(position.y, 0);
+}
+
+TEST(Graphics, FrustumCulling)
+{
+    neko::Camera3D camera;
+    camera.position = neko::Vec3f(0.0f, 0.0f, 10.0f);
+    camera.WorldLookAt(neko::Vec3f::zero);
+    camera.farPlane = 50.0f;
+    const auto frustum = neko::Frustum::FromCamera(camera);
+    EXPECT_TRUE(frustum.ContainsSphere({neko::Vec3f::zero, 0.1f}));
+    EXPECT_FALSE(frustum.ContainsSphere({neko::Vec3f(0.0f, 0.0f, 20.0f), 1.0f}));
+    EXPECT_FALSE(frustum.ContainsSphere({neko::Vec3f(0.0f, 0.0f, -100.0f), 1.0f}));
+    EXPECT_FALSE(frustum.ContainsSphere({neko::Vec3f(100.0f, 0.0f, 0.0f), 1.0f}));
+
+    //The packed culling should match the scalar tests, with a partially filled last pack
+    const std::size_t boundsNmb = 1'003;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> positionDistribution(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.1f, 3.0f);
+    neko::BoundingSpheres spheres;
+    neko::BoundingBoxes boxes;
+    spheres.Resize(boundsNmb);
+    boxes.Resize(boundsNmb);
+    std::vector<std::uint32_t> expectedSpheres;
+    std::vector<std::uint32_t> expectedBoxes;
+    for (std::uint32_t i = 0; i < boundsNmb; i++)
+    {
+        const neko::Vec3f center(positionDistribution(generator), positionDistribution(generator),
+                                 positionDistribution(generator));
+        const neko::Sphere sphere{center, sizeDistribution(generator)};
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(center, neko::Vec3f(sizeDistribution(generator), sizeDistribution(generator),
+                                                   sizeDistribution(generator)));
+        spheres.Set(i, sphere);
+        boxes.Set(i, aabb);
+        if (frustum.ContainsSphere(sphere))
+            expectedSpheres.push_back(i);
+        if (frustum.IntersectAabb(aabb))
+            expectedBoxes.push_back(i);
+    }
+    EXPECT_GT(expectedSpheres.size(), 0u);
+    EXPECT_LT(expectedSpheres.size(), boundsNmb);
+    //Small grain size to compact several chunks
+    neko::FrustumCuller culler(64);
+    EXPECT_EQ(culler.Cull(frustum, spheres), expectedSpheres);
+    EXPECT_EQ(culler.Cull(frustum, boxes), expectedBoxes);
+
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    EXPECT_EQ(culler.Cull(frustum, spheres, jobSystem), expectedSpheres);
+    EXPECT_EQ(culler.Cull(frustum, boxes, jobSystem), expectedBoxes);
+    jobSystem.Destroy();
+}
+
+static std::vector<neko::Entity> SortedEntities(std::vector<neko::Entity> entities)
+{
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+TEST(Graphics, DynamicBvh)
+{
+    neko::Camera3D camera;
+    camera.position = neko::Vec3f(0.0f, 0.0f, 10.0f);
+    camera.WorldLookAt(neko::Vec3f::zero);
+    camera.farPlane = 50.0f;
+    const auto frustum = neko::Frustum::FromCamera(camera);
+
+    //More entities than a rebuild task to build the upper tree in parallel
+    const neko::Entity entitiesNmb = 3'000;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> positionDistribution(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.1f, 2.0f);
+    std::vector<neko::Aabb3d> aabbs(entitiesNmb);
+    const auto randomAabb = [&]()
+    {
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(neko::Vec3f(positionDistribution(generator), positionDistribution(generator),
+                                           positionDistribution(generator)),
+                               neko::Vec3f(sizeDistribution(generator), sizeDistribution(generator),
+                                           sizeDistribution(generator)));
+        return aabb;
+    };
+    neko::DynamicBvh bvh;
+    for (neko::Entity entity = 0; entity < entitiesNmb; entity++)
+    {
+        aabbs[entity] = randomAabb();
+        bvh.Insert(entity, aabbs[entity]);
+    }
+    //Remove every tenth entity
+    for (neko::Entity entity = 0; entity < entitiesNmb; entity += 10)
+    {
+        bvh.Remove(entity);
+    }
+    //Move a third of them
+    for (neko::Entity entity = 1; entity < entitiesNmb; entity += 3)
+    {
+        if (!bvh.Contains(entity))
+            continue;
+        aabbs[entity] = randomAabb();
+        bvh.Update(entity, aabbs[entity]);
+    }
+    EXPECT_EQ(bvh.GetLeavesNmb(), entitiesNmb - entitiesNmb / 10);
+
+    neko::Aabb3d queryAabb;
+    queryAabb.FromCenterExtends(neko::Vec3f::zero, neko::Vec3f(15.0f, 15.0f, 15.0f));
+    const neko::Vec3f rayOrigin(-70.0f, 0.5f, 0.5f);
+    const neko::Vec3f rayDirection(1.0f, 0.05f, 0.02f);
+    std::vector<neko::Entity> expectedFrustum;
+    std::vector<neko::Entity> expectedAabb;
+    neko::Entity expectedHit = neko::INVALID_ENTITY;
+    float closestDistance = std::numeric_limits<float>::max();
+    for (neko::Entity entity = 0; entity < entitiesNmb; entity++)
+    {
+        if (!bvh.Contains(entity))
+            continue;
+        const auto& aabb = aabbs[entity];
+        if (frustum.IntersectAabb(aabb))
+            expectedFrustum.push_back(entity);
+        if (aabb.lowerLeftBound.x <= queryAabb.upperRightBound.x && queryAabb.lowerLeftBound.x <= aabb.upperRightBound.x &&
+            aabb.lowerLeftBound.y <= queryAabb.upperRightBound.y && queryAabb.lowerLeftBound.y <= aabb.upperRightBound.y &&
+            aabb.lowerLeftBound.z <= queryAabb.upperRightBound.z && queryAabb.lowerLeftBound.z <= aabb.upperRightBound.z)
+            expectedAabb.push_back(entity);
+        //Slab test along the normalized direction
+        const auto direction = rayDirection.Normalized();
+        float enter = 0.0f;
+        float exit = std::numeric_limits<float>::max();
+        for (std::size_t axis = 0; axis < 3; axis++)
+        {
+            const float near = (aabb.lowerLeftBound[axis] - rayOrigin[axis]) / direction[axis];
+            const float far = (aabb.upperRightBound[axis] - rayOrigin[axis]) / direction[axis];
+            enter = std::max(enter, std::min(near, far));
+            exit = std::min(exit, std::max(near, far));
+        }
+        if (enter <= exit && enter < closestDistance)
+        {
+            closestDistance = enter;
+            expectedHit = entity;
+        }
+    }
+    EXPECT_GT(expectedFrustum.size(), 0u);
+    ASSERT_NE(expectedHit, neko::INVALID_ENTITY);
+
+    const auto checkQueries = [&]()
+    {
+        std::vector<neko::Entity> result;
+        bvh.QueryFrustum(frustum, result);
+        EXPECT_EQ(SortedEntities(result), expectedFrustum);
+        result.clear();
+        bvh.QueryAabb(queryAabb, result);
+        EXPECT_EQ(SortedEntities(result), expectedAabb);
+        neko::BvhRaycastHit hit;
+        EXPECT_TRUE(bvh.Raycast(rayOrigin, rayDirection, 1000.0f, hit));
+        EXPECT_EQ(hit.entity, expectedHit);
+        EXPECT_NEAR(hit.distance, closestDistance, 0.001f);
+    };
+    checkQueries();
+    //The incremental tree stays balanced
+    EXPECT_LT(bvh.GetHeight(), 32);
+
+    bvh.Rebuild();
+    checkQueries();
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    bvh.Rebuild(&jobSystem);
+    jobSystem.Destroy();
+    checkQueries();
+    //Incremental updates still work on a rebuilt tree
+    bvh.Remove(1);
+    EXPECT_FALSE(bvh.Contains(1));
+    bvh.Insert(1, aabbs[1]);
+    checkQueries();
+
+    neko::Mat4f transform = neko::Transform3d::Translate(neko::Mat4f::Identity, neko::Vec3f(1.0f, 2.0f, 3.0f));
+    neko::Aabb3d unitAabb;
+    unitAabb.FromCenterExtends(neko::Vec3f::zero, neko::Vec3f::one);
+    const auto worldAabb = neko::TransformBvh::TransformAabb(transform, unitAabb);
+    EXPECT_NEAR(worldAabb.lowerLeftBound.x, 0.0f, 0.0001f);
+    EXPECT_NEAR(worldAabb.upperRightBound.z, 4.0f, 0.0001f);
+}
+
+namespace
+{
+class TestRenderer : public neko::Renderer
+{
+public:
+    using neko::Renderer::PreRender;
+    void ClearScreen() override {}
+};
+
+class TestTextureManager : public neko::TextureManager
+{
+public:
+    using neko::TextureManager::UploadTextures;
+    std::vector<neko::TextureId> createdTextures;
+protected:
+    void CreateTexture() override
+    {
+        createdTextures.push_back(currentUploadedTexture_.textureId);
+    }
+};
+}
+
+TEST(Graphics, PreRenderBudget)
+{
+    TestRenderer renderer;
+    renderer.SetPreRenderBudget(neko::microseconds(0));
+    int executedNmb = 0;
+    int executedDuringDependency = -1;
+    //Pre render while the dependency is running, started but not done
+    neko::Job dependency([&renderer, &executedNmb, &executedDuringDependency]
+    {
+        renderer.PreRender();
+        executedDuringDependency = executedNmb;
+    });
+    neko::Job firstJob([&executedNmb] { executedNmb++; });
+    neko::Job waitingJob([&executedNmb] { executedNmb++; });
+    waitingJob.AddDependency(&dependency);
+    renderer.AddPreRenderJob(&firstJob);
+    renderer.AddPreRenderJob(&waitingJob);
+    //Without budget, only one job per frame
+    renderer.PreRender();
+    EXPECT_EQ(executedNmb, 1);
+    //The waiting job is kept until its dependency is done
+    renderer.PreRender();
+    EXPECT_EQ(executedNmb, 1);
+    dependency.Execute();
+    EXPECT_EQ(executedDuringDependency, 1);
+    renderer.PreRender();
+    EXPECT_EQ(executedNmb, 2);
+}
+
+TEST(Graphics, TextureUploadBudget)
+{
+    TestTextureManager textureManager;
+    const int imageSize = 64;
+    const std::size_t imageBytes = imageSize * imageSize * 4;
+    for (int i = 0; i < 5; i++)
+    {
+        neko::TextureInfo textureInfo;
+        textureInfo.textureId = sole::uuid4();
+        textureInfo.image.width = imageSize;
+        textureInfo.image.height = imageSize;
+        textureInfo.image.nbChannels = 4;
+        //Images are released with stbi_image_free
+        textureInfo.image.data = static_cast<unsigned char*>(std::malloc(imageBytes));
+        textureManager.UploadToGpu(std::move(textureInfo));
+    }
+    //The budget is never exceeded, the second texture waits for the next frame
+    textureManager.SetUploadBudget(2 * imageBytes - 1);
+    textureManager.UploadTextures();
+    EXPECT_EQ(textureManager.createdTextures.size(), 1u);
+    textureManager.SetUploadBudget(2 * imageBytes);
+    textureManager.UploadTextures();
+    EXPECT_EQ(textureManager.createdTextures.size(), 3u);
+    //At least one texture per frame
+    textureManager.SetUploadBudget(0);
+    textureManager.UploadTextures();
+    EXPECT_EQ(textureManager.createdTextures.size(), 4u);
+    textureManager.SetUploadBudget(neko::DEFAULT_TEXTURE_UPLOAD_BUDGET);
+    textureManager.UploadTextures();
+    EXPECT_EQ(textureManager.createdTextures.size(), 5u);
+    const auto metrics = textureManager.GetLoadMetrics();
+    EXPECT_EQ(metrics.uploadedNmb, 5u);
+    EXPECT_EQ(metrics.uploadedBytes, 5 * imageBytes);
+}
+
+namespace
+{
+neko::BufferFile CopyBufferFile(const neko::BufferFile& bufferFile)
+{
+    neko::BufferFile copy;
+    copy.dataLength = bufferFile.dataLength;
+    copy.dataBuffer = new unsigned char[copy.dataLength + 1];
+    std::memcpy(copy.dataBuffer, bufferFile.dataBuffer, copy.dataLength + 1);
+    return copy;
+}
+}
+
+TEST(Graphics, TextureCache)
+{
+    const int width = 5;
+    const int height = 3;
+    const int nbChannels = 3;
+    neko::Image image;
+    image.width = width;
+    image.height = height;
+    image.nbChannels = nbChannels;
+    //Images are released with stbi_image_free
+    image.data = static_cast<unsigned char*>(std::malloc(width * height * nbChannels));
+    for (int i = 0; i < width * height * nbChannels; i++)
+    {
+        image.data[i] = static_cast<unsigned char>(i * 7);
+    }
+    const std::string stamp = "42:7:2";
+    const auto cacheFile = neko::WriteTextureCache(image, neko::Texture::DEFAULT, stamp);
+
+    neko::CachedTexture cachedTexture;
+    ASSERT_TRUE(neko::ReadTextureCache(CopyBufferFile(cacheFile), stamp, cachedTexture));
+    EXPECT_FALSE(cachedTexture.IsCompressed());
+    EXPECT_EQ(cachedTexture.glInternalFormat, static_cast<std::uint32_t>(GL_RGB8));
+    EXPECT_EQ(cachedTexture.glFormat, static_cast<std::uint32_t>(GL_RGB));
+    EXPECT_EQ(cachedTexture.glType, static_cast<std::uint32_t>(GL_UNSIGNED_BYTE));
+    //5x3, 2x1 and 1x1 with the rows aligned to 4 bytes
+    ASSERT_EQ(cachedTexture.levels.size(), 3u);
+    EXPECT_EQ(cachedTexture.levels[1].width, 2);
+    EXPECT_EQ(cachedTexture.levels[1].height, 1);
+    EXPECT_EQ(cachedTexture.levels[0].size, 16u * height);
+    EXPECT_EQ(cachedTexture.levels[1].size, 8u);
+    EXPECT_EQ(cachedTexture.levels[2].size, 4u);
+    EXPECT_EQ(cachedTexture.GetDataSize(), 16u * height + 8u + 4u);
+    for (int y = 0; y < height; y++)
+    {
+        EXPECT_EQ(std::memcmp(cachedTexture.levels[0].data + y * 16,
+                              image.data + y * width * nbChannels, width * nbChannels), 0);
+    }
+    //Box filter of the first 2x2 pixels
+    const int firstMipValue = (image.data[0] + image.data[3] + image.data[15] + image.data[18] + 2) / 4;
+    EXPECT_EQ(cachedTexture.levels[1].data[0], firstMipValue);
+
+    //Another source image or other flags
+    EXPECT_FALSE(neko::ReadTextureCache(CopyBufferFile(cacheFile), "43:7:2", cachedTexture));
+    EXPECT_TRUE(cachedTexture.levels.empty());
+    auto truncatedFile = CopyBufferFile(cacheFile);
+    truncatedFile.dataLength -= 2;
+    EXPECT_FALSE(neko::ReadTextureCache(std::move(truncatedFile), stamp, cachedTexture));
+
+    const auto singleLevelFile = neko::WriteTextureCache(image, neko::Texture::SMOOTH_TEXTURE, stamp);
+    ASSERT_TRUE(neko::ReadTextureCache(CopyBufferFile(singleLevelFile), stamp, cachedTexture));
+    EXPECT_EQ(cachedTexture.levels.size(), 1u);
+
+    //ETC2 payloads written offline are used, other compressed formats need extensions
+    auto compressedFile = CopyBufferFile(cacheFile);
+    const std::uint32_t zero = 0;
+    const std::uint32_t etc2Format = GL_COMPRESSED_RGBA8_ETC2_EAC;
+    std::memcpy(compressedFile.dataBuffer + 16, &zero, sizeof(zero));
+    std::memcpy(compressedFile.dataBuffer + 24, &zero, sizeof(zero));
+    std::memcpy(compressedFile.dataBuffer + 28, &etc2Format, sizeof(etc2Format));
+    auto astcFile = CopyBufferFile(compressedFile);
+    ASSERT_TRUE(neko::ReadTextureCache(std::move(compressedFile), stamp, cachedTexture));
+    EXPECT_TRUE(cachedTexture.IsCompressed());
+    EXPECT_EQ(cachedTexture.glInternalFormat, etc2Format);
+    const std::uint32_t astcFormat = 0x93B0;
+    std::memcpy(astcFile.dataBuffer + 28, &astcFormat, sizeof(astcFormat));
+    EXPECT_FALSE(neko::ReadTextureCache(std::move(astcFile), stamp, cachedTexture));
+
+    //sRGB mipmaps are averaged in linear space, a uniform color stays the same
+    std::memset(image.data, 200, width * height * nbChannels);
+    const auto srgbFile = neko::WriteTextureCache(image, neko::Texture::TextureFlags(
+        neko::Texture::DEFAULT | neko::Texture::GAMMA_CORRECTION), stamp);
+    ASSERT_TRUE(neko::ReadTextureCache(CopyBufferFile(srgbFile), stamp, cachedTexture));
+    EXPECT_EQ(cachedTexture.glInternalFormat, static_cast<std::uint32_t>(GL_SRGB8));
+    EXPECT_EQ(cachedTexture.levels[2].data[0], 200);
+    EXPECT_EQ(cachedTexture.levels[2].data[2], 200);
+    cachedTexture.Destroy();
+}
+
+namespace
+{
+class StampArchive : public neko::NullAssetArchive
+{
+public:
+    [[nodiscard]] const neko::AssetArchiveEntry* FindEntry([[maybe_unused]] std::string_view path) const override
+    {
+        return &entry;
+    }
+    neko::AssetArchiveEntry entry;
+};
+}
+
+TEST(Graphics, TextureCacheArchiveStamp)
+{
+    StampArchive archive;
+    archive.entry.originalSize = 1024;
+    archive.entry.contentCrc = 0x1234u;
+    neko::AssetArchiveLocator::provide(&archive);
+    const auto stamp = neko::GetTextureCacheStamp("sprites/wall.jpg", neko::Texture::DEFAULT);
+    //An edited asset of the same size does not reuse the cached texture
+    archive.entry.contentCrc = 0x4321u;
+    EXPECT_NE(neko::GetTextureCacheStamp("sprites/wall.jpg", neko::Texture::DEFAULT), stamp);
+    archive.entry.contentCrc = 0x1234u;
+    EXPECT_EQ(neko::GetTextureCacheStamp("sprites/wall.jpg", neko::Texture::DEFAULT), stamp);
+    neko::AssetArchiveLocator::provide(nullptr);
+}
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include <engine/jobsystem.h>
+#include <engine/engine.h>
+#include <engine/window.h>
+#include <graphics/graphics.h>
 #include <atomic>
 #include <thread>
+#include <vector>
 //#include <easy/profiler.h>
 
 namespace neko
@@ -54,4 +58,303 @@ TEST(Engine, TestJobSystem)
     //EXPECT_EQ(TASKS_COUNT, doneTasks);
 }
 
+TEST(Engine, TestJobSystemWorkStealing)
+{
+    const size_t TASKS_COUNT = 64;
+    std::atomic<unsigned int> doneTasks = 0;
+    std::vector<std::unique_ptr<Job>> jobs(TASKS_COUNT);
+    std::generate(jobs.begin(), jobs.end(),
+            [&doneTasks]{ return std::make_unique<Job>([&doneTasks] { ++doneTasks; });
+    });
+
+    JobSystem jobSystem;
+    jobSystem.Init();
+    //Jobs scheduled from an other worker go to its own deque and get stolen by the others
+    Job spawnJob([&jobSystem, &jobs]
+    {
+        for (auto& job : jobs)
+        {
+            jobSystem.ScheduleJob(job.get(), JobThreadType::OTHER_THREAD);
+        }
+    });
+    jobSystem.ScheduleJob(&spawnJob, JobThreadType::OTHER_THREAD);
+    spawnJob.Join();
+    for (auto& job : jobs)
+    {
+        job->Join();
+    }
+    jobSystem.Destroy();
+    EXPECT_EQ(TASKS_COUNT, doneTasks);
+}
+
+TEST(Engine, TestJobSystemThreadAffinity)
+{
+    JobSystem jobSystem;
+    jobSystem.Init();
+    std::thread::id renderThreadId;
+    Job firstRenderJob([&renderThreadId] { renderThreadId = std::this_thread::get_id(); });
+    bool sameThread = false;
+    Job secondRenderJob([&renderThreadId, &sameThread] { sameThread = renderThreadId == std::this_thread::get_id(); });
+    secondRenderJob.AddDependency(&firstRenderJob);
+    jobSystem.ScheduleJob(&firstRenderJob, JobThreadType::RENDER_THREAD);
+    jobSystem.ScheduleJob(&secondRenderJob, JobThreadType::RENDER_THREAD);
+    secondRenderJob.Join();
+    jobSystem.Destroy();
+    EXPECT_TRUE(sameThread);
+    EXPECT_NE(renderThreadId, std::this_thread::get_id());
+}
+
+TEST(Engine, TestJobSystemDependencies)
+{
+    const size_t TASKS_COUNT = 32;
+    std::vector<size_t> executionOrder;
+    executionOrder.reserve(TASKS_COUNT);
+    std::vector<std::unique_ptr<Job>> jobs;
+    jobs.reserve(TASKS_COUNT);
+    for (size_t i = 0; i < TASKS_COUNT; ++i)
+    {
+        jobs.push_back(std::make_unique<Job>([&executionOrder, i] { executionOrder.push_back(i); }));
+        if (i > 0)
+        {
+            jobs[i]->AddDependency(jobs[i - 1].get());
+        }
+    }
+
+    JobSystem jobSystem;
+    jobSystem.Init();
+    //Scheduled in reverse order, each job is only pushed when its dependency is done
+    for (size_t i = TASKS_COUNT; i > 0; --i)
+    {
+        jobSystem.ScheduleJob(jobs[i - 1].get(), JobThreadType::OTHER_THREAD);
+    }
+    jobs.back()->Join();
+    jobSystem.Destroy();
+
+    ASSERT_EQ(TASKS_COUNT, executionOrder.size());
+    for (size_t i = 0; i < TASKS_COUNT; ++i)
+    {
+        EXPECT_EQ(i, executionOrder[i]);
+    }
+}
+
+TEST(Engine, TestJobSystemDependencyOnRunningJob)
+{
+    const size_t ITERATIONS_COUNT = 2048;
+    const size_t SUCCESSORS_COUNT = 4;
+    std::atomic<unsigned int> doneTasks = 0;
+    JobPool jobPool(SUCCESSORS_COUNT + 1);
+    JobSystem jobSystem;
+    jobSystem.Init();
+    for (size_t iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+    {
+        jobPool.Clear();
+        //The dependency is already scheduled and can finish while the successors are linked to it,
+        //its duration changes with the iteration to hit the different interleavings
+        Job* dependency = jobPool.CreateJob([&doneTasks, iteration]
+        {
+            for (size_t i = 0; i < iteration % 64; ++i)
+            {
+                std::this_thread::yield();
+            }
+            ++doneTasks;
+        });
+        jobSystem.ScheduleJob(dependency, JobThreadType::OTHER_THREAD);
+        Job* successors[SUCCESSORS_COUNT];
+        for (auto*& successor : successors)
+        {
+            successor = jobPool.CreateJob([&doneTasks] { ++doneTasks; });
+            successor->AddDependency(dependency);
+            jobSystem.ScheduleJob(successor, JobThreadType::OTHER_THREAD);
+        }
+        for (auto* successor : successors)
+        {
+            successor->Join();
+        }
+        dependency->Join();
+    }
+    jobSystem.Destroy();
+    EXPECT_EQ(ITERATIONS_COUNT * (SUCCESSORS_COUNT + 1), doneTasks);
+}
+
+TEST(Engine, TestJobPool)
+{
+    const size_t FRAMES_COUNT = 8;
+    const size_t JOBS_COUNT = 4;
+    std::atomic<unsigned int> doneTasks = 0;
+    JobPool jobPool(JOBS_COUNT);
+    JobSystem jobSystem;
+    jobSystem.Init();
+    for (size_t frame = 0; frame < FRAMES_COUNT; ++frame)
+    {
+        jobPool.Clear();
+        Job* lastJob = jobPool.CreateJob([&doneTasks] { ++doneTasks; });
+        for (size_t i = 1; i < JOBS_COUNT; ++i)
+        {
+            Job* job = jobPool.CreateJob([&doneTasks] { ++doneTasks; });
+            lastJob->AddDependency(job);
+            jobSystem.ScheduleJob(job, JobThreadType::OTHER_THREAD);
+        }
+        jobSystem.ScheduleJob(lastJob, JobThreadType::OTHER_THREAD);
+        lastJob->Join();
+    }
+    jobSystem.Destroy();
+    EXPECT_EQ(FRAMES_COUNT * JOBS_COUNT, doneTasks);
+}
+
+TEST(Engine, TestJobSystemParallelFor)
+{
+    const size_t ELEMENTS_COUNT = 10'000;
+    const size_t GRAIN_SIZE = 64;
+    std::vector<std::atomic<unsigned int>> counts(ELEMENTS_COUNT);
+    JobSystem jobSystem;
+    jobSystem.Init();
+    //From the main thread
+    jobSystem.ParallelFor(0, ELEMENTS_COUNT, GRAIN_SIZE, [&counts, GRAIN_SIZE](size_t begin, size_t end)
+    {
+        EXPECT_LE(end - begin, GRAIN_SIZE);
+        for (size_t i = begin; i < end; i++)
+        {
+            ++counts[i];
+        }
+    });
+    //From an other worker
+    Job job([&jobSystem, &counts]
+    {
+        jobSystem.ParallelFor(0, ELEMENTS_COUNT, GRAIN_SIZE, [&counts](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                ++counts[i];
+            }
+        });
+    });
+    jobSystem.ScheduleJob(&job, JobThreadType::OTHER_THREAD);
+    job.Join();
+    jobSystem.Destroy();
+    for (auto& count : counts)
+    {
+        EXPECT_EQ(2u, count);
+    }
+}
+
+TEST(Engine, TestJobSystemProfile)
+{
+    const size_t JOBS_COUNT = 64;
+    std::vector<Job> jobs(JOBS_COUNT);
+    JobSystem jobSystem;
+    jobSystem.Init();
+    jobSystem.StartTrace();
+    //The second half depends on the first half, scheduled first so they are deferred
+    for (size_t i = JOBS_COUNT / 2; i < JOBS_COUNT; i++)
+    {
+        jobs[i].AddDependency(&jobs[i - JOBS_COUNT / 2]);
+        jobSystem.ScheduleJob(&jobs[i], JobThreadType::OTHER_THREAD);
+    }
+    for (size_t i = 0; i < JOBS_COUNT / 2; i++)
+    {
+        jobSystem.ScheduleJob(&jobs[i], JobThreadType::OTHER_THREAD);
+    }
+    for (auto& job : jobs)
+    {
+        job.Join();
+    }
+    jobSystem.StopTrace();
+    const auto stats = jobSystem.GetStats();
+    const auto trace = jobSystem.GenerateChromeTrace();
+    jobSystem.Destroy();
+
+    std::uint64_t executedJobs = 0;
+    for (const auto& worker : stats.workers)
+    {
+        executedJobs += worker.executedJobs;
+        EXPECT_LE(worker.maxScheduleLatency, worker.totalScheduleLatency);
+    }
+    EXPECT_EQ(JOBS_COUNT, executedJobs);
+    EXPECT_EQ(JOBS_COUNT / 2, stats.deferredJobs);
+    EXPECT_GE(stats.otherQueueHighWater, 1);
+
+    size_t traceEvents = 0;
+    for (auto pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1))
+    {
+        traceEvents++;
+    }
+    EXPECT_EQ(JOBS_COUNT, traceEvents);
+    EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+}
+
+class FakeWindow : public Window
+{
+public:
+    void Init() override {}
+    void Update([[maybe_unused]] seconds dt) override {}
+    void Destroy() override {}
+    void GenerateUiFrame() override {}
+    void SwapBuffer() override { ++swapCount; }
+    void RenderUi() override {}
+    void OnResize([[maybe_unused]] Vec2u newWindowSize) override {}
+    std::atomic<unsigned int> swapCount = 0;
+};
+
+class FakeRenderer : public Renderer
+{
+public:
+    void ClearScreen() override {}
+};
+
+class FakeRenderCommand : public RenderCommandInterface
+{
+public:
+    void Render() override { ++renderCount; }
+    std::atomic<unsigned int> renderCount = 0;
+};
+
+class FakeEngine : public BasicEngine
+{
+public:
+    explicit FakeEngine(Configuration* config) : BasicEngine(config) {}
+    void ManageEvent() override {}
+    void GenerateUiFrame() override {}
+};
+
+class FakeRenderProgram : public SystemInterface
+{
+public:
+    void Init() override {}
+    void Update([[maybe_unused]] seconds dt) override
+    {
+        RendererLocator::get().Render(&command);
+        ++updateCount;
+    }
+    void Destroy() override {}
+    FakeRenderCommand command;
+    unsigned int updateCount = 0;
+};
+
+TEST(Engine, TestFramePipelining)
+{
+    const unsigned int FRAMES_COUNT = 32;
+    for (std::uint8_t pipelineDepth = 1; pipelineDepth <= 2; pipelineDepth++)
+    {
+        Configuration config;
+        config.framePipelineDepth = pipelineDepth;
+        FakeWindow window;
+        FakeRenderer renderer;
+        FakeEngine engine(&config);
+        FakeRenderProgram program;
+        engine.SetWindowAndRenderer(&window, &renderer);
+        engine.RegisterSystem(program);
+        engine.Init();
+        for (unsigned int frame = 0; frame < FRAMES_COUNT; frame++)
+        {
+            engine.Update(seconds(0.01f));
+        }
+        engine.Destroy();
+        RendererLocator::provide(nullptr);
+        EXPECT_EQ(FRAMES_COUNT, window.swapCount);
+        EXPECT_EQ(FRAMES_COUNT, program.updateCount);
+        //Commands are rendered the frame after they are submitted
+        EXPECT_EQ(FRAMES_COUNT - 1, program.command.renderCount);
+    }
+}
+
 }
@@ -12,6 +12,7 @@
 
 #include <mathematics/quaternion.h>
 #include <mathematics/matrix.h>
+#include <mathematics/transform.h>
 #include "mathematics/vector.h"
 
 
@@ -107,6 +108,98 @@ TEST(Engine, Quaternion_FromEuler)
     //TODO
 }
 
+TEST(Engine, Quaternion_ToEuler)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> angleDistribution(-170.0f, 170.0f);
+    std::uniform_real_distribution<float> pitchDistribution(-80.0f, 80.0f);
+    for (int i = 0; i < 100; i++)
+    {
+        const neko::EulerAngles angles(
+                neko::degree_t(angleDistribution(generator)),
+                neko::degree_t(pitchDistribution(generator)),
+                neko::degree_t(angleDistribution(generator)));
+        const auto result = neko::Quaternion::ToEuler(neko::Quaternion::FromEuler(angles));
+        EXPECT_NEAR(result.x.value(), angles.x.value(), 0.01f);
+        EXPECT_NEAR(result.y.value(), angles.y.value(), 0.01f);
+        EXPECT_NEAR(result.z.value(), angles.z.value(), 0.01f);
+    }
+}
+
+TEST(Engine, Quaternion_Slerp)
+{
+    const neko::Quaternion a = neko::Quaternion::FromEuler(
+            neko::EulerAngles(neko::degree_t(0), neko::degree_t(0), neko::degree_t(0)));
+    const neko::Quaternion b = neko::Quaternion::FromEuler(
+            neko::EulerAngles(neko::degree_t(90), neko::degree_t(0), neko::degree_t(0)));
+    const neko::Quaternion half = neko::Quaternion::FromEuler(
+            neko::EulerAngles(neko::degree_t(45), neko::degree_t(0), neko::degree_t(0)));
+    EXPECT_NEAR(neko::Quaternion::Dot(neko::Quaternion::Slerp(a, b, 0.0f), a), 1.0f, 0.0001f);
+    EXPECT_NEAR(neko::Quaternion::Dot(neko::Quaternion::Slerp(a, b, 1.0f), b), 1.0f, 0.0001f);
+    EXPECT_NEAR(neko::Quaternion::Dot(neko::Quaternion::Slerp(a, b, 0.5f), half), 1.0f, 0.0001f);
+    //Same rotation with the opposite sign, the shortest path stays on the rotation
+    const auto opposite = neko::Quaternion::Slerp(a, a * -1.0f, 0.5f);
+    EXPECT_NEAR(std::abs(neko::Quaternion::Dot(opposite, a)), 1.0f, 0.0001f);
+    const auto nlerp = neko::Quaternion::Nlerp(a, b, 0.5f);
+    EXPECT_NEAR(neko::Quaternion::Magnitude(nlerp), 1.0f, 0.0001f);
+    EXPECT_NEAR(neko::Quaternion::Dot(nlerp, half), 1.0f, 0.0001f);
+}
+
+template<typename NVec4, int N>
+void TestQuaternionBatch()
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> angleDistribution(-180.0f, 180.0f);
+    NVec4 as;
+    NVec4 bs;
+    std::array<neko::Quaternion, N> aQuaternions;
+    std::array<neko::Quaternion, N> bQuaternions;
+    for (int i = 0; i < N; i++)
+    {
+        aQuaternions[i] = neko::Quaternion::FromEuler(neko::EulerAngles(
+                neko::degree_t(angleDistribution(generator)),
+                neko::degree_t(angleDistribution(generator)),
+                neko::degree_t(angleDistribution(generator))));
+        //The last lane is almost the same rotation to use the nlerp fallback
+        bQuaternions[i] = i == N - 1 ? aQuaternions[i] : neko::Quaternion::FromEuler(neko::EulerAngles(
+                neko::degree_t(angleDistribution(generator)),
+                neko::degree_t(angleDistribution(generator)),
+                neko::degree_t(angleDistribution(generator))));
+        as.xs[i] = aQuaternions[i].x;
+        as.ys[i] = aQuaternions[i].y;
+        as.zs[i] = aQuaternions[i].z;
+        as.ws[i] = aQuaternions[i].w;
+        bs.xs[i] = bQuaternions[i].x;
+        bs.ys[i] = bQuaternions[i].y;
+        bs.zs[i] = bQuaternions[i].z;
+        bs.ws[i] = bQuaternions[i].w;
+    }
+    for (float t : {0.0f, 0.3f, 1.0f})
+    {
+        const auto slerps = neko::Quaternion::Slerp(as, bs, t);
+        const auto nlerps = neko::Quaternion::Nlerp(as, bs, t);
+        for (int i = 0; i < N; i++)
+        {
+            const auto slerp = neko::Quaternion::Slerp(aQuaternions[i], bQuaternions[i], t);
+            EXPECT_NEAR(slerps.xs[i], slerp.x, 0.001f);
+            EXPECT_NEAR(slerps.ys[i], slerp.y, 0.001f);
+            EXPECT_NEAR(slerps.zs[i], slerp.z, 0.001f);
+            EXPECT_NEAR(slerps.ws[i], slerp.w, 0.001f);
+            const auto nlerp = neko::Quaternion::Nlerp(aQuaternions[i], bQuaternions[i], t);
+            EXPECT_NEAR(nlerps.xs[i], nlerp.x, 0.001f);
+            EXPECT_NEAR(nlerps.ys[i], nlerp.y, 0.001f);
+            EXPECT_NEAR(nlerps.zs[i], nlerp.z, 0.001f);
+            EXPECT_NEAR(nlerps.ws[i], nlerp.w, 0.001f);
+        }
+    }
+}
+
+TEST(Engine, Quaternion_SlerpBatch)
+{
+    TestQuaternionBatch<neko::FourVec4f, 4>();
+    TestQuaternionBatch<neko::EightVec4f, 8>();
+}
+
 TEST(Aabb, Aabb2d_Aabb2d)
 {
     //Same Aabb
@@ -738,3 +831,51 @@ TEST(Engine, TestMatrix4)
 	EXPECT_LT(neko::Mat4f::MatrixDifference(mInvCalculus, mInv), 0.01f);
 	EXPECT_GT(neko::Mat4f::MatrixDifference(mInvCalculus, neko::Mat4f::Identity), 0.01f);
 }
+
+template<typename Vec3Batch, typename Vec4Batch>
+void TestComposeTransforms()
+{
+    const int batchSize = sizeof(Vec4Batch::xs) / sizeof(float);
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+    Vec3Batch positions;
+    Vec3Batch scales;
+    Vec4Batch rotations;
+    std::vector<neko::Mat4f> expectedTransforms(batchSize);
+    for (int i = 0; i < batchSize; i++)
+    {
+        const neko::Vec3f position(distribution(generator), distribution(generator), distribution(generator));
+        const neko::Vec3f scale(distribution(generator), distribution(generator), distribution(generator));
+        const neko::EulerAngles angles(
+                neko::degree_t(distribution(generator) * 18.0f),
+                neko::degree_t(distribution(generator) * 18.0f),
+                neko::degree_t(distribution(generator) * 18.0f));
+        const auto rotation = neko::Quaternion::FromEuler(angles);
+        positions.xs[i] = position.x;
+        positions.ys[i] = position.y;
+        positions.zs[i] = position.z;
+        scales.xs[i] = scale.x;
+        scales.ys[i] = scale.y;
+        scales.zs[i] = scale.z;
+        rotations.xs[i] = rotation.x;
+        rotations.ys[i] = rotation.y;
+        rotations.zs[i] = rotation.z;
+        rotations.ws[i] = rotation.w;
+        //Same order as the transform managers
+        auto transform = neko::Transform3d::Rotate(neko::Mat4f::Identity, angles);
+        transform = neko::Transform3d::Scale(transform, scale);
+        expectedTransforms[i] = neko::Transform3d::Translate(transform, position);
+    }
+    std::vector<neko::Mat4f> transforms(batchSize);
+    neko::Transform3d::ComposeTransforms(positions, scales, rotations, transforms.data());
+    for (int i = 0; i < batchSize; i++)
+    {
+        EXPECT_LT(neko::Mat4f::MatrixDifference(transforms[i], expectedTransforms[i]), 0.01f);
+    }
+}
+
+TEST(Engine, ComposeTransforms)
+{
+    TestComposeTransforms<neko::FourVec3f, neko::FourVec4f>();
+    TestComposeTransforms<neko::EightVec3f, neko::EightVec4f>();
+}